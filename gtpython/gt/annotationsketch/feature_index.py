@@ -51,8 +51,7 @@ class FeatureIndex:
             a = Array(rval, True)
             result = []
             for i in range(a.size()):
-                fptr = gtlib.gt_genome_node_ref(a.get(i))
-                result.append(FeatureNode.create_from_ptr(fptr))
+                result.append(FeatureNode.create_from_ptr(a.get(i)))
             return result
         else:
             return None
@@ -94,8 +93,7 @@ class FeatureIndex:
             gterror(err)
         result = []
         for i in range(a.size()):
-            fptr = gtlib.gt_genome_node_ref(a.get(i))
-            result.append(FeatureNode.create_from_ptr(fptr))
+            result.append(FeatureNode.create_from_ptr(a.get(i)))
         return result
 
     def register(cls, gtlib):
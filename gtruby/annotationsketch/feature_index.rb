@@ -56,7 +56,7 @@ module GT
         a = GT::Array.new(rval)
         result = []
         1.upto(a.size) do |i|
-          fn = GT::FeatureNode.new(GT.gt_genome_node_ref(a.get(i-1)))
+          fn = GT::FeatureNode.new(a.get(i-1))
           result.push(fn)
         end
         result
@@ -78,7 +78,7 @@ module GT
       end
       result = []
       1.upto(a.size) do |i|
-        fn = GT::FeatureNode.new(GT.gt_genome_node_ref(a.get(i-1)))
+        fn = GT::FeatureNode.new(a.get(i-1))
         result.push(fn)
       end
       result
@@ -0,0 +1,59 @@
+#!/bin/sh
+#
+# Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+#
+# Permission to use, copy, modify, and distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+#
+
+# Compare the memory consumption of feature trees between different gt
+# binaries (e.g., before and after a change of the node layout). For each
+# binary the space peak of loading and sorting all features of the given GFF3
+# files is shown, together with the resulting number of bytes per feature.
+
+if test $# -lt 2
+then
+  echo "Usage: $0 <gt binary> [<gt binary> ...] -- <GFF3 file> [...]"
+  exit 1
+fi
+
+binaries=""
+while test $# -gt 0 -a "$1" != "--"
+do
+  binaries="${binaries} $1"
+  shift
+done
+if test $# -lt 2
+then
+  echo "$0: no GFF3 file given"
+  exit 1
+fi
+shift
+
+# the number of features (all non-comment lines which are not directives)
+features=`cat $* | grep -v '^#' | grep -c -v '^$'`
+echo "features: ${features}"
+
+for gt in ${binaries}
+do
+  peak=`env GT_MEM_BOOKKEEPING=on GT_ENV_OPTIONS=-spacepeak \
+        ${gt} gff3 -sort $* | grep '^# space peak' | \
+        sed -e 's/.*megabytes: \([0-9.]*\).*/\1/'`
+  if test -z "${peak}"
+  then
+    echo "failure: ${gt} gff3 -sort $*"
+    exit 1
+  fi
+  echo "${gt}: space peak ${peak} MB" | \
+    awk -v f=${features} -v p=${peak} \
+        '{printf("%s (%.2f bytes per feature)\n", $0, p * 1048576 / f)}'
+done
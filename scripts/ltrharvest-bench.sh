@@ -0,0 +1,78 @@
+#!/bin/bash
+#
+# Times gt ltrharvest on the LTR sets of the testdata (yeast and Drosophila,
+# with the parameters of the testsuite) and checks that the output is the same
+# as that of a reference binary, e.g. one built before a change to the seed
+# extension.
+#
+# usage: scripts/ltrharvest-bench.sh [reference-gt]
+# GTTESTDATA must point to the gttestdata directory.
+
+set -e
+
+if test -z "${GTTESTDATA}"
+then
+  echo "$0: set GTTESTDATA to the gttestdata directory" 1>&2
+  exit 1
+fi
+GT=`pwd`/bin/gt
+REFGT=$1
+TMPDIR=`mktemp -d ltrbench.XXXXXX`
+trap "rm -rf ${TMPDIR}" EXIT
+TIMEFORMAT="%U"
+
+# runs ltrharvest with <binary> on index <idx> and parameters <params>,
+# prints the user time and writes the output to <out>
+runltrharvest()
+{
+  binary=$1
+  idx=$2
+  out=$3
+  shift 3
+  { time ${binary} ltrharvest -index ${idx} "$@" > ${out} 2>/dev/null ; } 2>&1
+}
+
+benchset()
+{
+  name=$1
+  file=$2
+  shift 2
+  ${GT} suffixerator -db ${file} -dna -suf -lcp -tis -des -ssp \
+                     -indexname ${TMPDIR}/${name}
+  newtime=`runltrharvest ${GT} ${TMPDIR}/${name} ${TMPDIR}/${name}.new "$@"`
+  if test -n "${REFGT}"
+  then
+    reftime=`runltrharvest ${REFGT} ${TMPDIR}/${name} ${TMPDIR}/${name}.ref \
+                           "$@"`
+    if cmp -s ${TMPDIR}/${name}.new ${TMPDIR}/${name}.ref
+    then
+      result="same"
+    else
+      result="DIFFERENT"
+    fi
+    echo "${name} ${newtime}s ${reftime}s ${result}"
+  else
+    echo "${name} ${newtime}s"
+  fi
+}
+
+if test -n "${REFGT}"
+then
+  echo "# set time time(reference) output"
+else
+  echo "# set time"
+fi
+for file in ${GTTESTDATA}/ltrharvest/s_cer/chr*.fsa.gz
+do
+  benchset `basename ${file} .fsa.gz` ${file} -seed 100 -minlenltr 100 \
+           -maxlenltr 1000 -mindistltr 1500 -maxdistltr 15000 -similar 80 \
+           -mintsd 5 -maxtsd 20 -motif tgca -motifmis 0 -vic 60 \
+           -overlaps best -xdrop 5 -mat 2 -mis -2 -ins -3 -del -3 -v
+done
+for file in ${GTTESTDATA}/ltrharvest/d_mel/*_genomic_dmel_RELEASE3-1.FASTA.gz
+do
+  benchset `basename ${file} .FASTA.gz` ${file} -seed 76 -minlenltr 116 \
+           -maxlenltr 800 -mindistltr 2280 -maxdistltr 8773 -similar 91 \
+           -mintsd 4 -maxtsd 20 -vic 60 -overlaps best -xdrop 7 -mat 2 \
+           -mis -2 -ins -3 -del -3 -v
+done
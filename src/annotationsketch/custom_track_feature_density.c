@@ -0,0 +1,138 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "annotationsketch/custom_track_feature_density.h"
+#include "annotationsketch/custom_track_rep.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/unused_api.h"
+
+struct GtCustomTrackFeatureDensity {
+  const GtCustomTrack parent_instance;
+  unsigned long *counts,
+                nof_bins,
+                max_count,
+                height;
+  GtStr *title;
+};
+
+#define gt_custom_track_feature_density_cast(ct)\
+        gt_custom_track_cast(gt_custom_track_feature_density_class(), ct)
+
+int gt_custom_track_feature_density_sketch(GtCustomTrack *ct,
+                                           GtGraphics *graphics,
+                                           unsigned int start_ypos,
+                                           GT_UNUSED GtRange viewrange,
+                                           GtStyle *style,
+                                           GT_UNUSED GtError *err)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  GtColor color, grey;
+  double bin_width, bar_height, xmargins;
+  unsigned long i;
+  gt_assert(ct && graphics && style);
+  ctfd = gt_custom_track_feature_density_cast(ct);
+
+  (void) gt_style_get_color(style, "feature_density", "fill", &color, NULL);
+  grey.red = grey.blue = grey.green = 0.8;
+  grey.alpha = 0.9;
+  xmargins = gt_graphics_get_xmargins(graphics);
+  bin_width = (gt_graphics_get_image_width(graphics) - 2 * xmargins)
+                / ctfd->nof_bins;
+
+  gt_graphics_draw_horizontal_line(graphics, xmargins,
+                                   start_ypos + ctfd->height, grey,
+                                   gt_graphics_get_image_width(graphics)
+                                     - 2 * xmargins,
+                                   1.0);
+  if (!ctfd->max_count)
+    return 0;
+  for (i = 0; i < ctfd->nof_bins; i++) {
+    if (!ctfd->counts[i])
+      continue;
+    bar_height = (double) ctfd->counts[i] / ctfd->max_count * ctfd->height;
+    gt_graphics_draw_vertical_line(graphics, xmargins + (i + 0.5) * bin_width,
+                                   start_ypos + ctfd->height - bar_height,
+                                   color, bar_height, bin_width);
+  }
+  return 0;
+}
+
+unsigned long gt_custom_track_feature_density_get_height(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  return ctfd->height;
+}
+
+const char* gt_custom_track_feature_density_get_title(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  return gt_str_get(ctfd->title);
+}
+
+void gt_custom_track_feature_density_delete(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  if (!ct) return;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  gt_free(ctfd->counts);
+  gt_str_delete(ctfd->title);
+}
+
+const GtCustomTrackClass* gt_custom_track_feature_density_class(void)
+{
+  static const GtCustomTrackClass *ctc = NULL;
+  if (!ctc)
+  {
+    ctc = gt_custom_track_class_new(sizeof (GtCustomTrackFeatureDensity),
+                                    gt_custom_track_feature_density_sketch,
+                                    gt_custom_track_feature_density_get_height,
+                                    gt_custom_track_feature_density_get_title,
+                                    gt_custom_track_feature_density_delete);
+  }
+  return ctc;
+}
+
+GtCustomTrack* gt_custom_track_feature_density_new(const unsigned long *counts,
+                                                   unsigned long nof_bins,
+                                                   unsigned long nof_features,
+                                                   unsigned long height)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  GtCustomTrack *ct;
+  unsigned long i;
+  gt_assert(counts && nof_bins);
+  ct = gt_custom_track_create(gt_custom_track_feature_density_class());
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  ctfd->counts = gt_malloc(nof_bins * sizeof (unsigned long));
+  memcpy(ctfd->counts, counts, nof_bins * sizeof (unsigned long));
+  ctfd->nof_bins = nof_bins;
+  ctfd->height = height;
+  for (i = 0; i < nof_bins; i++) {
+    if (counts[i] > ctfd->max_count)
+      ctfd->max_count = counts[i];
+  }
+  ctfd->title = gt_str_new_cstr("Feature density (");
+  gt_str_append_ulong(ctfd->title, nof_features);
+  gt_str_append_cstr(ctfd->title, " features, at most ");
+  gt_str_append_ulong(ctfd->title, ctfd->max_count);
+  gt_str_append_cstr(ctfd->title, " per bin)");
+  return ct;
+}
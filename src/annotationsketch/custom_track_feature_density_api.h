@@ -0,0 +1,38 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef CUSTOM_TRACK_FEATURE_DENSITY_API_H
+#define CUSTOM_TRACK_FEATURE_DENSITY_API_H
+
+#include "annotationsketch/custom_track_api.h"
+
+/* Implements the <GtCustomTrack> interface. This custom track draws a
+   histogram of the number of features overlapping each of a number of equally
+   sized bins covering the displayed range. It is used instead of the
+   individual features if these are too many to be drawn in a meaningful
+   way. */
+typedef struct GtCustomTrackFeatureDensity GtCustomTrackFeatureDensity;
+
+/* Creates a new <GtCustomTrackFeatureDensity> of height <height> drawing the
+   <nof_bins> feature counts given in <counts>. The title mentions
+   <nof_features> as the total number of features in the displayed range. */
+GtCustomTrack* gt_custom_track_feature_density_new(const unsigned long *counts,
+                                                   unsigned long nof_bins,
+                                                   unsigned long nof_features,
+                                                   unsigned long height);
+
+#endif
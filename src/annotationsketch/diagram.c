@@ -19,7 +19,10 @@
 
 #include "annotationsketch/canvas.h"
 #include "annotationsketch/canvas_cairo_file.h"
+#include "annotationsketch/custom_track_feature_density.h"
+#include "annotationsketch/default_formats.h"
 #include "annotationsketch/diagram.h"
+#include "annotationsketch/feature_index.h"
 #include "annotationsketch/feature_index_memory_api.h"
 #include "annotationsketch/line_breaker_captions.h"
 #include "annotationsketch/style.h"
@@ -36,12 +39,16 @@
 #include "core/unused_api.h"
 #include "extended/feature_node.h"
 #include "extended/genome_node.h"
+#include "extended/region_node.h"
 
 /* used to index non-multiline-feature blocks
    undefined pointer -- never dereference! */
 #define GT_UNDEF_REPR               (void*)~0
 /* used to separate a filename from the type in a track name */
 #define FILENAME_TYPE_SEPARATOR  '|'
+/* features per pixel above which only their density is shown */
+#define DENSITY_THRESHOLD_DEFAULT  10
+#define DENSITY_HEIGHT_DEFAULT     50
 
 struct GtDiagram {
   /* GtBlock lists indexed by track keys */
@@ -53,6 +60,14 @@ struct GtDiagram {
   GtStyle *style;
   GtArray *features,
           *custom_tracks;
+  /* the features are owned by the diagram, unless they were passed to
+     gt_diagram_new_from_array() */
+  bool owns_features;
+  /* maps root features to their RootBlocks, blocks of features which stay
+     completely visible are reused by gt_diagram_update() */
+  GtHashmap *root_blocks;
+  /* replaces the features if there are too many of them to be shown */
+  GtCustomTrack *density_track;
   GtRange range;
   void *ptr;
   GtTrackSelectorFunc select_func;
@@ -87,8 +102,26 @@ typedef struct {
 typedef struct {
   GtFeatureNode *parent;
   GtDiagram *diagram;
+  unsigned long max_start, /* largest start of a node in the tree */
+                min_end;   /* smallest end of a node in the tree */
 } NodeTraverseInfo;
 
+/* the blocks built from a root feature and the tracks they belong to */
+typedef struct {
+  GtArray *blocks;
+  GtStrArray *track_ids;
+  /* all nodes of the feature tree overlap a range iff it contains
+     [min_end, max_start] (for max_start > min_end) */
+  unsigned long max_start,
+                min_end;
+  bool complete; /* all nodes overlapped the range the blocks were built for */
+} RootBlocks;
+
+typedef struct {
+  GtDiagram *diagram;
+  RootBlocks *root_blocks;
+} BlockCollectInfo;
+
 static inline GtBlockTuple* blocktuple_new(const char *gft,
                                            GtFeatureNode *rep,
                                            GtBlock *block)
@@ -520,6 +553,15 @@ static void process_node(GtDiagram *d, GtFeatureNode *node,
     gt_assert(gt_hashmap_get(d->nodeinfo, node));
 }
 
+static void update_extent(NodeTraverseInfo *nti, GtGenomeNode *gn)
+{
+  GtRange range = gt_genome_node_get_range(gn);
+  if (range.start > nti->max_start)
+    nti->max_start = range.start;
+  if (range.end < nti->min_end)
+    nti->min_end = range.end;
+}
+
 static int visit_child(GtGenomeNode* gn, void *nti,
                        GtError *err)
 {
@@ -527,6 +569,7 @@ static int visit_child(GtGenomeNode* gn, void *nti,
    int had_err;
   gt_genome_node_info = (NodeTraverseInfo*) nti;
   gt_error_check(err);
+  update_extent(gt_genome_node_info, gn);
 
   if (gt_genome_node_has_children(gn))
   {
@@ -565,12 +608,13 @@ static void default_track_selector(GtBlock *block, GtStr *result,
   gt_str_append_cstr(result, gt_block_get_type(block));
 }
 
-/* Create lists of all GtBlocks in the diagram. */
+/* Collect the GtBlocks of a feature tree and their track identifiers. */
 static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
                           GT_UNUSED GtError *err)
 {
   NodeInfoElement *ni = (NodeInfoElement*) value;
-  GtDiagram *diagram = (GtDiagram*) data;
+  BlockCollectInfo *bci = (BlockCollectInfo*) data;
+  GtDiagram *diagram = bci->diagram;
   GtBlock *block = NULL;
   GtStr *trackid_str;
   unsigned long i = 0;
@@ -578,7 +622,6 @@ static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
   for (i = 0; i < gt_str_array_size(ni->types); i++) {
     const char *type;
     unsigned long j;
-    GtArray *list;
     PerTypeInfo *type_struc = NULL;
     GtBlock* mainblock = NULL;
     type = gt_str_array_get(ni->types, i);
@@ -608,16 +651,8 @@ static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
       gt_str_reset(trackid_str);
       /* execute hook for track selector function */
       diagram->select_func(block, trackid_str, diagram->ptr);
-
-      if (!(list = (GtArray*) gt_hashmap_get(diagram->blocks,
-                                             gt_str_get(trackid_str))))
-      {
-        list = gt_array_new(sizeof (GtBlock*));
-        gt_hashmap_add(diagram->blocks, gt_cstr_dup(gt_str_get(trackid_str)),
-                       list);
-      };
-      gt_assert(list);
-      gt_array_add(list, block);
+      gt_array_add(bci->root_blocks->blocks, block);
+      gt_str_array_add(bci->root_blocks->track_ids, trackid_str);
       gt_free(bt);
     }
     gt_array_delete(type_struc->blocktuples);
@@ -640,6 +675,7 @@ static void traverse_genome_nodes(GtFeatureNode *gn,
   gt_assert(nti);
   gt_genome_node_info = (NodeTraverseInfo*) nti;
   gt_genome_node_info->parent = gn;
+  update_extent(gt_genome_node_info, (GtGenomeNode*) gn);
   /* handle root nodes */
   process_node(gt_genome_node_info->diagram, (GtFeatureNode*)gn, NULL);
   if (gt_genome_node_has_children((GtGenomeNode*) gn)) {
@@ -661,14 +697,94 @@ static void blocklist_delete(void *value)
   gt_array_delete(a);
 }
 
+static void root_blocks_delete(RootBlocks *rb)
+{
+  unsigned long i;
+  if (!rb) return;
+  for (i = 0; i < gt_array_size(rb->blocks); i++)
+    gt_block_delete(*(GtBlock**) gt_array_get(rb->blocks, i));
+  gt_array_delete(rb->blocks);
+  gt_str_array_delete(rb->track_ids);
+  gt_free(rb);
+}
+
+static int delete_root_blocks(GT_UNUSED void *key, void *value,
+                              GT_UNUSED void *data, GT_UNUSED GtError *err)
+{
+  root_blocks_delete(value);
+  return 0;
+}
+
+static void reset_root_blocks(GtDiagram *diagram)
+{
+  int had_err;
+  gt_assert(diagram);
+  had_err = gt_hashmap_foreach(diagram->root_blocks, delete_root_blocks, NULL,
+                               NULL);
+  gt_assert(!had_err); /* delete_root_blocks() is sane */
+  gt_hashmap_reset(diagram->root_blocks);
+}
+
+static bool root_blocks_are_complete(const RootBlocks *rb,
+                                     const GtRange *range)
+{
+  gt_assert(rb && range);
+  return rb->max_start <= range->end && rb->min_end >= range->start;
+}
+
+/* Build the blocks of the feature tree rooted at <root>. */
+static RootBlocks* build_root_blocks(GtDiagram *diagram, GtFeatureNode *root)
+{
+  NodeTraverseInfo nti;
+  BlockCollectInfo bci;
+  RootBlocks *rb;
+  int had_err;
+  gt_assert(diagram && root);
+  nti.diagram = diagram;
+  nti.max_start = 0;
+  nti.min_end = ~0UL;
+  gt_hashmap_reset(diagram->nodeinfo);
+  traverse_genome_nodes(root, &nti);
+  rb = gt_malloc(sizeof *rb);
+  rb->blocks = gt_array_new(sizeof (GtBlock*));
+  rb->track_ids = gt_str_array_new();
+  rb->max_start = nti.max_start;
+  rb->min_end = nti.min_end;
+  rb->complete = root_blocks_are_complete(rb, &diagram->range);
+  /* collect blocks from nodeinfo structures */
+  bci.diagram = diagram;
+  bci.root_blocks = rb;
+  had_err = gt_hashmap_foreach_ordered(diagram->nodeinfo, collect_blocks, &bci,
+                                       (GtCompare) gt_genome_node_cmp, NULL);
+  gt_assert(!had_err); /* collect_blocks() is sane */
+  gt_hashmap_reset(diagram->nodeinfo);
+  return rb;
+}
+
+static void add_root_blocks_to_tracks(GtDiagram *diagram, RootBlocks *rb)
+{
+  GtArray *list;
+  GtBlock *block;
+  const char *track_id;
+  unsigned long i;
+  gt_assert(diagram && rb);
+  for (i = 0; i < gt_array_size(rb->blocks); i++) {
+    track_id = gt_str_array_get(rb->track_ids, i);
+    if (!(list = (GtArray*) gt_hashmap_get(diagram->blocks, track_id))) {
+      list = gt_array_new(sizeof (GtBlock*));
+      gt_hashmap_add(diagram->blocks, gt_cstr_dup(track_id), list);
+    }
+    block = gt_block_ref(*(GtBlock**) gt_array_get(rb->blocks, i));
+    gt_array_add(list, block);
+  }
+}
+
 int gt_diagram_build(GtDiagram *diagram)
 {
   unsigned long i = 0;
-  int had_err = 0;
-  NodeTraverseInfo nti;
+  RootBlocks *rb;
 
   gt_assert(diagram);
-  nti.diagram = diagram;
 
   /* clear caches */
   gt_hashmap_reset(diagram->collapsingtypes);
@@ -677,26 +793,23 @@ int gt_diagram_build(GtDiagram *diagram)
 
   if (!diagram->blocks)
   {
-    gt_hashmap_reset(diagram->nodeinfo);
-    /* do node traversal for each root feature */
+    diagram->blocks = gt_hashmap_new(HASH_STRING, gt_free_func,
+                                    (GtFree) blocklist_delete);
+    /* do node traversal for each root feature whose blocks have not been
+       kept by gt_diagram_update() */
     for (i = 0; i < gt_array_size(diagram->features); i++)
     {
       GtFeatureNode *current_root = *(GtFeatureNode**)
                                            gt_array_get(diagram->features,i);
-      traverse_genome_nodes(current_root, &nti);
+      if (!(rb = gt_hashmap_get(diagram->root_blocks, current_root))) {
+        rb = build_root_blocks(diagram, current_root);
+        gt_hashmap_add(diagram->root_blocks, current_root, rb);
+      }
+      add_root_blocks_to_tracks(diagram, rb);
     }
-    diagram->blocks = gt_hashmap_new(HASH_STRING, gt_free_func,
-                                    (GtFree) blocklist_delete);
-    /* collect blocks from nodeinfo structures */
-    had_err = gt_hashmap_foreach_ordered(diagram->nodeinfo,
-                                         collect_blocks,
-                                         diagram,
-                                         (GtCompare) gt_genome_node_cmp,
-                                         NULL);
-    gt_assert(!had_err); /* collect_blocks() is sane */
   }
 
-  return had_err;
+  return 0;
 }
 
 static GtDiagram* gt_diagram_new_generic(GtArray *features,
@@ -715,6 +828,7 @@ static GtDiagram* gt_diagram_new_generic(GtArray *features,
     diagram->features = features;
   diagram->select_func = default_track_selector;
   diagram->custom_tracks = gt_array_new(sizeof (GtCustomTrack*));
+  diagram->root_blocks = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
   /* init caches */
   diagram->collapsingtypes = gt_hashmap_new(HASH_STRING, NULL, gt_free_func);
   diagram->groupedtypes = gt_hashmap_new(HASH_STRING, NULL, gt_free_func);
@@ -745,6 +859,57 @@ GtDiagram* gt_diagram_new(GtFeatureIndex *feature_index, const char *seqid,
     return NULL;
   }
   diagram = gt_diagram_new_generic(features, range, style, false);
+  diagram->owns_features = true;
+  return diagram;
+}
+
+GtDiagram* gt_diagram_new_for_width(GtFeatureIndex *feature_index,
+                                    const char *seqid, const GtRange *range,
+                                    unsigned int width, GtStyle *style,
+                                    GtError *err)
+{
+  GtDiagram *diagram;
+  unsigned long *counts, nof_bins, nof_features = 0;
+  double margins = MARGINS_DEFAULT,
+         threshold = DENSITY_THRESHOLD_DEFAULT,
+         height = DENSITY_HEIGHT_DEFAULT;
+  int had_err = 0;
+  gt_assert(seqid && range && style);
+  if (range->start == range->end)
+  {
+    gt_error_set(err, "range start must not be equal to range end");
+    return NULL;
+  }
+  (void) gt_style_get_num(style, "format", "margins", &margins, NULL);
+  (void) gt_style_get_num(style, "feature_density", "threshold", &threshold,
+                          NULL);
+  if (threshold <= 0 || width <= 2 * margins)
+    return gt_diagram_new(feature_index, seqid, range, style, err);
+  /* count the features per pixel without loading them, if possible */
+  nof_bins = width - 2 * margins;
+  counts = gt_calloc(nof_bins, sizeof (unsigned long));
+  had_err = gt_feature_index_get_counts_for_range(feature_index, counts,
+                                                  nof_bins, seqid, range,
+                                                  &nof_features, err);
+  if (had_err) {
+    gt_free(counts);
+    return NULL;
+  }
+  if (nof_features <= threshold * nof_bins) {
+    gt_free(counts);
+    return gt_diagram_new(feature_index, seqid, range, style, err);
+  }
+  gt_log_log("showing density of %lu features instead of the features",
+             nof_features);
+  (void) gt_style_get_num(style, "feature_density", "height", &height, NULL);
+  diagram = gt_diagram_new_generic(gt_array_new(sizeof (GtGenomeNode*)), range,
+                                   style, false);
+  diagram->density_track = gt_custom_track_feature_density_new(counts,
+                                                               nof_bins,
+                                                               nof_features,
+                                                               height);
+  gt_diagram_add_custom_track(diagram, diagram->density_track);
+  gt_free(counts);
   return diagram;
 }
 
@@ -755,6 +920,173 @@ GtDiagram* gt_diagram_new_from_array(GtArray *features, const GtRange *range,
   return gt_diagram_new_generic(features, range, style, true);
 }
 
+GtDiagram* gt_diagram_new_from_stream(GtNodeStream *sorted_stream,
+                                      const char *seqid, const GtRange *range,
+                                      GtStyle *style, GtError *err)
+{
+  GtDiagram *diagram;
+  GtArray *features;
+  GtGenomeNode *gn;
+  GtStr *window_seqid = NULL;
+  GtRange node_range, span, window;
+  bool seqid_found = false,
+       features_found = false,
+       past_window = false;
+  unsigned long i;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(sorted_stream && style);
+  features = gt_array_new(sizeof (GtGenomeNode*));
+  if (seqid)
+    window_seqid = gt_str_new_cstr(seqid);
+  span.start = GT_UNDEF_ULONG;
+  span.end = 0;
+
+  while (!past_window &&
+         !(had_err = gt_node_stream_next(sorted_stream, &gn, err)) && gn) {
+    /* the first sequence region is shown if no <seqid> was given */
+    if (!window_seqid && (gt_region_node_try_cast(gn) ||
+                          gt_feature_node_try_cast(gn))) {
+      window_seqid = gt_str_ref(gt_genome_node_get_seqid(gn));
+    }
+    if (gt_region_node_try_cast(gn) &&
+        !gt_str_cmp(gt_genome_node_get_seqid(gn), window_seqid)) {
+      seqid_found = true;
+      if (!features_found)
+        span = gt_genome_node_get_range(gn);
+    }
+    else if (gt_feature_node_try_cast(gn)) {
+      node_range = gt_genome_node_get_range(gn);
+      if (gt_str_cmp(gt_genome_node_get_seqid(gn), window_seqid)) {
+        /* the features of <seqid> come in one run */
+        past_window = features_found;
+      }
+      else if (range && node_range.start > range->end)
+        past_window = true;
+      else {
+        if (!features_found) {
+          /* the span of the features replaces the sequence region */
+          span = node_range;
+          seqid_found = features_found = true;
+        }
+        else
+          span = gt_range_join(&span, &node_range);
+        if (!range || gt_range_overlap(&node_range, range)) {
+          gt_array_add(features, gn);
+          continue;
+        }
+      }
+    }
+    gt_genome_node_delete(gn);
+  }
+  if (past_window)
+    gt_log_log("stopped reading after the end of the diagram range");
+
+  if (!had_err && !seqid_found) {
+    if (window_seqid) {
+      gt_error_set(err, "sequence region '%s' does not exist in the input",
+                   gt_str_get(window_seqid));
+    }
+    else
+      gt_error_set(err, "the input does not contain a sequence region");
+    had_err = -1;
+  }
+  if (!had_err) {
+    window = range ? *range : span;
+    if (window.start == window.end) {
+      gt_error_set(err, "range start must not be equal to range end");
+      had_err = -1;
+    }
+  }
+  gt_str_delete(window_seqid);
+  if (had_err) {
+    for (i = 0; i < gt_array_size(features); i++)
+      gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(features, i));
+    gt_array_delete(features);
+    return NULL;
+  }
+  diagram = gt_diagram_new_generic(features, &window, style, false);
+  diagram->owns_features = true;
+  return diagram;
+}
+
+int gt_diagram_update(GtDiagram *diagram, GtFeatureIndex *feature_index,
+                      const char *seqid, const GtRange *range, GtError *err)
+{
+  GtHashmap *kept;
+  GtArray *features;
+  GtFeatureNode *root;
+  RootBlocks *rb;
+  unsigned long i, nof_kept = 0;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(diagram && feature_index && seqid && range);
+  if (range->start == range->end)
+  {
+    gt_error_set(err, "range start must not be equal to range end");
+    return -1;
+  }
+  features = gt_array_new(sizeof (GtGenomeNode*));
+  had_err = gt_feature_index_get_features_for_range(feature_index, features,
+                                                    seqid, range, err);
+  if (had_err)
+  {
+    gt_array_delete(features);
+    return -1;
+  }
+  /* the blocks only stay the same if the visible nodes and the range length
+     (on which the style options depend) do not change */
+  kept = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  if (gt_range_length(range) == gt_range_length(&diagram->range))
+  {
+    for (i = 0; i < gt_array_size(features); i++)
+    {
+      root = *(GtFeatureNode**) gt_array_get(features, i);
+      if ((rb = gt_hashmap_get(diagram->root_blocks, root)) && rb->complete
+            && root_blocks_are_complete(rb, range))
+      {
+        gt_hashmap_remove(diagram->root_blocks, root);
+        gt_hashmap_add(kept, root, rb);
+        nof_kept++;
+      }
+    }
+  }
+  gt_log_log("keeping the blocks of %lu of %lu features",
+             nof_kept, gt_array_size(features));
+  reset_root_blocks(diagram);
+  gt_hashmap_delete(diagram->root_blocks);
+  diagram->root_blocks = kept;
+  if (diagram->blocks)
+  {
+    gt_hashmap_delete(diagram->blocks);
+    diagram->blocks = NULL;
+  }
+  /* the old features are released only now, a kept root is referenced by the
+     new features and no other node can have taken its address */
+  if (diagram->owns_features)
+    gt_feature_index_release_features(diagram->features);
+  gt_array_delete(diagram->features);
+  diagram->features = features;
+  diagram->owns_features = true;
+  diagram->range = *range;
+  /* the features are shown now instead of their density */
+  if (diagram->density_track)
+  {
+    for (i = 0; i < gt_array_size(diagram->custom_tracks); i++)
+    {
+      if (*(GtCustomTrack**) gt_array_get(diagram->custom_tracks, i)
+            == diagram->density_track)
+      {
+        gt_array_rem(diagram->custom_tracks, i);
+        break;
+      }
+    }
+    gt_custom_track_delete(diagram->density_track);
+    diagram->density_track = NULL;
+  }
+  return 0;
+}
+
 GtRange gt_diagram_get_range(const GtDiagram *diagram)
 {
   gt_assert(diagram);
@@ -772,6 +1104,7 @@ void gt_diagram_set_track_selector_func(GtDiagram *diagram,
   /* this could change track assignment -> discard current blocks and requeue */
   gt_hashmap_delete(diagram->blocks);
   diagram->blocks = NULL;
+  reset_root_blocks(diagram);
 }
 
 void gt_diagram_reset_track_selector_func(GtDiagram *diagram)
@@ -780,6 +1113,7 @@ void gt_diagram_reset_track_selector_func(GtDiagram *diagram)
   diagram->select_func = default_track_selector;
   gt_hashmap_delete(diagram->blocks);
   diagram->blocks = NULL;
+  reset_root_blocks(diagram);
 }
 
 GtHashmap* gt_diagram_get_blocks(const GtDiagram *diagram)
@@ -803,13 +1137,18 @@ void gt_diagram_add_custom_track(GtDiagram *diagram, GtCustomTrack* ctrack)
 void gt_diagram_delete(GtDiagram *diagram)
 {
   if (!diagram) return;
-  gt_array_delete(diagram->features);
   if (diagram->blocks)
     gt_hashmap_delete(diagram->blocks);
   gt_hashmap_delete(diagram->nodeinfo);
+  reset_root_blocks(diagram);
+  gt_hashmap_delete(diagram->root_blocks);
+  if (diagram->owns_features)
+    gt_feature_index_release_features(diagram->features);
+  gt_array_delete(diagram->features);
   gt_hashmap_delete(diagram->collapsingtypes);
   gt_hashmap_delete(diagram->groupedtypes);
   gt_hashmap_delete(diagram->caption_display_status);
   gt_array_delete(diagram->custom_tracks);
+  gt_custom_track_delete(diagram->density_track);
   gt_free(diagram);
 }
@@ -33,6 +33,7 @@ typedef struct GtDiagram GtDiagram;
 #include "annotationsketch/style_api.h"
 #include "annotationsketch/block_api.h"
 #include "core/error_api.h"
+#include "extended/node_stream_api.h"
 
 /* A <GtTrackSelectorFunc> is a callback function which sets a <GtStr> to a
    string to be used as a track identifier for assignment of a <GtBlock>
@@ -45,12 +46,45 @@ typedef void (*GtTrackSelectorFunc)(GtBlock*, GtStr*, void*);
    layout process. */
 GtDiagram* gt_diagram_new(GtFeatureIndex *feature_index, const char *seqid,
                           const GtRange *range, GtStyle *style, GtError*);
+/* Like <gt_diagram_new()>, but for a diagram to be shown in an image <width>
+   pixels wide. If the features in <range> are more than
+   __feature_density.threshold__ (default: 10) times the number of pixels
+   available for drawing, the diagram does not contain the features but a
+   single custom track showing the number of features per pixel. This
+   avoids building, laying out and drawing many features which would not be
+   distinguishable anyway. Setting the threshold to 0 disables this. */
+GtDiagram* gt_diagram_new_for_width(GtFeatureIndex *feature_index,
+                                    const char *seqid, const GtRange *range,
+                                    unsigned int width, GtStyle *style,
+                                    GtError*);
 /* Create a new <GtDiagram> object representing the feature nodes in
    <features>. The features must overlap with <range>. The <GtStyle>
    object <style> will be used to determine collapsing options during the
    layout process.*/
 GtDiagram* gt_diagram_new_from_array(GtArray *features, const GtRange *range,
                                      GtStyle *style);
+/* Create a new <GtDiagram> object representing the feature nodes read from
+   <sorted_stream> in region <seqid> overlapping with <range>, without building
+   a feature index. Only the feature trees overlapping with <range> are kept,
+   all other nodes are deleted right away, and reading stops with the first
+   node after <range>. The rest of <sorted_stream> can be read afterwards.
+   If <seqid> is NULL, the first sequence region is shown. If <range> is NULL,
+   the whole sequence region is shown, which requires reading all of its
+   features. <sorted_stream> must be sorted. The diagram owns the kept
+   features. Returns NULL and sets <err> on error. */
+GtDiagram* gt_diagram_new_from_stream(GtNodeStream *sorted_stream,
+                                      const char *seqid, const GtRange *range,
+                                      GtStyle *style, GtError *err);
+/* Changes <diagram> to represent the feature nodes in <feature_index> in
+   region <seqid> overlapping with <range>, as if it had been created with
+   <gt_diagram_new()>. This is meant for panning: if <range> has the same
+   length as the current range, the blocks of features which are completely
+   visible in both ranges are kept and only the features which entered the
+   view (or are still partially visible) are processed again. Returns 0 on
+   success, or -1 and sets <err> otherwise. */
+int        gt_diagram_update(GtDiagram *diagram, GtFeatureIndex *feature_index,
+                             const char *seqid, const GtRange *range,
+                             GtError *err);
 /* Returns the sequence position range represented by the <diagram>. */
 GtRange    gt_diagram_get_range(const GtDiagram *diagram);
 /* Assigns a GtTrackSelectorFunc to use to assign blocks to tracks.
@@ -19,6 +19,7 @@
 #include "core/class_alloc.h"
 #include "core/array.h"
 #include "core/ma.h"
+#include "core/minmax.h"
 #include "core/unused_api.h"
 #include "annotationsketch/feature_index_rep.h"
 #include "annotationsketch/feature_visitor.h"
@@ -34,6 +35,7 @@ struct GtFeatureIndexClass {
   GtFeatureIndexGetSeqidsFunc get_seqids;
   GtFeatureIndexGetRangeForSeqidFunc get_range_for_seqid;
   GtFeatureIndexHasSeqidFunc has_seqid;
+  GtFeatureIndexGetCountsForRangeFunc get_counts_for_range;
   GtFeatureIndexFreeFunc free;
 };
 
@@ -58,6 +60,8 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
                                                  get_range_for_seqid,
                                          GtFeatureIndexHasSeqidFunc
                                                  has_seqid,
+                                         GtFeatureIndexGetCountsForRangeFunc
+                                                 get_counts_for_range,
                                          GtFeatureIndexFreeFunc
                                                  free)
 {
@@ -71,6 +75,7 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
   c_class->get_seqids = get_seqids;
   c_class->get_range_for_seqid = get_range_for_seqid;
   c_class->has_seqid = has_seqid;
+  c_class->get_counts_for_range = get_counts_for_range;
   c_class->free = free;
   return c_class;
 }
@@ -196,6 +201,70 @@ bool gt_feature_index_has_seqid(const GtFeatureIndex *feature_index,
   return feature_index->c_class->has_seqid(feature_index, seqid);
 }
 
+void gt_feature_index_release_features(GtArray *features)
+{
+  unsigned long i;
+  if (!features) return;
+  for (i = 0; i < gt_array_size(features); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(features, i));
+  gt_array_reset(features);
+}
+
+void gt_feature_index_count_range(unsigned long *counts,
+                                   unsigned long nof_bins,
+                                   const GtRange *range,
+                                   unsigned long start, unsigned long end)
+{
+  unsigned long first, last;
+  double bin_width;
+  gt_assert(counts && nof_bins && range && start <= end);
+  if (end < range->start || start > range->end)
+    return;
+  bin_width = (double) gt_range_length(range) / nof_bins;
+  first = (MAX(start, range->start) - range->start) / bin_width;
+  last = (MIN(end, range->end) - range->start) / bin_width;
+  last = MIN(last, nof_bins - 1);
+  for (; first <= last; first++)
+    counts[first]++;
+}
+
+int gt_feature_index_get_counts_for_range(GtFeatureIndex *feature_index,
+                                          unsigned long *counts,
+                                          unsigned long nof_bins,
+                                          const char *seqid,
+                                          const GtRange *range,
+                                          unsigned long *nof_features,
+                                          GtError *err)
+{
+  GtArray *features;
+  unsigned long i;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(feature_index && feature_index->c_class && counts && nof_bins &&
+            seqid && range && nof_features);
+  if (feature_index->c_class->get_counts_for_range) {
+    return feature_index->c_class->get_counts_for_range(feature_index, counts,
+                                                        nof_bins, seqid, range,
+                                                        nof_features, err);
+  }
+  /* fall back to counting the features of the range */
+  features = gt_array_new(sizeof (GtGenomeNode*));
+  had_err = gt_feature_index_get_features_for_range(feature_index, features,
+                                                    seqid, range, err);
+  if (!had_err) {
+    for (i = 0; i < gt_array_size(features); i++) {
+      GtRange rng = gt_genome_node_get_range(*(GtGenomeNode**)
+                                             gt_array_get(features, i));
+      gt_feature_index_count_range(counts, nof_bins, range, rng.start,
+                                   rng.end);
+    }
+    *nof_features = gt_array_size(features);
+    gt_feature_index_release_features(features);
+  }
+  gt_array_delete(features);
+  return had_err;
+}
+
 void* gt_feature_index_cast(GT_UNUSED const GtFeatureIndexClass *fic,
                             GtFeatureIndex *fi)
 {
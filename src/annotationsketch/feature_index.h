@@ -24,5 +24,28 @@ typedef struct GtFeatureIndexClass GtFeatureIndexClass;
 #include "annotationsketch/feature_index_api.h"
 
 GtFeatureIndex* gt_feature_index_ref(GtFeatureIndex*);
+/* Divides <range> into <nof_bins> bins of equal width and adds the number of
+   top-level features on sequence <seqid> overlapping each bin to <counts>.
+   The number of features overlapping <range> is stored in <nof_features>.
+   The features themselves are only loaded if <feature_index> cannot count
+   them directly. */
+int             gt_feature_index_get_counts_for_range(GtFeatureIndex*,
+                                                      unsigned long *counts,
+                                                      unsigned long nof_bins,
+                                                      const char *seqid,
+                                                      const GtRange *range,
+                                                      unsigned long
+                                                      *nof_features,
+                                                      GtError*);
+/* Releases the features returned by a <gt_feature_index_get_features_*()>
+   method and empties the <features> array. */
+void            gt_feature_index_release_features(GtArray *features);
+/* Adds one to the bins of <counts> overlapped by the feature from <start> to
+   <end>, where <range> is divided into <nof_bins> bins as above. */
+void            gt_feature_index_count_range(unsigned long *counts,
+                                             unsigned long nof_bins,
+                                             const GtRange *range,
+                                             unsigned long start,
+                                             unsigned long end);
 
 #endif
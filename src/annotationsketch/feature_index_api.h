@@ -31,7 +31,8 @@
    place is left to the discretion of the implementing class.
 
    Output from a <gt_feature_index_get_features_*()> method should always
-   be sorted by feature start position. */
+   be sorted by feature start position. The returned features are referenced,
+   the caller has to release them with <gt_genome_node_delete()>. */
 typedef struct GtFeatureIndex GtFeatureIndex;
 
 /* Add <region_node> to <feature_index>. */
@@ -46,11 +47,12 @@ void        gt_feature_index_add_feature_node(GtFeatureIndex *feature_index,
 int         gt_feature_index_add_gff3file(GtFeatureIndex *feature_index,
                                           const char *gff3file, GtError *err);
 /* Returns an array of <GtFeatureNodes> associated with a given sequence region
-   identifier <seqid>. */
+   identifier <seqid>. The features have to be released by the caller. */
 GtArray*    gt_feature_index_get_features_for_seqid(GtFeatureIndex*,
                                                     const char *seqid);
 /* Look up genome features in <feature_index> for sequence region <seqid> in
-   <range> and store them in <results>. */
+   <range> and store them in <results>. The features have to be released by the
+   caller. If an error occurs, <results> is not changed and <err> is set. */
 int         gt_feature_index_get_features_for_range(GtFeatureIndex
                                                     *feature_index,
                                                     GtArray *results,
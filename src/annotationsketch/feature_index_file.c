@@ -0,0 +1,715 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "annotationsketch/feature_index_file.h"
+#include "annotationsketch/feature_index_memory_api.h"
+#include "annotationsketch/feature_index_rep.h"
+#include "core/ensure.h"
+#include "core/fa.h"
+#include "core/hashmap.h"
+#include "core/ma.h"
+#include "core/minmax.h"
+#include "core/thread.h"
+#include "core/unused_api.h"
+#include "core/warning_api.h"
+#include "core/xansi.h"
+#include "extended/binary_reader.h"
+#include "extended/binary_visitor.h"
+#include "extended/feature_node.h"
+#include "extended/genome_node.h"
+
+#define FEATURE_INDEX_FILE_CACHE_SIZE  1024
+
+/* A feature tree kept in the cache of recently used trees. */
+typedef struct CachedTree CachedTree;
+struct CachedTree {
+  uint64_t offset;
+  GtGenomeNode *tree;
+  CachedTree *newer, *older;
+};
+
+struct GtFeatureIndexFile {
+  const GtFeatureIndex parent_instance;
+  GtStr *filename;
+  GtBinaryReader *reader;
+  GtHashmap *seqs,    /* maps seqids to their <GtBinarySeqIndex> */
+            *trees;   /* maps record offsets to their <CachedTree> */
+  CachedTree *newest, *oldest; /* the cached trees in the order of use */
+  unsigned long nof_cached,
+                cache_size; /* maximum number of cached trees */
+  GtMutex *trees_mutex; /* guards the cache and <reader> */
+  GtFeatureIndex *added; /* nodes added after creation, created on demand */
+};
+
+#define gt_feature_index_file_cast(FI)\
+        gt_feature_index_cast(gt_feature_index_file_class(), FI)
+
+static GtFeatureIndex* added_index(GtFeatureIndexFile *fif)
+{
+  gt_assert(fif);
+  if (!fif->added)
+    fif->added = gt_feature_index_memory_new();
+  return fif->added;
+}
+
+static bool added_has_seqid(const GtFeatureIndexFile *fif, const char *seqid)
+{
+  gt_assert(fif && seqid);
+  return fif->added && gt_feature_index_has_seqid(fif->added, seqid);
+}
+
+static void gt_feature_index_file_add_region_node(GtFeatureIndex *gfi,
+                                                  GtRegionNode *rn)
+{
+  GtFeatureIndexFile *fif = gt_feature_index_file_cast(gfi);
+  gt_feature_index_add_region_node(added_index(fif), rn);
+}
+
+static void gt_feature_index_file_add_feature_node(GtFeatureIndex *gfi,
+                                                   GtFeatureNode *fn)
+{
+  GtFeatureIndexFile *fif = gt_feature_index_file_cast(gfi);
+  gt_feature_index_add_feature_node(added_index(fif), fn);
+}
+
+static void cache_unlink(GtFeatureIndexFile *fif, CachedTree *ct)
+{
+  if (ct->newer)
+    ct->newer->older = ct->older;
+  else
+    fif->newest = ct->older;
+  if (ct->older)
+    ct->older->newer = ct->newer;
+  else
+    fif->oldest = ct->newer;
+}
+
+static void cache_insert_newest(GtFeatureIndexFile *fif, CachedTree *ct)
+{
+  ct->newer = NULL;
+  ct->older = fif->newest;
+  if (fif->newest)
+    fif->newest->newer = ct;
+  else
+    fif->oldest = ct;
+  fif->newest = ct;
+}
+
+/* Drop the least recently used trees until at most <size> are cached. Trees
+   which are still referenced by query results stay alive until these are
+   released. */
+static void cache_shrink(GtFeatureIndexFile *fif, unsigned long size)
+{
+  CachedTree *ct;
+  while (fif->nof_cached > size) {
+    ct = fif->oldest;
+    cache_unlink(fif, ct);
+    fif->nof_cached--;
+    gt_hashmap_remove(fif->trees, (void*) (unsigned long) ct->offset);
+    gt_genome_node_delete(ct->tree);
+    gt_free(ct);
+  }
+}
+
+/* Return a new reference to the feature tree stored at <offset>. The tree is
+   read from the file unless it is one of the <cache_size> most recently used
+   trees. */
+static GtFeatureNode* get_tree(GtFeatureIndexFile *fif, uint64_t offset,
+                               GtError *err)
+{
+  CachedTree *ct;
+  GtGenomeNode *gn = NULL;
+  uint64_t next = offset;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(fif);
+  gt_mutex_lock(fif->trees_mutex);
+  if ((ct = gt_hashmap_get(fif->trees, (void*) (unsigned long) offset))) {
+    cache_unlink(fif, ct);
+    cache_insert_newest(fif, ct);
+    gn = gt_genome_node_ref(ct->tree);
+  }
+  else {
+    had_err = gt_binary_reader_read_record(fif->reader, &gn, &next, err);
+    if (!had_err && !gt_feature_node_try_cast(gn)) {
+      gt_error_set(err, "feature index file \"%s\" is corrupt",
+                   gt_str_get(fif->filename));
+      gt_genome_node_delete(gn);
+      had_err = -1;
+    }
+    if (!had_err && fif->cache_size) {
+      ct = gt_malloc(sizeof *ct);
+      ct->offset = offset;
+      ct->tree = gt_genome_node_ref(gn);
+      cache_insert_newest(fif, ct);
+      fif->nof_cached++;
+      gt_hashmap_add(fif->trees, (void*) (unsigned long) offset, ct);
+      cache_shrink(fif, fif->cache_size);
+    }
+  }
+  gt_mutex_unlock(fif->trees_mutex);
+  return had_err ? NULL : (GtFeatureNode*) gn;
+}
+
+static int gt_genome_node_cmp_range_start(const void *v1, const void *v2)
+{
+  GtGenomeNode *n1, *n2;
+  n1 = *(GtGenomeNode**) v1;
+  n2 = *(GtGenomeNode**) v2;
+  return gt_genome_node_compare(&n1, &n2);
+}
+
+static GtArray* gt_feature_index_file_get_features_for_seqid(GtFeatureIndex
+                                                             *gfi,
+                                                             const char *seqid)
+{
+  GtFeatureIndexFile *fif;
+  const GtBinarySeqIndex *seq;
+  const GtBinaryInterval *intervals;
+  GtFeatureNode *fn;
+  GtArray *a, *added;
+  GtError *err;
+  uint64_t i;
+  gt_assert(gfi && seqid);
+  fif = gt_feature_index_file_cast(gfi);
+  a = gt_array_new(sizeof (GtFeatureNode*));
+  if ((seq = gt_hashmap_get(fif->seqs, seqid))) {
+    err = gt_error_new();
+    intervals = gt_binary_reader_get_intervals(fif->reader, seq);
+    for (i = 0; i < seq->nof_intervals; i++) {
+      if (!(fn = get_tree(fif, intervals[i].offset, err))) {
+        /* this interface cannot report errors, skip the broken tree */
+        gt_warning("%s", gt_error_get(err));
+        gt_error_unset(err);
+        continue;
+      }
+      gt_array_add(a, fn);
+    }
+    gt_error_delete(err);
+  }
+  if (added_has_seqid(fif, seqid)) {
+    added = gt_feature_index_get_features_for_seqid(fif->added, seqid);
+    gt_array_add_array(a, added);
+    gt_array_delete(added);
+    gt_array_sort_stable(a, gt_genome_node_cmp_range_start);
+  }
+  return a;
+}
+
+/* Return the first of the <nof_intervals> <intervals> which may overlap a range
+   starting at <start>. */
+static uint64_t first_candidate(const GtBinaryInterval *intervals,
+                                uint64_t nof_intervals, unsigned long start)
+{
+  uint64_t left = 0, right = nof_intervals, mid;
+  /* the maximum ends are sorted, all intervals before the first one reaching
+     <start> end before it */
+  while (left < right) {
+    mid = left + (right - left) / 2;
+    if (intervals[mid].max_end < start)
+      left = mid + 1;
+    else
+      right = mid;
+  }
+  return left;
+}
+
+static int gt_feature_index_file_get_features_for_range(GtFeatureIndex *gfi,
+                                                        GtArray *results,
+                                                        const char *seqid,
+                                                        const GtRange
+                                                        *qry_range,
+                                                        GtError *err)
+{
+  GtFeatureIndexFile *fif;
+  const GtBinarySeqIndex *seq;
+  const GtBinaryInterval *intervals;
+  GtFeatureNode *fn;
+  unsigned long nof_results;
+  uint64_t i;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(gfi && results && seqid && qry_range);
+
+  fif = gt_feature_index_file_cast(gfi);
+  seq = gt_hashmap_get(fif->seqs, seqid);
+  if (!seq && !added_has_seqid(fif, seqid)) {
+    gt_error_set(err, "feature index does not contain the given sequence id");
+    return -1;
+  }
+  nof_results = gt_array_size(results);
+  if (seq) {
+    intervals = gt_binary_reader_get_intervals(fif->reader, seq);
+    for (i = first_candidate(intervals, seq->nof_intervals, qry_range->start);
+         !had_err && i < seq->nof_intervals &&
+         intervals[i].start <= qry_range->end; i++) {
+      if (intervals[i].end < qry_range->start)
+        continue;
+      if (!(fn = get_tree(fif, intervals[i].offset, err)))
+        had_err = -1;
+      else
+        gt_array_add(results, fn);
+    }
+  }
+  /* the intervals are sorted, only merged results have to be sorted again */
+  if (!had_err && added_has_seqid(fif, seqid)) {
+    had_err = gt_feature_index_get_features_for_range(fif->added, results,
+                                                      seqid, qry_range, err);
+    if (!had_err)
+      gt_array_sort_stable(results, gt_genome_node_cmp_range_start);
+  }
+  /* release the trees found before the error */
+  while (had_err && gt_array_size(results) > nof_results)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_pop(results));
+  return had_err;
+}
+
+/* Counts the intervals stored in the file directly, without loading any
+   feature trees. */
+static int gt_feature_index_file_get_counts_for_range(GtFeatureIndex *gfi,
+                                                      unsigned long *counts,
+                                                      unsigned long nof_bins,
+                                                      const char *seqid,
+                                                      const GtRange *qry_range,
+                                                      unsigned long
+                                                      *nof_features,
+                                                      GtError *err)
+{
+  GtFeatureIndexFile *fif;
+  const GtBinarySeqIndex *seq;
+  const GtBinaryInterval *intervals;
+  unsigned long added = 0;
+  uint64_t i;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(gfi && counts && seqid && qry_range && nof_features);
+  fif = gt_feature_index_file_cast(gfi);
+  *nof_features = 0;
+  if ((seq = gt_hashmap_get(fif->seqs, seqid))) {
+    intervals = gt_binary_reader_get_intervals(fif->reader, seq);
+    for (i = first_candidate(intervals, seq->nof_intervals, qry_range->start);
+         i < seq->nof_intervals && intervals[i].start <= qry_range->end; i++) {
+      if (intervals[i].end < qry_range->start)
+        continue;
+      gt_feature_index_count_range(counts, nof_bins, qry_range,
+                                   intervals[i].start, intervals[i].end);
+      (*nof_features)++;
+    }
+  }
+  if (added_has_seqid(fif, seqid)) {
+    had_err = gt_feature_index_get_counts_for_range(fif->added, counts,
+                                                    nof_bins, seqid, qry_range,
+                                                    &added, err);
+    *nof_features += added;
+  }
+  return had_err;
+}
+
+static const char* gt_feature_index_file_get_first_seqid(const GtFeatureIndex
+                                                         *gfi)
+{
+  GtFeatureIndexFile *fif;
+  gt_assert(gfi);
+  fif = gt_feature_index_file_cast((GtFeatureIndex*) gfi);
+  if (gt_binary_reader_nof_seqs(fif->reader)) {
+    return gt_binary_reader_get_string(fif->reader,
+                                   gt_binary_reader_get_seq(fif->reader,
+                                                            0)->seqid);
+  }
+  if (fif->added)
+    return gt_feature_index_get_first_seqid(fif->added);
+  return NULL;
+}
+
+static int compare_seqids(const void *a, const void *b)
+{
+  return strcmp(*(const char**) a, *(const char**) b);
+}
+
+static GtStrArray* gt_feature_index_file_get_seqids(const GtFeatureIndex *gfi)
+{
+  GtFeatureIndexFile *fif;
+  GtStrArray *seqids, *added = NULL;
+  GtArray *cstrs;
+  const char *seqid;
+  unsigned long i;
+  gt_assert(gfi);
+  fif = gt_feature_index_file_cast((GtFeatureIndex*) gfi);
+  cstrs = gt_array_new(sizeof (const char*));
+  for (i = 0; i < gt_binary_reader_nof_seqs(fif->reader); i++) {
+    seqid = gt_binary_reader_get_string(fif->reader,
+                                   gt_binary_reader_get_seq(fif->reader,
+                                                            i)->seqid);
+    gt_array_add(cstrs, seqid);
+  }
+  if (fif->added) {
+    added = gt_feature_index_get_seqids(fif->added);
+    for (i = 0; i < gt_str_array_size(added); i++) {
+      seqid = gt_str_array_get(added, i);
+      if (!gt_hashmap_get(fif->seqs, seqid))
+        gt_array_add(cstrs, seqid);
+    }
+  }
+  gt_array_sort(cstrs, compare_seqids);
+  seqids = gt_str_array_new();
+  for (i = 0; i < gt_array_size(cstrs); i++)
+    gt_str_array_add_cstr(seqids, *(const char**) gt_array_get(cstrs, i));
+  gt_array_delete(cstrs);
+  gt_str_array_delete(added);
+  return seqids;
+}
+
+static void gt_feature_index_file_get_range_for_seqid(GtFeatureIndex *gfi,
+                                                      GtRange *range,
+                                                      const char *seqid)
+{
+  GtFeatureIndexFile *fif;
+  const GtBinarySeqIndex *seq;
+  const GtBinaryInterval *intervals;
+  GtRange added_range;
+  gt_assert(gfi && range && seqid);
+  fif = gt_feature_index_file_cast(gfi);
+  seq = gt_hashmap_get(fif->seqs, seqid);
+  gt_assert(seq || added_has_seqid(fif, seqid));
+  if (seq) {
+    /* like the memory index, prefer the range of the features over the range
+       of the region */
+    if (seq->nof_intervals) {
+      intervals = gt_binary_reader_get_intervals(fif->reader, seq);
+      range->start = intervals[0].start;
+      range->end = intervals[seq->nof_intervals - 1].max_end;
+    }
+    else if (seq->flags & GT_BINARY_HAS_REGION) {
+      range->start = seq->region_start;
+      range->end = seq->region_end;
+    }
+  }
+  if (added_has_seqid(fif, seqid)) {
+    gt_feature_index_get_range_for_seqid(fif->added, &added_range, seqid);
+    if (seq) {
+      range->start = MIN(range->start, added_range.start);
+      range->end = MAX(range->end, added_range.end);
+    }
+    else
+      *range = added_range;
+  }
+}
+
+static bool gt_feature_index_file_has_seqid(const GtFeatureIndex *gfi,
+                                            const char *seqid)
+{
+  GtFeatureIndexFile *fif;
+  gt_assert(gfi);
+  fif = gt_feature_index_file_cast((GtFeatureIndex*) gfi);
+  return gt_hashmap_get(fif->seqs, seqid) || added_has_seqid(fif, seqid);
+}
+
+static void gt_feature_index_file_delete(GtFeatureIndex *gfi)
+{
+  GtFeatureIndexFile *fif;
+  if (!gfi) return;
+  fif = gt_feature_index_file_cast(gfi);
+  cache_shrink(fif, 0);
+  gt_hashmap_delete(fif->trees);
+  gt_mutex_delete(fif->trees_mutex);
+  gt_hashmap_delete(fif->seqs);
+  gt_feature_index_delete(fif->added);
+  gt_binary_reader_delete(fif->reader);
+  gt_str_delete(fif->filename);
+}
+
+const GtFeatureIndexClass* gt_feature_index_file_class(void)
+{
+  static const GtFeatureIndexClass *fic = NULL;
+  if (!fic) {
+    fic = gt_feature_index_class_new(sizeof (GtFeatureIndexFile),
+                     gt_feature_index_file_add_region_node,
+                     gt_feature_index_file_add_feature_node,
+                     gt_feature_index_file_get_features_for_seqid,
+                     gt_feature_index_file_get_features_for_range,
+                     gt_feature_index_file_get_first_seqid,
+                     gt_feature_index_file_get_seqids,
+                     gt_feature_index_file_get_range_for_seqid,
+                     gt_feature_index_file_has_seqid,
+                     gt_feature_index_file_get_counts_for_range,
+                     gt_feature_index_file_delete);
+  }
+  return fic;
+}
+
+GtFeatureIndex* gt_feature_index_file_new(const char *filename, GtError *err)
+{
+  GtFeatureIndexFile *fif;
+  GtFeatureIndex *fi;
+  GtBinaryReader *reader;
+  const GtBinarySeqIndex *seq;
+  unsigned long i;
+  gt_error_check(err);
+  gt_assert(filename);
+  if (!(reader = gt_binary_reader_new(filename, NULL, err)))
+    return NULL;
+  fi = gt_feature_index_create(gt_feature_index_file_class());
+  fif = gt_feature_index_file_cast(fi);
+  fif->filename = gt_str_new_cstr(filename);
+  fif->reader = reader;
+  fif->added = NULL;
+  /* the seqids point into the mapped string table */
+  fif->seqs = gt_hashmap_new(HASH_STRING, NULL, NULL);
+  for (i = 0; i < gt_binary_reader_nof_seqs(reader); i++) {
+    seq = gt_binary_reader_get_seq(reader, i);
+    gt_hashmap_add(fif->seqs,
+                   (void*) gt_binary_reader_get_string(reader, seq->seqid),
+                   (void*) seq);
+  }
+  fif->trees = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  fif->newest = fif->oldest = NULL;
+  fif->nof_cached = 0;
+  fif->cache_size = FEATURE_INDEX_FILE_CACHE_SIZE;
+  fif->trees_mutex = gt_mutex_new();
+  return fi;
+}
+
+void gt_feature_index_file_set_cache_size(GtFeatureIndex *fi,
+                                          unsigned long cache_size)
+{
+  GtFeatureIndexFile *fif;
+  gt_assert(fi);
+  fif = gt_feature_index_file_cast(fi);
+  gt_mutex_lock(fif->trees_mutex);
+  fif->cache_size = cache_size;
+  cache_shrink(fif, cache_size);
+  gt_mutex_unlock(fif->trees_mutex);
+}
+
+#define NOF_WINDOWS  100UL
+#define WINDOW_SIZE  1000UL
+
+int gt_feature_index_file_unit_test(GtError *err)
+{
+  GtGenomeNode *gn1, *gn2, *gn3, *ex1, *ex2, *rn1, *rn2, *rn4, *gn4;
+  GtNodeVisitor *binary_visitor;
+  GtFeatureIndex *fi = NULL;
+  GtArray *features = NULL;
+  GtStrArray *seqids = NULL;
+  GtStr *seqid1, *seqid2, *seqid3, *seqid4, *tmpfilename;
+  GtRange range;
+  GtFile *outfp;
+  FILE *tmpfp;
+  unsigned long i;
+  int had_err = 0;
+  gt_error_check(err);
+
+  seqid1 = gt_str_new_cstr("test1");
+  seqid2 = gt_str_new_cstr("test2");
+  seqid3 = gt_str_new_cstr("test3");
+  seqid4 = gt_str_new_cstr("test4");
+  rn1 = gt_region_node_new(seqid1, 100, 5000);
+  rn2 = gt_region_node_new(seqid2, 100, 1200);
+  rn4 = gt_region_node_new(seqid4, 1, NOF_WINDOWS * WINDOW_SIZE);
+  gn1 = gt_feature_node_new(seqid1, gt_ft_gene, 100, 1000, GT_STRAND_FORWARD);
+  ex1 = gt_feature_node_new(seqid1, gt_ft_exon, 100, 300, GT_STRAND_FORWARD);
+  ex2 = gt_feature_node_new(seqid1, gt_ft_exon, 500, 1000, GT_STRAND_FORWARD);
+  gt_feature_node_add_child((GtFeatureNode*) gn1, (GtFeatureNode*) ex1);
+  gt_feature_node_add_child((GtFeatureNode*) gn1, (GtFeatureNode*) ex2);
+  /* a long feature which overlaps the following one */
+  gn2 = gt_feature_node_new(seqid1, gt_ft_gene, 200, 4000, GT_STRAND_REVERSE);
+  gn3 = gt_feature_node_new(seqid1, gt_ft_gene, 2000, 2500, GT_STRAND_FORWARD);
+
+  /* write the features (unsorted) into a binary annotation file */
+  tmpfilename = gt_str_new();
+  tmpfp = gt_xtmpfp(tmpfilename);
+  outfp = gt_file_new_from_fileptr(tmpfp);
+  binary_visitor = gt_binary_visitor_new(outfp);
+  had_err = gt_genome_node_accept(rn1, binary_visitor, err);
+  if (!had_err)
+    had_err = gt_genome_node_accept(gn3, binary_visitor, err);
+  if (!had_err)
+    had_err = gt_genome_node_accept(gn1, binary_visitor, err);
+  if (!had_err)
+    had_err = gt_genome_node_accept(gn2, binary_visitor, err);
+  if (!had_err)
+    had_err = gt_genome_node_accept(rn2, binary_visitor, err);
+  /* one feature per window on the last sequence */
+  if (!had_err)
+    had_err = gt_genome_node_accept(rn4, binary_visitor, err);
+  for (i = 0; !had_err && i < NOF_WINDOWS; i++) {
+    gn4 = gt_feature_node_new(seqid4, gt_ft_gene, i * WINDOW_SIZE + 1,
+                              i * WINDOW_SIZE + WINDOW_SIZE / 2,
+                              GT_STRAND_FORWARD);
+    had_err = gt_genome_node_accept(gn4, binary_visitor, err);
+    gt_genome_node_delete(gn4);
+  }
+  gt_binary_visitor_finish(binary_visitor);
+  gt_node_visitor_delete(binary_visitor);
+  gt_file_delete_without_handle(outfp);
+  gt_fa_xfclose(tmpfp);
+
+  if (!had_err)
+    fi = gt_feature_index_file_new(gt_str_get(tmpfilename), err);
+  ensure(had_err, fi);
+
+  if (!had_err) {
+    ensure(had_err, gt_feature_index_has_seqid(fi, "test1"));
+    ensure(had_err, gt_feature_index_has_seqid(fi, "test2"));
+    ensure(had_err, !gt_feature_index_has_seqid(fi, "test3"));
+    ensure(had_err, !strcmp(gt_feature_index_get_first_seqid(fi), "test1"));
+  }
+
+  /* the range of the features is preferred over the range of the region */
+  if (!had_err) {
+    gt_feature_index_get_range_for_seqid(fi, &range, "test1");
+    ensure(had_err, range.start == 100UL && range.end == 4000UL);
+    gt_feature_index_get_range_for_seqid(fi, &range, "test2");
+    ensure(had_err, range.start == 100UL && range.end == 1200UL);
+  }
+
+  /* all features, sorted by start position */
+  if (!had_err) {
+    features = gt_feature_index_get_features_for_seqid(fi, "test1");
+    ensure(had_err, gt_array_size(features) == 3UL);
+    if (!had_err) {
+      gn4 = *(GtGenomeNode**) gt_array_get(features, 0);
+      ensure(had_err, gt_genome_node_get_start(gn4) == 100UL);
+      ensure(had_err, gt_genome_node_number_of_children(gn4) == 2UL);
+      gn4 = *(GtGenomeNode**) gt_array_get(features, 2);
+      ensure(had_err, gt_genome_node_get_start(gn4) == 2000UL);
+    }
+    gt_feature_index_release_features(features);
+    gt_array_delete(features);
+    features = NULL;
+  }
+
+  /* range queries, including a feature starting before the range */
+  if (!had_err) {
+    features = gt_array_new(sizeof (GtFeatureNode*));
+    range.start = 2100;
+    range.end = 2200;
+    had_err = gt_feature_index_get_features_for_range(fi, features, "test1",
+                                                      &range, err);
+    ensure(had_err, gt_array_size(features) == 2UL);
+    gt_feature_index_release_features(features);
+    range.start = 4001;
+    range.end = 5000;
+    if (!had_err) {
+      had_err = gt_feature_index_get_features_for_range(fi, features, "test1",
+                                                        &range, err);
+    }
+    ensure(had_err, gt_array_size(features) == 0);
+    gt_feature_index_release_features(features);
+    range.start = 1;
+    range.end = 100;
+    if (!had_err) {
+      had_err = gt_feature_index_get_features_for_range(fi, features, "test1",
+                                                        &range, err);
+    }
+    ensure(had_err, gt_array_size(features) == 1UL);
+    ensure(had_err, gt_feature_index_get_features_for_range(fi, features,
+                                                            "test3", &range,
+                                                            err));
+    gt_error_unset(err);
+    gt_feature_index_release_features(features);
+    gt_array_delete(features);
+    features = NULL;
+  }
+
+  /* feature counts are taken from the intervals */
+  if (!had_err) {
+    unsigned long counts[4] = {0, 0, 0, 0}, nof_features = 0;
+    range.start = 1;
+    range.end = 4000;
+    had_err = gt_feature_index_get_counts_for_range(fi, counts, 4, "test1",
+                                                    &range, &nof_features, err);
+    ensure(had_err, nof_features == 3UL);
+    ensure(had_err, counts[0] == 2UL && counts[1] == 2UL && counts[2] == 2UL
+                      && counts[3] == 1UL);
+  }
+
+  /* nodes added later on are kept in memory and merged into the results */
+  if (!had_err) {
+    gn4 = gt_feature_node_new(seqid3, gt_ft_gene, 10, 20, GT_STRAND_FORWARD);
+    gt_feature_index_add_feature_node(fi, (GtFeatureNode*) gn4);
+    gt_genome_node_delete(gn4);
+    ensure(had_err, gt_feature_index_has_seqid(fi, "test3"));
+    seqids = gt_feature_index_get_seqids(fi);
+    ensure(had_err, gt_str_array_size(seqids) == 4UL);
+    ensure(had_err, !strcmp(gt_str_array_get(seqids, 2), "test3"));
+    gt_str_array_delete(seqids);
+  }
+
+  if (!had_err) {
+    unsigned long counts[1] = {0}, nof_features = 0;
+    range.start = 1;
+    range.end = 100;
+    had_err = gt_feature_index_get_counts_for_range(fi, counts, 1, "test3",
+                                                    &range, &nof_features, err);
+    ensure(had_err, nof_features == 1UL && counts[0] == 1UL);
+  }
+
+  /* querying many disjoint windows keeps only the most recently used trees,
+     trees dropped from the cache stay valid while they are referenced */
+  if (!had_err) {
+    GtFeatureIndexFile *fif = gt_feature_index_file_cast(fi);
+    GtGenomeNode *first = NULL, *last = NULL;
+    gt_feature_index_file_set_cache_size(fi, 8);
+    ensure(had_err, fif->nof_cached <= 8UL);
+    features = gt_array_new(sizeof (GtFeatureNode*));
+    for (i = 0; !had_err && i < NOF_WINDOWS; i++) {
+      range.start = i * WINDOW_SIZE + 1;
+      range.end = (i + 1) * WINDOW_SIZE;
+      had_err = gt_feature_index_get_features_for_range(fi, features, "test4",
+                                                        &range, err);
+      ensure(had_err, gt_array_size(features) == 1UL);
+      ensure(had_err, fif->nof_cached <= 8UL);
+      if (!had_err) {
+        last = *(GtGenomeNode**) gt_array_get(features, 0);
+        if (!first)
+          first = gt_genome_node_ref(last);
+      }
+      gt_feature_index_release_features(features);
+    }
+    ensure(had_err, first && gt_genome_node_get_start(first) == 1UL);
+    gt_genome_node_delete(first);
+    /* the tree of the last window is still cached */
+    if (!had_err) {
+      had_err = gt_feature_index_get_features_for_range(fi, features, "test4",
+                                                        &range, err);
+      ensure(had_err, gt_array_size(features) == 1UL &&
+                      *(GtGenomeNode**) gt_array_get(features, 0) == last);
+      gt_feature_index_release_features(features);
+    }
+    gt_feature_index_file_set_cache_size(fi, 0);
+    ensure(had_err, fif->nof_cached == 0 && !fif->newest && !fif->oldest);
+    gt_array_delete(features);
+    features = NULL;
+  }
+
+  gt_feature_index_delete(fi);
+  gt_xremove(gt_str_get(tmpfilename));
+  gt_str_delete(tmpfilename);
+  gt_genome_node_delete(gn1);
+  gt_genome_node_delete(gn2);
+  gt_genome_node_delete(gn3);
+  gt_genome_node_delete(rn1);
+  gt_genome_node_delete(rn2);
+  gt_genome_node_delete(rn4);
+  gt_str_delete(seqid1);
+  gt_str_delete(seqid2);
+  gt_str_delete(seqid3);
+  gt_str_delete(seqid4);
+  return had_err;
+}
@@ -0,0 +1,46 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef FEATURE_INDEX_FILE_API_H
+#define FEATURE_INDEX_FILE_API_H
+
+#include "annotationsketch/feature_index_api.h"
+
+/* The <GtFeatureIndexFile> class implements a <GtFeatureIndex> on top of a
+   binary annotation file (as written by ``gt gff3 -binary''). The file is
+   memory mapped and only the feature trees overlapping a queried range are
+   read, using the interval index stored in the file. Hence, creating the
+   index takes constant time and the memory used grows with the queried
+   ranges instead of the size of the annotation. The most recently used trees
+   are cached for later queries. Nodes added later on are
+   kept in memory. Queries can be issued from several threads at the same
+   time, as long as no nodes are added concurrently. */
+typedef struct GtFeatureIndexFile GtFeatureIndexFile;
+
+/* Creates a new <GtFeatureIndexFile> object for the binary annotation file
+   <filename>. Returns <NULL> and sets <err> if the file cannot be mapped or is
+   not a valid binary annotation file. */
+GtFeatureIndex* gt_feature_index_file_new(const char *filename, GtError *err);
+/* Keep at most <cache_size> of the feature trees read from the file of
+   <feature_index> cached (default: 1024). If <cache_size> is 0, every query
+   reads its trees again. Trees still referenced by query results are kept
+   until the results are released. */
+void            gt_feature_index_file_set_cache_size(GtFeatureIndex
+                                                     *feature_index,
+                                                     unsigned long cache_size);
+
+#endif
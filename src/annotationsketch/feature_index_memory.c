@@ -25,10 +25,11 @@
 #include "annotationsketch/feature_stream.h"
 #include "core/ensure.h"
 #include "core/hashmap.h"
-#include "core/interval_tree.h"
+#include "core/implicit_interval_tree.h"
 #include "core/ma.h"
 #include "core/minmax.h"
 #include "core/range.h"
+#include "core/thread.h"
 #include "core/undef.h"
 #include "core/unused_api.h"
 #include "extended/genome_node.h"
@@ -38,6 +39,8 @@ struct GtFeatureIndexMemory {
   GtHashmap *regions;
   GtHashmap *nodes_in_index;
   GtArray *ids;
+  GtMutex *build_mutex; /* queries from different threads might build the
+                           same interval index */
   char *firstseqid;
   unsigned long nof_region_nodes,
                 reference_count,
@@ -48,14 +51,14 @@ struct GtFeatureIndexMemory {
         gt_feature_index_cast(gt_feature_index_memory_class(), FI)
 
 typedef struct {
-  GtIntervalTree *features;
+  GtImplicitIntervalTree *features;
   GtRegionNode *region;
   GtRange dyn_range;
 } RegionInfo;
 
 static void region_info_delete(RegionInfo *info)
 {
-  gt_interval_tree_delete(info->features);
+  gt_implicit_interval_tree_delete(info->features);
   if (info->region)
     gt_genome_node_delete((GtGenomeNode*)info->region);
   gt_free(info);
@@ -73,8 +76,8 @@ void gt_feature_index_memory_add_region_node(GtFeatureIndex *gfi,
   if (!gt_hashmap_get(fi->regions, seqid)) {
     info = gt_calloc(1, sizeof (RegionInfo));
     info->region = (GtRegionNode*) gt_genome_node_ref((GtGenomeNode*) rn);
-    info->features = gt_interval_tree_new((GtFree)
-                                          gt_genome_node_delete);
+    info->features = gt_implicit_interval_tree_new((GtFree)
+                                                   gt_genome_node_delete);
     info->dyn_range.start = ~0UL;
     info->dyn_range.end   = 0;
     gt_hashmap_add(fi->regions, seqid, info);
@@ -91,7 +94,6 @@ void gt_feature_index_memory_add_feature_node(GtFeatureIndex *gfi,
   GtFeatureIndexMemory *fi;
   GtRange node_range;
   RegionInfo *info;
-  GtIntervalTreeNode *new_node;
   gt_assert(gfi && gf);
 
   fi = gt_feature_index_memory_cast(gfi);
@@ -110,8 +112,8 @@ void gt_feature_index_memory_add_feature_node(GtFeatureIndex *gfi,
   {
     info = gt_calloc(1, sizeof (RegionInfo));
     info->region = NULL;
-    info->features = gt_interval_tree_new((GtFree)
-                                          gt_genome_node_delete);
+    info->features = gt_implicit_interval_tree_new((GtFree)
+                                                   gt_genome_node_delete);
     info->dyn_range.start = ~0UL;
     info->dyn_range.end   = 0;
     gt_hashmap_add(fi->regions, seqid, info);
@@ -119,49 +121,50 @@ void gt_feature_index_memory_add_feature_node(GtFeatureIndex *gfi,
       fi->firstseqid = seqid;
   }
 
-  /* add node to the appropriate array in the hashtable */
-  new_node = gt_interval_tree_node_new(gn, node_range.start, node_range.end);
-  gt_interval_tree_insert(info->features, new_node);
+  /* add node to the appropriate interval index, which is built in bulk on the
+     next query */
+  gt_implicit_interval_tree_add(info->features, gn, node_range.start,
+                                node_range.end);
   /* update dynamic range */
   info->dyn_range.start = MIN(info->dyn_range.start, node_range.start);
   info->dyn_range.end = MAX(info->dyn_range.end, node_range.end);
 }
 
-static int collect_features_from_itree(GtIntervalTreeNode *node, void *data)
+/* Build the interval index of <ri> if nodes have been added since the last
+   query. Afterwards, the index is only read by queries. */
+static void build_features(GtFeatureIndexMemory *fi, RegionInfo *ri)
 {
-  GtArray *a = (GtArray*) data;
-  GtGenomeNode *gn = (GtGenomeNode*) gt_interval_tree_node_get_data(node);
-  gt_array_add(a, gn);
-  return 0;
+  gt_mutex_lock(fi->build_mutex);
+  gt_implicit_interval_tree_build(ri->features);
+  gt_mutex_unlock(fi->build_mutex);
+}
+
+/* Reference the features stored in <results> from position <from> on, they are
+   released by the caller. */
+static void ref_results(GtArray *results, unsigned long from)
+{
+  for (; from < gt_array_size(results); from++)
+    gt_genome_node_ref(*(GtGenomeNode**) gt_array_get(results, from));
 }
 
 GtArray* gt_feature_index_memory_get_features_for_seqid(GtFeatureIndex *gfi,
                                                         const char *seqid)
 {
   RegionInfo *ri;
-  int had_err = 0;
   GtArray *a;
   GtFeatureIndexMemory *fi;
   gt_assert(gfi && seqid);
   fi = gt_feature_index_memory_cast(gfi);
   a = gt_array_new(sizeof (GtFeatureNode*));
   ri = (RegionInfo*) gt_hashmap_get(fi->regions, seqid);
-  if (ri)
-    had_err = gt_interval_tree_traverse(ri->features,
-                                     collect_features_from_itree,
-                                     a);
-  gt_assert(!had_err);   /* collect_features_from_itree() is sane */
+  if (ri) {
+    build_features(fi, ri);
+    gt_implicit_interval_tree_get_all(ri->features, a);
+    ref_results(a, 0);
+  }
   return a;
 }
 
-static int gt_genome_node_cmp_range_start(const void *v1, const void *v2)
-{
-  GtGenomeNode *n1, *n2;
-  n1 = *(GtGenomeNode**) v1;
-  n2 = *(GtGenomeNode**) v2;
-  return gt_genome_node_compare(&n1, &n2);
-}
-
 int gt_feature_index_memory_get_features_for_range(GtFeatureIndex *gfi,
                                                    GtArray *results,
                                                    const char *seqid,
@@ -170,6 +173,7 @@ int gt_feature_index_memory_get_features_for_range(GtFeatureIndex *gfi,
 {
   RegionInfo *ri;
   GtFeatureIndexMemory *fi;
+  unsigned long nof_results;
   gt_error_check(err);
   gt_assert(gfi && results);
 
@@ -179,9 +183,13 @@ int gt_feature_index_memory_get_features_for_range(GtFeatureIndex *gfi,
     gt_error_set(err, "feature index does not contain the given sequence id");
     return -1;
   }
-  gt_interval_tree_find_all_overlapping(ri->features, qry_range->start,
-                                        qry_range->end, results);
-  gt_array_sort(results, gt_genome_node_cmp_range_start);
+  build_features(fi, ri);
+  nof_results = gt_array_size(results);
+  /* the results are sorted by start already */
+  gt_implicit_interval_tree_find_all_overlapping(ri->features,
+                                                 qry_range->start,
+                                                 qry_range->end, results);
+  ref_results(results, nof_results);
   return 0;
 }
 
@@ -270,6 +278,7 @@ void gt_feature_index_memory_delete(GtFeatureIndex *gfi)
   fi = gt_feature_index_memory_cast(gfi);
   gt_hashmap_delete(fi->regions);
   gt_hashmap_delete(fi->nodes_in_index);
+  gt_mutex_delete(fi->build_mutex);
 }
 
 const GtFeatureIndexClass* gt_feature_index_memory_class(void)
@@ -285,6 +294,7 @@ const GtFeatureIndexClass* gt_feature_index_memory_class(void)
                      gt_feature_index_memory_get_seqids,
                      gt_feature_index_memory_get_range_for_seqid,
                      gt_feature_index_memory_has_seqid,
+                     NULL,
                      gt_feature_index_memory_delete);
   }
   return fic;
@@ -300,6 +310,7 @@ GtFeatureIndex* gt_feature_index_memory_new(void)
   fim->regions = gt_hashmap_new(HASH_STRING, NULL,
                                 (GtFree) region_info_delete);
   fim->nodes_in_index = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  fim->build_mutex = gt_mutex_new();
   return fi;
 }
 
@@ -379,6 +390,7 @@ int gt_feature_index_memory_unit_test(GtError *err)
     features = gt_feature_index_get_features_for_seqid(fi, "test1");
   }
   ensure(had_err, gt_array_size(features) == 1UL);
+  gt_feature_index_release_features(features);
   gt_array_delete(features);
   features = NULL;
 
@@ -387,6 +399,7 @@ int gt_feature_index_memory_unit_test(GtError *err)
     features = gt_feature_index_get_features_for_seqid(fi, "test2");
   }
   ensure(had_err, gt_array_size(features) == 1UL);
+  gt_feature_index_release_features(features);
   gt_array_delete(features);
   features = NULL;
 
@@ -410,6 +423,7 @@ int gt_feature_index_memory_unit_test(GtError *err)
   if (!had_err)
     features = gt_feature_index_get_features_for_seqid(fi, "test1");
   ensure(had_err, features);
+  gt_feature_index_release_features(features);
   gt_array_delete(features);
 
   testerr = gt_error_new();
@@ -22,8 +22,11 @@
 
 /* The <GtFeatureIndexMemory> class implements a <GtFeatureIndex> in memory.
    Features are organised by region node. Each region node collects its
-   feature nodes in an interval tree structure, which allows for efficient
-   range queries. */
+   feature nodes in a static interval index, which is built in bulk on the
+   first query after features have been added and allows for efficient range
+   queries returning the features sorted by start position. Queries can be
+   issued from several threads at the same time, as long as no nodes are added
+   concurrently. */
 typedef struct GtFeatureIndexMemory GtFeatureIndexMemory;
 
 /* Creates a new <GtFeatureIndexMemory> object. */
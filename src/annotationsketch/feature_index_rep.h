@@ -39,6 +39,13 @@ typedef void        (*GtFeatureIndexGetRangeForSeqidFunc)(GtFeatureIndex*,
                                                           const char*);
 typedef bool        (*GtFeatureIndexHasSeqidFunc)(const GtFeatureIndex*,
                                                   const char*);
+typedef int         (*GtFeatureIndexGetCountsForRangeFunc)(GtFeatureIndex*,
+                                                          unsigned long*,
+                                                          unsigned long,
+                                                          const char*,
+                                                          const GtRange*,
+                                                          unsigned long*,
+                                                          GtError*);
 typedef void        (*GtFeatureIndexFreeFunc)(GtFeatureIndex*);
 
 typedef struct GtFeatureIndexMembers GtFeatureIndexMembers;
@@ -65,6 +72,8 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
                                                  get_range_for_seqid,
                                          GtFeatureIndexHasSeqidFunc
                                                  has_seqid,
+                                         GtFeatureIndexGetCountsForRangeFunc
+                                                 get_counts_for_range,
                                          GtFeatureIndexFreeFunc
                                                  free);
 GtFeatureIndex* gt_feature_index_create(const GtFeatureIndexClass*);
@@ -17,18 +17,25 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <ctype.h>
 #include <string.h>
 #include <cairo.h>
 #include "core/cstr.h"
+#include "core/fa.h"
 #include "core/fileutils_api.h"
 #include "core/gtdatapath.h"
+#include "core/ma.h"
 #include "core/option.h"
+#include "core/parseutils.h"
 #include "core/splitter.h"
+#include "core/thread.h"
+#include "core/timer.h"
 #include "core/undef.h"
 #include "core/unused_api.h"
 #include "core/versionfunc.h"
 #include "core/warning_api.h"
 #include "extended/add_introns_stream.h"
+#include "extended/binary_in_stream.h"
 #include "extended/gff3_in_stream.h"
 #include "extended/bed_in_stream.h"
 #include "extended/gtf_in_stream.h"
@@ -37,34 +44,70 @@
 #include "annotationsketch/block.h"
 #include "annotationsketch/canvas_api.h"
 #include "annotationsketch/canvas_cairo_file.h"
+#include "annotationsketch/custom_track_feature_density.h"
 #include "annotationsketch/diagram.h"
+#include "annotationsketch/feature_index_file_api.h"
 #include "annotationsketch/feature_index_memory_api.h"
 #include "annotationsketch/feature_stream.h"
+#include "annotationsketch/graphics_cairo.h"
 #include "annotationsketch/gt_sketch.h"
 #include "annotationsketch/image_info.h"
 #include "annotationsketch/layout.h"
+#include "annotationsketch/line_breaker_bases.h"
+#include "annotationsketch/line_breaker_captions.h"
 #include "annotationsketch/style.h"
+#include "annotationsketch/text_width_calculator_cairo.h"
 
 typedef struct {
   bool pipe,
+       streaming,
        verbose,
        addintrons,
        showrecmaps,
-       flattenfiles;
-  GtStr *seqid, *format, *stylefile, *input;
+       flattenfiles,
+       force;
+  GtStr *seqid, *format, *stylefile, *input, *batchfile;
   unsigned long start,
                 end;
-  unsigned int width;
+  unsigned int width,
+               nof_threads;
 } AnnotationSketchArguments;
 
+/* a single image of a batch run */
+typedef struct {
+  GtStr *seqid,
+        *file,
+        *recmaps;
+  GtRange range;
+  double time;
+} SketchTile;
+
+typedef struct {
+  const AnnotationSketchArguments *arguments;
+  GtFeatureIndex *features;
+  SketchTile *tiles;
+  unsigned long nof_tiles,
+                next_tile; /* next tile to be drawn by a worker */
+  GtMutex *mutex;
+  GtError *err; /* the first error which occurred */
+  int had_err;
+} SketchBatch;
+
+typedef struct {
+  SketchBatch *batch;
+  GtStyle *style;
+  GtError *err;
+  GtThread *thread;
+} SketchWorker;
+
 static OPrval parse_options(int *parsed_args,
                             AnnotationSketchArguments *arguments,
                             int argc, const char **argv, GtError *err)
 {
   GtOptionParser *op;
-  GtOption  *option, *option2;
+  GtOption  *option, *option2, *seqid_option, *start_option, *batch_option,
+            *streaming_option;
   OPrval oprval;
-  bool force;
   static const char *formats[] = { "png",
 #ifdef CAIRO_HAS_PDF_SURFACE
     "pdf",
@@ -86,7 +129,8 @@ static OPrval parse_options(int *parsed_args,
   gt_error_check(err);
 
   /* init */
-  op = gt_option_parser_new("[option ...] image_file [GFF3_file ...]",
+  op = gt_option_parser_new("[option ...] {image_file | -batch batch_file} "
+                            "[GFF3_file ...]",
                          "Create graphical representations of "
                          "GFF3 annotation files.");
 
@@ -99,6 +143,15 @@ static OPrval parse_options(int *parsed_args,
                            "features on stdout)", &arguments->pipe, false);
   gt_option_parser_add_option(op, option);
 
+  /* -streaming */
+  streaming_option = gt_option_new_bool("streaming", "read sorted GFF3 input "
+                                        "without building a feature index, "
+                                        "only the features in the query range "
+                                        "are kept and reading stops after it "
+                                        "(unless -pipe is used)",
+                                        &arguments->streaming, false);
+  gt_option_parser_add_option(op, streaming_option);
+
   /* -flattenfiles */
   option = gt_option_new_bool("flattenfiles", "do not group tracks by source "
                               "file name and remove file names from track "
@@ -106,23 +159,24 @@ static OPrval parse_options(int *parsed_args,
   gt_option_parser_add_option(op, option);
 
   /* -force */
-  option = gt_option_new_bool("force", "force writing to output file", &force,
-                           false);
+  option = gt_option_new_bool("force", "force writing to output file",
+                              &arguments->force, false);
   gt_option_parser_add_option(op, option);
 
   /* -seqid */
-  option = gt_option_new_string("seqid", "sequence region identifier\n"
+  seqid_option = gt_option_new_string("seqid", "sequence region identifier\n"
                                       "default: first one in file",
                             arguments->seqid, NULL);
-  gt_option_parser_add_option(op, option);
-  gt_option_hide_default(option);
+  gt_option_parser_add_option(op, seqid_option);
+  gt_option_hide_default(seqid_option);
 
   /* -start */
-  option = gt_option_new_ulong_min("start", "start position\n"
+  start_option = gt_option_new_ulong_min("start", "start position\n"
                                          "default: first region start",
                             &arguments->start, GT_UNDEF_ULONG, 1);
-  gt_option_parser_add_option(op, option);
-  gt_option_hide_default(option);
+  gt_option_parser_add_option(op, start_option);
+  gt_option_hide_default(start_option);
+  option = start_option;
 
   /* -end */
   option2 = gt_option_new_ulong("end", "end position\ndefault: last region end",
@@ -179,13 +233,50 @@ static OPrval parse_options(int *parsed_args,
   gt_option_is_development_option(option);
   gt_option_parser_add_option(op, option);
 
+  /* -batch */
+  batch_option = gt_option_new_filename("batch", "draw the images listed in "
+                                        "the given file, one per line with "
+                                        "the sequence region identifier, "
+                                        "start, end, and image file separated "
+                                        "by white space. The annotation and "
+                                        "the style file are read only once",
+                                        arguments->batchfile);
+  gt_option_parser_add_option(op, batch_option);
+  gt_option_exclude(batch_option, seqid_option);
+  gt_option_exclude(batch_option, start_option);
+  gt_option_exclude(batch_option, streaming_option);
+
+  /* -threads */
+  option = gt_option_new_uint_min("threads", "number of threads which draw "
+                                  "the images of a -batch run",
+                                  &arguments->nof_threads, 1, 1);
+  gt_option_parser_add_option(op, option);
+  gt_option_imply(option, batch_option);
+
   /* parse options */
-  gt_option_parser_set_min_args(op, 1);
   oprval = gt_option_parser_parse(op, parsed_args, argc, argv, gt_versionfunc,
                                   err);
 
-  if (oprval == OPTIONPARSER_OK && !force &&
-      gt_file_exists(argv[*parsed_args])) {
+  if (oprval == OPTIONPARSER_OK && !gt_str_length(arguments->batchfile) &&
+      *parsed_args == argc) {
+    gt_error_set(err, "missing argument image_file (or option -batch)");
+    oprval = OPTIONPARSER_ERROR;
+  }
+
+  if (oprval == OPTIONPARSER_OK && arguments->streaming) {
+    if (strcmp(gt_str_get(arguments->input), "gff")) {
+      gt_error_set(err, "option \"-streaming\" requires GFF3 input");
+      oprval = OPTIONPARSER_ERROR;
+    }
+    else if (argc - *parsed_args > 2) {
+      gt_error_set(err, "option \"-streaming\" allows at most one GFF3 "
+                   "file");
+      oprval = OPTIONPARSER_ERROR;
+    }
+  }
+
+  if (oprval == OPTIONPARSER_OK && !gt_str_length(arguments->batchfile) &&
+      !arguments->force && gt_file_exists(argv[*parsed_args])) {
     gt_error_set(err, "file \"%s\" exists already. use option -force to "
                    "overwrite", argv[*parsed_args]);
     oprval = OPTIONPARSER_ERROR;
@@ -207,6 +298,407 @@ static void flattened_file_track_selector(GtBlock *block, GtStr *result,
   gt_str_append_cstr(result, gt_block_get_type(block));
 }
 
+/* Draw the diagram <d> into <file>. If -showrecmaps was used, the RecMaps of
+   the image are appended to <recmaps>. */
+static int draw_diagram(GtDiagram *d, GtStyle *sty,
+                        const AnnotationSketchArguments *arguments,
+                        const char *file, GtStr *recmaps, GtError *err)
+{
+  GtLayout *l = NULL;
+  GtImageInfo* ii = NULL;
+  GtCanvas *canvas = NULL;
+  GtGraphicsOutType type;
+  const char *format;
+  unsigned long height;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(d);
+
+  if (arguments->flattenfiles)
+    gt_diagram_set_track_selector_func(d, flattened_file_track_selector, NULL);
+  if (!(l = gt_layout_new(d, arguments->width, sty, err)))
+    had_err = -1;
+  if (!had_err) {
+    height = gt_layout_get_height(l);
+    ii = gt_image_info_new();
+    format = gt_str_get(arguments->format);
+    if (strcmp(format, "pdf") == 0)
+      type = GT_GRAPHICS_PDF;
+    else if (strcmp(format, "ps") == 0)
+      type = GT_GRAPHICS_PS;
+    else if (strcmp(format, "svg") == 0)
+      type = GT_GRAPHICS_SVG;
+    else
+      type = GT_GRAPHICS_PNG;
+    canvas = gt_canvas_cairo_file_new(sty, type, arguments->width, height, ii);
+    had_err = gt_layout_sketch(l, canvas, err);
+  }
+  if (!had_err && arguments->showrecmaps) {
+    unsigned long i;
+    const GtRecMap *rm;
+    for (i = 0; i < gt_image_info_num_of_rec_maps(ii) ;i++) {
+      char buf[BUFSIZ];
+      rm = gt_image_info_get_rec_map(ii, i);
+      (void) gt_rec_map_format_html_imagemap_coords(rm, buf, BUFSIZ);
+      gt_str_append_cstr(recmaps, buf);
+      gt_str_append_cstr(recmaps, ", ");
+      gt_str_append_cstr(recmaps,
+                 gt_feature_node_get_type(gt_rec_map_get_genome_feature(rm)));
+      gt_str_append_char(recmaps, '\n');
+    }
+  }
+  if (!had_err) {
+    had_err = gt_canvas_cairo_file_to_file((GtCanvasCairoFile*) canvas, file,
+                                           err);
+  }
+
+  gt_canvas_delete(canvas);
+  gt_layout_delete(l);
+  gt_image_info_delete(ii);
+  return had_err;
+}
+
+/* Draw the image of <range> on <seqid> into <file>. If -showrecmaps was used,
+   the RecMaps of the image are appended to <recmaps>. */
+static int sketch_image(GtFeatureIndex *features, const char *seqid,
+                        const GtRange *range, GtStyle *sty,
+                        const AnnotationSketchArguments *arguments,
+                        const char *file, GtStr *recmaps, GtError *err)
+{
+  GtDiagram *d;
+  int had_err = 0;
+  gt_error_check(err);
+
+  if (!(d = gt_diagram_new_for_width(features, seqid, range, arguments->width,
+                                     sty, err)))
+    had_err = -1;
+  if (!had_err)
+    had_err = draw_diagram(d, sty, arguments, file, recmaps, err);
+
+  gt_diagram_delete(d);
+  return had_err;
+}
+
+/* Draw the image of the query range into <file> while reading the sorted
+   GFF3 input given in <argv> (or stdin), without building a feature index. */
+static int sketch_stream(int argc, const char **argv, GtStyle *sty,
+                         const AnnotationSketchArguments *arguments,
+                         const char *file, GtStr *recmaps, GtError *err)
+{
+  GtNodeStream *in_stream,
+               *add_introns_stream = NULL,
+               *gff3_out_stream = NULL,
+               *last_stream;
+  GtDiagram *d;
+  GtRange qry_range;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(argc <= 1);
+
+  in_stream = gt_gff3_in_stream_new_sorted(argc ? argv[0] : NULL);
+  if (arguments->verbose)
+    gt_gff3_in_stream_show_progress_bar((GtGFF3InStream*) in_stream);
+  last_stream = in_stream;
+
+  /* the input is sorted already */
+  if (arguments->addintrons) {
+    add_introns_stream = gt_add_introns_stream_new(last_stream);
+    last_stream = add_introns_stream;
+  }
+
+  if (arguments->pipe) {
+    gff3_out_stream = gt_gff3_out_stream_new(last_stream, NULL);
+    last_stream = gff3_out_stream;
+  }
+
+  qry_range.start = arguments->start;
+  qry_range.end = arguments->end;
+  if (!(d = gt_diagram_new_from_stream(last_stream,
+                                       gt_str_length(arguments->seqid)
+                                       ? gt_str_get(arguments->seqid) : NULL,
+                                       arguments->start != GT_UNDEF_ULONG
+                                       ? &qry_range : NULL,
+                                       sty, err))) {
+    had_err = -1;
+  }
+  if (!had_err)
+    had_err = draw_diagram(d, sty, arguments, file, recmaps, err);
+
+  /* in pipe mode all features are shown, read the rest of the input */
+  if (!had_err && arguments->pipe)
+    had_err = gt_node_stream_pull(last_stream, err);
+
+  gt_diagram_delete(d);
+  gt_node_stream_delete(gff3_out_stream);
+  gt_node_stream_delete(add_introns_stream);
+  gt_node_stream_delete(in_stream);
+  return had_err;
+}
+
+/* Split <line> at white space into at most <max> <tokens>. Returns the number
+   of tokens, or <max> + 1 if the line contains more tokens. */
+static unsigned long split_line(char *line, char **tokens, unsigned long max)
+{
+  unsigned long nof_tokens = 0;
+  for (;;) {
+    while (isspace((int) *line))
+      line++;
+    if (!*line)
+      break;
+    if (nof_tokens == max)
+      return max + 1;
+    tokens[nof_tokens++] = line;
+    while (*line && !isspace((int) *line))
+      line++;
+    if (*line)
+      *line++ = '\0';
+  }
+  return nof_tokens;
+}
+
+/* Read the tiles of <batch> from the batch file <filename>. Empty lines and
+   lines starting with '#' are ignored. */
+static int read_tiles(SketchBatch *batch, GtArray *tiles, const char *filename,
+                      GtError *err)
+{
+  SketchTile tile;
+  GtStr *line;
+  FILE *fp;
+  char *tokens[4];
+  unsigned long nof_tokens, line_number = 0;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(batch && tiles && filename);
+  if (!(fp = gt_fa_fopen(filename, "r", err)))
+    return -1;
+  line = gt_str_new();
+  while (!had_err && (gt_str_read_next_line(line, fp) != EOF ||
+                      gt_str_length(line))) {
+    line_number++;
+    nof_tokens = split_line(gt_str_get(line), tokens, 4);
+    if (!nof_tokens || tokens[0][0] == '#') {
+      gt_str_reset(line);
+      continue;
+    }
+    if (nof_tokens != 4) {
+      gt_error_set(err, "line %lu in file '%s' does not consist of sequence "
+                   "region identifier, start, end, and image file", line_number,
+                   filename);
+      had_err = -1;
+    }
+    if (!had_err) {
+      had_err = gt_parse_range(&tile.range, tokens[1], tokens[2], line_number,
+                               filename, err);
+    }
+    if (!had_err && !(tile.range.start && tile.range.start < tile.range.end)) {
+      gt_error_set(err, "start (%lu) must be positive and before end (%lu) on "
+                   "line %lu in file '%s'", tile.range.start, tile.range.end,
+                   line_number, filename);
+      had_err = -1;
+    }
+    if (!had_err && !gt_feature_index_has_seqid(batch->features, tokens[0])) {
+      gt_error_set(err, "sequence region '%s' on line %lu in file '%s' does "
+                   "not exist in GFF input file", tokens[0], line_number,
+                   filename);
+      had_err = -1;
+    }
+    if (!had_err && !batch->arguments->force && gt_file_exists(tokens[3])) {
+      gt_error_set(err, "file \"%s\" exists already. use option -force to "
+                   "overwrite", tokens[3]);
+      had_err = -1;
+    }
+    if (!had_err) {
+      tile.seqid = gt_str_new_cstr(tokens[0]);
+      tile.file = gt_str_new_cstr(tokens[3]);
+      tile.recmaps = gt_str_new();
+      tile.time = 0.0;
+      gt_array_add(tiles, tile);
+    }
+    gt_str_reset(line);
+  }
+  gt_str_delete(line);
+  gt_fa_fclose(fp);
+  return had_err;
+}
+
+static void* sketch_tiles(void *data)
+{
+  SketchWorker *worker = data;
+  SketchBatch *batch = worker->batch;
+  SketchTile *tile;
+  GtTimer *timer;
+  int had_err;
+  timer = gt_timer_new();
+  for (;;) {
+    gt_mutex_lock(batch->mutex);
+    if (batch->had_err || batch->next_tile == batch->nof_tiles) {
+      gt_mutex_unlock(batch->mutex);
+      break;
+    }
+    tile = batch->tiles + batch->next_tile++;
+    gt_mutex_unlock(batch->mutex);
+    gt_timer_start(timer);
+    had_err = sketch_image(batch->features, gt_str_get(tile->seqid),
+                           &tile->range, worker->style, batch->arguments,
+                           gt_str_get(tile->file), tile->recmaps, worker->err);
+    gt_timer_stop(timer);
+    tile->time = gt_timer_elapsed_seconds(timer);
+    if (had_err) {
+      /* keep the first error, the other workers stop after their tile */
+      gt_mutex_lock(batch->mutex);
+      if (!batch->had_err) {
+        gt_error_set(batch->err, "%s", gt_error_get(worker->err));
+        batch->had_err = -1;
+      }
+      gt_mutex_unlock(batch->mutex);
+      gt_error_unset(worker->err);
+    }
+  }
+  gt_timer_delete(timer);
+  return NULL;
+}
+
+/* The class objects are created on their first use, which must not happen in
+   several threads at the same time. Therefore, the classes used for drawing
+   are created before the workers are started. */
+static void create_drawing_classes(void)
+{
+  (void) gt_canvas_cairo_file_class();
+  (void) gt_graphics_cairo_class();
+  (void) gt_text_width_calculator_cairo_class();
+  (void) gt_line_breaker_captions_class();
+  (void) gt_line_breaker_bases_class();
+  (void) gt_custom_track_feature_density_class();
+}
+
+static void show_tile_statistics(const SketchBatch *batch,
+                                 unsigned int nof_workers, double time)
+{
+  const SketchTile *tile, *slowest = NULL;
+  double min_time = 0.0, sum_time = 0.0;
+  unsigned long i;
+  gt_assert(batch);
+  for (i = 0; i < batch->nof_tiles; i++) {
+    tile = batch->tiles + i;
+    if (batch->arguments->verbose || batch->arguments->showrecmaps) {
+      printf("# %s:%lu-%lu, %s, %.3fs\n", gt_str_get(tile->seqid),
+             tile->range.start, tile->range.end, gt_str_get(tile->file),
+             tile->time);
+      fputs(gt_str_get(tile->recmaps), stdout);
+    }
+    if (!slowest || tile->time > slowest->time)
+      slowest = tile;
+    if (!i || tile->time < min_time)
+      min_time = tile->time;
+    sum_time += tile->time;
+  }
+  printf("# %lu images drawn with %u thread%s in %.3fs\n", batch->nof_tiles,
+         nof_workers, nof_workers == 1 ? "" : "s", time);
+  if (slowest) {
+    printf("# time per image: min %.3fs, average %.3fs, max %.3fs (%s)\n",
+           min_time, sum_time / batch->nof_tiles, slowest->time,
+           gt_str_get(slowest->file));
+  }
+}
+
+/* Draw the images listed in the batch file. The workers share the read-only
+   <features>, but every worker draws with its own style (and Lua state). */
+static int sketch_batch(GtFeatureIndex *features,
+                        const AnnotationSketchArguments *arguments,
+                        GtError *err)
+{
+  SketchBatch batch;
+  SketchWorker *workers = NULL;
+  GtArray *tiles;
+  GtTimer *timer = NULL;
+  unsigned int i, nof_workers = 0;
+  unsigned long j;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(features && arguments);
+
+  batch.arguments = arguments;
+  batch.features = features;
+  tiles = gt_array_new(sizeof (SketchTile));
+  had_err = read_tiles(&batch, tiles, gt_str_get(arguments->batchfile), err);
+  batch.tiles = gt_array_get_space(tiles);
+  batch.nof_tiles = gt_array_size(tiles);
+  batch.next_tile = 0;
+  batch.mutex = gt_mutex_new();
+  batch.err = gt_error_new();
+  batch.had_err = 0;
+
+  if (!had_err) {
+    nof_workers = gt_thread_support() ? arguments->nof_threads : 1;
+    if (nof_workers > batch.nof_tiles)
+      nof_workers = batch.nof_tiles ? batch.nof_tiles : 1;
+    workers = gt_calloc(nof_workers, sizeof (SketchWorker));
+    if (!gt_file_exists(gt_str_get(arguments->stylefile))) {
+      gt_error_set(err, "style file '%s' does not exist!",
+                   gt_str_get(arguments->stylefile));
+      had_err = -1;
+    }
+  }
+  for (i = 0; !had_err && i < nof_workers; i++) {
+    workers[i].batch = &batch;
+    workers[i].err = gt_error_new();
+    if (!(workers[i].style = gt_style_new(err)))
+      had_err = -1;
+    if (!had_err) {
+      had_err = gt_style_load_file(workers[i].style,
+                                   gt_str_get(arguments->stylefile), err);
+    }
+  }
+
+  if (!had_err) {
+    timer = gt_timer_new();
+    gt_timer_start(timer);
+    if (nof_workers == 1)
+      (void) sketch_tiles(workers);
+    else {
+      create_drawing_classes();
+      for (i = 0; i < nof_workers; i++) {
+        if (!(workers[i].thread = gt_thread_new(sketch_tiles, workers + i,
+                                                err))) {
+          /* let the running workers stop after their current tile */
+          gt_mutex_lock(batch.mutex);
+          batch.had_err = had_err = -1;
+          gt_mutex_unlock(batch.mutex);
+          break;
+        }
+      }
+      for (i = 0; i < nof_workers; i++) {
+        if (workers[i].thread)
+          gt_thread_join(workers[i].thread);
+      }
+    }
+    gt_timer_stop(timer);
+    if (!had_err && batch.had_err) {
+      gt_error_set(err, "%s", gt_error_get(batch.err));
+      had_err = -1;
+    }
+  }
+
+  if (!had_err)
+    show_tile_statistics(&batch, nof_workers, gt_timer_elapsed_seconds(timer));
+
+  for (i = 0; workers && i < nof_workers; i++) {
+    gt_style_delete(workers[i].style);
+    gt_error_delete(workers[i].err);
+  }
+  gt_free(workers);
+  for (j = 0; j < batch.nof_tiles; j++) {
+    gt_str_delete(batch.tiles[j].seqid);
+    gt_str_delete(batch.tiles[j].file);
+    gt_str_delete(batch.tiles[j].recmaps);
+  }
+  gt_array_delete(tiles);
+  gt_timer_delete(timer);
+  gt_error_delete(batch.err);
+  gt_mutex_delete(batch.mutex);
+  return had_err;
+}
+
 int gt_sketch(int argc, const char **argv, GtError *err)
 {
   GtNodeStream *in_stream = NULL,
@@ -218,16 +710,11 @@ int gt_sketch(int argc, const char **argv, GtError *err)
   AnnotationSketchArguments arguments;
   GtFeatureIndex *features = NULL;
   int parsed_args, had_err=0;
-  const char *file, *seqid = NULL;
+  const char *file = NULL, *seqid = NULL;
   GtRange qry_range, sequence_region_range;
   GtArray *results = NULL;
   GtStyle *sty = NULL;
-  GtStr *prog, *gt_style_file = NULL;
-  GtDiagram *d = NULL;
-  GtLayout *l = NULL;
-  GtImageInfo* ii = NULL;
-  GtCanvas *canvas = NULL;
-  unsigned long height;
+  GtStr *prog, *gt_style_file = NULL, *recmaps = NULL;
 
   gt_error_check(err);
 
@@ -235,6 +722,7 @@ int gt_sketch(int argc, const char **argv, GtError *err)
   arguments.seqid = gt_str_new();
   arguments.format = gt_str_new();
   arguments.input = gt_str_new();
+  arguments.batchfile = gt_str_new();
   prog = gt_str_new();
   gt_str_append_cstr_nt(prog, argv[0],
                         gt_cstr_length_up_to_char(argv[0], ' '));
@@ -250,6 +738,7 @@ int gt_sketch(int argc, const char **argv, GtError *err)
       gt_str_delete(arguments.seqid);
       gt_str_delete(arguments.format);
       gt_str_delete(arguments.input);
+      gt_str_delete(arguments.batchfile);
       return -1;
     case OPTIONPARSER_REQUESTS_EXIT:
       gt_str_delete(arguments.stylefile);
@@ -257,11 +746,14 @@ int gt_sketch(int argc, const char **argv, GtError *err)
       gt_str_delete(arguments.seqid);
       gt_str_delete(arguments.format);
       gt_str_delete(arguments.input);
+      gt_str_delete(arguments.batchfile);
       return 0;
   }
 
-  /* save name of output file */
-  file = argv[parsed_args];
+  /* save name of output file (in batch mode, the names are in the batch
+     file) */
+  if (!gt_str_length(arguments.batchfile))
+    file = argv[parsed_args++];
 
   /* check for correct order: range end < range start */
   if (!had_err &&
@@ -275,9 +767,18 @@ int gt_sketch(int argc, const char **argv, GtError *err)
   }
 
   if (!had_err) {
+    /* a single binary annotation file which is drawn unchanged is used as the
+       feature index directly, only the features in the query range are read */
+    if (argc - parsed_args == 1 && !arguments.pipe && !arguments.addintrons &&
+        strcmp(gt_str_get(arguments.input), "gff") == 0 &&
+        gt_binary_in_stream_file_is_binary(argv[parsed_args])) {
+      if (!(features = gt_feature_index_file_new(argv[parsed_args], err)))
+        had_err = -1;
+    }
+  }
+  if (!had_err && !features && !arguments.streaming) {
     /* create feature index */
     features = gt_feature_index_memory_new();
-    parsed_args++;
 
     /* create an input stream */
     if (strcmp(gt_str_get(arguments.input), "gff") == 0)
@@ -286,6 +787,8 @@ int gt_sketch(int argc, const char **argv, GtError *err)
                                                  argv + parsed_args);
       if (arguments.verbose)
         gt_gff3_in_stream_show_progress_bar((GtGFF3InStream*) in_stream);
+      /* all features are kept until the end, allocate them in chunks */
+      gt_gff3_in_stream_enable_arena_allocation(in_stream);
     } else if (strcmp(gt_str_get(arguments.input), "bed") == 0)
     {
       if (argc - parsed_args == 0)
@@ -327,25 +830,40 @@ int gt_sketch(int argc, const char **argv, GtError *err)
     gt_node_stream_delete(in_stream);
   }
 
-  /* if seqid is empty, take first one added to index */
-  if (!had_err && strcmp(gt_str_get(arguments.seqid),"") == 0) {
-    seqid = gt_feature_index_get_first_seqid(features);
-    if (seqid == NULL) {
-      gt_error_set(err, "GFF input file must contain a sequence region!");
+  if (!had_err && gt_str_length(arguments.batchfile)) {
+    had_err = sketch_batch(features, &arguments, err);
+    gt_str_delete(gt_style_file);
+    gt_str_delete(arguments.seqid);
+    gt_str_delete(arguments.stylefile);
+    gt_str_delete(arguments.format);
+    gt_str_delete(arguments.input);
+    gt_str_delete(arguments.batchfile);
+    gt_feature_index_delete(features);
+    return had_err;
+  }
+
+  /* if seqid is empty, take first one added to index (in streaming mode, the
+     sequence region and the range are determined while reading) */
+  if (!had_err && !arguments.streaming) {
+    if (strcmp(gt_str_get(arguments.seqid),"") == 0) {
+      seqid = gt_feature_index_get_first_seqid(features);
+      if (seqid == NULL) {
+        gt_error_set(err, "GFF input file must contain a sequence region!");
+        had_err = -1;
+      }
+    }
+    else if (!gt_feature_index_has_seqid(features,
+                                         gt_str_get(arguments.seqid))) {
+      gt_error_set(err, "sequence region '%s' does not exist in GFF input "
+                   "file", gt_str_get(arguments.seqid));
       had_err = -1;
     }
+    else
+      seqid = gt_str_get(arguments.seqid);
   }
-  else if (!had_err && !gt_feature_index_has_seqid(features,
-                                                gt_str_get(arguments.seqid))) {
-    gt_error_set(err, "sequence region '%s' does not exist in GFF input file",
-                 gt_str_get(arguments.seqid));
-    had_err = -1;
-  }
-  else if (!had_err)
-    seqid = gt_str_get(arguments.seqid);
 
   results = gt_array_new(sizeof (GtGenomeNode*));
-  if (!had_err) {
+  if (!had_err && !arguments.streaming) {
     gt_feature_index_get_range_for_seqid(features, &sequence_region_range,
                                          seqid);
     qry_range.start = (arguments.start == GT_UNDEF_ULONG ?
@@ -376,63 +894,27 @@ int gt_sketch(int argc, const char **argv, GtError *err)
 
   if (!had_err) {
     /* create and write image file */
-    if (!(d = gt_diagram_new(features, seqid, &qry_range, sty, err)))
-      had_err = -1;
-    if (!had_err && arguments.flattenfiles)
-      gt_diagram_set_track_selector_func(d, flattened_file_track_selector,
-                                         NULL);
-    if (had_err || !(l = gt_layout_new(d, arguments.width, sty, err)))
-      had_err = -1;
-    if (!had_err)
-    {
-      height = gt_layout_get_height(l);
-      ii = gt_image_info_new();
-
-      if (strcmp(gt_str_get(arguments.format),"pdf")==0) {
-        canvas = gt_canvas_cairo_file_new(sty, GT_GRAPHICS_PDF, arguments.width,
-                                          height, ii);
-      }
-      else if (strcmp(gt_str_get(arguments.format),"ps")==0) {
-        canvas = gt_canvas_cairo_file_new(sty, GT_GRAPHICS_PS, arguments.width,
-                                          height, ii);
-      }
-      else if (strcmp(gt_str_get(arguments.format),"svg")==0) {
-        canvas = gt_canvas_cairo_file_new(sty, GT_GRAPHICS_SVG, arguments.width,
-                                          height, ii);
-      }
-      else {
-        canvas = gt_canvas_cairo_file_new(sty, GT_GRAPHICS_PNG, arguments.width,
-                                          height, ii);
-      }
-      had_err = gt_layout_sketch(l, canvas, err);
-      if (arguments.showrecmaps) {
-        unsigned long i;
-        const GtRecMap *rm;
-        for (i = 0; i < gt_image_info_num_of_rec_maps(ii) ;i++) {
-          char buf[BUFSIZ];
-          rm = gt_image_info_get_rec_map(ii, i);
-          (void) gt_rec_map_format_html_imagemap_coords(rm, buf, BUFSIZ);
-          printf("%s, %s\n",
-                 buf,
-                 gt_feature_node_get_type(gt_rec_map_get_genome_feature(rm)));
-        }
-      }
-      had_err = gt_canvas_cairo_file_to_file((GtCanvasCairoFile*) canvas, file,
-                                             err);
+    recmaps = gt_str_new();
+    if (arguments.streaming) {
+      had_err = sketch_stream(argc - parsed_args, argv + parsed_args, sty,
+                              &arguments, file, recmaps, err);
     }
+    else {
+      had_err = sketch_image(features, seqid, &qry_range, sty, &arguments,
+                             file, recmaps, err);
+    }
+    fputs(gt_str_get(recmaps), stdout);
   }
 
   /* free */
-  gt_canvas_delete(canvas);
-  gt_layout_delete(l);
-  gt_image_info_delete(ii);
   gt_style_delete(sty);
   gt_str_delete(gt_style_file);
-  gt_diagram_delete(d);
+  gt_str_delete(recmaps);
   gt_str_delete(arguments.seqid);
   gt_str_delete(arguments.stylefile);
   gt_str_delete(arguments.format);
   gt_str_delete(arguments.input);
+  gt_str_delete(arguments.batchfile);
   gt_array_delete(results);
   gt_feature_index_delete(features);
 
@@ -0,0 +1,529 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "core/cstr.h"
+#include "core/gtdatapath.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/option.h"
+#include "core/timer.h"
+#include "core/unused_api.h"
+#include "core/xposix.h"
+#include "extended/feature_node.h"
+#include "extended/gff3_in_stream.h"
+#include "extended/region_node.h"
+#include "annotationsketch/canvas_cairo_file.h"
+#include "annotationsketch/diagram.h"
+#include "annotationsketch/feature_index.h"
+#include "annotationsketch/feature_index_memory.h"
+#include "annotationsketch/feature_visitor.h"
+#include "annotationsketch/gt_sketchbench.h"
+#include "annotationsketch/layout.h"
+#include "annotationsketch/style.h"
+
+#define SYNTHETIC_SEQID  "chr1"
+#define CAPTION_LENGTH   80
+
+typedef struct {
+  GtStr *workload,
+        *seqid,
+        *stylefile;
+  unsigned long nof_features,
+                nof_windows,
+                window;
+  unsigned int width;
+} SketchbenchArguments;
+
+/* the phases of drawing an image, in the order in which they are run */
+typedef enum {
+  PHASE_PARSE,
+  PHASE_INDEX,
+  PHASE_DIAGRAM,
+  PHASE_LAYOUT,
+  PHASE_SKETCH,
+  NOF_PHASES
+} BenchPhaseType;
+
+typedef struct {
+  const char *name;
+  unsigned long runs,
+                space_peak; /* largest increase of the allocated space */
+  unsigned long long allocations;
+  double time;
+} BenchPhase;
+
+/* the state at the start of a phase run */
+typedef struct {
+  GtTimer *timer;
+  unsigned long space;
+  unsigned long long mallocevents;
+} BenchMark;
+
+static const char *workloads[] = {
+  "genes",
+  "pileup",
+  "captions",
+  NULL
+};
+
+static void* gt_sketchbench_arguments_new(void)
+{
+  SketchbenchArguments *arguments = gt_calloc(1, sizeof *arguments);
+  arguments->workload = gt_str_new();
+  arguments->seqid = gt_str_new();
+  arguments->stylefile = gt_str_new();
+  return arguments;
+}
+
+static void gt_sketchbench_arguments_delete(void *tool_arguments)
+{
+  SketchbenchArguments *arguments = tool_arguments;
+  if (!arguments) return;
+  gt_str_delete(arguments->stylefile);
+  gt_str_delete(arguments->seqid);
+  gt_str_delete(arguments->workload);
+  gt_free(arguments);
+}
+
+static GtOptionParser* gt_sketchbench_option_parser_new(void *tool_arguments)
+{
+  SketchbenchArguments *arguments = tool_arguments;
+  GtOptionParser *op;
+  GtOption *option;
+  gt_assert(arguments);
+
+  op = gt_option_parser_new("[option ...] [GFF3_file ...]",
+                            "Measure the time, allocations and space peak of "
+                            "the phases of drawing\nimages with "
+                            "AnnotationSketch. If no GFF3 files are given, a "
+                            "synthetic\nworkload is drawn.");
+
+  option = gt_option_new_choice("workload", "synthetic workload to draw if no "
+                                "GFF3 files are given\nchoose from: genes "
+                                "(dense gene models), pileup (deeply "
+                                "overlapping\nalignments), captions (genes "
+                                "with long captions)",
+                                arguments->workload, workloads[0], workloads);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_ulong_min("features", "number of top-level features "
+                                   "of the synthetic workload",
+                                   &arguments->nof_features, 5000, 1);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_string("seqid", "sequence region to draw\n"
+                                "default: first in file",
+                                arguments->seqid, NULL);
+  gt_option_parser_add_option(op, option);
+  gt_option_hide_default(option);
+
+  option = gt_option_new_ulong_min("windows", "number of images to draw, "
+                                   "spread evenly over the\nsequence region",
+                                   &arguments->nof_windows, 20, 1);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_ulong("window", "length of the range shown in each "
+                               "image\n0 shows the whole sequence region",
+                               &arguments->window, 100000);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uint_min("width", "target image width (in pixel)",
+                                  &arguments->width, 800, 1);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_string("style", "style file to use\n"
+                                "default: gtdata/sketch/default.style",
+                                arguments->stylefile, NULL);
+  gt_option_parser_add_option(op, option);
+  gt_option_hide_default(option);
+
+  return op;
+}
+
+static void bench_phase_start(BenchMark *mark)
+{
+  gt_assert(mark);
+  mark->space = gt_ma_get_space_current();
+  mark->mallocevents = gt_ma_get_mallocevents();
+  gt_ma_reset_local_space_peak();
+  gt_timer_start(mark->timer);
+}
+
+static void bench_phase_stop(BenchPhase *phase, BenchMark *mark)
+{
+  unsigned long space_peak;
+  gt_assert(phase && mark);
+  gt_timer_stop(mark->timer);
+  phase->time += gt_timer_elapsed_seconds(mark->timer);
+  phase->allocations += gt_ma_get_mallocevents() - mark->mallocevents;
+  space_peak = gt_ma_get_local_space_peak() - mark->space;
+  if (space_peak > phase->space_peak)
+    phase->space_peak = space_peak;
+  phase->runs++;
+}
+
+/* Returns a random number in the range [<min>, <max>]. */
+static unsigned long random_between(unsigned long min, unsigned long max)
+{
+  gt_assert(min <= max);
+  return min + gt_rand_max(max - min);
+}
+
+static void set_long_caption(GtFeatureNode *fn, unsigned long num)
+{
+  char caption[CAPTION_LENGTH + 1];
+  unsigned long i, length;
+  gt_assert(fn);
+  length = random_between(CAPTION_LENGTH / 2, CAPTION_LENGTH);
+  for (i = snprintf(caption, sizeof caption, "gene%lu", num); i < length; i++)
+    caption[i] = i % 8 ? 'a' + gt_rand_max('z' - 'a') : '_';
+  caption[i] = '\0';
+  gt_feature_node_set_attribute(fn, "Name", caption);
+}
+
+/* Returns a gene starting at <start> with up to three transcripts of up to
+   eight exons each. */
+static GtGenomeNode* synthetic_gene(GtStr *seqid, unsigned long start,
+                                    unsigned long num, bool long_caption)
+{
+  GtGenomeNode *gene, *mrna, *child;
+  GtStrand strand;
+  unsigned long i, j, end, exon_start, exon_length, nof_exons;
+  char id[32];
+  gt_assert(seqid);
+  strand = gt_rand_max(1) ? GT_STRAND_FORWARD : GT_STRAND_REVERSE;
+  nof_exons = random_between(3, 8);
+  exon_length = random_between(100, 600);
+  end = start + nof_exons * 2 * exon_length - exon_length - 1;
+  gene = gt_feature_node_new(seqid, "gene", start, end, strand);
+  (void) snprintf(id, sizeof id, "gene%lu", num);
+  gt_feature_node_set_attribute((GtFeatureNode*) gene, "ID", id);
+  if (long_caption)
+    set_long_caption((GtFeatureNode*) gene, num);
+  for (i = random_between(1, 3); i > 0; i--) {
+    mrna = gt_feature_node_new(seqid, "mRNA", start, end, strand);
+    gt_feature_node_add_child((GtFeatureNode*) gene, (GtFeatureNode*) mrna);
+    for (j = 0; j < nof_exons; j++) {
+      /* skip some inner exons to get different transcripts */
+      if (j && j + 1 < nof_exons && !gt_rand_max(3))
+        continue;
+      exon_start = start + j * 2 * exon_length;
+      child = gt_feature_node_new(seqid, "exon", exon_start,
+                                  exon_start + exon_length - 1, strand);
+      gt_feature_node_add_child((GtFeatureNode*) mrna, (GtFeatureNode*) child);
+      child = gt_feature_node_new(seqid, "CDS",
+                                  exon_start + (j ? 0 : exon_length / 2),
+                                  exon_start + exon_length - 1, strand);
+      gt_feature_node_add_child((GtFeatureNode*) mrna, (GtFeatureNode*) child);
+    }
+  }
+  return gene;
+}
+
+/* Returns an alignment of up to four parts starting at <start>. */
+static GtGenomeNode* synthetic_match(GtStr *seqid, unsigned long start)
+{
+  GtGenomeNode *match, *part;
+  GtStrand strand;
+  unsigned long i, end, nof_parts, part_length, gap_length;
+  gt_assert(seqid);
+  strand = gt_rand_max(1) ? GT_STRAND_FORWARD : GT_STRAND_REVERSE;
+  nof_parts = random_between(1, 4);
+  part_length = random_between(50, 300);
+  gap_length = random_between(50, 500);
+  end = start + nof_parts * (part_length + gap_length) - gap_length - 1;
+  match = gt_feature_node_new(seqid, "expressed_sequence_match", start, end,
+                              strand);
+  for (i = 0; i < nof_parts; i++) {
+    part = gt_feature_node_new(seqid, "match_part",
+                               start + i * (part_length + gap_length),
+                               start + i * (part_length + gap_length)
+                               + part_length - 1, strand);
+    gt_feature_node_add_child((GtFeatureNode*) match, (GtFeatureNode*) part);
+  }
+  return match;
+}
+
+/* Creates the nodes of the synthetic <workload> and adds them to <nodes>. */
+static void generate_workload(GtArray *nodes, const char *workload,
+                              unsigned long nof_features)
+{
+  GtGenomeNode *gn;
+  GtStr *seqid;
+  GtRange range;
+  unsigned long i, pos = 1;
+  bool pileup;
+  gt_assert(nodes && workload);
+  seqid = gt_str_new_cstr(SYNTHETIC_SEQID);
+  pileup = !strcmp(workload, "pileup");
+  range.start = range.end = 1;
+  /* the region node is set after the features have been generated */
+  gn = NULL;
+  gt_array_add(nodes, gn);
+  for (i = 0; i < nof_features; i++) {
+    if (pileup) {
+      /* about 50 alignments cover each position */
+      gn = synthetic_match(seqid, pos + gt_rand_max(nof_features * 20));
+    }
+    else {
+      gn = synthetic_gene(seqid, pos, i + 1, !strcmp(workload, "captions"));
+      pos = gt_genome_node_get_end(gn) + random_between(100, 2000);
+    }
+    if (gt_genome_node_get_end(gn) > range.end)
+      range.end = gt_genome_node_get_end(gn);
+    gt_array_add(nodes, gn);
+  }
+  gn = gt_region_node_new(seqid, range.start, range.end);
+  *(GtGenomeNode**) gt_array_get(nodes, 0) = gn;
+  gt_str_delete(seqid);
+}
+
+static int parse_files(GtArray *nodes, int argc, const char **argv,
+                       GtError *err)
+{
+  GtNodeStream *in_stream;
+  GtGenomeNode *gn;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(nodes);
+  in_stream = gt_gff3_in_stream_new_unsorted(argc, argv);
+  while (!(had_err = gt_node_stream_next(in_stream, &gn, err)) && gn)
+    gt_array_add(nodes, gn);
+  gt_node_stream_delete(in_stream);
+  return had_err;
+}
+
+static void index_nodes(GtFeatureIndex *features, GtArray *nodes)
+{
+  GtNodeVisitor *feature_visitor;
+  unsigned long i;
+  int had_err;
+  gt_assert(features && nodes);
+  feature_visitor = gt_feature_visitor_new(features);
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    had_err = gt_genome_node_accept(*(GtGenomeNode**) gt_array_get(nodes, i),
+                                    feature_visitor, NULL);
+    gt_assert(!had_err); /* cannot happen */
+  }
+  gt_node_visitor_delete(feature_visitor);
+}
+
+/* Draw the image of <range> on <seqid>, measuring the phases separately. */
+static int draw_window(GtFeatureIndex *features, const char *seqid,
+                       const GtRange *range, GtStyle *sty,
+                       const SketchbenchArguments *arguments,
+                       BenchPhase *phases, BenchMark *mark, GtError *err)
+{
+  GtDiagram *d = NULL;
+  GtLayout *l = NULL;
+  GtCanvas *canvas = NULL;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(phases && mark);
+
+  /* the blocks are built lazily by the layout, build them here instead */
+  bench_phase_start(mark);
+  if (!(d = gt_diagram_new_for_width(features, seqid, range, arguments->width,
+                                     sty, err)))
+    had_err = -1;
+  else
+    (void) gt_diagram_build(d);
+  bench_phase_stop(phases + PHASE_DIAGRAM, mark);
+  if (!had_err) {
+    bench_phase_start(mark);
+    if (!(l = gt_layout_new(d, arguments->width, sty, err)))
+      had_err = -1;
+    bench_phase_stop(phases + PHASE_LAYOUT, mark);
+  }
+  if (!had_err) {
+    bench_phase_start(mark);
+    canvas = gt_canvas_cairo_file_new(sty, GT_GRAPHICS_PNG, arguments->width,
+                                      gt_layout_get_height(l), NULL);
+    had_err = gt_layout_sketch(l, canvas, err);
+    bench_phase_stop(phases + PHASE_SKETCH, mark);
+  }
+
+  gt_canvas_delete(canvas);
+  gt_layout_delete(l);
+  gt_diagram_delete(d);
+  return had_err;
+}
+
+static void show_phases(const BenchPhase *phases)
+{
+  unsigned long i;
+  bool bookkeeping;
+  gt_assert(phases);
+  bookkeeping = gt_ma_bookkeeping_enabled();
+  printf("# phase      runs  time (s)  time/run (s)  allocations  "
+         "space peak (MB)\n");
+  for (i = 0; i < NOF_PHASES; i++) {
+    if (!phases[i].runs)
+      continue;
+    printf("%-10s %6lu %9.3f %13.6f", phases[i].name, phases[i].runs,
+           phases[i].time, phases[i].time / phases[i].runs);
+    if (bookkeeping) {
+      printf(" %12llu %16.2f\n", phases[i].allocations,
+             (double) phases[i].space_peak / (1 << 20));
+    }
+    else
+      printf(" %12s %16s\n", "-", "-");
+  }
+  if (!bookkeeping) {
+    printf("# allocations and space peaks are only measured with "
+           "GT_MEM_BOOKKEEPING=on\n");
+  }
+}
+
+static int gt_sketchbench_runner(int argc, const char **argv, int parsed_args,
+                                 void *tool_arguments, GtError *err)
+{
+  SketchbenchArguments *arguments = tool_arguments;
+  BenchPhase phases[NOF_PHASES];
+  BenchMark mark;
+  GtFeatureIndex *features;
+  GtArray *nodes, *results;
+  GtStyle *sty = NULL;
+  GtStr *prog, *stylefile;
+  GtRange extent, range;
+  const char *seqid = NULL;
+  unsigned long i, window;
+  struct rusage ru;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(arguments);
+
+  memset(phases, 0, sizeof phases);
+  phases[PHASE_PARSE].name = parsed_args < argc ? "parse" : "generate";
+  phases[PHASE_INDEX].name = "index";
+  phases[PHASE_DIAGRAM].name = "diagram";
+  phases[PHASE_LAYOUT].name = "layout";
+  phases[PHASE_SKETCH].name = "sketch";
+  mark.timer = gt_timer_new();
+  nodes = gt_array_new(sizeof (GtGenomeNode*));
+  results = gt_array_new(sizeof (GtGenomeNode*));
+  features = gt_feature_index_memory_new();
+
+  /* get style */
+  if (gt_str_length(arguments->stylefile))
+    stylefile = gt_str_ref(arguments->stylefile);
+  else {
+    prog = gt_str_new();
+    gt_str_append_cstr_nt(prog, argv[0],
+                          gt_cstr_length_up_to_char(argv[0], ' '));
+    stylefile = gt_get_gtdata_path(gt_str_get(prog), err);
+    gt_str_delete(prog);
+    if (stylefile)
+      gt_str_append_cstr(stylefile, "/sketch/default.style");
+    else
+      had_err = -1;
+  }
+  if (!had_err && !(sty = gt_style_new(err)))
+    had_err = -1;
+  if (!had_err)
+    had_err = gt_style_load_file(sty, gt_str_get(stylefile), err);
+
+  /* read or generate the annotation */
+  if (!had_err) {
+    bench_phase_start(&mark);
+    if (parsed_args < argc) {
+      had_err = parse_files(nodes, argc - parsed_args, argv + parsed_args,
+                            err);
+    }
+    else {
+      generate_workload(nodes, gt_str_get(arguments->workload),
+                        arguments->nof_features);
+    }
+    bench_phase_stop(phases + PHASE_PARSE, &mark);
+  }
+
+  /* the index is built with the first query */
+  if (!had_err) {
+    bench_phase_start(&mark);
+    index_nodes(features, nodes);
+    if (gt_str_length(arguments->seqid))
+      seqid = gt_str_get(arguments->seqid);
+    else
+      seqid = gt_feature_index_get_first_seqid(features);
+    if (!seqid) {
+      gt_error_set(err, "the input does not contain any features");
+      had_err = -1;
+    }
+    else if (!gt_feature_index_has_seqid(features, seqid)) {
+      gt_error_set(err, "sequence region '%s' does not exist in input",
+                   seqid);
+      had_err = -1;
+    }
+    if (!had_err) {
+      gt_feature_index_get_range_for_seqid(features, &extent, seqid);
+      had_err = gt_feature_index_get_features_for_range(features, results,
+                                                        seqid, &extent, err);
+    }
+    bench_phase_stop(phases + PHASE_INDEX, &mark);
+  }
+
+  /* draw the images */
+  if (!had_err) {
+    printf("# %lu top-level features on sequence region %s (%lu-%lu)\n",
+           gt_array_size(results), seqid, extent.start, extent.end);
+    window = arguments->window;
+    if (!window || window > gt_range_length(&extent))
+      window = gt_range_length(&extent);
+    for (i = 0; !had_err && i < arguments->nof_windows; i++) {
+      range.start = extent.start;
+      if (arguments->nof_windows > 1) {
+        range.start += i * (gt_range_length(&extent) - window)
+                       / (arguments->nof_windows - 1);
+      }
+      range.end = range.start + window - 1;
+      if (range.start == range.end)
+        range.end++;
+      had_err = draw_window(features, seqid, &range, sty, arguments, phases,
+                            &mark, err);
+    }
+  }
+
+  if (!had_err) {
+    printf("# %lu images of %lu bases, %u pixels wide\n",
+           arguments->nof_windows, window, arguments->width);
+    show_phases(phases);
+    gt_xgetrusage(RUSAGE_SELF, &ru);
+    printf("# maximum resident set size in megabytes: %.2f\n",
+           (double) ru.ru_maxrss / (1 << 10));
+  }
+
+  for (i = 0; i < gt_array_size(nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(nodes, i));
+  gt_feature_index_delete(features);
+  gt_style_delete(sty);
+  gt_str_delete(stylefile);
+  gt_feature_index_release_features(results);
+  gt_array_delete(results);
+  gt_array_delete(nodes);
+  gt_timer_delete(mark.timer);
+  return had_err;
+}
+
+GtTool* gt_sketchbench(void)
+{
+  return gt_tool_new(gt_sketchbench_arguments_new,
+                     gt_sketchbench_arguments_delete,
+                     gt_sketchbench_option_parser_new,
+                     NULL,
+                     gt_sketchbench_runner);
+}
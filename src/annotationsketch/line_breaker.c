@@ -29,18 +29,21 @@ struct GtLineBreakerClass {
   size_t size;
   GtLineBreakerIsOccupiedFunc is_occupied;
   GtLineBreakerRegisterBlockFunc register_block;
+  GtLineBreakerOccupiedRangeFunc occupied_range;
   GtLineBreakerFreeFunc free;
 };
 
 const GtLineBreakerClass* gt_line_breaker_class_new(size_t size,
                                   GtLineBreakerIsOccupiedFunc is_occupied,
                                   GtLineBreakerRegisterBlockFunc register_block,
+                                  GtLineBreakerOccupiedRangeFunc occupied_range,
                                   GtLineBreakerFreeFunc free)
 {
   GtLineBreakerClass *c_class = gt_class_alloc(sizeof *c_class);
   c_class->size = size;
   c_class->is_occupied = is_occupied;
   c_class->register_block = register_block;
+  c_class->occupied_range = occupied_range;
   c_class->free = free;
   return c_class;
 }
@@ -90,6 +93,15 @@ void gt_line_breaker_register_block(GtLineBreaker *lb, GtLine *line,
   lb->c_class->register_block(lb, line, block);
 }
 
+bool gt_line_breaker_get_occupied_range(GtLineBreaker *lb, GtBlock *block,
+                                        double *start, double *end)
+{
+  gt_assert(lb && lb->c_class && block && start && end);
+  if (!lb->c_class->occupied_range)
+    return false;
+  return lb->c_class->occupied_range(lb, block, start, end);
+}
+
 void* gt_line_breaker_cast(GT_UNUSED const GtLineBreakerClass *lbc,
                            GtLineBreaker *lb)
 {
@@ -30,6 +30,13 @@ bool           gt_line_breaker_line_is_occupied(GtLineBreaker *lb, GtLine *line,
                                                 GtBlock *block);
 void           gt_line_breaker_register_block(GtLineBreaker *lb, GtLine *line,
                                               GtBlock *block);
+/* Returns false if occupation of a line by <lb> cannot be expressed by a
+   single number per line. Otherwise true is returned and <block> is described
+   by <start> and <end>: a line is occupied for <block> if and only if the <end>
+   of the block registered last on it is not smaller than <start>. */
+bool           gt_line_breaker_get_occupied_range(GtLineBreaker *lb,
+                                                  GtBlock *block,
+                                                  double *start, double *end);
 void           gt_line_breaker_delete(GtLineBreaker*);
 
 #endif
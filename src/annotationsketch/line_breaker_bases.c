@@ -80,6 +80,7 @@ const GtLineBreakerClass* gt_line_breaker_bases_class(void)
     lbc = gt_line_breaker_class_new(sizeof (GtLineBreakerBases),
                                     gt_line_breaker_bases_is_line_occupied,
                                     gt_line_breaker_bases_register_block,
+                                    NULL,
                                     gt_line_breaker_bases_delete);
   }
   return lbc;
@@ -91,6 +91,20 @@ void gt_line_breaker_captions_register_block(GtLineBreaker *lb,
   *num = floor(dr.end);
 }
 
+bool gt_line_breaker_captions_get_occupied_range(GtLineBreaker *lb,
+                                                GtBlock *block,
+                                                double *start, double *end)
+{
+  GtDrawingRange dr;
+  GtLineBreakerCaptions *lbcap;
+  gt_assert(lb && block && start && end);
+  lbcap = gt_line_breaker_captions_cast(lb);
+  dr = calculate_drawing_range(lbcap, block);
+  *start = dr.start;
+  *end = floor(dr.end);
+  return true;
+}
+
 void gt_line_breaker_captions_delete(GtLineBreaker *lb)
 {
   GtLineBreakerCaptions *lbcap;
@@ -107,6 +121,7 @@ const GtLineBreakerClass* gt_line_breaker_captions_class(void)
     lbc = gt_line_breaker_class_new(sizeof (GtLineBreakerCaptions),
                                    gt_line_breaker_captions_is_line_occupied,
                                    gt_line_breaker_captions_register_block,
+                                   gt_line_breaker_captions_get_occupied_range,
                                    gt_line_breaker_captions_delete);
   }
   return lbc;
@@ -24,6 +24,8 @@
 typedef bool (*GtLineBreakerIsOccupiedFunc)(GtLineBreaker*, GtLine*, GtBlock*);
 typedef void (*GtLineBreakerRegisterBlockFunc)(GtLineBreaker*, GtLine*,
                                                GtBlock*);
+typedef bool (*GtLineBreakerOccupiedRangeFunc)(GtLineBreaker*, GtBlock*,
+                                               double *start, double *end);
 typedef void (*GtLineBreakerFreeFunc)(GtLineBreaker*);
 
 typedef struct GtLineBreakerMembers GtLineBreakerMembers;
@@ -36,6 +38,7 @@ struct GtLineBreaker {
 const GtLineBreakerClass* gt_line_breaker_class_new(size_t size,
                                   GtLineBreakerIsOccupiedFunc is_occupied,
                                   GtLineBreakerRegisterBlockFunc register_block,
+                                  GtLineBreakerOccupiedRangeFunc occupied_range,
                                   GtLineBreakerFreeFunc free);
 GtLineBreaker* gt_line_breaker_create(const GtLineBreakerClass*);
 void*          gt_line_breaker_cast(const GtLineBreakerClass*,
@@ -25,20 +25,43 @@
 #include "core/assert_api.h"
 #include "core/cstr.h"
 #include "core/ensure.h"
+#include "core/hashmap.h"
 #include "core/log.h"
 #include "core/ma.h"
 #include "core/unused_api.h"
 #include "core/warning_api.h"
+#include "extended/feature_node.h"
+#include "extended/feature_type.h"
 #include "extended/luahelper.h"
 #include "extended/luaserialize.h"
 #include "gtlua/genome_node_lua.h"
 #include "gtlua/gt_lua.h"
 
+/* Flags describing which getters a compiled style value can answer. */
+#define STYLE_VALUE_COLOR     1U
+#define STYLE_VALUE_STR       2U
+#define STYLE_VALUE_NUM       4U
+#define STYLE_VALUE_BOOL      8U
+#define STYLE_VALUE_FUNCTION 16U
+
+/* A static value of a style section, resolved from the Lua table once. */
+typedef struct {
+  unsigned int flags;
+  GtColor color;
+  char *str;
+  double num;
+  bool bool_val;
+} StyleValue;
+
 struct GtStyle
 {
   lua_State *L;
   unsigned long reference_count;
   char *filename;
+  /* maps section names to hashmaps from keys to <StyleValue>s, NULL if the
+     Lua state is shared and may be changed behind our back */
+  GtHashmap *compiled;
+  GtTextWidthCache *text_widths;
 };
 
 static void style_lua_new_table(lua_State *L, const char *key)
@@ -84,6 +107,8 @@ GtStyle* gt_style_new(GtError *err)
   }
   else
     luaL_opensecurelibs(sty->L); /* do not replace with luaL_openlibs()! */
+  sty->compiled = gt_hashmap_new(HASH_STRING, gt_free_func,
+                                 (GtFree) gt_hashmap_delete);
   return sty;
 }
 
@@ -103,6 +128,18 @@ GtStyle* gt_style_ref(GtStyle *style)
   return style;
 }
 
+/* Drops the compiled values of <section>, or all of them if it is NULL. */
+static void style_invalidate(GtStyle *sty, const char *section)
+{
+  gt_assert(sty);
+  if (!sty->compiled)
+    return;
+  if (section)
+    gt_hashmap_remove(sty->compiled, section);
+  else
+    gt_hashmap_reset(sty->compiled);
+}
+
 int gt_style_load_file(GtStyle *sty, const char *filename, GtError *err)
 {
 #ifndef NDEBUG
@@ -114,7 +151,11 @@ int gt_style_load_file(GtStyle *sty, const char *filename, GtError *err)
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
-  sty->filename = gt_cstr_dup(filename);
+  if (sty->filename != filename) {
+    gt_free(sty->filename);
+    sty->filename = gt_cstr_dup(filename);
+  }
+  style_invalidate(sty, NULL);
   gt_log_log("Trying to load style file: %s...", filename);
   if (luaL_loadfile(sty->L, filename) || lua_pcall(sty->L, 0, 0, 0)) {
     gt_error_set(err, "cannot run style file: %s",
@@ -189,6 +230,100 @@ static int style_find_section_for_getting(const GtStyle *sty,
   return depth;
 }
 
+static void style_value_delete(StyleValue *value)
+{
+  if (!value) return;
+  gt_free(value->str);
+  gt_free(value);
+}
+
+static void style_compile_color(lua_State *L, GtColor *color)
+{
+  color->red = 0.5; color->green = 0.5; color->blue = 0.5; color->alpha = 0.5;
+  lua_getfield(L, -1, "red");
+  if (lua_isnumber(L, -1))
+    color->red = lua_tonumber(L, -1);
+  lua_pop(L, 1);
+  lua_getfield(L, -1, "green");
+  if (lua_isnumber(L, -1))
+    color->green = lua_tonumber(L, -1);
+  lua_pop(L, 1);
+  lua_getfield(L, -1, "blue");
+  if (lua_isnumber(L, -1))
+    color->blue = lua_tonumber(L, -1);
+  lua_pop(L, 1);
+  lua_getfield(L, -1, "alpha");
+  if (lua_isnumber(L, -1))
+    color->alpha = lua_tonumber(L, -1);
+  lua_pop(L, 1);
+}
+
+/* Resolves all values of <section> into a hashmap from keys to <StyleValue>s.
+   Values which are functions are only marked as such, they have to be
+   evaluated in Lua for every feature. */
+static GtHashmap* style_compile_section(const GtStyle *sty, const char *section)
+{
+  GtHashmap *values;
+  lua_State *L = sty->L;
+  gt_assert(sty && section);
+  values = gt_hashmap_new(HASH_STRING, gt_free_func,
+                          (GtFree) style_value_delete);
+  if (style_find_section_for_getting(sty, section) < 0)
+    return values;
+  lua_pushnil(L);
+  while (lua_next(L, -2)) {
+    if (lua_type(L, -2) == LUA_TSTRING) {
+      StyleValue *value = gt_calloc(1, sizeof (StyleValue));
+      switch (lua_type(L, -1)) {
+        case LUA_TFUNCTION:
+          value->flags = STYLE_VALUE_FUNCTION;
+          break;
+        case LUA_TTABLE:
+          value->flags = STYLE_VALUE_COLOR;
+          style_compile_color(L, &value->color);
+          break;
+        case LUA_TBOOLEAN:
+          value->flags = STYLE_VALUE_BOOL;
+          value->bool_val = lua_toboolean(L, -1);
+          break;
+        case LUA_TNUMBER:
+        case LUA_TSTRING:
+          /* convert a copy, lua_tostring() must not touch the table value */
+          lua_pushvalue(L, -1);
+          value->flags = STYLE_VALUE_STR;
+          value->str = gt_cstr_dup(lua_tostring(L, -1));
+          lua_pop(L, 1);
+          if (lua_isnumber(L, -1)) {
+            value->flags |= STYLE_VALUE_NUM;
+            value->num = lua_tonumber(L, -1);
+          }
+          break;
+      }
+      if (value->flags)
+        gt_hashmap_add(values, gt_cstr_dup(lua_tostring(L, -2)), value);
+      else
+        style_value_delete(value);
+    }
+    lua_pop(L, 1);
+  }
+  lua_pop(L, 2);
+  return values;
+}
+
+/* Returns the compiled value of <key> in <section> or NULL if it is not set.
+   Sections are compiled on first access. */
+static StyleValue* style_get_compiled(const GtStyle *sty, const char *section,
+                                      const char *key)
+{
+  GtHashmap *values;
+  gt_assert(sty && sty->compiled && section && key);
+  if (!(values = gt_hashmap_get(sty->compiled, section))) {
+    values = style_compile_section(sty, section);
+    gt_hashmap_add(sty->compiled, gt_cstr_dup(section), values);
+  }
+  return gt_hashmap_get(values, key);
+}
+
 bool gt_style_get_color(const GtStyle *sty, const char *section,
                         const char *key, GtColor *color, GtFeatureNode *gn)
 {
@@ -200,6 +335,18 @@ bool gt_style_get_color(const GtStyle *sty, const char *section,
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  if (sty->compiled) {
+    StyleValue *value = style_get_compiled(sty, section, key);
+    if (!value || !(value->flags & STYLE_VALUE_FUNCTION) || !gn) {
+      if (value && (value->flags & STYLE_VALUE_COLOR)) {
+        *color = value->color;
+        return true;
+      }
+      color->red = 0.5; color->green = 0.5; color->blue = 0.5;
+      color->alpha = 0.5;
+      return false;
+    }
+  }
   /* set default colors */
   color->red = 0.5; color->green = 0.5; color->blue = 0.5; color->alpha = 0.5;
   /* get section */
@@ -264,6 +411,7 @@ void gt_style_set_color(GtStyle *sty, const char *section, const char *key,
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  style_invalidate(sty, section);
   i = style_find_section_for_setting(sty, section);
   lua_getfield(sty->L, -1, key);
   i++;
@@ -296,6 +444,16 @@ bool gt_style_get_str(const GtStyle *sty, const char *section,
 #endif
   int i = 0;
   gt_assert(sty && key && section);
+  if (sty->compiled) {
+    StyleValue *value = style_get_compiled(sty, section, key);
+    if (!value || !(value->flags & STYLE_VALUE_FUNCTION) || !gn) {
+      if (value && (value->flags & STYLE_VALUE_STR)) {
+        gt_str_set(text, value->str);
+        return true;
+      }
+      return false;
+    }
+  }
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
@@ -346,6 +504,7 @@ void gt_style_set_str(GtStyle *sty, const char *section, const char *key,
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  style_invalidate(sty, section);
   i = style_find_section_for_setting(sty, section);
   lua_pushstring(sty->L, key);
   lua_pushstring(sty->L, gt_str_get(value));
@@ -362,6 +521,16 @@ bool gt_style_get_num(const GtStyle *sty, const char *section, const char *key,
 #endif
   int i = 0;
   gt_assert(sty && key && section && val);
+  if (sty->compiled) {
+    StyleValue *value = style_get_compiled(sty, section, key);
+    if (!value || !(value->flags & STYLE_VALUE_FUNCTION) || !gn) {
+      if (value && (value->flags & STYLE_VALUE_NUM)) {
+        *val = value->num;
+        return true;
+      }
+      return false;
+    }
+  }
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
@@ -412,6 +581,7 @@ void gt_style_set_num(GtStyle *sty, const char *section, const char *key,
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  style_invalidate(sty, section);
   i = style_find_section_for_setting(sty, section);
   lua_pushstring(sty->L, key);
   lua_pushnumber(sty->L, number);
@@ -428,6 +598,14 @@ bool gt_style_get_bool(const GtStyle *sty, const char *section,
 #endif
   int i = 0;
   gt_assert(sty && key && section);
+  if (sty->compiled) {
+    StyleValue *value = style_get_compiled(sty, section, key);
+    if (value && (value->flags & STYLE_VALUE_BOOL)) {
+      *val = value->bool_val;
+      return true;
+    }
+    return false;
+  }
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
@@ -464,6 +642,7 @@ void gt_style_set_bool(GtStyle *sty, const char *section, const char *key,
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  style_invalidate(sty, section);
   i = style_find_section_for_setting(sty, section);
   lua_pushstring(sty->L, key);
   lua_pushboolean(sty->L, val);
@@ -481,6 +660,7 @@ void gt_style_unset(GtStyle *sty, const char *section, const char *key)
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);
 #endif
+  style_invalidate(sty, section);
   lua_getglobal(sty->L, "style");
   if (!lua_isnil(sty->L, -1)) {
     gt_assert(lua_istable(sty->L, -1));
@@ -497,6 +677,14 @@ void gt_style_unset(GtStyle *sty, const char *section, const char *key)
   gt_assert(lua_gettop(sty->L) == stack_size);
 }
 
+GtTextWidthCache* gt_style_get_text_width_cache(GtStyle *sty)
+{
+  gt_assert(sty);
+  if (!sty->text_widths)
+    sty->text_widths = gt_text_width_cache_new(GT_TEXT_WIDTH_CACHE_SIZE);
+  return sty->text_widths;
+}
+
 int gt_style_to_str(const GtStyle *sty, GtStr *outstr, GtError *err)
 {
 #ifndef NDEBUG
@@ -534,6 +722,7 @@ int gt_style_load_str(GtStyle *sty, GtStr *instr, GtError *err)
 #ifndef NDEBUG
   stack_size = lua_gettop(sty->L);;
 #endif
+  style_invalidate(sty, NULL);
   if (luaL_loadbuffer(sty->L, gt_str_get(instr), gt_str_length(instr), "str") ||
       lua_pcall(sty->L, 0, 0, 0)) {
     gt_error_set(err, "cannot run style buffer: %s",
@@ -647,6 +836,54 @@ int gt_style_unit_test(GtError *err)
       gt_str_set(str, "");
     ensure(had_err, (strcmp(gt_str_get(str),"")==0));
   }
+  /* compiled values follow later changes and evaluate functions per node */
+  if (!had_err) {
+    GtGenomeNode *exon, *gene;
+    GtStr *seqid = gt_str_new_cstr("seq"),
+          *code = gt_str_new_cstr("style = { exon = { bar_height = \"12\",\n"
+                                  "  fill = function(gn)\n"
+                                  "    if gn:get_strand() == \"+\" then\n"
+                                  "      return {red=1.0, green=1.0,"
+                                  " blue=1.0}\n"
+                                  "    end\n"
+                                  "  end,\n"
+                                  "  stroke_width = function(gn)\n"
+                                  "    return 3\n"
+                                  "  end } }");
+    exon = gt_feature_node_new(seqid, gt_ft_exon, 1, 10, GT_STRAND_FORWARD);
+    gene = gt_feature_node_new(seqid, gt_ft_gene, 1, 10, GT_STRAND_REVERSE);
+    had_err = gt_style_load_str(sty, code, err);
+    ensure(had_err, !gt_style_get_num(sty, "format", "margins", &num, NULL));
+    ensure(had_err, gt_style_get_num(sty, "exon", "bar_height", &num, NULL));
+    ensure(had_err, num == 12.0);
+    ensure(had_err, gt_style_get_str(sty, "exon", "bar_height", str, NULL));
+    ensure(had_err, strcmp(gt_str_get(str), "12") == 0);
+    ensure(had_err, !gt_style_get_color(sty, "exon", "fill", &tmpcol, NULL));
+    ensure(had_err, gt_color_equals(&tmpcol, &defcol));
+    ensure(had_err, gt_style_get_color(sty, "exon", "fill", &tmpcol,
+                                       (GtFeatureNode*) exon));
+    ensure(had_err, gt_color_equals(&tmpcol, &col));
+    ensure(had_err, !gt_style_get_color(sty, "exon", "fill", &tmpcol,
+                                        (GtFeatureNode*) gene));
+    ensure(had_err, gt_style_get_num(sty, "exon", "stroke_width", &num,
+                                     (GtFeatureNode*) gene));
+    ensure(had_err, num == 3.0);
+    gt_style_set_num(sty, "exon", "bar_height", 20.0);
+    ensure(had_err, gt_style_get_num(sty, "exon", "bar_height", &num, NULL));
+    ensure(had_err, num == 20.0);
+    gt_style_set_bool(sty, "exon", "collapse_to_parent", true);
+    ensure(had_err, gt_style_get_bool(sty, "exon", "collapse_to_parent", &val,
+                                      NULL));
+    ensure(had_err, val);
+    gt_style_unset(sty, "exon", "collapse_to_parent");
+    ensure(had_err, !gt_style_get_bool(sty, "exon", "collapse_to_parent", &val,
+                                       NULL));
+    gt_genome_node_delete(exon);
+    gt_genome_node_delete(gene);
+    gt_str_delete(code);
+    gt_str_delete(seqid);
+  }
+
   /* mem cleanup */
   gt_str_delete(test1);
   gt_str_delete(str);
@@ -665,6 +902,8 @@ void gt_style_delete_without_state(GtStyle *sty)
     sty->reference_count--;
     return;
   }
+  gt_hashmap_delete(sty->compiled);
+  gt_text_width_cache_delete(sty->text_widths);
   gt_free(sty->filename);
   gt_free(sty);
 }
@@ -21,6 +21,7 @@
 
 #include "lua.h"
 #include "annotationsketch/style_api.h"
+#include "annotationsketch/text_width_cache.h"
 #include "extended/genome_node.h"
 
 /* Creates a GtStyle object wich reuses the given Lua state. */
@@ -41,6 +42,9 @@ bool           gt_style_get_num(const GtStyle*, const char *section,
    If not set, false is returned.*/
 bool           gt_style_get_bool(const GtStyle*, const char *section,
                                  const char *key, bool*, GtFeatureNode*);
+/* Returns the cache for caption widths measured with this style, shared by
+   all text width calculators using it. */
+GtTextWidthCache* gt_style_get_text_width_cache(GtStyle*);
 int            gt_style_unit_test(GtError*);
 /* Deletes a GT_Style object but leaves the internal Lua state intact. */
 void           gt_style_delete_without_state(GtStyle*);
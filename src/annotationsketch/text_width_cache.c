@@ -0,0 +1,193 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "annotationsketch/text_width_cache.h"
+#include "core/array.h"
+#include "core/cstr.h"
+#include "core/ensure.h"
+#include "core/hashmap.h"
+#include "core/log.h"
+#include "core/ma.h"
+
+/* the cached widths of all texts measured in one font size */
+typedef struct {
+  double size;
+  GtHashmap *widths;
+} TextWidthCacheSize;
+
+struct GtTextWidthCache {
+  GtArray *sizes;
+  unsigned long max_entries,
+                nof_entries,
+                hits,
+                misses,
+                reference_count;
+};
+
+GtTextWidthCache* gt_text_width_cache_new(unsigned long max_entries)
+{
+  GtTextWidthCache *cache;
+  gt_assert(max_entries);
+  cache = gt_calloc(1, sizeof (GtTextWidthCache));
+  cache->sizes = gt_array_new(sizeof (TextWidthCacheSize));
+  cache->max_entries = max_entries;
+  return cache;
+}
+
+GtTextWidthCache* gt_text_width_cache_ref(GtTextWidthCache *cache)
+{
+  gt_assert(cache);
+  cache->reference_count++;
+  return cache;
+}
+
+/* Returns the widths for font size <size>, or NULL if there are none. Usually
+   only very few different font sizes are used, so a linear scan suffices. */
+static GtHashmap* text_width_cache_widths(const GtTextWidthCache *cache,
+                                          double size)
+{
+  unsigned long i;
+  for (i = 0; i < gt_array_size(cache->sizes); i++) {
+    TextWidthCacheSize *s = gt_array_get(cache->sizes, i);
+    if (s->size == size)
+      return s->widths;
+  }
+  return NULL;
+}
+
+bool gt_text_width_cache_get(GtTextWidthCache *cache, double size,
+                             const char *text, double *width)
+{
+  GtHashmap *widths;
+  double *w;
+  gt_assert(cache && text && width);
+  if ((widths = text_width_cache_widths(cache, size))
+        && (w = gt_hashmap_get(widths, text))) {
+    cache->hits++;
+    *width = *w;
+    return true;
+  }
+  cache->misses++;
+  return false;
+}
+
+void gt_text_width_cache_add(GtTextWidthCache *cache, double size,
+                             const char *text, double width)
+{
+  GtHashmap *widths;
+  double *w;
+  gt_assert(cache && text);
+  if (cache->nof_entries == cache->max_entries)
+    gt_text_width_cache_reset(cache);
+  if (!(widths = text_width_cache_widths(cache, size))) {
+    TextWidthCacheSize s;
+    s.size = size;
+    s.widths = widths = gt_hashmap_new(HASH_STRING, gt_free_func,
+                                       gt_free_func);
+    gt_array_add(cache->sizes, s);
+  }
+  if ((w = gt_hashmap_get(widths, text))) {
+    *w = width;
+    return;
+  }
+  w = gt_malloc(sizeof (double));
+  *w = width;
+  gt_hashmap_add(widths, gt_cstr_dup(text), w);
+  cache->nof_entries++;
+}
+
+unsigned long gt_text_width_cache_size(const GtTextWidthCache *cache)
+{
+  gt_assert(cache);
+  return cache->nof_entries;
+}
+
+unsigned long gt_text_width_cache_hits(const GtTextWidthCache *cache)
+{
+  gt_assert(cache);
+  return cache->hits;
+}
+
+unsigned long gt_text_width_cache_misses(const GtTextWidthCache *cache)
+{
+  gt_assert(cache);
+  return cache->misses;
+}
+
+void gt_text_width_cache_reset(GtTextWidthCache *cache)
+{
+  unsigned long i;
+  gt_assert(cache);
+  for (i = 0; i < gt_array_size(cache->sizes); i++) {
+    TextWidthCacheSize *s = gt_array_get(cache->sizes, i);
+    gt_hashmap_delete(s->widths);
+  }
+  gt_array_reset(cache->sizes);
+  cache->nof_entries = 0;
+}
+
+int gt_text_width_cache_unit_test(GtError *err)
+{
+  GtTextWidthCache *cache;
+  double width = 0.0;
+  int had_err = 0;
+  gt_error_check(err);
+
+  cache = gt_text_width_cache_new(3);
+  ensure(had_err, !gt_text_width_cache_get(cache, 8.0, "gene", &width));
+  gt_text_width_cache_add(cache, 8.0, "gene", 20.0);
+  gt_text_width_cache_add(cache, 10.0, "gene", 25.0);
+  ensure(had_err, gt_text_width_cache_get(cache, 8.0, "gene", &width));
+  ensure(had_err, width == 20.0);
+  ensure(had_err, gt_text_width_cache_get(cache, 10.0, "gene", &width));
+  ensure(had_err, width == 25.0);
+  ensure(had_err, !gt_text_width_cache_get(cache, 8.0, "exon", &width));
+  ensure(had_err, gt_text_width_cache_hits(cache) == 2);
+  ensure(had_err, gt_text_width_cache_misses(cache) == 2);
+
+  /* updating an entry does not count against the bound */
+  gt_text_width_cache_add(cache, 8.0, "gene", 21.0);
+  ensure(had_err, gt_text_width_cache_size(cache) == 2);
+  ensure(had_err, gt_text_width_cache_get(cache, 8.0, "gene", &width));
+  ensure(had_err, width == 21.0);
+
+  /* exceeding the bound empties the cache */
+  gt_text_width_cache_add(cache, 8.0, "exon", 20.0);
+  ensure(had_err, gt_text_width_cache_size(cache) == 3);
+  gt_text_width_cache_add(cache, 8.0, "mRNA", 20.0);
+  ensure(had_err, gt_text_width_cache_size(cache) == 1);
+  ensure(had_err, !gt_text_width_cache_get(cache, 8.0, "gene", &width));
+  ensure(had_err, gt_text_width_cache_get(cache, 8.0, "mRNA", &width));
+
+  gt_text_width_cache_delete(cache);
+  return had_err;
+}
+
+void gt_text_width_cache_delete(GtTextWidthCache *cache)
+{
+  if (!cache) return;
+  if (cache->reference_count) {
+    cache->reference_count--;
+    return;
+  }
+  gt_log_log("text width cache: %lu hits, %lu misses", cache->hits,
+             cache->misses);
+  gt_text_width_cache_reset(cache);
+  gt_array_delete(cache->sizes);
+  gt_free(cache);
+}
@@ -0,0 +1,59 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef TEXT_WIDTH_CACHE_H
+#define TEXT_WIDTH_CACHE_H
+
+#include <stdbool.h>
+#include "core/error_api.h"
+
+/* A <GtTextWidthCache> memoizes text widths measured by a drawing backend,
+   keyed by font size and text. Captions like gene names and feature types
+   repeat very often, so most measurements can be answered from the cache.
+   The number of cached widths is bounded, when the bound is reached the cache
+   starts over empty. */
+typedef struct GtTextWidthCache GtTextWidthCache;
+
+/* The default number of widths held by a <GtTextWidthCache>. */
+#define GT_TEXT_WIDTH_CACHE_SIZE 65536UL
+
+/* Creates a new <GtTextWidthCache> holding at most <max_entries> widths. */
+GtTextWidthCache* gt_text_width_cache_new(unsigned long max_entries);
+/* Increases the reference count of <cache>. */
+GtTextWidthCache* gt_text_width_cache_ref(GtTextWidthCache *cache);
+/* Looks up the width of <text> in font size <size>. Returns true and writes
+   the width to <width> if it is cached, false otherwise. */
+bool              gt_text_width_cache_get(GtTextWidthCache *cache,
+                                          double size, const char *text,
+                                          double *width);
+/* Stores <width> as the width of <text> in font size <size>. */
+void              gt_text_width_cache_add(GtTextWidthCache *cache,
+                                          double size, const char *text,
+                                          double width);
+/* Returns the number of cached widths. */
+unsigned long     gt_text_width_cache_size(const GtTextWidthCache *cache);
+/* Returns the number of lookups answered from <cache>. */
+unsigned long     gt_text_width_cache_hits(const GtTextWidthCache *cache);
+/* Returns the number of lookups not answered from <cache>. */
+unsigned long     gt_text_width_cache_misses(const GtTextWidthCache *cache);
+/* Removes all widths from <cache>. */
+void              gt_text_width_cache_reset(GtTextWidthCache *cache);
+int               gt_text_width_cache_unit_test(GtError*);
+/* Deletes <cache>. */
+void              gt_text_width_cache_delete(GtTextWidthCache *cache);
+
+#endif
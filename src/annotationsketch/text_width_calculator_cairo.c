@@ -21,6 +21,7 @@
 #include "core/unused_api.h"
 #include "annotationsketch/default_formats.h"
 #include "annotationsketch/style.h"
+#include "annotationsketch/text_width_cache.h"
 #include "annotationsketch/text_width_calculator.h"
 #include "annotationsketch/text_width_calculator_cairo.h"
 #include "annotationsketch/text_width_calculator_rep.h"
@@ -34,6 +35,7 @@ struct GtTextWidthCalculatorCairo {
   GtStyle *style;
   cairo_t *context;
   cairo_surface_t *mysurf;
+  GtTextWidthCache *cache;
   bool own_context;
 };
 
@@ -45,14 +47,17 @@ double gt_text_width_calculator_cairo_get_text_width(GtTextWidthCalculator *twc,
                                                      const char *text)
 {
   GtTextWidthCalculatorCairo *twcc;
-  double theight = TOY_TEXT_HEIGHT;
+  double theight = TOY_TEXT_HEIGHT, width;
   cairo_text_extents_t ext;
   gt_assert(twc && text);
   twcc = gt_text_width_calculator_cairo_cast(twc);
   if (twcc->style)
-  {
     (void) gt_style_get_num(twcc->style, "format", "block_caption_font_size",
                             &theight, NULL);
+  if (gt_text_width_cache_get(twcc->cache, theight, text, &width))
+    return width;
+  if (twcc->style)
+  {
     cairo_save(twcc->context);
     cairo_set_font_size(twcc->context, theight);
   }
@@ -60,6 +65,7 @@ double gt_text_width_calculator_cairo_get_text_width(GtTextWidthCalculator *twc,
   cairo_text_extents(twcc->context, text, &ext);
   if (twcc->style)
     cairo_restore(twcc->context);
+  gt_text_width_cache_add(twcc->cache, theight, text, ext.width);
   return ext.width;
 }
 
@@ -68,6 +74,7 @@ void gt_text_width_calculator_cairo_delete(GtTextWidthCalculator *twc)
   GtTextWidthCalculatorCairo *twcc;
   if (!twc) return;
   twcc = gt_text_width_calculator_cairo_cast(twc);
+  gt_text_width_cache_delete(twcc->cache);
   if (twcc->style)
     gt_style_delete(twcc->style);
   if (twcc->own_context)
@@ -109,6 +116,12 @@ GtTextWidthCalculator* gt_text_width_calculator_cairo_new(cairo_t *context,
     twcc->context = context;
     twcc->own_context = false;
   }
+  /* widths measured on our own surface only depend on the font size, so they
+     can be shared by all calculators using the same style */
+  if (twcc->own_context && style)
+    twcc->cache = gt_text_width_cache_ref(gt_style_get_text_width_cache(style));
+  else
+    twcc->cache = gt_text_width_cache_new(GT_TEXT_WIDTH_CACHE_SIZE);
 
   return twc;
 }
@@ -16,14 +16,20 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <math.h>
+#include <string.h>
 #include "core/ensure.h"
 #include "core/hashtable.h"
 #include "core/ma.h"
+#include "core/minmax.h"
+#include "core/mathsupport.h"
 #include "core/undef.h"
 #include "core/unused_api.h"
 #include "annotationsketch/default_formats.h"
+#include "annotationsketch/layout.h"
 #include "annotationsketch/line.h"
 #include "annotationsketch/line_breaker_bases.h"
+#include "annotationsketch/line_breaker_captions.h"
 #include "annotationsketch/style.h"
 #include "annotationsketch/track.h"
 
@@ -34,6 +40,12 @@ struct GtTrack {
   bool split;
   unsigned long y_index;
   GtArray *lines;
+  /* tournament tree over the lines holding the minimum end of the blocks
+     registered last on them, if supported by the line breaker: node 1 is the
+     root, the children of node i are 2i and 2i+1, and line i is stored in
+     leaf nof_leaves + i */
+  double *line_ends;
+  unsigned long nof_leaves;
 };
 
 GtTrack* gt_track_new(GtStr *title, unsigned long max_num_lines,
@@ -52,17 +64,79 @@ GtTrack* gt_track_new(GtStr *title, unsigned long max_num_lines,
   return track;
 }
 
-static GtLine* get_next_free_line(GtTrack *track, GtBlock *block)
+/* Sets the end of line <lineno> to <end> and updates the tournament tree. */
+static void track_set_line_end(GtTrack *track, unsigned long lineno,
+                               double end)
 {
   unsigned long i;
-  GtLine* line;
   gt_assert(track);
+  if (lineno >= track->nof_leaves) {
+    /* double the number of leaves, unused leaves are never free */
+    unsigned long nof_leaves = track->nof_leaves ? 2 * track->nof_leaves : 16;
+    while (lineno >= nof_leaves)
+      nof_leaves *= 2;
+    track->line_ends = gt_realloc(track->line_ends,
+                                  2 * nof_leaves * sizeof (double));
+    if (track->nof_leaves) {
+      memmove(track->line_ends + nof_leaves,
+              track->line_ends + track->nof_leaves,
+              track->nof_leaves * sizeof (double));
+    }
+    for (i = nof_leaves + track->nof_leaves; i < 2 * nof_leaves; i++)
+      track->line_ends[i] = HUGE_VAL;
+    track->nof_leaves = nof_leaves;
+    for (i = nof_leaves - 1; i > 0; i--) {
+      track->line_ends[i] = MIN(track->line_ends[2*i],
+                                track->line_ends[2*i+1]);
+    }
+  }
+  i = track->nof_leaves + lineno;
+  track->line_ends[i] = end;
+  for (i /= 2; i > 0; i /= 2) {
+    track->line_ends[i] = MIN(track->line_ends[2*i],
+                              track->line_ends[2*i+1]);
+  }
+}
+
+/* Returns the first line whose end is smaller than <start>, or GT_UNDEF_ULONG
+   if there is none. */
+static unsigned long track_first_free_line(const GtTrack *track, double start)
+{
+  unsigned long i = 1;
+  gt_assert(track);
+  if (!track->nof_leaves || !(track->line_ends[1] < start))
+    return GT_UNDEF_ULONG;
+  while (i < track->nof_leaves)
+    i = track->line_ends[2*i] < start ? 2*i : 2*i + 1;
+  return i - track->nof_leaves;
+}
 
-  /* find unoccupied line -- may need optimisation */
-  for (i = 0; i < gt_array_size(track->lines); i++) {
-    line = *(GtLine**) gt_array_get(track->lines, i);
-    if (!gt_line_breaker_line_is_occupied(track->lb, line, block))
-      return line;
+/* Returns the first line <block> fits into, its index is stored in <lineno>.
+   If <start> is given, it is the start of the occupied range of <block> and
+   the line is looked up in the tournament tree instead of asking the line
+   breaker for every line. */
+static GtLine* get_next_free_line(GtTrack *track, GtBlock *block,
+                                  const double *start, unsigned long *lineno)
+{
+  unsigned long i;
+  GtLine* line;
+  gt_assert(track && lineno);
+
+  if (start) {
+    if ((i = track_first_free_line(track, *start)) != GT_UNDEF_ULONG) {
+      gt_assert(i < gt_array_size(track->lines));
+      *lineno = i;
+      return *(GtLine**) gt_array_get(track->lines, i);
+    }
+  }
+  else {
+    for (i = 0; i < gt_array_size(track->lines); i++) {
+      line = *(GtLine**) gt_array_get(track->lines, i);
+      if (!gt_line_breaker_line_is_occupied(track->lb, line, block)) {
+        *lineno = i;
+        return line;
+      }
+    }
   }
   /* if line limit is hit, do not create any more lines! */
   if (track->max_num_lines != GT_UNDEF_ULONG
@@ -82,11 +156,13 @@ static GtLine* get_next_free_line(GtTrack *track, GtBlock *block)
     else
       line = *(GtLine**) gt_array_get(track->lines, 0);
     gt_assert(gt_array_size(track->lines) == 1);
+    *lineno = 0;
   }
   else
   {
     line = gt_line_new();
     gt_array_add(track->lines, line);
+    *lineno = gt_array_size(track->lines) - 1;
   }
   gt_assert(line);
   return line;
@@ -113,13 +189,21 @@ unsigned long gt_track_get_number_of_discarded_blocks(GtTrack *track)
 void gt_track_insert_block(GtTrack *track, GtBlock *block)
 {
   GtLine *line;
+  unsigned long lineno;
+  double start, end;
+  bool has_range;
   gt_assert(track && block);
 
-  if ((line = get_next_free_line(track, block)))
+  has_range = gt_line_breaker_get_occupied_range(track->lb, block, &start,
+                                                 &end);
+  if ((line = get_next_free_line(track, block, has_range ? &start : NULL,
+                                 &lineno)))
   {
     block = gt_block_ref(block);
     gt_line_insert_block(line, block);
     gt_line_breaker_register_block(track->lb, line, block);
+    if (has_range)
+      track_set_line_end(track, lineno, end);
   };
 }
 
@@ -214,6 +298,11 @@ int gt_track_unit_test(GtError *err)
   GtStyle *sty;
   unsigned long i;
   GtLineBreaker *lb;
+  GtArray *features;
+  GtDiagram *d;
+  GtLayout *l;
+  GtStr *caption;
+  GtRange qr, br;
   double t_rest = TOY_TEXT_HEIGHT + CAPTION_BAR_SPACE_DEFAULT
                                   + TRACK_VSPACE_DEFAULT,
          l_rest =  BAR_VSPACE_DEFAULT;
@@ -289,6 +378,52 @@ int gt_track_unit_test(GtError *err)
   ensure(had_err, gt_track_get_number_of_discarded_blocks(track) == 0);
 
   gt_track_delete(track);
+
+  /* blocks inserted through the tournament tree end up in the same lines as
+     with a linear scan asking the captions line breaker for every line */
+  features = gt_array_new(sizeof (GtFeatureNode*));
+  qr.start = 1UL; qr.end = 100000UL;
+  d = gt_diagram_new_from_array(features, &qr, sty);
+  l = gt_layout_new(d, 800, sty, err);
+  ensure(had_err, l);
+  caption = gt_str_new_cstr("a caption wider than most blocks");
+  if (!had_err) {
+    track = gt_track_new(title, GT_UNDEF_ULONG, true,
+                         gt_line_breaker_captions_new(l, 800, sty));
+    br.start = qr.start;
+    for (i = 0; !had_err && i < 1000; i++) {
+      GtBlock *block = gt_block_new();
+      GtLine *line;
+      unsigned long j, expected;
+      br.start += gt_rand_max(50);
+      br.end = MIN(br.start + gt_rand_max(2000), qr.end);
+      gt_block_set_range(block, br);
+      if (i % 3 == 0)
+        gt_block_set_caption(block, gt_str_ref(caption));
+      expected = gt_array_size(track->lines);
+      for (j = 0; j < gt_array_size(track->lines); j++) {
+        line = *(GtLine**) gt_array_get(track->lines, j);
+        if (!gt_line_breaker_line_is_occupied(track->lb, line, block)) {
+          expected = j;
+          break;
+        }
+      }
+      gt_track_insert_block(track, block);
+      ensure(had_err, expected < gt_array_size(track->lines));
+      if (!had_err) {
+        line = *(GtLine**) gt_array_get(track->lines, expected);
+        ensure(had_err, *(GtBlock**) gt_array_get_last(gt_line_get_blocks(line))
+                          == block);
+      }
+      gt_block_delete(block);
+    }
+    ensure(had_err, gt_array_size(track->lines) > 1);
+    gt_track_delete(track);
+  }
+  gt_str_delete(caption);
+  gt_layout_delete(l);
+  gt_diagram_delete(d);
+  gt_array_delete(features);
   gt_str_delete(title);
   gt_style_delete(sty);
   for (i=0;i<4;i++)
@@ -308,6 +443,7 @@ void gt_track_delete(GtTrack *track)
   for (i = 0; i < gt_array_size(track->lines); i++)
     gt_line_delete(*(GtLine**) gt_array_get(track->lines, i));
   gt_array_delete(track->lines);
+  gt_free(track->line_ends);
   gt_str_delete(track->title);
   gt_free(track);
 }
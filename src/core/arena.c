@@ -0,0 +1,216 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <string.h>
+#include "core/arena.h"
+#include "core/assert_api.h"
+#include "core/ensure.h"
+#include "core/ma.h"
+
+#define ARENA_DEFAULT_BLOCK_SIZE  65536
+
+/* the alignment guaranteed for all objects allocated from an arena */
+typedef union {
+  long l;
+  double d;
+  void *p;
+} GtArenaAlign;
+
+#define ARENA_ALIGNMENT           sizeof (GtArenaAlign)
+#define ARENA_ALIGN(SIZE)         (((SIZE) + ARENA_ALIGNMENT - 1) & \
+                                   ~(ARENA_ALIGNMENT - 1))
+
+typedef struct GtArenaBlock GtArenaBlock;
+
+struct GtArenaBlock {
+  GtArenaBlock *next;
+  size_t size;
+};
+
+#define ARENA_BLOCK_HEADER        ARENA_ALIGN(sizeof (GtArenaBlock))
+
+struct GtArena {
+  GtArenaBlock *blocks; /* the first block is the current one */
+  char *next_free;
+  size_t block_size,
+         bytes_left;
+  unsigned long size,
+                capacity;
+  unsigned int reference_count;
+};
+
+GtArena* gt_arena_new(size_t block_size)
+{
+  GtArena *arena = gt_malloc(sizeof *arena);
+  arena->blocks = NULL;
+  arena->next_free = NULL;
+  arena->block_size = block_size ? ARENA_ALIGN(block_size)
+                                 : ARENA_DEFAULT_BLOCK_SIZE;
+  arena->bytes_left = 0;
+  arena->size = 0;
+  arena->capacity = 0;
+  arena->reference_count = 0;
+  return arena;
+}
+
+GtArena* gt_arena_ref(GtArena *arena)
+{
+  gt_assert(arena);
+#ifdef GT_THREADS_ENABLED
+  /* every node allocated from the arena holds a reference, and the nodes are
+     shared between threads which may delete them at the same time */
+  __sync_fetch_and_add(&arena->reference_count, 1);
+#else
+  arena->reference_count++;
+#endif
+  return arena;
+}
+
+static GtArenaBlock* arena_block_new(GtArena *arena, size_t size)
+{
+  GtArenaBlock *block = gt_malloc(ARENA_BLOCK_HEADER + size);
+  block->size = size;
+  arena->capacity += size;
+  return block;
+}
+
+void* gt_arena_malloc(GtArena *arena, size_t size)
+{
+  GtArenaBlock *block;
+  void *mem;
+  gt_assert(arena && size);
+  size = ARENA_ALIGN(size);
+  if (size > arena->bytes_left) {
+    if (size > arena->block_size / 4) {
+      /* large objects get a block of their own, which is put behind the
+         current block to keep its remaining space usable */
+      block = arena_block_new(arena, size);
+      if (arena->blocks) {
+        block->next = arena->blocks->next;
+        arena->blocks->next = block;
+      }
+      else {
+        block->next = NULL;
+        arena->blocks = block;
+      }
+      arena->size += size;
+      return (char*) block + ARENA_BLOCK_HEADER;
+    }
+    block = arena_block_new(arena, arena->block_size);
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->next_free = (char*) block + ARENA_BLOCK_HEADER;
+    arena->bytes_left = arena->block_size;
+  }
+  mem = arena->next_free;
+  arena->next_free += size;
+  arena->bytes_left -= size;
+  arena->size += size;
+  return mem;
+}
+
+void* gt_arena_calloc(GtArena *arena, size_t nmemb, size_t size)
+{
+  void *mem;
+  gt_assert(arena);
+  mem = gt_arena_malloc(arena, nmemb * size);
+  memset(mem, 0, nmemb * size);
+  return mem;
+}
+
+char* gt_arena_cstr_dup(GtArena *arena, const char *cstr)
+{
+  size_t length;
+  char *copy;
+  gt_assert(arena && cstr);
+  length = strlen(cstr);
+  copy = gt_arena_malloc(arena, length + 1);
+  memcpy(copy, cstr, length + 1);
+  return copy;
+}
+
+unsigned long gt_arena_size(const GtArena *arena)
+{
+  gt_assert(arena);
+  return arena->size;
+}
+
+unsigned long gt_arena_capacity(const GtArena *arena)
+{
+  gt_assert(arena);
+  return arena->capacity;
+}
+
+void gt_arena_delete(GtArena *arena)
+{
+  GtArenaBlock *block, *next;
+  if (!arena) return;
+#ifdef GT_THREADS_ENABLED
+  if (__sync_fetch_and_sub(&arena->reference_count, 1))
+    return;
+#else
+  if (arena->reference_count) {
+    arena->reference_count--;
+    return;
+  }
+#endif
+  for (block = arena->blocks; block != NULL; block = next) {
+    next = block->next;
+    gt_free(block);
+  }
+  gt_free(arena);
+}
+
+int gt_arena_unit_test(GtError *err)
+{
+  GtArena *arena;
+  unsigned long i;
+  char *cstr, *ptrs[1000];
+  void *large;
+  int had_err = 0;
+  gt_error_check(err);
+
+  arena = gt_arena_new(1024);
+  ensure(had_err, gt_arena_size(arena) == 0);
+  ensure(had_err, gt_arena_capacity(arena) == 0);
+
+  /* small objects are aligned and do not overlap */
+  for (i = 0; !had_err && i < 1000; i++) {
+    ptrs[i] = gt_arena_malloc(arena, i % 13 + 1);
+    ensure(had_err, (size_t) ptrs[i] % ARENA_ALIGNMENT == 0);
+    memset(ptrs[i], (int) (i % 256), i % 13 + 1);
+  }
+  for (i = 0; !had_err && i < 1000; i++)
+    ensure(had_err, ptrs[i][i % 13] == (char) (i % 256));
+  ensure(had_err, gt_arena_capacity(arena) >= gt_arena_size(arena));
+
+  /* large objects get their own block */
+  if (!had_err) {
+    large = gt_arena_calloc(arena, 1, 4096);
+    ensure(had_err, ((char*) large)[4095] == 0);
+  }
+
+  cstr = gt_arena_cstr_dup(arena, "foo bar");
+  ensure(had_err, !strcmp(cstr, "foo bar"));
+
+  /* reference counting */
+  gt_arena_ref(arena);
+  gt_arena_delete(arena);
+  ensure(had_err, !strcmp(cstr, "foo bar"));
+  gt_arena_delete(arena);
+
+  return had_err;
+}
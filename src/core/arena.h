@@ -0,0 +1,53 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include "core/error.h"
+
+/* A <GtArena> is a reference counted region allocator: Objects are carved out
+   of large memory blocks and cannot be freed individually. Instead, all
+   blocks are released at once when the last reference to the arena is
+   dropped. This saves most of the per-object <malloc(3)> overhead for large
+   numbers of small objects with a common lifetime (e.g., the nodes of
+   feature trees). References may be taken and dropped from several threads
+   at once, allocating from an arena is not thread-safe. */
+typedef struct GtArena GtArena;
+
+/* Return a new <GtArena> which allocates memory in blocks of <block_size>
+   bytes (if <block_size> equals 0 a default size is used). */
+GtArena*      gt_arena_new(size_t block_size);
+/* Increase the reference count of <arena>. */
+GtArena*      gt_arena_ref(GtArena *arena);
+/* Return <size> bytes of uninitialized memory from <arena>, aligned for all
+   basic types. */
+void*         gt_arena_malloc(GtArena *arena, size_t size);
+/* Like <gt_arena_malloc()>, but the returned memory is set to zero. */
+void*         gt_arena_calloc(GtArena *arena, size_t nmemb, size_t size);
+/* Return a copy of <cstr> which is allocated from <arena>. */
+char*         gt_arena_cstr_dup(GtArena *arena, const char *cstr);
+/* Return the number of bytes handed out by <arena> so far. */
+unsigned long gt_arena_size(const GtArena *arena);
+/* Return the number of bytes <arena> has allocated from the system. */
+unsigned long gt_arena_capacity(const GtArena *arena);
+/* Decrease the reference count of <arena> or free it (together with all
+   objects allocated from it) if it drops to zero. */
+void          gt_arena_delete(GtArena *arena);
+int           gt_arena_unit_test(GtError*);
+
+#endif
@@ -18,9 +18,9 @@
 #include "core/assert_api.h"
 #include "core/array.h"
 #include "core/bioseq.h"
-#include "core/cstr.h"
 #include "core/disc_distri.h"
 #include "core/dynalloc.h"
+#include "core/ensure.h"
 #include "core/error.h"
 #include "core/fa.h"
 #include "core/fasta.h"
@@ -28,98 +28,214 @@
 #include "core/fasta_reader_fsm.h"
 #include "core/fasta_reader_rec.h"
 #include "core/fasta_reader_seqit.h"
+#include "core/fasta_separator.h"
+#include "core/file.h"
 #include "core/fileutils_api.h"
 #include "core/gc_content.h"
 #include "core/grep_api.h"
 #include "core/ma.h"
 #include "core/md5_fingerprint.h"
-#include "core/parseutils.h"
-#include "core/range.h"
+#include "core/minmax.h"
 #include "core/sig.h"
 #include "core/str.h"
+#include "core/thread.h"
 #include "core/undef.h"
 #include "core/unused_api.h"
 #include "core/xansi.h"
 #include "core/xposix.h"
 
+/* length of an MD5 fingerprint in hexadecimal notation */
+#define GT_MD5_LENGTH 32
+/* the fingerprint file contains one '\0'-terminated record per sequence, so
+   that the fingerprints can be returned straight from the mapped file */
+#define GT_MD5_RECORD_LENGTH (GT_MD5_LENGTH + 1)
+
+/* The index file starts with this header, followed by the '\0'-terminated
+   descriptions (padded to a multiple of sizeof (unsigned long)), the start
+   positions of the sequences in the raw file and the start positions of the
+   descriptions. Both tables have <num_of_sequences> + 1 entries, the last
+   entry is the total length. The tables are stored in the native word size
+   and byte order, index files written on other platforms are constructed
+   again. */
+#define GT_BIOSEQ_INDEX_MAGIC "GTBSIv2"
+
+typedef struct {
+  char magic[8];
+  unsigned char word_size,  /* sizeof (unsigned long) */
+                big_endian,
+                reserved[6];
+  unsigned long num_of_sequences,
+                descriptions_length;
+} GtBioseqIndexHeader;
+
+#define GT_BIOSEQ_INDEX_PADDING(LEN)\
+        ((sizeof (unsigned long) - (LEN) % sizeof (unsigned long))\
+         % sizeof (unsigned long))
+
 typedef struct {
-  GtStrArray *md5_fingerprints;
+  char *md5_fingerprints; /* GT_MD5_RECORD_LENGTH bytes per sequence */
+  bool mapped;            /* <md5_fingerprints> is the mapped fingerprint file,
+                             otherwise they were computed */
 } GtBioseqFingerprints;
 
 struct GtBioseq {
   bool use_stdin;
   GtStr *sequence_file;
   GtSeq **seqs;
-  GtArray *descriptions,
-        *sequence_ranges;
+  unsigned long num_of_sequences;
+  const unsigned long *sequence_offsets,    /* point into the index file or */
+                      *description_offsets; /* the arrays below */
+  const char *descriptions;
+  void *index;                             /* mapped index file */
+  GtArray *sequence_offset_array,          /* used when reading from stdin */
+          *description_offset_array;
+  GtStr *description_array;
   char *raw_sequence;
   size_t raw_sequence_length,
-         allocated;
+         allocated,
+         index_length;
   GtAlphabet *alphabet;
   GtBioseqFingerprints *fingerprints;
+  GtMutex *fingerprints_mutex; /* the fingerprints are created on demand,
+                                  possibly by several threads */
 };
 
-static bool read_fingerprints(GtStrArray *md5_fingerprints,
+/* the parallel construction uses at least this many bytes per part */
+#define GT_BIOSEQ_MIN_PART_LENGTH (1UL << 20)
+
+/* returns the number of parts <length> bytes are split into */
+static unsigned long bioseq_nof_parts(unsigned long length)
+{
+  unsigned long nof_parts = length / GT_BIOSEQ_MIN_PART_LENGTH;
+  nof_parts = MIN(nof_parts, gt_thread_nof_processors());
+  return MAX(nof_parts, 1);
+}
+
+/* Stores in <bounds> the indices where <nof_parts> parts of roughly equal
+   length start, <offsets> has <n> + 1 ascending entries. <bounds>[<nof_parts>]
+   is set to <n>. */
+static void bioseq_split(unsigned long *bounds, const unsigned long *offsets,
+                         unsigned long n, unsigned long nof_parts)
+{
+  unsigned long i = 0, part;
+  for (part = 0; part < nof_parts; part++) {
+    unsigned long start = offsets[0] + (offsets[n] - offsets[0]) / nof_parts
+                                       * part;
+    while (i < n && offsets[i] < start)
+      i++;
+    bounds[part] = i;
+  }
+  bounds[nof_parts] = n;
+}
+
+/* Runs <function> for each of the <nof_parts> parts of <part_size> bytes at
+   <parts>. The first part is processed by the calling thread, every other part
+   by a thread of its own (or also by the calling thread, if no thread could be
+   started). */
+static void bioseq_run_parts(GtThreadFunc function, void *parts,
+                             size_t part_size, unsigned long nof_parts)
+{
+  GtThread **threads;
+  unsigned long i;
+  threads = gt_calloc(nof_parts, sizeof (GtThread*));
+  for (i = 1; i < nof_parts; i++) {
+    void *part = (char*) parts + i * part_size;
+    if (!(threads[i] = gt_thread_new(function, part, NULL)))
+      function(part);
+  }
+  function(parts);
+  for (i = 1; i < nof_parts; i++) {
+    if (threads[i])
+      gt_thread_join(threads[i]);
+  }
+  gt_free(threads);
+}
+
+static bool read_fingerprints(GtBioseqFingerprints *bsf,
                               GtStr  *fingerprints_filename,
                               unsigned long num_of_seqs)
 {
-  bool reading_succeeded = true;
-  FILE *fingerprint_file = NULL;
-  gt_assert(md5_fingerprints && fingerprints_filename);
-  /* open file */
-  if (gt_file_exists(gt_str_get(fingerprints_filename)))
-    fingerprint_file = gt_fa_xfopen(gt_str_get(fingerprints_filename), "r");
-  else
-    reading_succeeded = false;
-  /* reading file (each line contains a single MD5 sum) */
-  if (reading_succeeded) {
-    GtStr *line = gt_str_new();
-    while (gt_str_read_next_line(line, fingerprint_file) != EOF) {
-      gt_str_array_add(md5_fingerprints, line);
-      gt_str_reset(line);
-    }
-    gt_str_delete(line);
-    if (gt_str_array_size(md5_fingerprints) < num_of_seqs) {
-      /* premature end of file (e.g., due to aborted construction) */
-      reading_succeeded = false;
-      gt_str_array_set_size(md5_fingerprints, 0);
-    }
-    else
-      gt_assert(gt_str_array_size(md5_fingerprints) == num_of_seqs);
+  size_t fingerprint_file_length = 0;
+  gt_assert(bsf && fingerprints_filename);
+  if (!num_of_seqs)
+    return true;
+  bsf->md5_fingerprints = gt_fa_mmap_read(gt_str_get(fingerprints_filename),
+                                          &fingerprint_file_length);
+  if (!bsf->md5_fingerprints)
+    return false;
+  if (fingerprint_file_length != num_of_seqs * GT_MD5_RECORD_LENGTH ||
+      bsf->md5_fingerprints[fingerprint_file_length - 1] != '\0') {
+    /* premature end of file (e.g., due to aborted construction) or a file
+       with newline-terminated records written by an older version */
+    gt_fa_xmunmap(bsf->md5_fingerprints);
+    bsf->md5_fingerprints = NULL;
+    return false;
   }
-  gt_fa_xfclose(fingerprint_file);
-  return reading_succeeded;
+  bsf->mapped = true;
+  return true;
 }
 
-static void add_fingerprints(GtStrArray *md5_fingerprints, GtBioseq *bs)
+typedef struct {
+  GtBioseq *bs;
+  char *md5_fingerprints;
+  unsigned long first, last;
+} BioseqMD5Part;
+
+static void* compute_md5_part(void *data)
 {
+  BioseqMD5Part *part = data;
   unsigned long i;
-  gt_assert(md5_fingerprints && bs);
-  for (i = 0; i < gt_bioseq_number_of_sequences(bs); i++) {
-    char *md5 = gt_md5_fingerprint(gt_bioseq_get_sequence(bs, i),
-                                   gt_bioseq_get_sequence_length(bs, i));
-    gt_str_array_add_cstr(md5_fingerprints, md5);
+  for (i = part->first; i < part->last; i++) {
+    char *md5 = gt_md5_fingerprint(gt_bioseq_get_sequence(part->bs, i),
+                                   gt_bioseq_get_sequence_length(part->bs, i));
+    gt_assert(strlen(md5) == GT_MD5_LENGTH);
+    memcpy(part->md5_fingerprints + i * GT_MD5_RECORD_LENGTH, md5,
+           GT_MD5_LENGTH);
     gt_free(md5);
   }
+  return NULL;
 }
 
-static void strarray_dump_to_file(GtStrArray *sa, FILE *outfp)
+/* computes the fingerprints in <nof_parts> parts in parallel, if <nof_parts>
+   is 0 the number of parts is determined from the sequence length */
+static void add_fingerprints(GtBioseqFingerprints *bsf, GtBioseq *bs,
+                             unsigned long nof_parts)
 {
-  unsigned long i;
-  gt_assert(sa && outfp);
-  for (i = 0; i < gt_str_array_size(sa); i++) {
-    gt_xfputs(gt_str_array_get(sa, i), outfp);
-    gt_xfputc('\n', outfp);
+  BioseqMD5Part *parts;
+  unsigned long i, *bounds;
+  gt_assert(bsf && bs);
+  if (!gt_bioseq_number_of_sequences(bs))
+    return;
+  /* zeroed, so that every record is '\0'-terminated */
+  bsf->md5_fingerprints = gt_calloc(gt_bioseq_number_of_sequences(bs),
+                                    GT_MD5_RECORD_LENGTH);
+  if (!nof_parts)
+    nof_parts = bioseq_nof_parts(gt_bioseq_get_raw_sequence_length(bs));
+  bounds = gt_malloc((nof_parts + 1) * sizeof (unsigned long));
+  bioseq_split(bounds, bs->sequence_offsets, bs->num_of_sequences, nof_parts);
+  parts = gt_malloc(nof_parts * sizeof (BioseqMD5Part));
+  for (i = 0; i < nof_parts; i++) {
+    parts[i].bs = bs;
+    parts[i].md5_fingerprints = bsf->md5_fingerprints;
+    parts[i].first = bounds[i];
+    parts[i].last = bounds[i+1];
   }
+  bioseq_run_parts(compute_md5_part, parts, sizeof (BioseqMD5Part), nof_parts);
+  gt_free(parts);
+  gt_free(bounds);
 }
 
-static void write_fingerprints(GtStrArray *md5_fingerprints,
+static void write_fingerprints(GtBioseqFingerprints *bsf,
+                               unsigned long num_of_seqs,
                                GtStr *fingerprints_filename)
 {
   FILE *fingerprints_file;
-  gt_assert(md5_fingerprints && fingerprints_filename);
+  gt_assert(bsf && fingerprints_filename);
   fingerprints_file = gt_fa_xfopen(gt_str_get(fingerprints_filename), "w");
-  strarray_dump_to_file(md5_fingerprints, fingerprints_file);
+  if (num_of_seqs) {
+    gt_xfwrite(bsf->md5_fingerprints, GT_MD5_RECORD_LENGTH, num_of_seqs,
+               fingerprints_file);
+  }
   gt_fa_xfclose(fingerprints_file);
 }
 
@@ -130,7 +246,6 @@ static GtBioseqFingerprints* gt_bioseq_fingerprints_new(GtBioseq *bs)
   GtStr *fingerprints_filename;
   gt_assert(bs);
   bsf = gt_calloc(1, sizeof *bsf);
-  bsf->md5_fingerprints = gt_str_array_new();
   fingerprints_filename = gt_str_clone(bs->sequence_file);
   gt_str_append_cstr(fingerprints_filename, GT_BIOSEQ_FINGERPRINTS);
   if (!bs->use_stdin && gt_file_exists(gt_str_get(fingerprints_filename)) &&
@@ -138,14 +253,15 @@ static GtBioseqFingerprints* gt_bioseq_fingerprints_new(GtBioseq *bs)
                         gt_str_get(fingerprints_filename))) {
     /* only try to read the fingerprint file if the sequence file was not
        modified in the meantime */
-    reading_succeeded = read_fingerprints(bsf->md5_fingerprints,
-                                          fingerprints_filename,
+    reading_succeeded = read_fingerprints(bsf, fingerprints_filename,
                                           gt_bioseq_number_of_sequences(bs));
   }
   if (!reading_succeeded) {
-    add_fingerprints(bsf->md5_fingerprints, bs);
-    if (!bs->use_stdin)
-      write_fingerprints(bsf->md5_fingerprints, fingerprints_filename);
+    add_fingerprints(bsf, bs, 0);
+    if (!bs->use_stdin) {
+      write_fingerprints(bsf, gt_bioseq_number_of_sequences(bs),
+                         fingerprints_filename);
+    }
   }
   gt_str_delete(fingerprints_filename);
   return bsf;
@@ -154,21 +270,30 @@ static GtBioseqFingerprints* gt_bioseq_fingerprints_new(GtBioseq *bs)
 static void gt_bioseq_fingerprints_delete(GtBioseqFingerprints *bsf)
 {
   if (!bsf) return;
-  gt_str_array_delete(bsf->md5_fingerprints);
+  if (bsf->mapped)
+    gt_fa_xmunmap(bsf->md5_fingerprints);
+  else
+    gt_free(bsf->md5_fingerprints);
   gt_free(bsf);
 }
 
-static const char* gt_bioseq_fingerprints_get(GtBioseqFingerprints *bsf,
-                                           unsigned long idx)
+static const char* gt_bioseq_fingerprints_get(const GtBioseqFingerprints *bsf,
+                                              unsigned long idx)
 {
-  gt_assert(bsf);
-  return gt_str_array_get(bsf->md5_fingerprints, idx);
+  const char *md5;
+  gt_assert(bsf && bsf->md5_fingerprints);
+  md5 = bsf->md5_fingerprints + idx * GT_MD5_RECORD_LENGTH;
+  gt_assert(md5[GT_MD5_LENGTH] == '\0');
+  return md5;
 }
 
 typedef struct {
   FILE *gt_bioseq_index,
        *gt_bioseq_raw;
-  unsigned long offset;
+  unsigned long offset,
+                descriptions_length;
+  GtArray *sequence_offsets,
+          *description_offsets;
   GtBioseq *bs;
 } ConstructBioseqFilesInfo;
 
@@ -176,17 +301,18 @@ static int proc_description(const char *description, unsigned long length,
                             void *data, GT_UNUSED GtError *err)
 {
   ConstructBioseqFilesInfo *info = (ConstructBioseqFilesInfo*) data;
-  char *description_cstr;
   gt_error_check(err);
+  gt_array_add(info->description_offsets, info->descriptions_length);
   if (info->bs->use_stdin) {
-    description_cstr = gt_cstr_dup(description);
-    gt_array_add(info->bs->descriptions, description_cstr);
+    gt_str_append_cstr_nt(info->bs->description_array, description, length);
+    gt_str_append_char(info->bs->description_array, '\0');
   }
   else {
     if (length)
-      gt_xfputs(description, info->gt_bioseq_index);
-    gt_xfputc('\n', info->gt_bioseq_index);
+      gt_xfwrite(description, 1, length, info->gt_bioseq_index);
+    gt_xfputc('\0', info->gt_bioseq_index);
   }
+  info->descriptions_length += length + 1;
   return 0;
 }
 
@@ -214,22 +340,44 @@ static int proc_sequence_length(unsigned long sequence_length, void *data,
                                 GT_UNUSED GtError *err)
 {
   ConstructBioseqFilesInfo *info = (ConstructBioseqFilesInfo*) data;
-  GtRange range;
   gt_error_check(err);
-  if (info->bs->use_stdin) {
-    range.start = info->offset;
-    range.end = info->offset + sequence_length - 1;
-    gt_array_add(info->bs->sequence_ranges, range);
-  }
-  else {
-    fprintf(info->gt_bioseq_index, "%lu\n", info->offset);
-    gt_assert(sequence_length);
-    fprintf(info->gt_bioseq_index, "%lu\n", info->offset + sequence_length - 1);
-  }
+  gt_assert(info->bs->use_stdin || sequence_length);
+  gt_array_add(info->sequence_offsets, info->offset);
   info->offset += sequence_length;
   return 0;
 }
 
+static bool bioseq_is_big_endian(void)
+{
+  unsigned long one = 1;
+  return !*(unsigned char*) &one;
+}
+
+/* writes the header and the offset tables of the index file, the
+   descriptions have already been written behind the space for the header */
+static void write_bioseq_index_tables(ConstructBioseqFilesInfo *info)
+{
+  GtBioseqIndexHeader header;
+  unsigned long zero = 0;
+  gt_assert(info && gt_array_size(info->sequence_offsets) ==
+                    gt_array_size(info->description_offsets));
+  gt_xfwrite(&zero, 1, GT_BIOSEQ_INDEX_PADDING(info->descriptions_length),
+             info->gt_bioseq_index);
+  gt_xfwrite(gt_array_get_space(info->sequence_offsets), sizeof (unsigned long),
+             gt_array_size(info->sequence_offsets), info->gt_bioseq_index);
+  gt_xfwrite(gt_array_get_space(info->description_offsets),
+             sizeof (unsigned long), gt_array_size(info->description_offsets),
+             info->gt_bioseq_index);
+  memset(&header, 0, sizeof header);
+  memcpy(header.magic, GT_BIOSEQ_INDEX_MAGIC, sizeof header.magic);
+  header.word_size = sizeof (unsigned long);
+  header.big_endian = bioseq_is_big_endian();
+  header.num_of_sequences = gt_array_size(info->description_offsets) - 1;
+  header.descriptions_length = info->descriptions_length;
+  gt_xfseek(info->gt_bioseq_index, 0, SEEK_SET);
+  gt_xfwrite(&header, sizeof header, 1, info->gt_bioseq_index);
+}
+
 /* this global variables are necessary for the signal handler below */
 static ConstructBioseqFilesInfo gt_bioseq_files_info;
 static const char *gt_bioseq_index_filename,
@@ -247,67 +395,89 @@ static void remove_bioseq_files(int sigraised)
   gt_xraise(sigraised);
 }
 
-static int fill_bioseq(GtBioseq *bs, const char *index_filename,
-                       const char *raw_filename, GtError *err)
+/* Maps the index file and the raw file into <bs>. Returns false, if the files
+   do not form a valid pair of bioseq files of this platform (e.g., because
+   they have been truncated or are in an older format). Then nothing is mapped
+   and the files have to be constructed again. */
+static bool fill_bioseq(GtBioseq *bs, const char *index_filename,
+                        const char *raw_filename)
 {
-  FILE *index_file;
-  GtStr *index_line;
-  unsigned long line_number = 1;
-  char *description;
-  GtRange range;
-  int had_err = 0;
-
-  gt_error_check(err);
-
-  /* parse the index file and fill the sequence to index mapping */
-  index_line = gt_str_new();
-  index_file = gt_fa_xfopen(index_filename, "r");
-
-  while (!had_err && gt_str_read_next_line(index_line, index_file) != EOF) {
-    switch (line_number % 3) {
-      case 1:
-        /* process description */
-        description = gt_cstr_dup(gt_str_get(index_line));
-        gt_array_add(bs->descriptions, description);
-        break;
-      case 2:
-        /* process sequence start */
-        if (gt_parse_ulong(&range.start, gt_str_get(index_line))) {
-          gt_error_set(err, "could not parse bioseq start in line %lu of file "
-                         "\"%s\"", line_number, index_filename);
-          had_err = -1;
-        }
-        break;
-      case 0:
-        /* process sequence end */
-        if (gt_parse_ulong(&range.end, gt_str_get(index_line))) {
-          gt_error_set(err,
-                    "could not parse bioseq end in line %lu of file \"%s\"",
-                    line_number, index_filename);
-          had_err = -1;
-        }
-        else {
-          gt_assert(range.start <= range.end); /* XXX */
-          gt_array_add(bs->sequence_ranges, range);
-        }
-        break;
+  const GtBioseqIndexHeader *header;
+  const unsigned long *sequence_offsets = NULL, *description_offsets = NULL;
+  const char *index, *descriptions = NULL;
+  unsigned long i, n = 0, descriptions_length = 0;
+  size_t index_length, raw_sequence_length = 0;
+  char *raw_sequence = NULL;
+  bool valid = true;
+
+  gt_assert(bs && !bs->index && !bs->raw_sequence);
+
+  /* map the index file, the tables and descriptions are used in place */
+  if (!(index = gt_fa_mmap_read(index_filename, &index_length)))
+    return false;
+  header = (const GtBioseqIndexHeader*) index;
+  if (index_length < sizeof *header ||
+      memcmp(header->magic, GT_BIOSEQ_INDEX_MAGIC, sizeof header->magic) ||
+      header->word_size != sizeof (unsigned long) ||
+      header->big_endian != bioseq_is_big_endian()) {
+    valid = false;
+  }
+  if (valid) {
+    /* check the size without overflows */
+    n = header->num_of_sequences;
+    descriptions_length = header->descriptions_length;
+    index_length -= sizeof *header;
+    if (n >= index_length / (2 * sizeof (unsigned long)) ||
+        descriptions_length > index_length ||
+        index_length - descriptions_length !=
+        GT_BIOSEQ_INDEX_PADDING(descriptions_length) +
+        2 * (n + 1) * sizeof (unsigned long)) {
+      valid = false;
     }
-    line_number++;
-    gt_str_reset(index_line);
   }
-
-  if (!had_err) {
-    /* the number of descriptions equals the number of sequence ranges */
-    gt_assert(gt_array_size(bs->descriptions) ==
-           gt_array_size(bs->sequence_ranges));
-    /* map the raw file */
-    bs->raw_sequence = gt_fa_xmmap_read(raw_filename, &bs->raw_sequence_length);
+  if (valid) {
+    descriptions = index + sizeof *header;
+    sequence_offsets = (const unsigned long*)
+                       (descriptions + descriptions_length +
+                        GT_BIOSEQ_INDEX_PADDING(descriptions_length));
+    description_offsets = sequence_offsets + n + 1;
+    /* every description is terminated within the descriptions and the
+       sequences are ascending, the raw file is checked below */
+    if ((descriptions_length && descriptions[descriptions_length - 1]) ||
+        description_offsets[n] != descriptions_length ||
+        sequence_offsets[0]) {
+      valid = false;
+    }
+    for (i = 0; valid && i < n; i++) {
+      if (description_offsets[i] >= descriptions_length ||
+          sequence_offsets[i] > sequence_offsets[i+1]) {
+        valid = false;
+      }
+    }
+  }
+  if (valid) {
+    /* map the raw file, the sequences have to end with it */
+    if (!(raw_sequence = gt_fa_mmap_read(raw_filename, &raw_sequence_length)))
+      valid = false;
+    else if (sequence_offsets[n] != raw_sequence_length) {
+      gt_fa_xmunmap(raw_sequence);
+      valid = false;
+    }
+  }
+  if (!valid) {
+    gt_fa_xmunmap((void*) index);
+    return false;
   }
 
-  gt_fa_xfclose(index_file);
-  gt_str_delete(index_line);
-
-  return had_err;
+  bs->index = (void*) index;
+  bs->index_length = index_length + sizeof *header;
+  bs->num_of_sequences = n;
+  bs->descriptions = descriptions;
+  bs->sequence_offsets = sequence_offsets;
+  bs->description_offsets = description_offsets;
+  bs->raw_sequence = raw_sequence;
+  bs->raw_sequence_length = raw_sequence_length;
+  return true;
 }
 
 static int construct_bioseq_files(GtBioseq *bs, GtStr *gt_bioseq_index_file,
@@ -316,6 +486,7 @@ static int construct_bioseq_files(GtBioseq *bs, GtStr *gt_bioseq_index_file,
                                   GtError *err)
 {
   GtFastaReader *fasta_reader = NULL;
+  GtBioseqIndexHeader header;
   GtStr *sequence_filename;
   int had_err;
 
@@ -327,8 +498,15 @@ static int construct_bioseq_files(GtBioseq *bs, GtStr *gt_bioseq_index_file,
       gt_fa_xfopen((const char *) gt_str_get(gt_bioseq_index_file), "w");
     gt_bioseq_files_info.gt_bioseq_raw =
       gt_fa_xfopen(gt_str_get(gt_bioseq_raw_file), "w");
+    /* the header is written when the sizes are known */
+    memset(&header, 0, sizeof header);
+    gt_xfwrite(&header, sizeof header, 1, gt_bioseq_files_info.gt_bioseq_index);
   }
   gt_bioseq_files_info.offset = 0;
+  gt_bioseq_files_info.descriptions_length = 0;
+  gt_bioseq_files_info.sequence_offsets = gt_array_new(sizeof (unsigned long));
+  gt_bioseq_files_info.description_offsets =
+    gt_array_new(sizeof (unsigned long));
   gt_bioseq_files_info.bs = bs;
 
   /* register the signal handler to remove incomplete files upon termination */
@@ -357,6 +535,18 @@ static int construct_bioseq_files(GtBioseq *bs, GtStr *gt_bioseq_index_file,
                                 &gt_bioseq_files_info, err);
   gt_fasta_reader_delete(fasta_reader);
 
+  if (!had_err) {
+    /* the number of descriptions equals the number of sequences */
+    gt_assert(gt_array_size(gt_bioseq_files_info.sequence_offsets) ==
+              gt_array_size(gt_bioseq_files_info.description_offsets));
+    gt_array_add(gt_bioseq_files_info.sequence_offsets,
+                 gt_bioseq_files_info.offset);
+    gt_array_add(gt_bioseq_files_info.description_offsets,
+                 gt_bioseq_files_info.descriptions_length);
+    if (!bs->use_stdin)
+      write_bioseq_index_tables(&gt_bioseq_files_info);
+  }
+
   /* unregister the signal handler */
   if (!bs->use_stdin)
     gt_sig_unregister_all();
@@ -371,9 +561,259 @@ static int construct_bioseq_files(GtBioseq *bs, GtStr *gt_bioseq_index_file,
     }
   }
 
+  if (bs->use_stdin) {
+    /* the tables are kept in memory */
+    bs->sequence_offset_array = gt_bioseq_files_info.sequence_offsets;
+    bs->description_offset_array = gt_bioseq_files_info.description_offsets;
+    if (!had_err) {
+      bs->num_of_sequences = gt_array_size(bs->sequence_offset_array) - 1;
+      bs->sequence_offsets = gt_array_get_space(bs->sequence_offset_array);
+      bs->description_offsets =
+        gt_array_get_space(bs->description_offset_array);
+      bs->descriptions = gt_str_get(bs->description_array);
+    }
+  }
+  else {
+    gt_array_delete(gt_bioseq_files_info.sequence_offsets);
+    gt_array_delete(gt_bioseq_files_info.description_offsets);
+  }
+
   return had_err;
 }
 
+typedef struct {
+  const char *sequences;  /* mapped sequence file */
+  unsigned long start,
+                end;
+  GtArray *separators;    /* positions of FASTA_SEPARATOR in [start,end) */
+} BioseqScanPart;
+
+static void* scan_separators(void *data)
+{
+  BioseqScanPart *part = data;
+  const char *pos = part->sequences + part->start,
+             *end = part->sequences + part->end;
+  unsigned long separator;
+  while ((pos = memchr(pos, FASTA_SEPARATOR, end - pos))) {
+    separator = pos - part->sequences;
+    gt_array_add(part->separators, separator);
+    pos++;
+  }
+  return NULL;
+}
+
+typedef struct {
+  const char *sequences;
+  const unsigned long *record_starts, /* position of FASTA_SEPARATOR */
+                      *description_ends; /* position of the newline */
+  unsigned long first, last,          /* the records of this part */
+                *sequence_lengths;
+  const unsigned long *sequence_offsets;
+  char *raw_sequence;
+} BioseqCopyPart;
+
+static void* count_sequence_part(void *data)
+{
+  BioseqCopyPart *part = data;
+  unsigned long i, length;
+  const char *pos, *end;
+  for (i = part->first; i < part->last; i++) {
+    pos = part->sequences + part->description_ends[i] + 1;
+    end = part->sequences + part->record_starts[i+1];
+    for (length = 0; pos < end; pos++) {
+      if (*pos != '\n' && *pos != ' ')
+        length++;
+    }
+    part->sequence_lengths[i] = length;
+  }
+  return NULL;
+}
+
+static void* copy_sequence_part(void *data)
+{
+  BioseqCopyPart *part = data;
+  unsigned long i;
+  const char *pos, *end;
+  char *raw;
+  for (i = part->first; i < part->last; i++) {
+    pos = part->sequences + part->description_ends[i] + 1;
+    end = part->sequences + part->record_starts[i+1];
+    raw = part->raw_sequence + part->sequence_offsets[i];
+    for (; pos < end; pos++) {
+      if (*pos != '\n' && *pos != ' ')
+        *raw++ = *pos;
+    }
+    gt_assert(raw == part->raw_sequence + part->sequence_offsets[i+1]);
+  }
+  return NULL;
+}
+
+/* Constructs the bioseq files of an uncompressed sequence file in <nof_parts>
+   parts in parallel (if <nof_parts> is 0 the number of parts is determined from
+   the file size). The files are identical to the ones produced with the
+   GT_FASTA_READER_REC reader. Returns false without creating the files if the
+   sequence file cannot be processed this way, e.g., because it is compressed
+   or not a valid FASTA file. In this case the regular construction reports the
+   error. */
+static bool construct_bioseq_files_parallel(GtBioseq *bs,
+                                            GtStr *gt_bioseq_index_file,
+                                            GtStr *gt_bioseq_raw_file,
+                                            unsigned long nof_parts)
+{
+  GtArray *record_starts, *description_ends;
+  BioseqScanPart *scan_parts;
+  BioseqCopyPart *copy_parts;
+  GtBioseqIndexHeader header;
+  unsigned long i, j, part, num_of_records, next_record, *separators,
+                *sequence_lengths, *bounds;
+  const char *sequences, *newline;
+  size_t sequences_length, raw_length;
+  char *raw_sequence;
+  bool valid = true;
+
+  gt_assert(bs && !bs->use_stdin);
+  if (gt_file_mode_determine(gt_str_get(bs->sequence_file)) !=
+      GFM_UNCOMPRESSED) {
+    return false;
+  }
+  if (!(sequences = gt_fa_mmap_read(gt_str_get(bs->sequence_file),
+                                    &sequences_length))) {
+    return false; /* e.g., an empty file */
+  }
+  if (!sequences_length || sequences[0] != FASTA_SEPARATOR) {
+    gt_fa_xmunmap((void*) sequences);
+    return false;
+  }
+  if (!nof_parts)
+    nof_parts = bioseq_nof_parts(sequences_length);
+
+  /* find the separator candidates in parallel */
+  scan_parts = gt_malloc(nof_parts * sizeof (BioseqScanPart));
+  for (part = 0; part < nof_parts; part++) {
+    scan_parts[part].sequences = sequences;
+    scan_parts[part].start = sequences_length / nof_parts * part;
+    scan_parts[part].end = part + 1 < nof_parts
+                           ? sequences_length / nof_parts * (part + 1)
+                           : sequences_length;
+    scan_parts[part].separators = gt_array_new(sizeof (unsigned long));
+  }
+  bioseq_run_parts(scan_separators, scan_parts, sizeof (BioseqScanPart),
+                   nof_parts);
+
+  /* a record starts with the first separator behind the description of the
+     previous record, separators within descriptions are skipped */
+  record_starts = gt_array_new(sizeof (unsigned long));
+  description_ends = gt_array_new(sizeof (unsigned long));
+  next_record = 0; /* the position from which on a separator starts a record */
+  for (part = 0; valid && part < nof_parts; part++) {
+    separators = gt_array_get_space(scan_parts[part].separators);
+    for (j = 0; valid && j < gt_array_size(scan_parts[part].separators); j++) {
+      if (separators[j] < next_record)
+        continue;
+      gt_array_add(record_starts, separators[j]);
+      newline = memchr(sequences + separators[j] + 1, '\n',
+                       sequences_length - separators[j] - 1);
+      if (!newline)
+        valid = false; /* no sequence after the last description */
+      else {
+        next_record = newline - sequences;
+        gt_array_add(description_ends, next_record);
+      }
+    }
+    gt_array_delete(scan_parts[part].separators);
+  }
+  gt_free(scan_parts);
+  num_of_records = gt_array_size(description_ends);
+  gt_array_add(record_starts, sequences_length);
+
+  /* count the sequence lengths in parallel */
+  bounds = gt_malloc((nof_parts + 1) * sizeof (unsigned long));
+  sequence_lengths = gt_malloc((num_of_records + 1) * sizeof (unsigned long));
+  copy_parts = gt_malloc(nof_parts * sizeof (BioseqCopyPart));
+  if (valid) {
+    bioseq_split(bounds, gt_array_get_space(record_starts), num_of_records,
+                 nof_parts);
+    for (part = 0; part < nof_parts; part++) {
+      copy_parts[part].sequences = sequences;
+      copy_parts[part].record_starts = gt_array_get_space(record_starts);
+      copy_parts[part].description_ends = gt_array_get_space(description_ends);
+      copy_parts[part].first = bounds[part];
+      copy_parts[part].last = bounds[part+1];
+      copy_parts[part].sequence_lengths = sequence_lengths;
+    }
+    bioseq_run_parts(count_sequence_part, copy_parts, sizeof (BioseqCopyPart),
+                     nof_parts);
+    for (i = 0; valid && i < num_of_records; i++) {
+      if (!sequence_lengths[i])
+        valid = false; /* empty sequence */
+    }
+  }
+
+  if (valid) {
+    /* write the index file, the sequence lengths become the offsets */
+    gt_bioseq_files_info.gt_bioseq_index =
+      gt_fa_xfopen(gt_str_get(gt_bioseq_index_file), "w");
+    gt_bioseq_files_info.gt_bioseq_raw =
+      gt_fa_xfopen(gt_str_get(gt_bioseq_raw_file), "w");
+    gt_bioseq_index_filename = gt_str_get(gt_bioseq_index_file);
+    gt_bioseq_raw_filename = gt_str_get(gt_bioseq_raw_file);
+    gt_sig_register_all(remove_bioseq_files);
+    gt_bioseq_files_info.offset = 0;
+    gt_bioseq_files_info.descriptions_length = 0;
+    gt_bioseq_files_info.sequence_offsets =
+      gt_array_new(sizeof (unsigned long));
+    gt_bioseq_files_info.description_offsets =
+      gt_array_new(sizeof (unsigned long));
+    gt_bioseq_files_info.bs = bs;
+    memset(&header, 0, sizeof header);
+    gt_xfwrite(&header, sizeof header, 1, gt_bioseq_files_info.gt_bioseq_index);
+    for (i = 0; i < num_of_records; i++) {
+      unsigned long start = copy_parts->record_starts[i] + 1;
+      proc_description(sequences + start,
+                       copy_parts->description_ends[i] - start,
+                       &gt_bioseq_files_info, NULL);
+      proc_sequence_length(sequence_lengths[i], &gt_bioseq_files_info, NULL);
+    }
+    gt_array_add(gt_bioseq_files_info.sequence_offsets,
+                 gt_bioseq_files_info.offset);
+    gt_array_add(gt_bioseq_files_info.description_offsets,
+                 gt_bioseq_files_info.descriptions_length);
+    write_bioseq_index_tables(&gt_bioseq_files_info);
+
+    /* extend the raw file to its final size and copy the sequences into it in
+       parallel */
+    gt_xfseek(gt_bioseq_files_info.gt_bioseq_raw,
+              (long) gt_bioseq_files_info.offset - 1, SEEK_SET);
+    gt_xfputc('\0', gt_bioseq_files_info.gt_bioseq_raw);
+    gt_xfflush(gt_bioseq_files_info.gt_bioseq_raw);
+    raw_sequence = gt_fa_xmmap_write(gt_str_get(gt_bioseq_raw_file),
+                                     &raw_length);
+    gt_assert(raw_length == gt_bioseq_files_info.offset);
+    for (part = 0; part < nof_parts; part++) {
+      copy_parts[part].sequence_offsets =
+        gt_array_get_space(gt_bioseq_files_info.sequence_offsets);
+      copy_parts[part].raw_sequence = raw_sequence;
+    }
+    bioseq_run_parts(copy_sequence_part, copy_parts, sizeof (BioseqCopyPart),
+                     nof_parts);
+    gt_fa_xmunmap(raw_sequence);
+
+    gt_sig_unregister_all();
+    gt_fa_xfclose(gt_bioseq_files_info.gt_bioseq_index);
+    gt_fa_xfclose(gt_bioseq_files_info.gt_bioseq_raw);
+    gt_array_delete(gt_bioseq_files_info.sequence_offsets);
+    gt_array_delete(gt_bioseq_files_info.description_offsets);
+  }
+
+  gt_free(copy_parts);
+  gt_free(sequence_lengths);
+  gt_free(bounds);
+  gt_array_delete(description_ends);
+  gt_array_delete(record_starts);
+  gt_fa_xmunmap((void*) sequences);
+  return valid;
+}
+
 static int gt_bioseq_fill(GtBioseq *bs, bool recreate,
                        GtFastaReaderType gt_fasta_reader_type, GtError *err)
 {
@@ -391,23 +831,32 @@ static int gt_bioseq_fill(GtBioseq *bs, bool recreate,
     gt_str_append_cstr(gt_bioseq_raw_file, GT_BIOSEQ_RAW);
   }
 
-  /* construct the bioseq files if necessary */
+  /* construct the bioseq files if necessary, existing files which cannot be
+     used are constructed again */
   if (recreate || bs->use_stdin ||
       !gt_file_exists(gt_str_get(gt_bioseq_index_file)) ||
       !gt_file_exists(gt_str_get(gt_bioseq_raw_file)) ||
       gt_file_is_newer(gt_str_get(bs->sequence_file),
                        gt_str_get(gt_bioseq_index_file)) ||
       gt_file_is_newer(gt_str_get(bs->sequence_file),
-                       gt_str_get(gt_bioseq_raw_file))) {
-    had_err = construct_bioseq_files(bs, gt_bioseq_index_file,
-                                     gt_bioseq_raw_file, gt_fasta_reader_type,
-                                     err);
-  }
-
-  if (!had_err && !bs->use_stdin) {
-    /* fill the bioseq */
-    had_err = fill_bioseq(bs, gt_str_get(gt_bioseq_index_file),
-                          gt_str_get(gt_bioseq_raw_file), err);
+                       gt_str_get(gt_bioseq_raw_file)) ||
+      !fill_bioseq(bs, gt_str_get(gt_bioseq_index_file),
+                   gt_str_get(gt_bioseq_raw_file))) {
+    if (bs->use_stdin || gt_fasta_reader_type != GT_FASTA_READER_REC ||
+        !construct_bioseq_files_parallel(bs, gt_bioseq_index_file,
+                                         gt_bioseq_raw_file, 0)) {
+      had_err = construct_bioseq_files(bs, gt_bioseq_index_file,
+                                       gt_bioseq_raw_file,
+                                       gt_fasta_reader_type, err);
+    }
+    if (!had_err && !bs->use_stdin &&
+        !fill_bioseq(bs, gt_str_get(gt_bioseq_index_file),
+                     gt_str_get(gt_bioseq_raw_file))) {
+      gt_error_set(err, "could not read the bioseq files \"%s\" and \"%s\" "
+                        "just constructed", gt_str_get(gt_bioseq_index_file),
+                   gt_str_get(gt_bioseq_raw_file));
+      had_err = -1;
+    }
   }
 
   /* free */
@@ -436,8 +885,9 @@ static GtBioseq* gt_bioseq_new_with_recreate_and_type(GtStr *sequence_file,
   }
   if (!had_err) {
     bs->sequence_file = gt_str_ref(sequence_file);
-    bs->descriptions = gt_array_new(sizeof (char*));
-    bs->sequence_ranges = gt_array_new(sizeof (GtRange));
+    bs->fingerprints_mutex = gt_mutex_new();
+    if (bs->use_stdin)
+      bs->description_array = gt_str_new();
     had_err = gt_bioseq_fill(bs, recreate, gt_fasta_reader_type, err);
   }
   if (had_err) {
@@ -495,16 +945,17 @@ void gt_bioseq_delete(GtBioseq *bs)
   unsigned long i;
   if (!bs) return;
   gt_bioseq_fingerprints_delete(bs->fingerprints);
+  gt_mutex_delete(bs->fingerprints_mutex);
   gt_str_delete(bs->sequence_file);
   if (bs->seqs) {
-    for (i = 0; i < gt_array_size(bs->descriptions); i++)
+    for (i = 0; i < bs->num_of_sequences; i++)
       gt_seq_delete(bs->seqs[i]);
     gt_free(bs->seqs);
   }
-  for (i = 0; i < gt_array_size(bs->descriptions); i++)
-    gt_free(*(char**) gt_array_get(bs->descriptions, i));
-  gt_array_delete(bs->descriptions);
-  gt_array_delete(bs->sequence_ranges);
+  gt_array_delete(bs->sequence_offset_array);
+  gt_array_delete(bs->description_offset_array);
+  gt_str_delete(bs->description_array);
+  gt_fa_xmunmap(bs->index);
   if (bs->use_stdin)
     gt_free(bs->raw_sequence);
   else
@@ -533,9 +984,9 @@ GtAlphabet* gt_bioseq_get_alphabet(GtBioseq *bs)
 GtSeq* gt_bioseq_get_seq(GtBioseq *bs, unsigned long idx)
 {
   gt_assert(bs);
-  gt_assert(idx < gt_array_size(bs->descriptions));
+  gt_assert(idx < bs->num_of_sequences);
   if (!bs->seqs)
-    bs->seqs = gt_calloc(gt_array_size(bs->descriptions), sizeof (GtSeq*));
+    bs->seqs = gt_calloc(bs->num_of_sequences, sizeof (GtSeq*));
   determine_alphabet_if_necessary(bs);
   if (!bs->seqs[idx]) {
     bs->seqs[idx] = gt_seq_new(gt_bioseq_get_sequence(bs, idx),
@@ -548,16 +999,14 @@ GtSeq* gt_bioseq_get_seq(GtBioseq *bs, unsigned long idx)
 
 const char* gt_bioseq_get_description(GtBioseq *bs, unsigned long idx)
 {
-  gt_assert(bs);
-  return *(char**) gt_array_get(bs->descriptions, idx);
+  gt_assert(bs && idx < bs->num_of_sequences);
+  return bs->descriptions + bs->description_offsets[idx];
 }
 
 const char* gt_bioseq_get_sequence(GtBioseq *bs, unsigned long idx)
 {
-  GtRange sequence_range;
-  gt_assert(bs);
-  sequence_range = *(GtRange*) gt_array_get(bs->sequence_ranges, idx);
-  return bs->raw_sequence + sequence_range.start;
+  gt_assert(bs && idx < bs->num_of_sequences);
+  return bs->raw_sequence + bs->sequence_offsets[idx];
 }
 
 const char* gt_bioseq_get_raw_sequence(GtBioseq *bs)
@@ -568,17 +1017,21 @@ const char* gt_bioseq_get_raw_sequence(GtBioseq *bs)
 
 const char* gt_bioseq_get_md5_fingerprint(GtBioseq *bs, unsigned long idx)
 {
+  const char *md5;
   gt_assert(bs && idx < gt_bioseq_number_of_sequences(bs));
+  gt_mutex_lock(bs->fingerprints_mutex);
   if (!bs->fingerprints)
     bs->fingerprints = gt_bioseq_fingerprints_new(bs);
-  gt_assert(gt_bioseq_fingerprints_get(bs->fingerprints, idx));
-  return gt_bioseq_fingerprints_get(bs->fingerprints, idx);
+  gt_mutex_unlock(bs->fingerprints_mutex);
+  md5 = gt_bioseq_fingerprints_get(bs->fingerprints, idx);
+  gt_assert(md5);
+  return md5;
 }
 
 unsigned long gt_bioseq_get_sequence_length(GtBioseq *bs, unsigned long idx)
 {
-  gt_assert(bs);
-  return gt_range_length(gt_array_get(bs->sequence_ranges, idx));
+  gt_assert(bs && idx < bs->num_of_sequences);
+  return bs->sequence_offsets[idx + 1] - bs->sequence_offsets[idx];
 }
 
 unsigned long gt_bioseq_get_raw_sequence_length(GtBioseq *bs)
@@ -590,7 +1043,7 @@ unsigned long gt_bioseq_get_raw_sequence_length(GtBioseq *bs)
 unsigned long gt_bioseq_number_of_sequences(GtBioseq *bs)
 {
   gt_assert(bs);
-  return gt_array_size(bs->descriptions);
+  return bs->num_of_sequences;
 }
 
 void gt_bioseq_show_as_fasta(GtBioseq *bs, unsigned long width)
@@ -657,3 +1110,141 @@ void gt_bioseq_show_seqlengthdistri(GtBioseq *bs)
   gt_disc_distri_show(d);
   gt_disc_distri_delete(d);
 }
+
+/* compares the file <filename> with <data> of <length> bytes */
+static bool bioseq_file_equals(const char *filename, const char *data,
+                               size_t length)
+{
+  size_t file_length;
+  char *file;
+  bool equal;
+  file = gt_fa_xmmap_read(filename, &file_length);
+  equal = file_length == length && !memcmp(file, data, length);
+  gt_fa_xmunmap(file);
+  return equal;
+}
+
+/* constructs the bioseq files for <fasta> serially and in parallel and checks
+   that they are identical */
+static int check_bioseq_files(const char *fasta, unsigned long nof_parts,
+                              bool valid, GtError *err)
+{
+  GtStr *sequence_file, *index_file, *raw_file;
+  char *index = NULL, *raw = NULL;
+  size_t index_length = 0, raw_length = 0;
+  FILE *fp;
+  GtBioseq *bs;
+  int had_err = 0;
+  gt_error_check(err);
+
+  sequence_file = gt_str_new();
+  fp = gt_xtmpfp(sequence_file);
+  gt_xfputs(fasta, fp);
+  gt_fa_xfclose(fp);
+  index_file = gt_str_clone(sequence_file);
+  gt_str_append_cstr(index_file, GT_BIOSEQ_INDEX);
+  raw_file = gt_str_clone(sequence_file);
+  gt_str_append_cstr(raw_file, GT_BIOSEQ_RAW);
+  bs = gt_calloc(1, sizeof *bs);
+  bs->sequence_file = gt_str_ref(sequence_file);
+
+  /* construct the files serially and keep a copy of them */
+  ensure(had_err, !construct_bioseq_files(bs, index_file, raw_file,
+                                          GT_FASTA_READER_REC, err) == valid);
+  if (!had_err && !valid)
+    gt_error_unset(err); /* the expected error */
+  if (!had_err && valid) {
+    char *file = gt_fa_xmmap_read(gt_str_get(index_file), &index_length);
+    index = gt_malloc(index_length);
+    memcpy(index, file, index_length);
+    gt_fa_xmunmap(file);
+    file = gt_fa_xmmap_read(gt_str_get(raw_file), &raw_length);
+    raw = gt_malloc(raw_length);
+    memcpy(raw, file, raw_length);
+    gt_fa_xmunmap(file);
+    gt_xremove(gt_str_get(index_file));
+    gt_xremove(gt_str_get(raw_file));
+  }
+
+  /* the parallel construction must produce the same files */
+  ensure(had_err, construct_bioseq_files_parallel(bs, index_file, raw_file,
+                                                  nof_parts) == valid);
+  if (!had_err && valid) {
+    ensure(had_err, bioseq_file_equals(gt_str_get(index_file), index,
+                                       index_length));
+    ensure(had_err, bioseq_file_equals(gt_str_get(raw_file), raw,
+                                       raw_length));
+  }
+  gt_bioseq_delete(bs);
+
+  /* the fingerprints must not depend on the number of parts */
+  if (!had_err && valid) {
+    GtBioseqFingerprints serial, parallel;
+    bs = gt_bioseq_new_str(sequence_file, err);
+    ensure(had_err, bs);
+    if (!had_err) {
+      serial.md5_fingerprints = parallel.md5_fingerprints = NULL;
+      add_fingerprints(&serial, bs, 1);
+      add_fingerprints(&parallel, bs, nof_parts);
+      ensure(had_err, !memcmp(serial.md5_fingerprints,
+                              parallel.md5_fingerprints,
+                              gt_bioseq_number_of_sequences(bs)
+                              * GT_MD5_RECORD_LENGTH));
+      gt_free(serial.md5_fingerprints);
+      gt_free(parallel.md5_fingerprints);
+    }
+    gt_bioseq_delete(bs);
+  }
+
+  if (valid) {
+    gt_xremove(gt_str_get(index_file));
+    gt_xremove(gt_str_get(raw_file));
+  }
+  gt_xremove(gt_str_get(sequence_file));
+  gt_free(raw);
+  gt_free(index);
+  gt_str_delete(raw_file);
+  gt_str_delete(index_file);
+  gt_str_delete(sequence_file);
+  return had_err;
+}
+
+int gt_bioseq_unit_test(GtError *err)
+{
+  GtStr *fasta;
+  unsigned long i, j, length;
+  int had_err = 0;
+  gt_error_check(err);
+
+  had_err = check_bioseq_files(">first > with separator\nAC GT\n\nacg\r\n"
+                               ">second\nNNNN>third inline\nTT\n>\nACGT", 3,
+                               true, err);
+  if (!had_err)
+    had_err = check_bioseq_files("ACGT\n", 2, false, err);
+  if (!had_err)
+    had_err = check_bioseq_files(">a\nAC\n>no sequence", 2, false, err);
+  if (!had_err)
+    had_err = check_bioseq_files(">a\n>b\nAC\n", 2, false, err);
+
+  /* random sequences with random line breaks */
+  fasta = gt_str_new();
+  for (i = 0; i < 500; i++) {
+    gt_str_append_char(fasta, FASTA_SEPARATOR);
+    length = rand() % 20;
+    for (j = 0; j < length; j++)
+      gt_str_append_char(fasta, "ab >"[rand() % 4]);
+    gt_str_append_char(fasta, '\n');
+    length = 1 + rand() % 300;
+    for (j = 0; j < length; j++) {
+      gt_str_append_char(fasta, "acgt"[rand() % 4]);
+      if (!(rand() % 60))
+        gt_str_append_char(fasta, "\n "[rand() % 2]);
+    }
+    gt_str_append_char(fasta, '\n');
+  }
+  for (i = 1; !had_err && i <= 8; i++)
+    had_err = check_bioseq_files(gt_str_get(fasta), i, true, err);
+  gt_str_delete(fasta);
+
+  return had_err;
+}
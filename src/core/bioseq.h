@@ -72,4 +72,6 @@ void gt_bioseq_show_stat(GtBioseq*);
 /* Shows bioseq sequence length distribution (on stdout). */
 void gt_bioseq_show_seqlengthdistri(GtBioseq*);
 
+int  gt_bioseq_unit_test(GtError*);
+
 #endif
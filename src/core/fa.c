@@ -16,6 +16,9 @@
 */
 
 #include <unistd.h>
+#ifdef GT_THREADS_ENABLED
+#include <pthread.h>
+#endif
 
 #include "core/dynalloc.h"
 #include "core/eansi.h"
@@ -41,6 +44,17 @@ typedef struct {
 
 static FA *fa = NULL;
 
+#ifdef GT_THREADS_ENABLED
+/* protects the bookkeeping, files might be opened and closed from within
+   different threads */
+static pthread_mutex_t fa_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define fa_lock()   pthread_mutex_lock(&fa_mutex)
+#define fa_unlock() pthread_mutex_unlock(&fa_mutex)
+#else
+#define fa_lock()
+#define fa_unlock()
+#endif
+
 typedef struct {
   const char *filename;
   int line;
@@ -99,8 +113,11 @@ static void* fileopen_generic(FA *fa, const char *path, const char *mode,
       break;
     default: gt_assert(0);
   }
-  if (fp)
+  if (fp) {
+    fa_lock();
     gt_hashmap_add(fa->file_pointer, fp, fileinfo);
+    fa_unlock();
+  }
   else
     gt_free(fileinfo);
   return fp;
@@ -110,9 +127,11 @@ static void fclose_generic(void *stream, GtFileMode genfilemode, FA *fa)
 {
   FAFileInfo *fileinfo;
   gt_assert(stream && fa);
+  fa_lock();
   fileinfo = gt_hashmap_get(fa->file_pointer, stream);
   gt_assert(fileinfo);
   gt_hashmap_remove(fa->file_pointer, stream);
+  fa_unlock();
   switch (genfilemode) {
     case GFM_UNCOMPRESSED:
       fclose(stream);
@@ -131,9 +150,11 @@ static void xfclose_generic(void *stream, GtFileMode genfilemode, FA *fa)
 {
   FAFileInfo *fileinfo;
   gt_assert(stream && fa);
+  fa_lock();
   fileinfo = gt_hashmap_get(fa->file_pointer, stream);
   gt_assert(fileinfo);
   gt_hashmap_remove(fa->file_pointer, stream);
+  fa_unlock();
   switch (genfilemode) {
     case GFM_UNCOMPRESSED:
       gt_xfclose(stream);
@@ -301,7 +322,9 @@ FILE* gt_xtmpfp_generic_func(GtStr *template_arg, int flags,
     fileinfo = gt_malloc(sizeof (FAFileInfo));
     fileinfo->filename = filename;
     fileinfo->line = line;
+    fa_lock();
     gt_hashmap_add(fa->file_pointer, fp, fileinfo);
+    fa_unlock();
   }
   if (!template_arg)
     gt_str_delete(template);
@@ -332,10 +355,12 @@ void* gt_fa_mmap_generic_fd_func(int fd, size_t len, size_t offset,
   }
 
   if (map) {
+    fa_lock();
     gt_hashmap_add(fa->memory_maps, map, mapinfo);
     fa->current_size += mapinfo->len;
     if (fa->current_size > fa->max_size)
       fa->max_size = fa->current_size;
+    fa_unlock();
   }
   else
     gt_free(mapinfo);
@@ -377,8 +402,8 @@ void* gt_fa_mmap_read_func(const char *path, size_t *len,
   return mmap_generic_path_func(path, len, false, false, filename, line);
 }
 
-void* gt_mmap_write_func(const char *path, size_t *len,
-                         const char *filename, int line)
+void* gt_fa_mmap_write_func(const char *path, size_t *len,
+                            const char *filename, int line)
 {
   gt_assert(path);
   if (!fa) fa_init();
@@ -395,8 +420,8 @@ void* gt_fa_xmmap_read_func(const char *path, size_t *len,
   return mmap_generic_path_func(path, len, false, true, filename, line);
 }
 
-void* gt_xmmap_write_func(const char *path, size_t *len,
-                          const char *filename, int line)
+void* gt_fa_xmmap_write_func(const char *path, size_t *len,
+                             const char *filename, int line)
 {
   gt_assert(path);
   if (!fa) fa_init();
@@ -410,12 +435,14 @@ void gt_fa_xmunmap(void *addr)
   if (!fa) fa_init();
   gt_assert(fa);
   if (!addr) return;
+  fa_lock();
   mapinfo = gt_hashmap_get(fa->memory_maps, addr);
   gt_assert(mapinfo);
   gt_xmunmap(addr, mapinfo->len);
   gt_assert(fa->current_size >= mapinfo->len);
   fa->current_size -= mapinfo->len;
   gt_hashmap_remove(fa->memory_maps, addr);
+  fa_unlock();
 }
 
 static int check_fptr_leak(GT_UNUSED void *key, void *value, void *data,
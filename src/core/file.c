@@ -16,11 +16,13 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "core/assert_api.h"
 #include "core/cstr.h"
 #include "core/fa.h"
 #include "core/file.h"
+#include "core/gzip_block_writer.h"
 #include "core/ma.h"
 #include "core/xansi.h"
 #include "core/xbzlib.h"
@@ -33,6 +35,7 @@ struct GtFile {
     gzFile gzfile;
     BZFILE *bzfile;
   } fileptr;
+  GtGzipBlockWriter *block_writer; /* used instead of <gzfile> if defined */
   char *orig_path,
        *orig_mode,
        unget_char;
@@ -173,6 +176,18 @@ GtFile* gt_file_xopen(const char *path, const char *mode)
   return gt_file_xopen_w_gfmode(gt_file_mode_determine(path), path, mode);
 }
 
+GtFile* gt_file_xopen_gzip_parallel(const char *path, unsigned int nof_threads)
+{
+  GtFile *genfile;
+  gt_assert(path);
+  genfile = gt_calloc(1, sizeof (GtFile));
+  genfile->mode = GFM_GZIP;
+  genfile->fileptr.file = gt_fa_xfopen(path, "w");
+  genfile->block_writer = gt_gzip_block_writer_new(genfile->fileptr.file,
+                                                   nof_threads);
+  return genfile;
+}
+
 GtFile* gt_file_new_from_fileptr(FILE *fp)
 {
   GtFile *genfile;
@@ -189,10 +204,26 @@ GtFileMode gt_file_mode(const GtFile *genfile)
   return genfile->mode;
 }
 
+/* A file is never read from different threads at the same time, therefore the
+   stream does not have to be locked for every single character (which is
+   expensive as soon as a program has started threads). */
+static int xfgetc_unlocked(FILE *stream)
+{
+  int cc;
+  if ((cc = getc_unlocked(stream)) == EOF) {
+    if (ferror(stream)) {
+      perror("cannot read char");
+      exit(EXIT_FAILURE);
+    }
+  }
+  return cc;
+}
+
 int gt_file_xfgetc(GtFile *genfile)
 {
   int c = -1;
   if (genfile) {
+    gt_assert(!genfile->block_writer);
     if (genfile->unget_used) {
       c = genfile->unget_char;
       genfile->unget_used = false;
@@ -200,7 +231,7 @@ int gt_file_xfgetc(GtFile *genfile)
     else {
       switch (genfile->mode) {
         case GFM_UNCOMPRESSED:
-          c = gt_xfgetc(genfile->fileptr.file);
+          c = xfgetc_unlocked(genfile->fileptr.file);
           break;
         case GFM_GZIP:
           c = gt_xgzfgetc(genfile->fileptr.gzfile);
@@ -213,7 +244,7 @@ int gt_file_xfgetc(GtFile *genfile)
     }
   }
   else
-    c = gt_xfgetc(stdin);
+    c = xfgetc_unlocked(stdin);
   return c;
 }
 
@@ -243,12 +274,25 @@ static int vbzprintf(BZFILE *file, const char *format, va_list va)
   return BZ2_bzwrite(file, buf, len);
 }
 
+static int vblockprintf(GtGzipBlockWriter *block_writer, const char *format,
+                        va_list va)
+{
+  char buf[BUFSIZ];
+  int len;
+  len = vsnprintf(buf, sizeof (buf), format, va);
+  gt_assert(len <= BUFSIZ);
+  gt_gzip_block_writer_write(block_writer, buf, len);
+  return len;
+}
+
 static int xvprintf(GtFile *genfile, const char *format, va_list va)
 {
   int rval = -1;
 
   if (!genfile) /* implies stdout */
     rval = vfprintf(stdout, format, va);
+  else if (genfile->block_writer)
+    rval = vblockprintf(genfile->block_writer, format, va);
   else {
     switch (genfile->mode) {
       case GFM_UNCOMPRESSED:
@@ -280,8 +324,11 @@ void gt_file_xprintf(GtFile *genfile, const char *format, ...)
 
 void gt_file_xfputc(int c, GtFile *genfile)
 {
+  char cc = c;
   if (!genfile)
     return gt_xfputc(c, stdout);
+  if (genfile->block_writer)
+    return gt_gzip_block_writer_write(genfile->block_writer, &cc, 1);
   switch (genfile->mode) {
     case GFM_UNCOMPRESSED:
       gt_xfputc(c, genfile->fileptr.file);
@@ -300,6 +347,10 @@ void gt_file_xfputs(const char *str, GtFile *genfile)
 {
   if (!genfile)
     return gt_xfputs(str, stdout);
+  if (genfile->block_writer) {
+    return gt_gzip_block_writer_write(genfile->block_writer, str,
+                                      strlen(str));
+  }
   switch (genfile->mode) {
     case GFM_UNCOMPRESSED:
       gt_xfputs(str, genfile->fileptr.file);
@@ -318,6 +369,7 @@ int gt_file_xread(GtFile *genfile, void *buf, size_t nbytes)
 {
   int rval = -1;
   if (genfile) {
+    gt_assert(!genfile->block_writer);
     switch (genfile->mode) {
       case GFM_UNCOMPRESSED:
         rval = gt_xfread(buf, 1, nbytes, genfile->fileptr.file);
@@ -342,6 +394,10 @@ void gt_file_xwrite(GtFile *genfile, void *buf, size_t nbytes)
     gt_xfwrite(buf, 1, nbytes, stdout);
     return;
   }
+  if (genfile->block_writer) {
+    gt_gzip_block_writer_write(genfile->block_writer, buf, nbytes);
+    return;
+  }
   switch (genfile->mode) {
     case GFM_UNCOMPRESSED:
       gt_xfwrite(buf, 1, nbytes, genfile->fileptr.file);
@@ -358,7 +414,7 @@ void gt_file_xwrite(GtFile *genfile, void *buf, size_t nbytes)
 
 void gt_file_xrewind(GtFile *genfile)
 {
-  gt_assert(genfile);
+  gt_assert(genfile && !genfile->block_writer);
   switch (genfile->mode) {
     case GFM_UNCOMPRESSED:
       rewind(genfile->fileptr.file);
@@ -385,6 +441,12 @@ void gt_file_delete_without_handle(GtFile *genfile)
 void gt_file_delete(GtFile *genfile)
 {
   if (!genfile) return;
+  if (genfile->block_writer) {
+    gt_gzip_block_writer_delete(genfile->block_writer);
+    gt_fa_fclose(genfile->fileptr.file);
+    gt_file_delete_without_handle(genfile);
+    return;
+  }
   switch (genfile->mode) {
     case GFM_UNCOMPRESSED:
         if (!genfile->is_stdin)
@@ -56,6 +56,13 @@ GtFile*    gt_file_xopen_w_gfmode(GtFileMode, const char *path,
    automatically via gt_file_mode_determine(path). */
 GtFile*    gt_file_xopen(const char *path, const char *mode);
 
+/* Create a new GtFile object for writing the gzip compressed file <path>.
+   The output is compressed in independent blocks by <nof_threads> threads
+   (see <gt_gzip_block_writer_new()>). Aborts if the file <path> could not be
+   opened. */
+GtFile*    gt_file_xopen_gzip_parallel(const char *path,
+                                       unsigned int nof_threads);
+
 /* Create a new GtFile object from a normal file pointer. */
 GtFile*    gt_file_new_from_fileptr(FILE*);
 
@@ -0,0 +1,295 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "core/assert_api.h"
+#include "core/ensure.h"
+#include "core/fa.h"
+#include "core/gzip_block_writer.h"
+#include "core/ma.h"
+#include "core/minmax.h"
+#include "core/thread.h"
+#include "core/xansi.h"
+#include "core/xzlib.h"
+
+/* the uncompressed size of a block */
+#define GZIP_BLOCK_SIZE  (1UL << 20)
+
+typedef struct {
+  unsigned char *in,
+                *out;
+  size_t in_length,
+         out_length,
+         out_allocated;
+  bool compressed;
+} GzipBlock;
+
+struct GtGzipBlockWriter {
+  FILE *fp;
+  GzipBlock *blocks; /* ring buffer, block <i> is stored at i % nof_blocks */
+  unsigned long nof_blocks,
+                submitted, /* number of blocks handed over for compression */
+                next_job,  /* next block to be compressed by a thread */
+                written;   /* number of blocks written to <fp> */
+  GtThread **threads;
+  unsigned int nof_threads;
+  GtMutex *mutex;
+  GtCondition *job_available,
+              *job_finished;
+  bool finish;
+};
+
+static void compress_block(GzipBlock *block)
+{
+  z_stream strm;
+  int rval;
+  gt_assert(block);
+  memset(&strm, 0, sizeof strm);
+  /* a window size of 15 + 16 produces a gzip header and trailer */
+  if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    fprintf(stderr, "cannot initialize gzip compression: %s\n",
+            strm.msg ? strm.msg : "unknown error");
+    exit(EXIT_FAILURE);
+  }
+  /* leave room for the gzip header and trailer */
+  block->out_allocated = deflateBound(&strm, block->in_length) + 32;
+  block->out = gt_realloc(block->out, block->out_allocated);
+  strm.next_in = block->in;
+  strm.avail_in = block->in_length;
+  strm.next_out = block->out;
+  strm.avail_out = block->out_allocated;
+  while ((rval = deflate(&strm, Z_FINISH)) == Z_OK) {
+    /* output buffer too small (should not happen) -> enlarge it */
+    block->out_allocated *= 2;
+    block->out = gt_realloc(block->out, block->out_allocated);
+    strm.next_out = block->out + strm.total_out;
+    strm.avail_out = block->out_allocated - strm.total_out;
+  }
+  if (rval != Z_STREAM_END) {
+    fprintf(stderr, "cannot compress block: %s\n",
+            strm.msg ? strm.msg : "unknown error");
+    exit(EXIT_FAILURE);
+  }
+  block->out_length = strm.total_out;
+  deflateEnd(&strm);
+  block->in_length = 0;
+}
+
+static void* compress_blocks(void *data)
+{
+  GtGzipBlockWriter *gbw = data;
+  GzipBlock *block;
+  gt_mutex_lock(gbw->mutex);
+  for (;;) {
+    while (gbw->next_job == gbw->submitted && !gbw->finish)
+      gt_condition_wait(gbw->job_available, gbw->mutex);
+    if (gbw->next_job == gbw->submitted)
+      break; /* finished and no jobs left */
+    block = gbw->blocks + gbw->next_job++ % gbw->nof_blocks;
+    gt_mutex_unlock(gbw->mutex);
+    compress_block(block);
+    gt_mutex_lock(gbw->mutex);
+    block->compressed = true;
+    gt_condition_signal(gbw->job_finished);
+  }
+  gt_mutex_unlock(gbw->mutex);
+  return NULL;
+}
+
+GtGzipBlockWriter* gt_gzip_block_writer_new(FILE *fp, unsigned int nof_threads)
+{
+  GtGzipBlockWriter *gbw;
+  unsigned int i;
+  gt_assert(fp);
+  gbw = gt_calloc(1, sizeof *gbw);
+  gbw->fp = fp;
+  if (!gt_thread_support())
+    nof_threads = 0;
+  if (nof_threads) {
+    gbw->mutex = gt_mutex_new();
+    gbw->job_available = gt_condition_new();
+    gbw->job_finished = gt_condition_new();
+    gbw->threads = gt_malloc(nof_threads * sizeof (GtThread*));
+    for (i = 0; i < nof_threads; i++) {
+      if (!(gbw->threads[i] = gt_thread_new(compress_blocks, gbw, NULL)))
+        break;
+    }
+    gbw->nof_threads = i;
+  }
+  /* every thread can compress a block while the next ones are filled */
+  gbw->nof_blocks = gbw->nof_threads ? 2 * gbw->nof_threads : 1;
+  gbw->blocks = gt_calloc(gbw->nof_blocks, sizeof (GzipBlock));
+  for (i = 0; i < gbw->nof_blocks; i++)
+    gbw->blocks[i].in = gt_malloc(GZIP_BLOCK_SIZE);
+  return gbw;
+}
+
+/* Write the compressed blocks in order. If <wait> is true, wait until all
+   blocks which have been submitted are written, otherwise wait only until the
+   block which is going to be filled next is free. */
+static void write_blocks(GtGzipBlockWriter *gbw, bool wait)
+{
+  GzipBlock *block;
+  if (!gbw->nof_threads) {
+    for (; gbw->written < gbw->submitted; gbw->written++) {
+      block = gbw->blocks + gbw->written % gbw->nof_blocks;
+      compress_block(block);
+      gt_xfwrite(block->out, 1, block->out_length, gbw->fp);
+    }
+    return;
+  }
+  gt_mutex_lock(gbw->mutex);
+  while (gbw->written < gbw->submitted) {
+    block = gbw->blocks + gbw->written % gbw->nof_blocks;
+    if (!block->compressed) {
+      if (!wait && gbw->submitted - gbw->written < gbw->nof_blocks)
+        break; /* there is a free block */
+      gt_condition_wait(gbw->job_finished, gbw->mutex);
+      continue;
+    }
+    gt_mutex_unlock(gbw->mutex);
+    gt_xfwrite(block->out, 1, block->out_length, gbw->fp);
+    gt_mutex_lock(gbw->mutex);
+    block->compressed = false;
+    gbw->written++;
+  }
+  gt_mutex_unlock(gbw->mutex);
+}
+
+static void submit_block(GtGzipBlockWriter *gbw)
+{
+  if (gbw->nof_threads) {
+    gt_mutex_lock(gbw->mutex);
+    gbw->submitted++;
+    gt_condition_signal(gbw->job_available);
+    gt_mutex_unlock(gbw->mutex);
+  }
+  else
+    gbw->submitted++;
+  write_blocks(gbw, false);
+}
+
+void gt_gzip_block_writer_write(GtGzipBlockWriter *gbw, const void *buf,
+                                size_t nbytes)
+{
+  const unsigned char *data = buf;
+  GzipBlock *block;
+  size_t length;
+  gt_assert(gbw && (buf || !nbytes));
+  while (nbytes) {
+    /* the block after the submitted ones is free (see write_blocks()) */
+    block = gbw->blocks + gbw->submitted % gbw->nof_blocks;
+    length = GZIP_BLOCK_SIZE - block->in_length;
+    if (length > nbytes)
+      length = nbytes;
+    memcpy(block->in + block->in_length, data, length);
+    block->in_length += length;
+    data += length;
+    nbytes -= length;
+    if (block->in_length == GZIP_BLOCK_SIZE)
+      submit_block(gbw);
+  }
+}
+
+void gt_gzip_block_writer_delete(GtGzipBlockWriter *gbw)
+{
+  unsigned long i;
+  if (!gbw) return;
+  /* submit the last block, an empty one is only needed for empty files to
+     make sure that they are still valid gzip files */
+  if (gbw->blocks[gbw->submitted % gbw->nof_blocks].in_length ||
+      !gbw->submitted) {
+    submit_block(gbw);
+  }
+  write_blocks(gbw, true);
+  if (gbw->nof_threads) {
+    gt_mutex_lock(gbw->mutex);
+    gbw->finish = true;
+    gt_condition_broadcast(gbw->job_available);
+    gt_mutex_unlock(gbw->mutex);
+    for (i = 0; i < gbw->nof_threads; i++)
+      gt_thread_join(gbw->threads[i]);
+  }
+  gt_free(gbw->threads);
+  gt_condition_delete(gbw->job_finished);
+  gt_condition_delete(gbw->job_available);
+  gt_mutex_delete(gbw->mutex);
+  for (i = 0; i < gbw->nof_blocks; i++) {
+    gt_free(gbw->blocks[i].in);
+    gt_free(gbw->blocks[i].out);
+  }
+  gt_free(gbw->blocks);
+  gt_free(gbw);
+}
+
+static int check_gzip_block_writer(unsigned int nof_threads, size_t length,
+                                   GtError *err)
+{
+  unsigned char *data, *buf;
+  GtGzipBlockWriter *gbw;
+  GtStr *tmpfilename;
+  FILE *tmpfp;
+  gzFile gzfp;
+  size_t i, written;
+  int had_err = 0;
+  gt_error_check(err);
+
+  data = gt_malloc(length + 1);
+  buf = gt_malloc(length + 1);
+  for (i = 0; i < length; i++)
+    data[i] = "acgt\n"[rand() % 5];
+
+  /* write the data in chunks of varying size */
+  tmpfilename = gt_str_new();
+  tmpfp = gt_xtmpfp(tmpfilename);
+  gbw = gt_gzip_block_writer_new(tmpfp, nof_threads);
+  for (written = 0; written < length; written += i) {
+    i = MIN(length - written, (size_t) rand() % 100000);
+    gt_gzip_block_writer_write(gbw, data + written, i);
+  }
+  gt_gzip_block_writer_delete(gbw);
+  gt_fa_xfclose(tmpfp);
+
+  /* read it back, the concatenated gzip members must form the original data */
+  gzfp = gt_xgzopen(gt_str_get(tmpfilename), "rb");
+  ensure(had_err, (size_t) gt_xgzread(gzfp, buf, length + 1) == length);
+  ensure(had_err, !memcmp(data, buf, length));
+  gt_xgzclose(gzfp);
+
+  gt_xremove(gt_str_get(tmpfilename));
+  gt_str_delete(tmpfilename);
+  gt_free(buf);
+  gt_free(data);
+  return had_err;
+}
+
+int gt_gzip_block_writer_unit_test(GtError *err)
+{
+  int had_err = 0;
+  gt_error_check(err);
+  had_err = check_gzip_block_writer(0, 0, err);
+  if (!had_err)
+    had_err = check_gzip_block_writer(0, 3 * GZIP_BLOCK_SIZE + 17, err);
+  if (!had_err)
+    had_err = check_gzip_block_writer(3, 7 * GZIP_BLOCK_SIZE + 5, err);
+  if (!had_err)
+    had_err = check_gzip_block_writer(2, GZIP_BLOCK_SIZE, err);
+  return had_err;
+}
@@ -0,0 +1,44 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef GZIP_BLOCK_WRITER_H
+#define GZIP_BLOCK_WRITER_H
+
+#include <stdio.h>
+#include "core/error.h"
+
+/* A <GtGzipBlockWriter> collects the data written to it into blocks of a fixed
+   size and compresses every block into a separate gzip member. The resulting
+   file is a valid gzip file (the members are concatenated), but the blocks
+   can be compressed by several threads in parallel. */
+typedef struct GtGzipBlockWriter GtGzipBlockWriter;
+
+/* Return a new <GtGzipBlockWriter> which writes the compressed data to <fp>
+   (which stays owned by the caller). The blocks are compressed by
+   <nof_threads> threads in the background while the caller produces the
+   next ones. If <nof_threads> is 0 or GenomeTools has been compiled without
+   thread support, the blocks are compressed by the calling thread. */
+GtGzipBlockWriter* gt_gzip_block_writer_new(FILE *fp, unsigned int nof_threads);
+/* Append <nbytes> from <buf> to <gzip_block_writer>. */
+void               gt_gzip_block_writer_write(GtGzipBlockWriter
+                                              *gzip_block_writer,
+                                              const void *buf, size_t nbytes);
+/* Compress and write all pending data and delete <gzip_block_writer>. */
+void               gt_gzip_block_writer_delete(GtGzipBlockWriter*);
+int                gt_gzip_block_writer_unit_test(GtError*);
+
+#endif
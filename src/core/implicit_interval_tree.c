@@ -0,0 +1,318 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "core/ensure.h"
+#include "core/implicit_interval_tree.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/msort_api.h"
+#include "core/range_api.h"
+
+/* The layout of the implicit tree follows H. Li's cgranges library: the
+   elements with even index are the leaves, an element whose index ends with
+   exactly <k> one bits (in binary) is an inner node on level <k>, which has
+   its children at index +/- 2^(k-1). Missing right children (beyond the end of
+   the array) are represented by the maximum of the rightmost existing subtree
+   on that level. */
+
+#define IMPLICIT_INTERVAL_TREE_SMALL_LEVEL  3
+#define IMPLICIT_INTERVAL_TREE_STACK_SIZE   128
+
+typedef struct {
+  unsigned long low,
+                high,
+                max; /* maximum <high> in the subtree of this element */
+  void *data;
+} ImplicitInterval;
+
+struct GtImplicitIntervalTree {
+  GtArray *intervals;
+  unsigned long nof_sorted; /* the intervals before this index are sorted and
+                               augmented */
+  int root_level;
+  GtFree free_func;
+};
+
+GtImplicitIntervalTree* gt_implicit_interval_tree_new(GtFree free_func)
+{
+  GtImplicitIntervalTree *iit = gt_malloc(sizeof *iit);
+  iit->intervals = gt_array_new(sizeof (ImplicitInterval));
+  iit->nof_sorted = 0;
+  iit->root_level = -1;
+  iit->free_func = free_func;
+  return iit;
+}
+
+void gt_implicit_interval_tree_add(GtImplicitIntervalTree *iit, void *data,
+                                   unsigned long low, unsigned long high)
+{
+  ImplicitInterval interval;
+  gt_assert(iit && low <= high);
+  interval.low = low;
+  interval.high = high;
+  interval.max = high;
+  interval.data = data;
+  gt_array_add(iit->intervals, interval);
+}
+
+unsigned long gt_implicit_interval_tree_size(const GtImplicitIntervalTree *iit)
+{
+  gt_assert(iit);
+  return gt_array_size(iit->intervals);
+}
+
+static int compare_intervals(const void *a, const void *b)
+{
+  const ImplicitInterval *ia = a, *ib = b;
+  if (ia->low != ib->low)
+    return ia->low < ib->low ? -1 : 1;
+  if (ia->high != ib->high)
+    return ia->high < ib->high ? -1 : 1;
+  return 0;
+}
+
+/* Sets the <max> of all <n> elements of <a>, returns the level of the root. */
+static int augment(ImplicitInterval *a, unsigned long n)
+{
+  unsigned long i, x, last_i = 0, last = 0, max;
+  int k;
+  gt_assert(a && n);
+  for (i = 0; i < n; i += 2) {
+    last_i = i;
+    last = a[i].max = a[i].high;
+  }
+  for (k = 1; 1UL << k <= n; k++) {
+    x = 1UL << (k - 1);
+    for (i = (x << 1) - 1; i < n; i += x << 2) {
+      max = a[i].high;
+      if (a[i - x].max > max)
+        max = a[i - x].max;
+      if (i + x < n) {
+        if (a[i + x].max > max)
+          max = a[i + x].max;
+      }
+      else if (last > max)
+        max = last;
+      a[i].max = max;
+    }
+    /* move to the parent of the rightmost subtree */
+    last_i = (last_i >> k & 1) ? last_i - x : last_i + x;
+    if (last_i < n && a[last_i].max > last)
+      last = a[last_i].max;
+  }
+  return k - 1;
+}
+
+void gt_implicit_interval_tree_build(GtImplicitIntervalTree *iit)
+{
+  ImplicitInterval *a, *merged;
+  unsigned long n, i, j, k;
+  gt_assert(iit);
+  n = gt_array_size(iit->intervals);
+  if (iit->nof_sorted == n)
+    return;
+  a = gt_array_get_space(iit->intervals);
+  /* sort the new intervals and merge them with the sorted ones (the old ones
+     come first for equal ranges to keep the insertion order) */
+  gt_msort(a + iit->nof_sorted, n - iit->nof_sorted, sizeof *a,
+           compare_intervals);
+  if (iit->nof_sorted) {
+    merged = gt_malloc(n * sizeof *merged);
+    for (i = 0, j = iit->nof_sorted, k = 0; i < iit->nof_sorted && j < n; k++)
+      merged[k] = compare_intervals(a + j, a + i) < 0 ? a[j++] : a[i++];
+    while (i < iit->nof_sorted)
+      merged[k++] = a[i++];
+    while (j < n)
+      merged[k++] = a[j++];
+    memcpy(a, merged, n * sizeof *a);
+    gt_free(merged);
+  }
+  iit->root_level = augment(a, n);
+  iit->nof_sorted = n;
+}
+
+void gt_implicit_interval_tree_find_all_overlapping(GtImplicitIntervalTree
+                                                    *iit,
+                                                    unsigned long start,
+                                                    unsigned long end,
+                                                    GtArray *results)
+{
+  struct {
+    unsigned long x;
+    int k;
+    bool left_done;
+  } stack[IMPLICIT_INTERVAL_TREE_STACK_SIZE], z;
+  ImplicitInterval *a;
+  unsigned long n, i, i_end, y;
+  int t = 0;
+  gt_assert(iit && start <= end && results);
+  gt_implicit_interval_tree_build(iit);
+  if (!(n = gt_array_size(iit->intervals)))
+    return;
+  a = gt_array_get_space(iit->intervals);
+  /* in-order traversal of the overlapping subtrees, which reports the
+     intervals sorted by their start */
+  stack[t].x = (1UL << iit->root_level) - 1;
+  stack[t].k = iit->root_level;
+  stack[t++].left_done = false;
+  while (t) {
+    z = stack[--t];
+    if (z.k <= IMPLICIT_INTERVAL_TREE_SMALL_LEVEL) {
+      /* small subtree, scan it */
+      i = z.x >> z.k << z.k;
+      i_end = i + (1UL << (z.k + 1)) - 1;
+      if (i_end > n)
+        i_end = n;
+      for (; i < i_end && a[i].low <= end; i++) {
+        if (a[i].high >= start)
+          gt_array_add(results, a[i].data);
+      }
+    }
+    else if (!z.left_done) {
+      /* revisit this node after its left subtree */
+      y = z.x - (1UL << (z.k - 1));
+      stack[t] = z;
+      stack[t++].left_done = true;
+      if (y >= n || a[y].max >= start) {
+        stack[t].x = y;
+        stack[t].k = z.k - 1;
+        stack[t++].left_done = false;
+      }
+    }
+    else if (z.x < n && a[z.x].low <= end) {
+      if (a[z.x].high >= start)
+        gt_array_add(results, a[z.x].data);
+      stack[t].x = z.x + (1UL << (z.k - 1));
+      stack[t].k = z.k - 1;
+      stack[t++].left_done = false;
+    }
+    gt_assert(t < IMPLICIT_INTERVAL_TREE_STACK_SIZE - 1);
+  }
+}
+
+void gt_implicit_interval_tree_get_all(GtImplicitIntervalTree *iit,
+                                       GtArray *results)
+{
+  ImplicitInterval *a;
+  unsigned long i;
+  gt_assert(iit && results);
+  gt_implicit_interval_tree_build(iit);
+  a = gt_array_get_space(iit->intervals);
+  for (i = 0; i < gt_array_size(iit->intervals); i++)
+    gt_array_add(results, a[i].data);
+}
+
+void gt_implicit_interval_tree_delete(GtImplicitIntervalTree *iit)
+{
+  ImplicitInterval *a;
+  unsigned long i;
+  if (!iit) return;
+  if (iit->free_func) {
+    a = gt_array_get_space(iit->intervals);
+    for (i = 0; i < gt_array_size(iit->intervals); i++)
+      iit->free_func(a[i].data);
+  }
+  gt_array_delete(iit->intervals);
+  gt_free(iit);
+}
+
+static int range_ptr_compare(const void *r1p, const void *r2p)
+{
+  return gt_range_compare(*(const GtRange**) r1p, *(const GtRange**) r2p);
+}
+
+int gt_implicit_interval_tree_unit_test(GtError *err)
+{
+  GtImplicitIntervalTree *iit;
+  GtArray *ranges, *res, *ref;
+  GtRange *rng, qrange;
+  unsigned long i, j, nof_ranges;
+  const unsigned long max_basepos = 90000,
+                      width = 700,
+                      query_width = 5000,
+                      nof_samples = 300;
+  int had_err = 0;
+  gt_error_check(err);
+
+  iit = gt_implicit_interval_tree_new(gt_free_func);
+  ranges = gt_array_new(sizeof (GtRange*));
+  res = gt_array_new(sizeof (GtRange*));
+  ref = gt_array_new(sizeof (GtRange*));
+
+  /* empty tree */
+  gt_implicit_interval_tree_find_all_overlapping(iit, 1, max_basepos, res);
+  ensure(had_err, gt_array_size(res) == 0);
+
+  /* add the ranges in several rounds with queries in between, which tests the
+     incremental building for trees of various sizes */
+  for (nof_ranges = 1; !had_err && nof_ranges <= 3000; nof_ranges *= 3) {
+    while (gt_array_size(ranges) < nof_ranges) {
+      rng = gt_malloc(sizeof *rng);
+      rng->start = gt_rand_max(max_basepos);
+      rng->end = rng->start + gt_rand_max(width);
+      gt_array_add(ranges, rng);
+      gt_implicit_interval_tree_add(iit, rng, rng->start, rng->end);
+    }
+    ensure(had_err, gt_implicit_interval_tree_size(iit) == nof_ranges);
+    for (i = 0; !had_err && i < nof_samples; i++) {
+      qrange.start = gt_rand_max(max_basepos);
+      qrange.end = qrange.start + gt_rand_max(query_width);
+      gt_array_reset(res);
+      gt_implicit_interval_tree_find_all_overlapping(iit, qrange.start,
+                                                     qrange.end, res);
+      /* the results have to be sorted already */
+      for (j = 1; !had_err && j < gt_array_size(res); j++) {
+        ensure(had_err, range_ptr_compare(gt_array_get(res, j - 1),
+                                          gt_array_get(res, j)) <= 0);
+      }
+      /* compare with a linear search */
+      gt_array_reset(ref);
+      for (j = 0; j < gt_array_size(ranges); j++) {
+        rng = *(GtRange**) gt_array_get(ranges, j);
+        if (gt_range_overlap(rng, &qrange))
+          gt_array_add(ref, rng);
+      }
+      ensure(had_err, gt_array_size(res) == gt_array_size(ref));
+      if (!had_err) {
+        gt_array_sort_stable(ref, range_ptr_compare);
+        gt_array_sort_stable(res, range_ptr_compare);
+        for (j = 0; !had_err && j < gt_array_size(res); j++) {
+          ensure(had_err, !gt_range_compare(*(GtRange**) gt_array_get(res, j),
+                                            *(GtRange**) gt_array_get(ref, j)));
+        }
+      }
+    }
+  }
+
+  /* all intervals, sorted */
+  if (!had_err) {
+    gt_array_reset(res);
+    gt_implicit_interval_tree_get_all(iit, res);
+    ensure(had_err, gt_array_size(res) == gt_array_size(ranges));
+    for (j = 1; !had_err && j < gt_array_size(res); j++) {
+      ensure(had_err, range_ptr_compare(gt_array_get(res, j - 1),
+                                        gt_array_get(res, j)) <= 0);
+    }
+  }
+
+  gt_array_delete(ref);
+  gt_array_delete(res);
+  gt_array_delete(ranges);
+  gt_implicit_interval_tree_delete(iit);
+  return had_err;
+}
@@ -0,0 +1,66 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef IMPLICIT_INTERVAL_TREE_H
+#define IMPLICIT_INTERVAL_TREE_H
+
+#include "core/array_api.h"
+#include "core/error_api.h"
+#include "core/fptr_api.h"
+
+/* An interval index for mostly static data. The intervals are kept in one
+   contiguous array sorted by start position, which is at the same time used as
+   an implicit, augmented binary search tree (every element stores the maximum
+   end position of its subtree). Adding an interval just appends it, the array
+   is (re)built on the next query. Queries report the overlapping intervals in
+   start order (intervals with equal ranges in insertion order). */
+typedef struct GtImplicitIntervalTree GtImplicitIntervalTree;
+
+/* Creates a new <GtImplicitIntervalTree>. If a <GtFree> function is given, it
+   is applied to the data pointers of all added intervals when the tree is
+   deleted. */
+GtImplicitIntervalTree* gt_implicit_interval_tree_new(GtFree);
+/* Adds the interval from <low> to <high> with the associated <data>. */
+void                    gt_implicit_interval_tree_add(GtImplicitIntervalTree*,
+                                                      void *data,
+                                                      unsigned long low,
+                                                      unsigned long high);
+/* Returns the number of intervals in the tree. */
+unsigned long           gt_implicit_interval_tree_size(const
+                                                       GtImplicitIntervalTree*);
+/* Sorts the intervals added since the last call and rebuilds the tree. Called
+   implicitly by the query functions, calling it explicitly after the last
+   interval has been added keeps the building cost out of the first query. */
+void                    gt_implicit_interval_tree_build(
+                                                  GtImplicitIntervalTree*);
+/* Appends the data pointers of all intervals which overlap the range from
+   <start> to <end> to <results>, sorted by the start of the intervals. */
+void                    gt_implicit_interval_tree_find_all_overlapping(
+                                                  GtImplicitIntervalTree*,
+                                                  unsigned long start,
+                                                  unsigned long end,
+                                                  GtArray *results);
+/* Appends the data pointers of all intervals to <results>, sorted by the
+   start of the intervals. */
+void                    gt_implicit_interval_tree_get_all(
+                                                  GtImplicitIntervalTree*,
+                                                  GtArray *results);
+void                    gt_implicit_interval_tree_delete(
+                                                  GtImplicitIntervalTree*);
+int                     gt_implicit_interval_tree_unit_test(GtError*);
+
+#endif
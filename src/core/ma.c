@@ -16,6 +16,9 @@
 */
 
 #include <stdbool.h>
+#ifdef GT_THREADS_ENABLED
+#include <pthread.h>
+#endif
 #include "core/hashmap.h"
 #include "core/ma.h"
 #include "core/unused_api.h"
@@ -24,14 +27,29 @@
 /* the memory allocator class */
 typedef struct {
   GtHashmap *allocated_pointer;
-  bool bookkeeping;
+  bool bookkeeping,
+       locking;
   unsigned long long mallocevents;
   unsigned long current_size,
-                max_size;
+                max_size,
+                local_max_size;
 } MA;
 
 static MA *ma = NULL;
 
+#ifdef GT_THREADS_ENABLED
+/* protects the bookkeeping, it has to be recursive because the hashmap of
+   allocated pointers allocates its memory with gt_malloc() itself */
+static pthread_mutex_t bookkeeping_mutex;
+#define ma_lock(MA)\
+        if ((MA)->locking) pthread_mutex_lock(&bookkeeping_mutex)
+#define ma_unlock(MA)\
+        if ((MA)->locking) pthread_mutex_unlock(&bookkeeping_mutex)
+#else
+#define ma_lock(MA)
+#define ma_unlock(MA)
+#endif
+
 typedef struct {
   size_t size;
   const char *filename;
@@ -97,6 +115,16 @@ void gt_ma_init(bool bookkeeping)
   gt_assert(!ma->bookkeeping);
   ma->allocated_pointer = gt_hashmap_new(HASH_DIRECT, NULL,
                                          (GtFree) ma_info_free);
+#ifdef GT_THREADS_ENABLED
+  if (bookkeeping) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&bookkeeping_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    ma->locking = true;
+  }
+#endif
   /* MA is ready to use */
   ma->bookkeeping = bookkeeping;
 }
@@ -107,6 +135,8 @@ static void add_size(MA* ma, unsigned long size)
   ma->current_size += size;
   if (ma->current_size > ma->max_size)
     ma->max_size = ma->current_size;
+  if (ma->current_size > ma->local_max_size)
+    ma->local_max_size = ma->current_size;
 }
 
 static void subtract_size(MA *ma, unsigned long size)
@@ -122,6 +152,7 @@ void* gt_malloc_mem(size_t size, const char *filename, int line)
   void *mem;
   if (!ma) gt_ma_init(false);
   gt_assert(ma);
+  ma_lock(ma);
   if (ma->bookkeeping) {
     ma->bookkeeping = false;
     ma->mallocevents++;
@@ -133,8 +164,10 @@ void* gt_malloc_mem(size_t size, const char *filename, int line)
     gt_hashmap_add(ma->allocated_pointer, mem, mainfo);
     add_size(ma, size);
     ma->bookkeeping = true;
+    ma_unlock(ma);
     return mem;
   }
+  ma_unlock(ma);
   return xmalloc(size, ma->current_size, filename, line);
 }
 
@@ -144,6 +177,7 @@ void* gt_calloc_mem(size_t nmemb, size_t size, const char *filename, int line)
   void *mem;
   if (!ma) gt_ma_init(false);
   gt_assert(ma);
+  ma_lock(ma);
   if (ma->bookkeeping) {
     ma->bookkeeping = false;
     ma->mallocevents++;
@@ -155,8 +189,10 @@ void* gt_calloc_mem(size_t nmemb, size_t size, const char *filename, int line)
     gt_hashmap_add(ma->allocated_pointer, mem, mainfo);
     add_size(ma, nmemb * size);
     ma->bookkeeping = true;
+    ma_unlock(ma);
     return mem;
   }
+  ma_unlock(ma);
   return xcalloc(nmemb, size, ma->current_size, filename, line);
 }
 
@@ -166,6 +202,7 @@ void* gt_realloc_mem(void *ptr, size_t size, const char *filename, int line)
   void *mem;
   if (!ma) gt_ma_init(false);
   gt_assert(ma);
+  ma_lock(ma);
   if (ma->bookkeeping) {
     ma->bookkeeping = false;
     ma->mallocevents++;
@@ -183,8 +220,10 @@ void* gt_realloc_mem(void *ptr, size_t size, const char *filename, int line)
     gt_hashmap_add(ma->allocated_pointer, mem, mainfo);
     add_size(ma, size);
     ma->bookkeeping = true;
+    ma_unlock(ma);
     return mem;
   }
+  ma_unlock(ma);
   return xrealloc(ptr, size, ma->current_size, filename, line);
 }
 
@@ -193,6 +232,7 @@ void gt_free_mem(void *ptr, GT_UNUSED const char *filename, GT_UNUSED int line)
   MAInfo *mainfo;
   gt_assert(ma);
   if (!ptr) return;
+  ma_lock(ma);
   if (ma->bookkeeping) {
     ma->bookkeeping = false;
 #ifndef NDEBUG
@@ -208,9 +248,12 @@ void gt_free_mem(void *ptr, GT_UNUSED const char *filename, GT_UNUSED int line)
     gt_hashmap_remove(ma->allocated_pointer, ptr);
     free(ptr);
     ma->bookkeeping = true;
+    ma_unlock(ma);
   }
-  else
+  else {
+    ma_unlock(ma);
     free(ptr);
+  }
 }
 
 void gt_free_func(void *ptr)
@@ -241,6 +284,50 @@ unsigned long gt_ma_get_space_peak(void)
   return ma->max_size;
 }
 
+unsigned long gt_ma_get_space_current(void)
+{
+  unsigned long current_size;
+  gt_assert(ma);
+  ma_lock(ma);
+  current_size = ma->current_size;
+  ma_unlock(ma);
+  return current_size;
+}
+
+void gt_ma_reset_local_space_peak(void)
+{
+  gt_assert(ma);
+  ma_lock(ma);
+  ma->local_max_size = ma->current_size;
+  ma_unlock(ma);
+}
+
+unsigned long gt_ma_get_local_space_peak(void)
+{
+  unsigned long local_max_size;
+  gt_assert(ma);
+  ma_lock(ma);
+  local_max_size = ma->local_max_size;
+  ma_unlock(ma);
+  return local_max_size;
+}
+
+unsigned long long gt_ma_get_mallocevents(void)
+{
+  unsigned long long mallocevents;
+  gt_assert(ma);
+  ma_lock(ma);
+  mallocevents = ma->mallocevents;
+  ma_unlock(ma);
+  return mallocevents;
+}
+
+bool gt_ma_bookkeeping_enabled(void)
+{
+  gt_assert(ma);
+  return ma->bookkeeping;
+}
+
 void gt_ma_show_space_peak(FILE *fp)
 {
   gt_assert(ma);
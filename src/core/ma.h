@@ -26,6 +26,16 @@
 void          gt_ma_init(bool bookkeeping);
 unsigned long gt_ma_get_space_peak(void); /* in bytes */
 void          gt_ma_show_space_peak(FILE*);
+/* the following functions only report meaningful values if bookkeeping is
+   enabled */
+unsigned long gt_ma_get_space_current(void); /* in bytes */
+/* the local space peak is the peak since the last call of
+   <gt_ma_reset_local_space_peak()>, it does not affect the global one */
+void          gt_ma_reset_local_space_peak(void);
+unsigned long gt_ma_get_local_space_peak(void); /* in bytes */
+/* the number of allocations and reallocations */
+unsigned long long gt_ma_get_mallocevents(void);
+bool          gt_ma_bookkeeping_enabled(void);
 /* check if all allocated memory has been freed, prints to stderr */
 int           gt_ma_check_space_leak(void);
 void          gt_ma_clean(void);
@@ -18,7 +18,9 @@
 #include <string.h>
 #include "core/fileutils_api.h"
 #include "core/ma.h"
+#include "core/minmax.h"
 #include "core/outputfile.h"
+#include "core/thread.h"
 #include "core/warning_api.h"
 
 struct GtOutputFileInfo {
@@ -26,6 +28,7 @@ struct GtOutputFileInfo {
   bool gzip,
        bzip2,
        force;
+  unsigned int compthreads;
   GtFile **outfp;
 };
 
@@ -34,6 +37,7 @@ GtOutputFileInfo* gt_outputfileinfo_new(void)
   GtOutputFileInfo *ofi;
   ofi = gt_malloc(sizeof (GtOutputFileInfo));
   ofi->output_filename = gt_str_new();
+  ofi->compthreads = 0;
   return ofi;
 }
 
@@ -72,19 +76,31 @@ static int determine_outfp(void *data, GtError *err)
         had_err = -1;
     }
     if (!had_err) {
-      *ofi->outfp = gt_file_xopen_w_gfmode(genfilemode,
-                                              gt_str_get(ofi->output_filename),
-                                              "w");
+      if (ofi->compthreads) {
+        /* one processor is needed to produce the output, more compression
+           threads than the remaining processors would only compete for them */
+        unsigned int nof_threads = MIN(ofi->compthreads,
+                                       gt_thread_nof_processors() - 1);
+        gt_assert(genfilemode == GFM_GZIP);
+        *ofi->outfp =
+          gt_file_xopen_gzip_parallel(gt_str_get(ofi->output_filename),
+                                      nof_threads);
+      }
+      else {
+        *ofi->outfp = gt_file_xopen_w_gfmode(genfilemode,
+                                             gt_str_get(ofi->output_filename),
+                                             "w");
+      }
       gt_assert(*ofi->outfp);
     }
   }
   return had_err;
 }
 
-void gt_outputfile_register_options(GtOptionParser *op, GtFile **outfp,
-                                 GtOutputFileInfo *ofi)
+static void register_options(GtOptionParser *op, GtFile **outfp,
+                             GtOutputFileInfo *ofi, bool compthreads)
 {
-  GtOption *opto, *optgzip, *optbzip2, *optforce;
+  GtOption *opto, *optgzip, *optbzip2, *optcompthreads = NULL, *optforce;
   gt_assert(outfp && ofi);
   ofi->outfp = outfp;
   /* register option -o */
@@ -99,6 +115,14 @@ void gt_outputfile_register_options(GtOptionParser *op, GtFile **outfp,
   optbzip2 = gt_option_new_bool("bzip2", "write bzip2 compressed output file",
                              &ofi->bzip2, false);
   gt_option_parser_add_option(op, optbzip2);
+  /* register option -compthreads */
+  if (compthreads) {
+    optcompthreads = gt_option_new_uint("compthreads", "compress the gzip "
+                                        "output file in independent blocks "
+                                        "with the given number of threads",
+                                        &ofi->compthreads, 0);
+    gt_option_parser_add_option(op, optcompthreads);
+  }
   /* register option -force */
   optforce = gt_option_new_bool(FORCE_OPT_CSTR, "force writing to output file",
                              &ofi->force, false);
@@ -109,10 +133,28 @@ void gt_outputfile_register_options(GtOptionParser *op, GtFile **outfp,
   gt_option_imply(optgzip, opto);
   gt_option_imply(optbzip2, opto);
   gt_option_imply(optforce, opto);
+  if (optcompthreads) {
+    /* the blocks are gzip members, bzip2 output cannot be split */
+    gt_option_imply(optcompthreads, optgzip);
+    gt_option_exclude(optcompthreads, optbzip2);
+  }
   /* set hook function to determine <outfp> */
   gt_option_parser_register_hook(op, determine_outfp, ofi);
 }
 
+void gt_outputfile_register_options(GtOptionParser *op, GtFile **outfp,
+                                    GtOutputFileInfo *ofi)
+{
+  register_options(op, outfp, ofi, false);
+}
+
+void gt_outputfile_register_options_with_compthreads(GtOptionParser *op,
+                                                     GtFile **outfp,
+                                                     GtOutputFileInfo *ofi)
+{
+  register_options(op, outfp, ofi, true);
+}
+
 void gt_outputfileinfo_delete(GtOutputFileInfo *ofi)
 {
   if (!ofi) return;
@@ -28,6 +28,13 @@ GtOutputFileInfo* gt_outputfileinfo_new(void);
 void              gt_outputfile_register_options(GtOptionParser*,
                                                  GtFile **outfp,
                                                  GtOutputFileInfo*);
+/* Like gt_outputfile_register_options(), but also registers option
+   -compthreads, which compresses the gzip output file in blocks with several
+   threads. Only for tools which write their output in large blocks. */
+void              gt_outputfile_register_options_with_compthreads(
+                                                        GtOptionParser*,
+                                                        GtFile **outfp,
+                                                        GtOutputFileInfo*);
 void              gt_outputfileinfo_delete(GtOutputFileInfo*);
 
 #endif
@@ -220,7 +220,13 @@ GtStr* gt_str_clone(const GtStr *s)
 GtStr* gt_str_ref(GtStr *s)
 {
   if (!s) return NULL;
+#ifdef GT_THREADS_ENABLED
+  /* strings like sequence ids are shared between feature trees, which might
+     be processed in different threads */
+  __sync_fetch_and_add(&s->reference_count, 1);
+#else
   s->reference_count++; /* increase the reference counter */
+#endif
   return s;
 }
 
@@ -355,10 +361,17 @@ int gt_str_unit_test(GtError *err)
 void gt_str_delete(GtStr *s)
 {
   if (!s) return;           /* return without action if 's' is NULL */
+#ifdef GT_THREADS_ENABLED
+  /* decrement the reference counter, free the object only if this was the
+     last reference */
+  if (__sync_fetch_and_sub(&s->reference_count, 1))
+    return;
+#else
   if (s->reference_count) { /* there are multiple references to this string */
     s->reference_count--;   /* decrement the reference counter */
     return;                 /* return without freeing the object */
   }
+#endif
   gt_free(s->cstr);         /* free the stored the C string */
   gt_free(s);               /* free the actual string object */
 }
@@ -54,6 +54,22 @@ void gt_string_distri_add(GtStringDistri *sd, const char *key)
   sd->num_of_occurrences++;
 }
 
+void gt_string_distri_add_multi(GtStringDistri *sd, const char *key,
+                                unsigned long occurrences)
+{
+  unsigned long *valueptr;
+  gt_assert(sd && key);
+  if (!occurrences)
+    return;
+  valueptr = cstr_ul_gt_hashmap_get(sd->hashdist, key);
+  if (!valueptr) {
+    cstr_ul_gt_hashmap_add(sd->hashdist, gt_cstr_dup(key), occurrences);
+  }
+  else
+    *valueptr += occurrences;
+  sd->num_of_occurrences += occurrences;
+}
+
 void gt_string_distri_sub(GtStringDistri *sd, const char *key)
 {
   unsigned long *valueptr;
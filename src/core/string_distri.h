@@ -30,6 +30,8 @@ typedef void (*GtStringDistriIterFunc)(const char *string,
 
 GtStringDistri* gt_string_distri_new(void);
 void            gt_string_distri_add(GtStringDistri*, const char*);
+void            gt_string_distri_add_multi(GtStringDistri*, const char*,
+                                           unsigned long occurrences);
 /* <string_distri> must contain at least one element with given <key>. */
 void            gt_string_distri_sub(GtStringDistri *string_distri,
                                      const char *key);
@@ -16,22 +16,37 @@
 */
 
 #include <string.h>
+#ifdef GT_THREADS_ENABLED
+#include <pthread.h>
+#endif
 #include "core/cstr_table.h"
 #include "core/symbol.h"
 
 static GtCstrTable *symbols = NULL;
 
+#ifdef GT_THREADS_ENABLED
+/* symbols are also looked up from within worker threads */
+static pthread_mutex_t symbols_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define symbols_lock()   pthread_mutex_lock(&symbols_mutex)
+#define symbols_unlock() pthread_mutex_unlock(&symbols_mutex)
+#else
+#define symbols_lock()
+#define symbols_unlock()
+#endif
+
 const char* gt_symbol(const char *cstr)
 {
   const char *symbol;
   if (!cstr)
     return NULL;
+  symbols_lock();
   if (!symbols)
     symbols = gt_cstr_table_new();
   if (!(symbol = gt_cstr_table_get(symbols, cstr))) {
     gt_cstr_table_add(symbols, cstr);
-    return gt_cstr_table_get(symbols, cstr);
+    symbol = gt_cstr_table_get(symbols, cstr);
   }
+  symbols_unlock();
   return symbol;
 }
 
@@ -0,0 +1,283 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef GT_THREADS_ENABLED
+#include <pthread.h>
+#endif
+#include "core/ensure.h"
+#include "core/ma.h"
+#include "core/thread.h"
+#include "core/unused_api.h"
+
+#ifdef GT_THREADS_ENABLED
+
+struct GtThread {
+  pthread_t id;
+};
+
+struct GtMutex {
+  pthread_mutex_t mutex;
+};
+
+struct GtCondition {
+  pthread_cond_t cond;
+};
+
+static void check_retval(int retval, const char *function)
+{
+  if (retval) {
+    fprintf(stderr, "%s() failed: %s\n", function, strerror(retval));
+    exit(EXIT_FAILURE);
+  }
+}
+
+bool gt_thread_support(void)
+{
+  return true;
+}
+
+GtThread* gt_thread_new(GtThreadFunc function, void *data, GtError *err)
+{
+  GtThread *thread;
+  int retval;
+  gt_error_check(err);
+  gt_assert(function);
+  thread = gt_malloc(sizeof *thread);
+  if ((retval = pthread_create(&thread->id, NULL, function, data))) {
+    gt_error_set(err, "cannot create thread: %s", strerror(retval));
+    gt_free(thread);
+    return NULL;
+  }
+  return thread;
+}
+
+void gt_thread_join(GtThread *thread)
+{
+  gt_assert(thread);
+  check_retval(pthread_join(thread->id, NULL), "pthread_join");
+  gt_free(thread);
+}
+
+GtMutex* gt_mutex_new(void)
+{
+  GtMutex *mutex = gt_malloc(sizeof *mutex);
+  check_retval(pthread_mutex_init(&mutex->mutex, NULL), "pthread_mutex_init");
+  return mutex;
+}
+
+void gt_mutex_lock(GtMutex *mutex)
+{
+  gt_assert(mutex);
+  check_retval(pthread_mutex_lock(&mutex->mutex), "pthread_mutex_lock");
+}
+
+void gt_mutex_unlock(GtMutex *mutex)
+{
+  gt_assert(mutex);
+  check_retval(pthread_mutex_unlock(&mutex->mutex), "pthread_mutex_unlock");
+}
+
+void gt_mutex_delete(GtMutex *mutex)
+{
+  if (!mutex) return;
+  pthread_mutex_destroy(&mutex->mutex);
+  gt_free(mutex);
+}
+
+GtCondition* gt_condition_new(void)
+{
+  GtCondition *condition = gt_malloc(sizeof *condition);
+  check_retval(pthread_cond_init(&condition->cond, NULL), "pthread_cond_init");
+  return condition;
+}
+
+void gt_condition_wait(GtCondition *condition, GtMutex *mutex)
+{
+  gt_assert(condition && mutex);
+  check_retval(pthread_cond_wait(&condition->cond, &mutex->mutex),
+               "pthread_cond_wait");
+}
+
+void gt_condition_signal(GtCondition *condition)
+{
+  gt_assert(condition);
+  check_retval(pthread_cond_signal(&condition->cond), "pthread_cond_signal");
+}
+
+void gt_condition_broadcast(GtCondition *condition)
+{
+  gt_assert(condition);
+  check_retval(pthread_cond_broadcast(&condition->cond),
+               "pthread_cond_broadcast");
+}
+
+void gt_condition_delete(GtCondition *condition)
+{
+  if (!condition) return;
+  pthread_cond_destroy(&condition->cond);
+  gt_free(condition);
+}
+
+#else
+
+struct GtMutex {
+  char dummy;
+};
+
+struct GtCondition {
+  char dummy;
+};
+
+bool gt_thread_support(void)
+{
+  return false;
+}
+
+GtThread* gt_thread_new(GT_UNUSED GtThreadFunc function, GT_UNUSED void *data,
+                        GtError *err)
+{
+  gt_error_check(err);
+  gt_error_set(err, "cannot create thread: GenomeTools has been compiled "
+                    "without thread support (threads=no)");
+  return NULL;
+}
+
+void gt_thread_join(GT_UNUSED GtThread *thread)
+{
+  gt_assert(0); /* a thread can never be created */
+}
+
+GtMutex* gt_mutex_new(void)
+{
+  return gt_malloc(sizeof (GtMutex));
+}
+
+void gt_mutex_lock(GT_UNUSED GtMutex *mutex)
+{
+  gt_assert(mutex);
+}
+
+void gt_mutex_unlock(GT_UNUSED GtMutex *mutex)
+{
+  gt_assert(mutex);
+}
+
+void gt_mutex_delete(GtMutex *mutex)
+{
+  gt_free(mutex);
+}
+
+GtCondition* gt_condition_new(void)
+{
+  return gt_malloc(sizeof (GtCondition));
+}
+
+void gt_condition_wait(GT_UNUSED GtCondition *condition,
+                       GT_UNUSED GtMutex *mutex)
+{
+  /* without threads nobody could ever signal the condition */
+  gt_assert(0);
+}
+
+void gt_condition_signal(GT_UNUSED GtCondition *condition)
+{
+  gt_assert(condition);
+}
+
+void gt_condition_broadcast(GT_UNUSED GtCondition *condition)
+{
+  gt_assert(condition);
+}
+
+void gt_condition_delete(GtCondition *condition)
+{
+  gt_free(condition);
+}
+
+#endif
+
+unsigned int gt_thread_nof_processors(void)
+{
+  long nof_processors = sysconf(_SC_NPROCESSORS_ONLN);
+  return nof_processors > 1 ? nof_processors : 1;
+}
+
+#define NOF_TEST_THREADS     4
+#define NOF_TEST_INCREMENTS  10000
+
+typedef struct {
+  GtMutex *mutex;
+  GtCondition *condition;
+  unsigned long counter,
+                finished;
+} ThreadTestInfo;
+
+static void* increment_counter(void *data)
+{
+  ThreadTestInfo *info = data;
+  unsigned long i;
+  for (i = 0; i < NOF_TEST_INCREMENTS; i++) {
+    gt_mutex_lock(info->mutex);
+    info->counter++;
+    gt_mutex_unlock(info->mutex);
+  }
+  gt_mutex_lock(info->mutex);
+  info->finished++;
+  gt_condition_signal(info->condition);
+  gt_mutex_unlock(info->mutex);
+  return NULL;
+}
+
+int gt_thread_unit_test(GtError *err)
+{
+  GtThread *threads[NOF_TEST_THREADS];
+  ThreadTestInfo info;
+  unsigned long i;
+  int had_err = 0;
+  gt_error_check(err);
+
+  if (!gt_thread_support()) {
+    ensure(had_err, !gt_thread_new(increment_counter, NULL, NULL));
+    return had_err;
+  }
+
+  info.mutex = gt_mutex_new();
+  info.condition = gt_condition_new();
+  info.counter = info.finished = 0;
+  for (i = 0; i < NOF_TEST_THREADS; i++) {
+    if (!(threads[i] = gt_thread_new(increment_counter, &info, err))) {
+      had_err = -1;
+      break;
+    }
+  }
+  if (!had_err) {
+    /* wait for all threads to signal that they are done */
+    gt_mutex_lock(info.mutex);
+    while (info.finished < NOF_TEST_THREADS)
+      gt_condition_wait(info.condition, info.mutex);
+    ensure(had_err, info.counter == NOF_TEST_THREADS * NOF_TEST_INCREMENTS);
+    gt_mutex_unlock(info.mutex);
+  }
+  while (i--)
+    gt_thread_join(threads[i]);
+  gt_condition_delete(info.condition);
+  gt_mutex_delete(info.mutex);
+  return had_err;
+}
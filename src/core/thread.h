@@ -0,0 +1,62 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdbool.h>
+#include "core/error.h"
+
+/*
+  This module contains a thin wrapper around POSIX threads. If GenomeTools has
+  been compiled with threads=no, <gt_thread_new()> always fails and the mutex
+  and condition functions do nothing, so that callers can fall back to a
+  sequential code path (see <gt_thread_support()>).
+*/
+
+typedef struct GtThread GtThread;
+typedef struct GtMutex GtMutex;
+typedef struct GtCondition GtCondition;
+
+typedef void* (*GtThreadFunc)(void *data);
+
+/* Return <true> if GenomeTools has been compiled with thread support. */
+bool         gt_thread_support(void);
+/* Return the number of online processors (at least 1). */
+unsigned int gt_thread_nof_processors(void);
+/* Start a new thread which executes <function> with <data> as argument.
+   Returns NULL and sets <err> if the thread could not be created. */
+GtThread*    gt_thread_new(GtThreadFunc function, void *data, GtError *err);
+/* Wait for <thread> to terminate and free it. */
+void         gt_thread_join(GtThread *thread);
+
+GtMutex*     gt_mutex_new(void);
+void         gt_mutex_lock(GtMutex*);
+void         gt_mutex_unlock(GtMutex*);
+void         gt_mutex_delete(GtMutex*);
+
+GtCondition* gt_condition_new(void);
+/* Atomically unlock <mutex> and wait for <condition> to be signaled. <mutex>
+   is locked again before the function returns. */
+void         gt_condition_wait(GtCondition *condition, GtMutex *mutex);
+void         gt_condition_signal(GtCondition*);
+void         gt_condition_broadcast(GtCondition*);
+void         gt_condition_delete(GtCondition*);
+
+int          gt_thread_unit_test(GtError*);
+
+#endif
@@ -92,6 +92,19 @@ void gt_timer_show(GtTimer *t, FILE *fp)
           (long)(t->stop_ru.ru_stime.tv_sec - t->stop_ru.ru_stime.tv_sec));
 }
 
+double gt_timer_elapsed_seconds(GtTimer *t)
+{
+  struct timeval now_tv, elapsed_tv;
+  gt_assert(t);
+  if (t->state == TIMER_RUNNING) {
+    gettimeofday(&now_tv, NULL);
+    timeval_subtract(&elapsed_tv, &now_tv, &t->start_tv);
+  }
+  else
+    timeval_subtract(&elapsed_tv, &t->stop_tv, &t->start_tv);
+  return elapsed_tv.tv_sec + elapsed_tv.tv_usec / 1000000.0;
+}
+
 void gt_timer_delete(GtTimer *t)
 {
   if (!t) return;
@@ -30,6 +30,9 @@ GtTimer* gt_timer_new(void);
 void     gt_timer_start(GtTimer*);
 void     gt_timer_stop(GtTimer*);
 void     gt_timer_show(GtTimer*, FILE*);
+/* Returns the elapsed wall-clock time in seconds (up to now, if the timer is
+   still running). */
+double   gt_timer_elapsed_seconds(GtTimer*);
 void     gt_timer_delete(GtTimer*);
 
 #endif
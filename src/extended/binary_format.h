@@ -0,0 +1,180 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include <inttypes.h>
+
+/* The binary annotation format: a compact on-disk representation of the
+   genome nodes of a GFF3 file which can be loaded again via mmap(2) without
+   any parsing, type checking, or ID/Parent resolution.
+
+   All numbers are stored in the native byte order of the machine which wrote
+   the file (the reader checks this) and all parts are aligned to 8 bytes.
+   A file consists of the following parts:
+
+   - a <GtBinaryHeader>
+   - the records (one for each top-level genome node, in stream order), each
+     starting with a <GtBinaryRecord> header, followed by
+     - comment:  a <GtBinaryComment>
+     - region:   a <GtBinaryRegion>
+     - sequence: a <GtBinarySequence>, followed by the sequence characters
+     - feature:  a <GtBinaryTree>, followed by <nof_nodes> <GtBinaryFeature>s
+                 (the root first), <nof_edges> (parent, child) pairs of node
+                 indices (uint32_t, in the order of the children), and
+                 <nof_attributes> (tag, value) pairs of string IDs (uint32_t)
+   - the string table: <nof_strings> uint64_t offsets relative to the start of
+     the following zero-terminated strings
+   - the used feature types (uint32_t string IDs)
+   - the per-seqid blocks (<GtBinaryBlock>s), which give the offset of the
+     first record of each run of records on the same sequence
+   - the interval index: one <GtBinarySeqIndex> for each sequence (in the order
+     of their first appearance), followed by the <GtBinaryInterval>s of the
+     top-level features of all sequences. The intervals of a sequence are
+     stored consecutively and sorted by start position, this allows to find
+     the features overlapping a given range without reading the records.
+   - a <GtBinaryFooter> with the offsets of the parts above
+*/
+
+#define GT_BINARY_MAGIC          "GTANNBIN"
+#define GT_BINARY_MAGIC_LENGTH   8
+#define GT_BINARY_VERSION        2
+#define GT_BINARY_BYTE_ORDER     0x01020304
+#define GT_BINARY_ALIGNMENT      8
+/* marks undefined string IDs and node indices */
+#define GT_BINARY_UNDEF          UINT32_MAX
+
+#define GT_BINARY_ALIGN(SIZE)\
+        (((SIZE) + GT_BINARY_ALIGNMENT - 1) & ~((uint64_t) GT_BINARY_ALIGNMENT\
+                                                - 1))
+
+typedef enum {
+  GT_BINARY_COMMENT_RECORD = 1,
+  GT_BINARY_REGION_RECORD,
+  GT_BINARY_SEQUENCE_RECORD,
+  GT_BINARY_FEATURE_RECORD
+} GtBinaryRecordType;
+
+/* flags of a <GtBinaryFeature> */
+#define GT_BINARY_STRAND_MASK    0x7
+#define GT_BINARY_PHASE_OFFSET   3
+#define GT_BINARY_PHASE_MASK     0x3
+#define GT_BINARY_SCORE_DEFINED  (1 << 5)
+#define GT_BINARY_PSEUDO         (1 << 6)
+#define GT_BINARY_MULTI          (1 << 7)
+
+typedef struct {
+  char magic[GT_BINARY_MAGIC_LENGTH];
+  uint32_t version,
+           byte_order;
+} GtBinaryHeader;
+
+typedef struct {
+  uint32_t type,        /* a <GtBinaryRecordType> */
+           filename,    /* string ID of the original file name */
+           line_number, /* original line number */
+           padding;
+  uint64_t size;        /* size of the record in bytes, including this
+                           header */
+} GtBinaryRecord;
+
+typedef struct {
+  uint32_t comment, /* string ID */
+           padding;
+} GtBinaryComment;
+
+typedef struct {
+  uint32_t seqid,   /* string ID */
+           padding;
+  uint64_t start,
+           end;
+} GtBinaryRegion;
+
+typedef struct {
+  uint32_t description, /* string ID */
+           padding;
+  uint64_t length;
+} GtBinarySequence;
+
+typedef struct {
+  uint32_t nof_nodes,
+           nof_edges,
+           nof_attributes,
+           padding;
+} GtBinaryTree;
+
+typedef struct {
+  uint64_t start,
+           end;
+  uint32_t seqid,           /* string ID */
+           source,          /* string ID, <GT_BINARY_UNDEF> if undefined */
+           type,            /* string ID, <GT_BINARY_UNDEF> for pseudo-nodes */
+           line_number,
+           first_attribute, /* index of the first (tag, value) pair */
+           nof_attributes,
+           representative,  /* node index of the multi-feature
+                               representative */
+           flags;
+  float score;
+  uint32_t filename;        /* string ID of the original file name */
+} GtBinaryFeature;
+
+typedef struct {
+  uint32_t seqid,    /* string ID */
+           nof_records;
+  uint64_t offset;   /* offset of the first record */
+} GtBinaryBlock;
+
+/* flags of a <GtBinarySeqIndex> */
+#define GT_BINARY_HAS_REGION     1
+
+typedef struct {
+  uint32_t seqid,          /* string ID */
+           flags;
+  uint64_t region_start,   /* range of the first region node of the
+                              sequence, if <GT_BINARY_HAS_REGION> is set */
+           region_end,
+           first_interval,
+           nof_intervals;
+} GtBinarySeqIndex;
+
+typedef struct {
+  uint64_t start,
+           end,
+           max_end,        /* maximum end of all intervals of the sequence up
+                              to (and including) this one */
+           offset;         /* offset of the feature record */
+} GtBinaryInterval;
+
+typedef struct {
+  uint64_t records_offset,
+           nof_records,
+           strings_offset,
+           nof_strings,
+           types_offset,
+           nof_types,
+           blocks_offset,
+           nof_blocks,
+           index_offset,
+           nof_seqs,
+           intervals_offset,
+           nof_intervals;
+  char magic[GT_BINARY_MAGIC_LENGTH];
+} GtBinaryFooter;
+
+#endif
@@ -0,0 +1,111 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "core/assert_api.h"
+#include "core/fa.h"
+#include "core/ma.h"
+#include "extended/binary_in_stream.h"
+#include "extended/binary_reader.h"
+
+struct GtBinaryInStream {
+  const GtNodeStream parent_instance;
+  GtStr *filename;
+  GtCstrTable *used_types;
+  bool arena_allocation;
+  GtBinaryReader *reader;
+  uint64_t next_record;
+};
+
+#define binary_in_stream_cast(NS)\
+        gt_node_stream_cast(gt_binary_in_stream_class(), NS)
+
+static int binary_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
+                                 GtError *err)
+{
+  GtBinaryInStream *bis = binary_in_stream_cast(ns);
+  gt_error_check(err);
+
+  if (!bis->reader) {
+    if (!(bis->reader = gt_binary_reader_new(gt_str_get(bis->filename),
+                                             bis->used_types, err))) {
+      return -1;
+    }
+    if (bis->arena_allocation)
+      gt_binary_reader_enable_arena_allocation(bis->reader);
+    bis->next_record = gt_binary_reader_first_record(bis->reader);
+  }
+  if (bis->next_record == gt_binary_reader_records_end(bis->reader)) {
+    *gn = NULL; /* stream is exhausted */
+    return 0;
+  }
+  return gt_binary_reader_read_record(bis->reader, gn, &bis->next_record, err);
+}
+
+static void binary_in_stream_free(GtNodeStream *ns)
+{
+  GtBinaryInStream *bis = binary_in_stream_cast(ns);
+  gt_binary_reader_delete(bis->reader);
+  gt_str_delete(bis->filename);
+}
+
+const GtNodeStreamClass* gt_binary_in_stream_class(void)
+{
+  static const GtNodeStreamClass *nsc = NULL;
+  if (!nsc) {
+    nsc = gt_node_stream_class_new(sizeof (GtBinaryInStream),
+                                   binary_in_stream_free,
+                                   binary_in_stream_next);
+  }
+  return nsc;
+}
+
+GtNodeStream* gt_binary_in_stream_new(const char *filename,
+                                      GtCstrTable *used_types)
+{
+  GtNodeStream *ns = gt_node_stream_create(gt_binary_in_stream_class(), false);
+  GtBinaryInStream *bis = binary_in_stream_cast(ns);
+  gt_assert(filename);
+  bis->filename = gt_str_new_cstr(filename);
+  bis->used_types = used_types;
+  bis->arena_allocation = false;
+  bis->reader = NULL;
+  bis->next_record = 0;
+  return ns;
+}
+
+void gt_binary_in_stream_enable_arena_allocation(GtNodeStream *ns)
+{
+  GtBinaryInStream *bis = binary_in_stream_cast(ns);
+  gt_assert(bis);
+  bis->arena_allocation = true;
+}
+
+bool gt_binary_in_stream_file_is_binary(const char *filename)
+{
+  char magic[GT_BINARY_MAGIC_LENGTH];
+  bool is_binary = false;
+  FILE *fp;
+  gt_assert(filename);
+  if ((fp = gt_fa_fopen(filename, "rb", NULL))) {
+    is_binary = fread(magic, 1, GT_BINARY_MAGIC_LENGTH, fp) ==
+                GT_BINARY_MAGIC_LENGTH &&
+                !memcmp(magic, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH);
+    gt_fa_xfclose(fp);
+  }
+  return is_binary;
+}
@@ -0,0 +1,46 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef BINARY_IN_STREAM_H
+#define BINARY_IN_STREAM_H
+
+#include <stdbool.h>
+#include "core/cstr_table.h"
+#include "extended/node_stream_api.h"
+
+/* implements the ``genome_stream'' interface, reads genome nodes from a file
+   in the binary annotation format (see binary_format.h) */
+typedef struct GtBinaryInStream GtBinaryInStream;
+
+const GtNodeStreamClass* gt_binary_in_stream_class(void);
+/* Create a <GtBinaryInStream*> which reads the nodes stored in the binary
+   annotation file <filename>. The file is mapped into memory on the first
+   call of <gt_node_stream_next()>. If <used_types> is given, the feature types
+   used in the file are added to it at that time. */
+GtNodeStream*            gt_binary_in_stream_new(const char *filename,
+                                                 GtCstrTable *used_types);
+/* Allocate the feature nodes from arenas (see
+   <gt_feature_node_new_with_arena()> for details). */
+void                     gt_binary_in_stream_enable_arena_allocation(
+                                                                 GtNodeStream*);
+/* Return <true> if the file <filename> is a binary annotation file, <false>
+   otherwise (i.e., if it does not start with the binary magic or cannot be
+   read). */
+bool                     gt_binary_in_stream_file_is_binary(const char
+                                                            *filename);
+
+#endif
@@ -0,0 +1,81 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "core/assert_api.h"
+#include "extended/binary_out_stream.h"
+#include "extended/binary_visitor.h"
+#include "extended/genome_node.h"
+#include "extended/node_stream_api.h"
+
+struct GtBinaryOutStream {
+  const GtNodeStream parent_instance;
+  GtNodeStream *in_stream;
+  GtNodeVisitor *binary_visitor;
+  bool finished;
+};
+
+#define binary_out_stream_cast(GS)\
+        gt_node_stream_cast(gt_binary_out_stream_class(), GS)
+
+static int binary_out_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
+                                  GtError *err)
+{
+  GtBinaryOutStream *binary_out_stream;
+  int had_err;
+  gt_error_check(err);
+  binary_out_stream = binary_out_stream_cast(ns);
+  had_err = gt_node_stream_next(binary_out_stream->in_stream, gn, err);
+  if (!had_err && *gn) {
+    had_err = gt_genome_node_accept(*gn, binary_out_stream->binary_visitor,
+                                    err);
+  }
+  if (!had_err && !*gn && !binary_out_stream->finished) {
+    /* the input stream is exhausted -> complete the output */
+    gt_binary_visitor_finish(binary_out_stream->binary_visitor);
+    binary_out_stream->finished = true;
+  }
+  return had_err;
+}
+
+static void binary_out_stream_free(GtNodeStream *ns)
+{
+  GtBinaryOutStream *binary_out_stream = binary_out_stream_cast(ns);
+  gt_node_stream_delete(binary_out_stream->in_stream);
+  gt_node_visitor_delete(binary_out_stream->binary_visitor);
+}
+
+const GtNodeStreamClass* gt_binary_out_stream_class(void)
+{
+  static const GtNodeStreamClass *nsc = NULL;
+  if (!nsc) {
+    nsc = gt_node_stream_class_new(sizeof (GtBinaryOutStream),
+                                   binary_out_stream_free,
+                                   binary_out_stream_next);
+  }
+  return nsc;
+}
+
+GtNodeStream* gt_binary_out_stream_new(GtNodeStream *in_stream, GtFile *outfp)
+{
+  GtNodeStream *ns = gt_node_stream_create(gt_binary_out_stream_class(),
+                                           gt_node_stream_is_sorted(in_stream));
+  GtBinaryOutStream *binary_out_stream = binary_out_stream_cast(ns);
+  binary_out_stream->in_stream = gt_node_stream_ref(in_stream);
+  binary_out_stream->binary_visitor = gt_binary_visitor_new(outfp);
+  binary_out_stream->finished = false;
+  return ns;
+}
@@ -0,0 +1,580 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <errno.h>
+#include <string.h>
+#include "core/arena.h"
+#include "core/array.h"
+#include "core/assert_api.h"
+#include "core/fa.h"
+#include "core/ma.h"
+#include "core/phase_api.h"
+#include "core/strand_api.h"
+#include "extended/binary_reader.h"
+#include "extended/comment_node_api.h"
+#include "extended/feature_node.h"
+#include "extended/genome_node.h"
+#include "extended/region_node_api.h"
+#include "extended/sequence_node_api.h"
+
+#define BINARY_READER_ARENA_CHUNK_SIZE  (1UL << 20)
+
+struct GtBinaryReader {
+  GtStr *filename;
+  bool arena_allocation;
+  const char *map;
+  size_t map_size;
+  const GtBinaryFooter *footer;
+  const uint64_t *string_offsets;
+  const char *strings;
+  uint64_t strings_size;
+  const GtBinarySeqIndex *seqs;
+  const GtBinaryInterval *intervals;
+  GtStr **strs; /* the strings used as GtStr*, created on demand */
+  GtArena *arena;
+  GtArray *nodes,
+          *has_parent,
+          *dag_space;
+};
+
+static int corrupt_file(GtBinaryReader *br, GtError *err)
+{
+  gt_error_check(err);
+  gt_error_set(err, "binary annotation file \"%s\" is corrupt",
+               gt_str_get(br->filename));
+  return -1;
+}
+
+static const char* get_cstr(const GtBinaryReader *br, uint32_t id)
+{
+  gt_assert(br && id < br->footer->nof_strings);
+  return br->strings + br->string_offsets[id];
+}
+
+static GtStr* get_str(GtBinaryReader *br, uint32_t id)
+{
+  gt_assert(br && id < br->footer->nof_strings);
+  if (!br->strs[id])
+    br->strs[id] = gt_str_new_cstr(get_cstr(br, id));
+  return br->strs[id];
+}
+
+static bool valid_string_id(GtBinaryReader *br, uint32_t id)
+{
+  gt_assert(br);
+  return id < br->footer->nof_strings;
+}
+
+/* Returns the arena new feature nodes should be allocated from (or <NULL>). */
+static GtArena* get_arena(GtBinaryReader *br)
+{
+  gt_assert(br);
+  if (!br->arena_allocation)
+    return NULL;
+  if (br->arena &&
+      gt_arena_size(br->arena) >= BINARY_READER_ARENA_CHUNK_SIZE) {
+    gt_arena_delete(br->arena);
+    br->arena = NULL;
+  }
+  if (!br->arena)
+    br->arena = gt_arena_new(0);
+  return br->arena;
+}
+
+static int map_file(GtBinaryReader *br, GtCstrTable *used_types,
+                    GtError *err)
+{
+  const GtBinaryHeader *header;
+  const GtBinaryFooter *footer;
+  const uint32_t *types;
+  uint64_t i;
+  gt_error_check(err);
+  gt_assert(br && !br->map);
+  if (!(br->map = gt_fa_mmap_read(gt_str_get(br->filename),
+                                  &br->map_size))) {
+    gt_error_set(err, "cannot map file \"%s\": %s", gt_str_get(br->filename),
+                 strerror(errno));
+    return -1;
+  }
+  /* check header and footer */
+  if (br->map_size < sizeof (GtBinaryHeader) + sizeof (GtBinaryFooter))
+    return corrupt_file(br, err);
+  header = (const GtBinaryHeader*) br->map;
+  br->footer = footer = (const GtBinaryFooter*)
+                         (br->map + br->map_size - sizeof (GtBinaryFooter));
+  if (memcmp(header->magic, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH)) {
+    gt_error_set(err, "file \"%s\" is not a binary annotation file",
+                 gt_str_get(br->filename));
+    return -1;
+  }
+  if (header->byte_order != GT_BINARY_BYTE_ORDER) {
+    gt_error_set(err, "binary annotation file \"%s\" has been written on a "
+                 "machine with a different byte order",
+                 gt_str_get(br->filename));
+    return -1;
+  }
+  if (header->version != GT_BINARY_VERSION) {
+    gt_error_set(err, "binary annotation file \"%s\" has unsupported version "
+                 "%u (expected %u)", gt_str_get(br->filename),
+                 header->version, GT_BINARY_VERSION);
+    return -1;
+  }
+  if (memcmp(footer->magic, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH) ||
+      footer->records_offset != sizeof (GtBinaryHeader) ||
+      footer->strings_offset < footer->records_offset ||
+      footer->types_offset < footer->strings_offset ||
+      footer->blocks_offset < footer->types_offset ||
+      footer->blocks_offset > br->map_size - sizeof (GtBinaryFooter) ||
+      footer->strings_offset % GT_BINARY_ALIGNMENT ||
+      footer->types_offset % GT_BINARY_ALIGNMENT ||
+      footer->blocks_offset % GT_BINARY_ALIGNMENT ||
+      footer->nof_strings >= GT_BINARY_UNDEF ||
+      footer->nof_strings * sizeof (uint64_t) >
+      footer->types_offset - footer->strings_offset ||
+      footer->nof_types * sizeof (uint32_t) >
+      footer->blocks_offset - footer->types_offset ||
+      footer->index_offset < footer->blocks_offset ||
+      footer->intervals_offset < footer->index_offset ||
+      footer->intervals_offset > br->map_size - sizeof (GtBinaryFooter) ||
+      footer->nof_blocks * sizeof (GtBinaryBlock) !=
+      footer->index_offset - footer->blocks_offset ||
+      footer->nof_seqs * sizeof (GtBinarySeqIndex) !=
+      footer->intervals_offset - footer->index_offset ||
+      footer->nof_intervals * sizeof (GtBinaryInterval) !=
+      br->map_size - sizeof (GtBinaryFooter) - footer->intervals_offset) {
+    return corrupt_file(br, err);
+  }
+  /* check string table (all strings are terminated by the last byte, which
+     is either the terminator of the last string or padding) */
+  br->string_offsets = (const uint64_t*) (br->map + footer->strings_offset);
+  br->strings = (const char*) (br->string_offsets + footer->nof_strings);
+  br->strings_size = br->map + footer->types_offset - br->strings;
+  if (footer->nof_strings &&
+      (!br->strings_size || br->strings[br->strings_size - 1] != '\0')) {
+    return corrupt_file(br, err);
+  }
+  for (i = 0; i < footer->nof_strings; i++) {
+    if (br->string_offsets[i] >= br->strings_size)
+      return corrupt_file(br, err);
+  }
+  /* add used types */
+  types = (const uint32_t*) (br->map + footer->types_offset);
+  for (i = 0; i < footer->nof_types; i++) {
+    if (!valid_string_id(br, types[i]))
+      return corrupt_file(br, err);
+    if (used_types && !gt_cstr_table_get(used_types, get_cstr(br, types[i])))
+      gt_cstr_table_add(used_types, get_cstr(br, types[i]));
+  }
+  /* check interval index (the intervals themselves are checked when they are
+     used, to keep the startup time independent of the number of features) */
+  br->seqs = (const GtBinarySeqIndex*) (br->map + footer->index_offset);
+  br->intervals = (const GtBinaryInterval*)
+                  (br->map + footer->intervals_offset);
+  for (i = 0; i < footer->nof_seqs; i++) {
+    if (!valid_string_id(br, br->seqs[i].seqid) ||
+        br->seqs[i].first_interval > footer->nof_intervals ||
+        br->seqs[i].nof_intervals > footer->nof_intervals -
+                                    br->seqs[i].first_interval ||
+        ((br->seqs[i].flags & GT_BINARY_HAS_REGION) &&
+         br->seqs[i].region_start > br->seqs[i].region_end)) {
+      return corrupt_file(br, err);
+    }
+  }
+  br->strs = gt_calloc(footer->nof_strings, sizeof (GtStr*));
+  return 0;
+}
+
+static void set_origin(GtBinaryReader *br, GtGenomeNode *gn,
+                       uint32_t filename, uint32_t line_number)
+{
+  gt_assert(br && gn);
+  if (filename != GT_BINARY_UNDEF && line_number)
+    gt_genome_node_set_origin(gn, get_str(br, filename), line_number);
+}
+
+static bool valid_feature(GtBinaryReader *br, const GtBinaryTree *tree,
+                          const GtBinaryFeature *features,
+                          const uint32_t *attributes, uint32_t i)
+{
+  const GtBinaryFeature *feature = features + i;
+  uint32_t j;
+  gt_assert(br && tree && features && i < tree->nof_nodes);
+  if (feature->start > feature->end ||
+      !valid_string_id(br, feature->seqid) ||
+      feature->seqid != features[0].seqid ||
+      (feature->source != GT_BINARY_UNDEF &&
+       !valid_string_id(br, feature->source)) ||
+      (feature->filename != GT_BINARY_UNDEF &&
+       !valid_string_id(br, feature->filename)) ||
+      (feature->flags & GT_BINARY_STRAND_MASK) >= GT_NUM_OF_STRAND_TYPES ||
+      feature->first_attribute > tree->nof_attributes ||
+      feature->nof_attributes > tree->nof_attributes -
+                                feature->first_attribute) {
+    return false;
+  }
+  if (feature->flags & GT_BINARY_PSEUDO) {
+    /* only the root can be a pseudo-feature */
+    if (i || feature->flags & GT_BINARY_MULTI)
+      return false;
+  }
+  else if (!valid_string_id(br, feature->type))
+    return false;
+  if (feature->flags & GT_BINARY_MULTI) {
+    /* the representative has to represent itself */
+    if (feature->representative >= tree->nof_nodes ||
+        !(features[feature->representative].flags & GT_BINARY_MULTI) ||
+        features[feature->representative].representative !=
+        feature->representative) {
+      return false;
+    }
+  }
+  for (j = feature->first_attribute;
+       j < feature->first_attribute + feature->nof_attributes; j++) {
+    if (!valid_string_id(br, attributes[2*j]) ||
+        !valid_string_id(br, attributes[2*j+1]) ||
+        !*get_cstr(br, attributes[2*j]) ||
+        !*get_cstr(br, attributes[2*j+1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static GtGenomeNode* create_feature(GtBinaryReader *br,
+                                    const GtBinaryFeature *feature,
+                                    const uint32_t *attributes)
+{
+  GtFeatureNode *fn;
+  GtGenomeNode *gn;
+  uint32_t j;
+  gt_assert(br && feature && attributes);
+  if (feature->flags & GT_BINARY_PSEUDO) {
+    gn = gt_feature_node_new_pseudo_with_arena(get_str(br, feature->seqid),
+                                               feature->start, feature->end,
+                                               feature->flags &
+                                               GT_BINARY_STRAND_MASK,
+                                               get_arena(br));
+  }
+  else {
+    gn = gt_feature_node_new_with_arena(get_str(br, feature->seqid),
+                                        get_cstr(br, feature->type),
+                                        feature->start, feature->end,
+                                        feature->flags & GT_BINARY_STRAND_MASK,
+                                        get_arena(br));
+  }
+  fn = (GtFeatureNode*) gn;
+  set_origin(br, gn, feature->filename, feature->line_number);
+  if (feature->source != GT_BINARY_UNDEF)
+    gt_feature_node_set_source(fn, get_str(br, feature->source));
+  gt_feature_node_set_phase(fn, (feature->flags >> GT_BINARY_PHASE_OFFSET) &
+                                GT_BINARY_PHASE_MASK);
+  if (feature->flags & GT_BINARY_SCORE_DEFINED)
+    gt_feature_node_set_score(fn, feature->score);
+  for (j = feature->first_attribute;
+       j < feature->first_attribute + feature->nof_attributes; j++) {
+    gt_feature_node_add_attribute(fn, get_cstr(br, attributes[2*j]),
+                                  get_cstr(br, attributes[2*j+1]));
+  }
+  return gn;
+}
+
+/* Returns true if the edges form a DAG in which every node can be reached from
+   the root (node 0). The nodes are taken in topological order, a node on a
+   cycle never loses all its incoming edges. <edges> are sorted by parent. */
+static bool edges_are_acyclic(GtBinaryReader *br, const uint32_t *edges,
+                              uint32_t nof_nodes, uint32_t nof_edges)
+{
+  uint32_t i, j, *indegree, *first_edge, *stack, stacksize = 0,
+           nof_visited = 0, zero = 0;
+
+  /* <nof_nodes> in-degrees, <nof_nodes> + 1 edge offsets, and a stack */
+  gt_array_reset(br->dag_space);
+  for (i = 0; i < 3 * nof_nodes + 1; i++)
+    gt_array_add(br->dag_space, zero);
+  indegree = gt_array_get_space(br->dag_space);
+  first_edge = indegree + nof_nodes;
+  stack = first_edge + nof_nodes + 1;
+  for (i = 0, j = 0; i <= nof_nodes; i++) {
+    while (j < nof_edges && edges[2*j] < i)
+      j++;
+    first_edge[i] = j;
+  }
+  for (i = 0; i < nof_edges; i++)
+    indegree[edges[2*i+1]]++;
+
+  stack[stacksize++] = 0;
+  while (stacksize) {
+    uint32_t parent = stack[--stacksize];
+    nof_visited++;
+    for (i = first_edge[parent]; i < first_edge[parent+1]; i++) {
+      if (!--indegree[edges[2*i+1]])
+        stack[stacksize++] = edges[2*i+1];
+    }
+  }
+  return nof_visited == nof_nodes;
+}
+
+static int read_feature_record(GtBinaryReader *br, GtGenomeNode **gn,
+                               const GtBinaryRecord *record, GtError *err)
+{
+  const GtBinaryTree *tree = (const GtBinaryTree*) (record + 1);
+  const GtBinaryFeature *features;
+  const uint32_t *edges, *attributes;
+  GtFeatureNode **nodes;
+  bool no_parent = false, *has_parent;
+  uint32_t i;
+  gt_error_check(err);
+  gt_assert(br && gn && record);
+
+  /* check record */
+  if (record->size < sizeof *record + sizeof *tree ||
+      !tree->nof_nodes ||
+      record->size != sizeof *record + sizeof *tree +
+                      (uint64_t) tree->nof_nodes * sizeof (GtBinaryFeature) +
+                      (uint64_t) tree->nof_edges * 2 * sizeof (uint32_t) +
+                      (uint64_t) tree->nof_attributes * 2 * sizeof (uint32_t)) {
+    return corrupt_file(br, err);
+  }
+  features = (const GtBinaryFeature*) (tree + 1);
+  edges = (const uint32_t*) (features + tree->nof_nodes);
+  attributes = edges + 2 * tree->nof_edges;
+  for (i = 0; i < tree->nof_nodes; i++) {
+    if (!valid_feature(br, tree, features, attributes, i))
+      return corrupt_file(br, err);
+  }
+  gt_array_reset(br->has_parent);
+  for (i = 0; i < tree->nof_nodes; i++)
+    gt_array_add(br->has_parent, no_parent);
+  has_parent = gt_array_get_space(br->has_parent);
+  for (i = 0; i < tree->nof_edges; i++) {
+    /* the root cannot be a child and the edges are sorted by parent (the nodes
+       are numbered in breadth first order) */
+    if (edges[2*i] >= tree->nof_nodes || !edges[2*i+1] ||
+        edges[2*i+1] >= tree->nof_nodes || edges[2*i] == edges[2*i+1] ||
+        (i && edges[2*i] < edges[2*i-2])) {
+      return corrupt_file(br, err);
+    }
+    has_parent[edges[2*i+1]] = true;
+  }
+  /* all nodes besides the root have to be part of the tree */
+  for (i = 1; i < tree->nof_nodes; i++) {
+    if (!has_parent[i])
+      return corrupt_file(br, err);
+  }
+  /* linking a cycle of children would make the nodes unreachable and
+     traversals of them endless */
+  if (!edges_are_acyclic(br, edges, tree->nof_nodes, tree->nof_edges))
+    return corrupt_file(br, err);
+
+  /* create nodes */
+  gt_array_reset(br->nodes);
+  for (i = 0; i < tree->nof_nodes; i++) {
+    *gn = create_feature(br, features + i, attributes);
+    gt_array_add(br->nodes, *gn);
+  }
+  nodes = gt_array_get_space(br->nodes);
+  /* restore multi-features (representatives first) */
+  for (i = 0; i < tree->nof_nodes; i++) {
+    if ((features[i].flags & GT_BINARY_MULTI) &&
+        features[i].representative == i) {
+      gt_feature_node_make_multi_representative(nodes[i]);
+    }
+  }
+  for (i = 0; i < tree->nof_nodes; i++) {
+    if ((features[i].flags & GT_BINARY_MULTI) &&
+        features[i].representative != i) {
+      gt_feature_node_set_multi_representative(nodes[i],
+                                          nodes[features[i].representative]);
+    }
+  }
+  /* link the nodes (the children are stored in their final order), nodes with
+     multiple parents are referenced once per additional parent */
+  memset(has_parent, 0, tree->nof_nodes * sizeof (bool));
+  for (i = 0; i < tree->nof_edges; i++) {
+    if (has_parent[edges[2*i+1]])
+      gt_genome_node_ref((GtGenomeNode*) nodes[edges[2*i+1]]);
+    else
+      has_parent[edges[2*i+1]] = true;
+    gt_feature_node_add_child(nodes[edges[2*i]], nodes[edges[2*i+1]]);
+  }
+  *gn = (GtGenomeNode*) nodes[0];
+  return 0;
+}
+
+int gt_binary_reader_read_record(GtBinaryReader *br, GtGenomeNode **gn,
+                                 uint64_t *offset, GtError *err)
+{
+  const GtBinaryRecord *record = NULL;
+  const GtBinaryComment *comment;
+  const GtBinaryRegion *region;
+  const GtBinarySequence *sequence;
+  GtStr *seq;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(br && gn && offset);
+
+  /* check record header */
+  if (*offset < br->footer->records_offset ||
+      *offset >= br->footer->strings_offset ||
+      *offset % GT_BINARY_ALIGNMENT) {
+    had_err = corrupt_file(br, err);
+  }
+  if (!had_err) {
+    record = (const GtBinaryRecord*) (br->map + *offset);
+    if (br->footer->strings_offset - *offset < sizeof *record ||
+        record->size < sizeof *record ||
+        record->size > br->footer->strings_offset - *offset ||
+        record->size % GT_BINARY_ALIGNMENT ||
+        (record->filename != GT_BINARY_UNDEF &&
+         !valid_string_id(br, record->filename))) {
+      had_err = corrupt_file(br, err);
+    }
+  }
+
+  if (!had_err) {
+    switch (record->type) {
+      case GT_BINARY_COMMENT_RECORD:
+        comment = (const GtBinaryComment*) (record + 1);
+        if (record->size != sizeof *record + sizeof *comment ||
+            !valid_string_id(br, comment->comment)) {
+          had_err = corrupt_file(br, err);
+          break;
+        }
+        *gn = gt_comment_node_new(get_cstr(br, comment->comment));
+        break;
+      case GT_BINARY_REGION_RECORD:
+        region = (const GtBinaryRegion*) (record + 1);
+        if (record->size != sizeof *record + sizeof *region ||
+            !valid_string_id(br, region->seqid) ||
+            region->start > region->end) {
+          had_err = corrupt_file(br, err);
+          break;
+        }
+        *gn = gt_region_node_new(get_str(br, region->seqid), region->start,
+                                 region->end);
+        break;
+      case GT_BINARY_SEQUENCE_RECORD:
+        sequence = (const GtBinarySequence*) (record + 1);
+        if (record->size < sizeof *record + sizeof *sequence ||
+            record->size != sizeof *record + sizeof *sequence +
+                            GT_BINARY_ALIGN(sequence->length) ||
+            !valid_string_id(br, sequence->description)) {
+          had_err = corrupt_file(br, err);
+          break;
+        }
+        seq = gt_str_new();
+        gt_str_append_cstr_nt(seq, (const char*) (sequence + 1),
+                              sequence->length);
+        *gn = gt_sequence_node_new(get_cstr(br, sequence->description), seq);
+        gt_str_delete(seq);
+        break;
+      case GT_BINARY_FEATURE_RECORD:
+        had_err = read_feature_record(br, gn, record, err);
+        break;
+      default:
+        had_err = corrupt_file(br, err);
+    }
+  }
+
+  if (!had_err) {
+    if (record->type != GT_BINARY_FEATURE_RECORD)
+      set_origin(br, *gn, record->filename, record->line_number);
+    *offset += record->size;
+  }
+  return had_err;
+}
+
+const char* gt_binary_reader_get_string(const GtBinaryReader *br, uint32_t id)
+{
+  return get_cstr(br, id);
+}
+
+unsigned long gt_binary_reader_nof_seqs(const GtBinaryReader *br)
+{
+  gt_assert(br);
+  return br->footer->nof_seqs;
+}
+
+const GtBinarySeqIndex* gt_binary_reader_get_seq(const GtBinaryReader *br,
+                                                 unsigned long seqnum)
+{
+  gt_assert(br && seqnum < br->footer->nof_seqs);
+  return br->seqs + seqnum;
+}
+
+const GtBinaryInterval* gt_binary_reader_get_intervals(const GtBinaryReader
+                                                       *br,
+                                                       const GtBinarySeqIndex
+                                                       *seq)
+{
+  gt_assert(br && seq);
+  return br->intervals + seq->first_interval;
+}
+
+GtBinaryReader* gt_binary_reader_new(const char *filename,
+                                     GtCstrTable *used_types, GtError *err)
+{
+  GtBinaryReader *br;
+  gt_error_check(err);
+  gt_assert(filename);
+  br = gt_calloc(1, sizeof *br);
+  br->filename = gt_str_new_cstr(filename);
+  br->nodes = gt_array_new(sizeof (GtFeatureNode*));
+  br->has_parent = gt_array_new(sizeof (bool));
+  br->dag_space = gt_array_new(sizeof (uint32_t));
+  if (map_file(br, used_types, err)) {
+    gt_binary_reader_delete(br);
+    return NULL;
+  }
+  return br;
+}
+
+void gt_binary_reader_enable_arena_allocation(GtBinaryReader *br)
+{
+  gt_assert(br);
+  br->arena_allocation = true;
+}
+
+uint64_t gt_binary_reader_first_record(const GtBinaryReader *br)
+{
+  gt_assert(br);
+  return br->footer->records_offset;
+}
+
+uint64_t gt_binary_reader_records_end(const GtBinaryReader *br)
+{
+  gt_assert(br);
+  return br->footer->strings_offset;
+}
+
+void gt_binary_reader_delete(GtBinaryReader *br)
+{
+  uint64_t i;
+  if (!br) return;
+  if (br->strs) {
+    for (i = 0; i < br->footer->nof_strings; i++)
+      gt_str_delete(br->strs[i]);
+    gt_free(br->strs);
+  }
+  gt_fa_xmunmap((void*) br->map);
+  gt_arena_delete(br->arena);
+  gt_array_delete(br->nodes);
+  gt_array_delete(br->has_parent);
+  gt_array_delete(br->dag_space);
+  gt_str_delete(br->filename);
+  gt_free(br);
+}
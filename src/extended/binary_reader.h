@@ -0,0 +1,67 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef BINARY_READER_H
+#define BINARY_READER_H
+
+#include <inttypes.h>
+#include "core/cstr_table.h"
+#include "core/error_api.h"
+#include "extended/binary_format.h"
+#include "extended/genome_node_api.h"
+
+/* A <GtBinaryReader> gives random access to the records and the interval index
+   of a memory mapped binary annotation file (see binary_format.h). */
+typedef struct GtBinaryReader GtBinaryReader;
+
+/* Map the binary annotation file <filename> and check its header, footer,
+   string table, and interval index. If <used_types> is given, the feature types
+   used in the file are added to it. Returns <NULL> and sets <err> on error. */
+GtBinaryReader*         gt_binary_reader_new(const char *filename,
+                                             GtCstrTable *used_types,
+                                             GtError *err);
+/* Allocate the feature nodes from arenas (see
+   <gt_feature_node_new_with_arena()> for details). */
+void                    gt_binary_reader_enable_arena_allocation(
+                                                              GtBinaryReader*);
+/* Return the offset of the first record in the file. */
+uint64_t                gt_binary_reader_first_record(const GtBinaryReader*);
+/* Return the offset directly after the last record in the file. */
+uint64_t                gt_binary_reader_records_end(const GtBinaryReader*);
+/* Read the record at <*offset> into <*gn> and set <*offset> to the offset of
+   the following record. Returns -1 and sets <err> if the record is corrupt. */
+int                     gt_binary_reader_read_record(GtBinaryReader*,
+                                                     GtGenomeNode **gn,
+                                                     uint64_t *offset,
+                                                     GtError *err);
+/* Return the string with ID <id>. */
+const char*             gt_binary_reader_get_string(const GtBinaryReader*,
+                                                    uint32_t id);
+/* Return the number of sequences in the interval index. */
+unsigned long           gt_binary_reader_nof_seqs(const GtBinaryReader*);
+/* Return the index of sequence <seqnum> (in the order of their first
+   appearance in the file). */
+const GtBinarySeqIndex* gt_binary_reader_get_seq(const GtBinaryReader*,
+                                                 unsigned long seqnum);
+/* Return the intervals of the top-level features of <seq>, sorted by start
+   position. */
+const GtBinaryInterval* gt_binary_reader_get_intervals(const GtBinaryReader*,
+                                                       const GtBinarySeqIndex
+                                                       *seq);
+void                    gt_binary_reader_delete(GtBinaryReader*);
+
+#endif
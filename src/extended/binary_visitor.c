@@ -0,0 +1,532 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "core/assert_api.h"
+#include "core/cstr.h"
+#include "core/hashmap.h"
+#include "core/ma.h"
+#include "core/unused_api.h"
+#include "extended/binary_format.h"
+#include "extended/binary_visitor.h"
+#include "extended/feature_node.h"
+#include "extended/feature_node_iterator_api.h"
+#include "extended/genome_node.h"
+#include "extended/node_visitor_rep.h"
+
+struct GtBinaryVisitor {
+  const GtNodeVisitor parent_instance;
+  GtFile *outfp;
+  bool header_written,
+       finished;
+  uint64_t offset,
+           nof_records;
+  GtHashmap *string_ids, /* maps strings to their ID + 1 */
+            *type_ids,   /* maps used (interned) types to their ID + 1 */
+            *node_indices,
+            *seq_ids;    /* maps seqid string IDs to their sequence index
+                            + 1 */
+  GtArray *strings,
+          *types,
+          *blocks,
+          *seqs,         /* the <GtBinarySeqIndex>s */
+          *intervals,    /* one array of <GtBinaryInterval>s per sequence */
+          *nodes,
+          *features,
+          *edges,
+          *attributes;
+};
+
+#define binary_visitor_cast(GV)\
+        gt_node_visitor_cast(gt_binary_visitor_class(), GV)
+
+static void binary_visitor_free(GtNodeVisitor *gv)
+{
+  GtBinaryVisitor *binary_visitor = binary_visitor_cast(gv);
+  unsigned long i;
+  gt_hashmap_delete(binary_visitor->string_ids);
+  gt_hashmap_delete(binary_visitor->type_ids);
+  gt_hashmap_delete(binary_visitor->node_indices);
+  gt_hashmap_delete(binary_visitor->seq_ids);
+  gt_array_delete(binary_visitor->strings);
+  gt_array_delete(binary_visitor->types);
+  gt_array_delete(binary_visitor->blocks);
+  gt_array_delete(binary_visitor->seqs);
+  for (i = 0; i < gt_array_size(binary_visitor->intervals); i++)
+    gt_array_delete(*(GtArray**) gt_array_get(binary_visitor->intervals, i));
+  gt_array_delete(binary_visitor->intervals);
+  gt_array_delete(binary_visitor->nodes);
+  gt_array_delete(binary_visitor->features);
+  gt_array_delete(binary_visitor->edges);
+  gt_array_delete(binary_visitor->attributes);
+}
+
+static void binary_write(GtBinaryVisitor *bv, const void *buf, size_t size)
+{
+  gt_file_xwrite(bv->outfp, (void*) buf, size);
+  bv->offset += size;
+}
+
+static void binary_write_padding(GtBinaryVisitor *bv)
+{
+  static const char zeros[GT_BINARY_ALIGNMENT] = { 0 };
+  if (bv->offset % GT_BINARY_ALIGNMENT) {
+    binary_write(bv, zeros,
+                 GT_BINARY_ALIGNMENT - bv->offset % GT_BINARY_ALIGNMENT);
+  }
+}
+
+static void binary_write_header(GtBinaryVisitor *bv)
+{
+  GtBinaryHeader header;
+  if (bv->header_written)
+    return;
+  memset(&header, 0, sizeof header);
+  memcpy(header.magic, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH);
+  header.version = GT_BINARY_VERSION;
+  header.byte_order = GT_BINARY_BYTE_ORDER;
+  binary_write(bv, &header, sizeof header);
+  bv->header_written = true;
+}
+
+/* Return the ID of <string> in the string table (<string> is added if
+   necessary). */
+static uint32_t string_id(GtBinaryVisitor *bv, const char *string)
+{
+  unsigned long id;
+  char *dup;
+  gt_assert(bv && string);
+  if ((id = (unsigned long) gt_hashmap_get(bv->string_ids, string)))
+    return id - 1;
+  dup = gt_cstr_dup(string);
+  gt_array_add(bv->strings, dup);
+  id = gt_array_size(bv->strings);
+  gt_assert(id < GT_BINARY_UNDEF);
+  gt_hashmap_add(bv->string_ids, dup, (void*) id);
+  return id - 1;
+}
+
+static uint32_t filename_id(GtBinaryVisitor *bv, GtGenomeNode *gn)
+{
+  gt_assert(bv && gn);
+  /* nodes without line number have not been read from a file */
+  if (!gt_genome_node_get_line_number(gn))
+    return GT_BINARY_UNDEF;
+  return string_id(bv, gt_genome_node_get_filename(gn));
+}
+
+/* Return the index of the sequence <seqid> in the interval index, the sequence
+   is added if necessary. */
+static unsigned long seq_index(GtBinaryVisitor *bv, GtStr *seqid)
+{
+  GtBinarySeqIndex seq;
+  unsigned long index, id;
+  GtArray *intervals;
+  gt_assert(bv && seqid);
+  id = string_id(bv, gt_str_get(seqid)) + 1;
+  if ((index = (unsigned long) gt_hashmap_get(bv->seq_ids, (void*) id)))
+    return index - 1;
+  memset(&seq, 0, sizeof seq);
+  seq.seqid = id - 1;
+  gt_array_add(bv->seqs, seq);
+  intervals = gt_array_new(sizeof (GtBinaryInterval));
+  gt_array_add(bv->intervals, intervals);
+  index = gt_array_size(bv->seqs);
+  gt_hashmap_add(bv->seq_ids, (void*) id, (void*) index);
+  return index - 1;
+}
+
+static void binary_write_record(GtBinaryVisitor *bv, GtBinaryRecordType type,
+                                GtGenomeNode *gn, GtStr *seqid, uint64_t size)
+{
+  GtBinaryBlock *block = NULL, new_block;
+  GtBinaryRecord record;
+  gt_assert(bv && gn);
+  binary_write_header(bv);
+  /* start a new block if the sequence changes */
+  if (gt_array_size(bv->blocks))
+    block = gt_array_get_last(bv->blocks);
+  if (seqid) {
+    new_block.seqid = string_id(bv, gt_str_get(seqid));
+    if (!block || block->seqid != new_block.seqid) {
+      new_block.nof_records = 0;
+      new_block.offset = bv->offset;
+      gt_array_add(bv->blocks, new_block);
+      block = gt_array_get_last(bv->blocks);
+    }
+  }
+  if (block)
+    block->nof_records++;
+  bv->nof_records++;
+  memset(&record, 0, sizeof record);
+  record.type = type;
+  record.filename = filename_id(bv, gn);
+  record.line_number = gt_genome_node_get_line_number(gn);
+  record.size = size;
+  binary_write(bv, &record, sizeof record);
+}
+
+static int binary_visitor_comment_node(GtNodeVisitor *gv, GtCommentNode *cn,
+                                       GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *binary_visitor;
+  GtBinaryComment comment;
+  gt_error_check(err);
+  binary_visitor = binary_visitor_cast(gv);
+  memset(&comment, 0, sizeof comment);
+  comment.comment = string_id(binary_visitor,
+                              gt_comment_node_get_comment(cn));
+  binary_write_record(binary_visitor, GT_BINARY_COMMENT_RECORD,
+                      (GtGenomeNode*) cn, NULL,
+                      sizeof (GtBinaryRecord) + sizeof comment);
+  binary_write(binary_visitor, &comment, sizeof comment);
+  return 0;
+}
+
+static void add_attribute(const char *attr_name, const char *attr_value,
+                          void *data)
+{
+  GtBinaryVisitor *bv = data;
+  uint32_t id;
+  gt_assert(attr_name && attr_value && bv);
+  id = string_id(bv, attr_name);
+  gt_array_add(bv->attributes, id);
+  id = string_id(bv, attr_value);
+  gt_array_add(bv->attributes, id);
+}
+
+/* Return the index of <fn> in the current tree, <fn> is added if necessary. */
+static uint32_t node_index(GtBinaryVisitor *bv, GtFeatureNode *fn)
+{
+  unsigned long index;
+  gt_assert(bv && fn);
+  if ((index = (unsigned long) gt_hashmap_get(bv->node_indices, fn)))
+    return index - 1;
+  gt_array_add(bv->nodes, fn);
+  index = gt_array_size(bv->nodes);
+  gt_assert(index < GT_BINARY_UNDEF);
+  gt_hashmap_add(bv->node_indices, fn, (void*) index);
+  return index - 1;
+}
+
+static void add_feature(GtBinaryVisitor *bv, GtFeatureNode *fn)
+{
+  GtGenomeNode *gn = (GtGenomeNode*) fn;
+  GtBinaryFeature feature;
+  unsigned long id;
+  GtRange range;
+  gt_assert(bv && fn);
+  memset(&feature, 0, sizeof feature);
+  range = gt_genome_node_get_range(gn);
+  feature.start = range.start;
+  feature.end = range.end;
+  feature.seqid = string_id(bv, gt_str_get(gt_genome_node_get_seqid(gn)));
+  feature.source = gt_feature_node_has_source(fn)
+                   ? string_id(bv, gt_feature_node_get_source(fn))
+                   : GT_BINARY_UNDEF;
+  feature.line_number = gt_genome_node_get_line_number(gn);
+  feature.filename = filename_id(bv, gn);
+  feature.representative = GT_BINARY_UNDEF;
+  feature.flags = gt_feature_node_get_strand(fn) |
+                  gt_feature_node_get_phase(fn) << GT_BINARY_PHASE_OFFSET;
+  if (gt_feature_node_is_pseudo(fn)) {
+    feature.type = GT_BINARY_UNDEF;
+    feature.flags |= GT_BINARY_PSEUDO;
+  }
+  else {
+    /* the types are interned, therefore the pointer identifies them */
+    if (!(id = (unsigned long) gt_hashmap_get(bv->type_ids,
+                                              gt_feature_node_get_type(fn)))) {
+      feature.type = string_id(bv, gt_feature_node_get_type(fn));
+      gt_array_add(bv->types, feature.type);
+      gt_hashmap_add(bv->type_ids, (void*) gt_feature_node_get_type(fn),
+                     (void*) ((unsigned long) feature.type + 1));
+    }
+    else
+      feature.type = id - 1;
+    if (gt_feature_node_is_multi(fn)) {
+      feature.flags |= GT_BINARY_MULTI;
+      /* the parts of a multi-feature belong to the same tree, otherwise the
+         part becomes its own representative */
+      id = (unsigned long)
+           gt_hashmap_get(bv->node_indices,
+                          gt_feature_node_get_multi_representative(fn));
+      feature.representative = id ? id - 1 : gt_array_size(bv->features);
+    }
+  }
+  if (gt_feature_node_score_is_defined(fn)) {
+    feature.flags |= GT_BINARY_SCORE_DEFINED;
+    feature.score = gt_feature_node_get_score(fn);
+  }
+  feature.first_attribute = gt_array_size(bv->attributes) / 2;
+  gt_feature_node_foreach_attribute(fn, add_attribute, bv);
+  feature.nof_attributes = gt_array_size(bv->attributes) / 2 -
+                           feature.first_attribute;
+  gt_array_add(bv->features, feature);
+}
+
+static int binary_visitor_feature_node(GtNodeVisitor *gv, GtFeatureNode *fn,
+                                       GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *binary_visitor;
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *node, *child;
+  GtBinaryFeature *feature;
+  GtBinaryInterval interval;
+  GtBinaryTree tree;
+  unsigned long i;
+  uint32_t index;
+  gt_error_check(err);
+  binary_visitor = binary_visitor_cast(gv);
+  gt_array_reset(binary_visitor->nodes);
+  gt_array_reset(binary_visitor->features);
+  gt_array_reset(binary_visitor->edges);
+  gt_array_reset(binary_visitor->attributes);
+  gt_hashmap_reset(binary_visitor->node_indices);
+
+  /* number the nodes in breadth first order and collect the edges (this also
+     handles DAGs, every node is stored only once) */
+  node_index(binary_visitor, fn);
+  for (i = 0; i < gt_array_size(binary_visitor->nodes); i++) {
+    node = *(GtFeatureNode**) gt_array_get(binary_visitor->nodes, i);
+    fni = gt_feature_node_iterator_new_direct(node);
+    while ((child = gt_feature_node_iterator_next(fni))) {
+      index = i;
+      gt_array_add(binary_visitor->edges, index);
+      index = node_index(binary_visitor, child);
+      gt_array_add(binary_visitor->edges, index);
+    }
+    gt_feature_node_iterator_delete(fni);
+  }
+  for (i = 0; i < gt_array_size(binary_visitor->nodes); i++) {
+    node = *(GtFeatureNode**) gt_array_get(binary_visitor->nodes, i);
+    add_feature(binary_visitor, node);
+  }
+  gt_assert(gt_array_size(binary_visitor->features) ==
+            gt_array_size(binary_visitor->nodes));
+
+  /* add the tree to the interval index */
+  memset(&interval, 0, sizeof interval);
+  interval.start = gt_genome_node_get_start((GtGenomeNode*) fn);
+  interval.end = gt_genome_node_get_end((GtGenomeNode*) fn);
+  interval.offset = binary_visitor->offset;
+  i = seq_index(binary_visitor,
+                gt_genome_node_get_seqid((GtGenomeNode*) fn));
+  gt_array_add(*(GtArray**) gt_array_get(binary_visitor->intervals, i),
+               interval);
+
+  /* write record */
+  memset(&tree, 0, sizeof tree);
+  tree.nof_nodes = gt_array_size(binary_visitor->features);
+  tree.nof_edges = gt_array_size(binary_visitor->edges) / 2;
+  tree.nof_attributes = gt_array_size(binary_visitor->attributes) / 2;
+  feature = gt_array_get_space(binary_visitor->features);
+  binary_write_record(binary_visitor, GT_BINARY_FEATURE_RECORD,
+                      (GtGenomeNode*) fn,
+                      gt_genome_node_get_seqid((GtGenomeNode*) fn),
+                      sizeof (GtBinaryRecord) + sizeof tree +
+                      tree.nof_nodes * sizeof (GtBinaryFeature) +
+                      tree.nof_edges * 2 * sizeof (uint32_t) +
+                      tree.nof_attributes * 2 * sizeof (uint32_t));
+  binary_write(binary_visitor, &tree, sizeof tree);
+  binary_write(binary_visitor, feature,
+               tree.nof_nodes * sizeof (GtBinaryFeature));
+  binary_write(binary_visitor, gt_array_get_space(binary_visitor->edges),
+               tree.nof_edges * 2 * sizeof (uint32_t));
+  binary_write(binary_visitor, gt_array_get_space(binary_visitor->attributes),
+               tree.nof_attributes * 2 * sizeof (uint32_t));
+  return 0;
+}
+
+static int binary_visitor_region_node(GtNodeVisitor *gv, GtRegionNode *rn,
+                                      GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *binary_visitor;
+  GtGenomeNode *gn = (GtGenomeNode*) rn;
+  GtBinarySeqIndex *seq;
+  GtBinaryRegion region;
+  gt_error_check(err);
+  binary_visitor = binary_visitor_cast(gv);
+  memset(&region, 0, sizeof region);
+  region.seqid = string_id(binary_visitor,
+                           gt_str_get(gt_genome_node_get_seqid(gn)));
+  region.start = gt_genome_node_get_start(gn);
+  region.end = gt_genome_node_get_end(gn);
+  /* only the first region of each sequence is indexed */
+  seq = gt_array_get(binary_visitor->seqs,
+                     seq_index(binary_visitor, gt_genome_node_get_seqid(gn)));
+  if (!(seq->flags & GT_BINARY_HAS_REGION)) {
+    seq->flags |= GT_BINARY_HAS_REGION;
+    seq->region_start = region.start;
+    seq->region_end = region.end;
+  }
+  binary_write_record(binary_visitor, GT_BINARY_REGION_RECORD, gn,
+                      gt_genome_node_get_seqid(gn),
+                      sizeof (GtBinaryRecord) + sizeof region);
+  binary_write(binary_visitor, &region, sizeof region);
+  return 0;
+}
+
+static int binary_visitor_sequence_node(GtNodeVisitor *gv, GtSequenceNode *sn,
+                                        GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *binary_visitor;
+  GtBinarySequence sequence;
+  gt_error_check(err);
+  binary_visitor = binary_visitor_cast(gv);
+  memset(&sequence, 0, sizeof sequence);
+  sequence.description = string_id(binary_visitor,
+                                   gt_sequence_node_get_description(sn));
+  sequence.length = gt_sequence_node_get_sequence_length(sn);
+  binary_write_record(binary_visitor, GT_BINARY_SEQUENCE_RECORD,
+                      (GtGenomeNode*) sn, NULL,
+                      sizeof (GtBinaryRecord) + sizeof sequence +
+                      GT_BINARY_ALIGN(sequence.length));
+  binary_write(binary_visitor, &sequence, sizeof sequence);
+  binary_write(binary_visitor, gt_sequence_node_get_sequence(sn),
+               sequence.length);
+  binary_write_padding(binary_visitor);
+  return 0;
+}
+
+const GtNodeVisitorClass* gt_binary_visitor_class()
+{
+  static const GtNodeVisitorClass *gvc = NULL;
+  if (!gvc) {
+    gvc = gt_node_visitor_class_new(sizeof (GtBinaryVisitor),
+                                    binary_visitor_free,
+                                    binary_visitor_comment_node,
+                                    binary_visitor_feature_node,
+                                    binary_visitor_region_node,
+                                    binary_visitor_sequence_node);
+  }
+  return gvc;
+}
+
+GtNodeVisitor* gt_binary_visitor_new(GtFile *outfp)
+{
+  GtNodeVisitor *gv = gt_node_visitor_create(gt_binary_visitor_class());
+  GtBinaryVisitor *binary_visitor = binary_visitor_cast(gv);
+  binary_visitor->outfp = outfp;
+  binary_visitor->header_written = false;
+  binary_visitor->finished = false;
+  binary_visitor->offset = 0;
+  binary_visitor->nof_records = 0;
+  binary_visitor->string_ids = gt_hashmap_new(HASH_STRING, gt_free_func, NULL);
+  binary_visitor->type_ids = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  binary_visitor->node_indices = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  binary_visitor->seq_ids = gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  binary_visitor->strings = gt_array_new(sizeof (char*));
+  binary_visitor->types = gt_array_new(sizeof (uint32_t));
+  binary_visitor->blocks = gt_array_new(sizeof (GtBinaryBlock));
+  binary_visitor->seqs = gt_array_new(sizeof (GtBinarySeqIndex));
+  binary_visitor->intervals = gt_array_new(sizeof (GtArray*));
+  binary_visitor->nodes = gt_array_new(sizeof (GtFeatureNode*));
+  binary_visitor->features = gt_array_new(sizeof (GtBinaryFeature));
+  binary_visitor->edges = gt_array_new(sizeof (uint32_t));
+  binary_visitor->attributes = gt_array_new(sizeof (uint32_t));
+  return gv;
+}
+
+static int compare_intervals(const void *a, const void *b)
+{
+  const GtBinaryInterval *ia = a, *ib = b;
+  if (ia->start != ib->start)
+    return ia->start < ib->start ? -1 : 1;
+  if (ia->end != ib->end)
+    return ia->end < ib->end ? -1 : 1;
+  return 0;
+}
+
+static void binary_write_index(GtBinaryVisitor *bv, GtBinaryFooter *footer)
+{
+  GtBinaryInterval *intervals;
+  GtBinarySeqIndex *seqs;
+  GtArray *seq_intervals;
+  unsigned long i, j;
+  uint64_t max_end;
+  gt_assert(bv && footer);
+  seqs = gt_array_get_space(bv->seqs);
+  footer->nof_seqs = gt_array_size(bv->seqs);
+  for (i = 0; i < footer->nof_seqs; i++) {
+    seq_intervals = *(GtArray**) gt_array_get(bv->intervals, i);
+    seqs[i].first_interval = footer->nof_intervals;
+    seqs[i].nof_intervals = gt_array_size(seq_intervals);
+    footer->nof_intervals += seqs[i].nof_intervals;
+  }
+  footer->index_offset = bv->offset;
+  binary_write(bv, seqs, footer->nof_seqs * sizeof (GtBinarySeqIndex));
+  footer->intervals_offset = bv->offset;
+  for (i = 0; i < footer->nof_seqs; i++) {
+    seq_intervals = *(GtArray**) gt_array_get(bv->intervals, i);
+    /* keep the stream order for equal ranges */
+    gt_array_sort_stable(seq_intervals, compare_intervals);
+    intervals = gt_array_get_space(seq_intervals);
+    max_end = 0;
+    for (j = 0; j < gt_array_size(seq_intervals); j++) {
+      if (intervals[j].end > max_end)
+        max_end = intervals[j].end;
+      intervals[j].max_end = max_end;
+    }
+    binary_write(bv, intervals,
+                 gt_array_size(seq_intervals) * sizeof (GtBinaryInterval));
+  }
+}
+
+void gt_binary_visitor_finish(GtNodeVisitor *gv)
+{
+  GtBinaryVisitor *binary_visitor = binary_visitor_cast(gv);
+  GtBinaryFooter footer;
+  unsigned long i;
+  uint64_t string_offset = 0;
+  const char *string;
+  gt_assert(!binary_visitor->finished);
+  binary_write_header(binary_visitor);
+  memset(&footer, 0, sizeof footer);
+  footer.records_offset = sizeof (GtBinaryHeader);
+  footer.nof_records = binary_visitor->nof_records;
+  /* write string table */
+  footer.strings_offset = binary_visitor->offset;
+  footer.nof_strings = gt_array_size(binary_visitor->strings);
+  for (i = 0; i < gt_array_size(binary_visitor->strings); i++) {
+    binary_write(binary_visitor, &string_offset, sizeof string_offset);
+    string = *(char**) gt_array_get(binary_visitor->strings, i);
+    string_offset += strlen(string) + 1;
+  }
+  for (i = 0; i < gt_array_size(binary_visitor->strings); i++) {
+    string = *(char**) gt_array_get(binary_visitor->strings, i);
+    binary_write(binary_visitor, string, strlen(string) + 1);
+  }
+  binary_write_padding(binary_visitor);
+  /* write used types */
+  footer.types_offset = binary_visitor->offset;
+  footer.nof_types = gt_array_size(binary_visitor->types);
+  binary_write(binary_visitor, gt_array_get_space(binary_visitor->types),
+               footer.nof_types * sizeof (uint32_t));
+  binary_write_padding(binary_visitor);
+  /* write blocks */
+  footer.blocks_offset = binary_visitor->offset;
+  footer.nof_blocks = gt_array_size(binary_visitor->blocks);
+  binary_write(binary_visitor, gt_array_get_space(binary_visitor->blocks),
+               footer.nof_blocks * sizeof (GtBinaryBlock));
+  /* write interval index */
+  binary_write_index(binary_visitor, &footer);
+  /* write footer */
+  memcpy(footer.magic, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH);
+  binary_write(binary_visitor, &footer, sizeof footer);
+  binary_visitor->finished = true;
+}
@@ -0,0 +1,35 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef BINARY_VISITOR_H
+#define BINARY_VISITOR_H
+
+/* implements the ``genome visitor'' interface, writes the visited nodes in the
+   binary annotation format (see binary_format.h) */
+typedef struct GtBinaryVisitor GtBinaryVisitor;
+
+#include "core/file.h"
+#include "extended/node_visitor.h"
+
+const GtNodeVisitorClass* gt_binary_visitor_class(void);
+GtNodeVisitor*            gt_binary_visitor_new(GtFile*);
+/* Write the string table, the block index, the interval index, and the
+   footer. Has to be called after the last node has been visited, the output
+   is incomplete otherwise. */
+void                      gt_binary_visitor_finish(GtNodeVisitor*);
+
+#endif
@@ -15,13 +15,16 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include "core/assert_api.h"
 #include "extended/cds_stream.h"
 #include "extended/cds_visitor.h"
 #include "extended/node_stream_api.h"
+#include "extended/parallel_visitor_stream.h"
 
 struct GtCDSStream {
   const GtNodeStream parent_instance;
-  GtNodeStream *in_stream;
+  GtNodeStream *in_stream,
+               *parallel_stream; /* visits the nodes in worker threads */
   GtNodeVisitor *cds_visitor;
 };
 
@@ -34,6 +37,8 @@ static int cds_stream_next(GtNodeStream *gs, GtGenomeNode **gn, GtError *err)
   int had_err;
   gt_error_check(err);
   cds_stream = cds_stream_cast(gs);
+  if (cds_stream->parallel_stream)
+    return gt_node_stream_next(cds_stream->parallel_stream, gn, err);
   had_err = gt_node_stream_next(cds_stream->in_stream, gn, err);
   if (!had_err && *gn)
     had_err = gt_genome_node_accept(*gn, cds_stream->cds_visitor, err);
@@ -43,6 +48,7 @@ static int cds_stream_next(GtNodeStream *gs, GtGenomeNode **gn, GtError *err)
 static void cds_stream_free(GtNodeStream *gs)
 {
   GtCDSStream *cds_stream = cds_stream_cast(gs);
+  gt_node_stream_delete(cds_stream->parallel_stream);
   gt_node_visitor_delete(cds_stream->cds_visitor);
   gt_node_stream_delete(cds_stream->in_stream);
 }
@@ -79,3 +85,16 @@ GtNodeStream* gt_cds_stream_new(GtNodeStream *in_stream, GtRegionMapping *rm,
   }
   return gs;
 }
+
+int gt_cds_stream_enable_threads(GtNodeStream *gs, unsigned int nof_threads,
+                                 GtError *err)
+{
+  GtCDSStream *cds_stream = cds_stream_cast(gs);
+  gt_error_check(err);
+  gt_assert(!cds_stream->parallel_stream);
+  cds_stream->parallel_stream =
+    gt_parallel_visitor_stream_new(cds_stream->in_stream, nof_threads,
+                                   gt_cds_visitor_new_worker,
+                                   cds_stream->cds_visitor, err);
+  return cds_stream->parallel_stream ? 0 : -1;
+}
@@ -30,5 +30,10 @@ const GtNodeStreamClass* gt_cds_stream_class(void);
 /* create a CDSSTream, takes ownership of GtRegionMapping */
 GtNodeStream*            gt_cds_stream_new(GtNodeStream*, GtRegionMapping*,
                                            const char *source);
+/* add the CDS features in <nof_threads> worker threads, has to be called
+   before the first node is pulled from the stream */
+int                      gt_cds_stream_enable_threads(GtNodeStream*,
+                                                      unsigned int nof_threads,
+                                                      GtError*);
 
 #endif
@@ -256,3 +256,13 @@ GtNodeVisitor* gt_cds_visitor_new(GtRegionMapping *region_mapping,
   cds_visitor->region_mapping = region_mapping;
   return gv;
 }
+
+GtNodeVisitor* gt_cds_visitor_new_worker(void *cds_visitor, GtError *err)
+{
+  GtCDSVisitor *v = cds_visitor_cast(cds_visitor);
+  GtRegionMapping *rm;
+  gt_error_check(err);
+  if (!(rm = gt_region_mapping_clone(v->region_mapping, err)))
+    return NULL;
+  return gt_cds_visitor_new(rm, v->source);
+}
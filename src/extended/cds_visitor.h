@@ -26,5 +26,9 @@ typedef struct GtCDSVisitor GtCDSVisitor;
 
 const GtNodeVisitorClass* gt_cds_visitor_class(void);
 GtNodeVisitor*            gt_cds_visitor_new(GtRegionMapping*, GtStr *source);
+/* Return a new visitor with the same source and a copy of the region mapping
+   of <cds_visitor> (for the worker threads of a parallel visitor stream). */
+GtNodeVisitor*            gt_cds_visitor_new_worker(void *cds_visitor,
+                                                    GtError*);
 
 #endif
@@ -16,14 +16,17 @@
 */
 
 #include "core/assert_api.h"
+#include "core/str_array.h"
 #include "extended/extract_feat_stream.h"
 #include "extended/extract_feat_visitor.h"
 #include "extended/node_stream_api.h"
+#include "extended/parallel_visitor_stream.h"
 
 struct GtExtractFeatStream
 {
   const GtNodeStream parent_instance;
-  GtNodeStream *in_stream;
+  GtNodeStream *in_stream,
+               *parallel_stream; /* visits the nodes in worker threads */
   GtNodeVisitor *extract_feat_visitor;
 };
 
@@ -37,6 +40,8 @@ static int extract_feat_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
   int had_err;
   gt_error_check(err);
   efs = gt_extract_feat_stream_cast(gs);
+  if (efs->parallel_stream)
+    return gt_node_stream_next(efs->parallel_stream, gn, err);
   had_err = gt_node_stream_next(efs->in_stream, gn, err);
   if (!had_err) {
     gt_assert(efs->extract_feat_visitor);
@@ -55,6 +60,7 @@ static int extract_feat_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
 static void extract_feat_stream_free(GtNodeStream *gs)
 {
   GtExtractFeatStream *extract_feat_stream = gt_extract_feat_stream_cast(gs);
+  gt_node_stream_delete(extract_feat_stream->parallel_stream);
   gt_node_visitor_delete(extract_feat_stream->extract_feat_visitor);
   gt_node_stream_delete(extract_feat_stream->in_stream);
 }
@@ -83,3 +89,25 @@ GtNodeStream* gt_extract_feat_stream_new(GtNodeStream *in_stream,
                                                           translate, outfp);
   return gs;
 }
+
+int gt_extract_feat_stream_enable_threads(GtNodeStream *gs,
+                                          unsigned int nof_threads,
+                                          GtError *err)
+{
+  GtExtractFeatStream *efs = gt_extract_feat_stream_cast(gs);
+  gt_error_check(err);
+  gt_assert(!efs->parallel_stream);
+  efs->parallel_stream =
+    gt_parallel_visitor_stream_new(efs->in_stream, nof_threads,
+                                   gt_extract_feat_visitor_new_worker,
+                                   efs->extract_feat_visitor, err);
+  if (!efs->parallel_stream)
+    return -1;
+  /* the sequences are shown in input order by the visitor of this stream */
+  gt_parallel_visitor_stream_set_collect_func(efs->parallel_stream,
+                                              efs->extract_feat_visitor,
+                                              gt_extract_feat_visitor_collect,
+                                              gt_extract_feat_visitor_emit,
+                                              (GtFree) gt_str_array_delete);
+  return 0;
+}
@@ -33,5 +33,11 @@ GtNodeStream*            gt_extract_feat_stream_new(GtNodeStream*,
                                                     const char *type, bool join,
                                                     bool translate,
                                                     GtFile *outfp);
+/* extract the features in <nof_threads> worker threads (the sequences are
+   still shown in input order), has to be called before the first node is
+   pulled from the stream */
+int                      gt_extract_feat_stream_enable_threads(GtNodeStream*,
+                                                       unsigned int nof_threads,
+                                                               GtError*);
 
 #endif
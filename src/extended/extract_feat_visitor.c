@@ -17,8 +17,10 @@
 
 #include "core/assert_api.h"
 #include "core/fasta.h"
+#include "core/str_array.h"
 #include "core/symbol.h"
 #include "core/translator.h"
+#include "core/unused_api.h"
 #include "extended/extract_feat_sequence.h"
 #include "extended/extract_feat_visitor.h"
 #include "extended/feature_node_iterator_api.h"
@@ -32,6 +34,8 @@ struct GtExtractFeatVisitor {
   unsigned long fastaseq_counter;
   GtRegionMapping *region_mapping;
   GtFile *outfp;
+  GtStrArray *sequences; /* the sequences of the current tree, if collected in
+                            a worker thread instead of being shown */
 };
 
 #define gt_extract_feat_visitor_cast(GV)\
@@ -42,6 +46,7 @@ static void extract_feat_visitor_free(GtNodeVisitor *gv)
   GtExtractFeatVisitor *extract_feat_visitor = gt_extract_feat_visitor_cast(gv);
   gt_assert(extract_feat_visitor);
   gt_region_mapping_delete(extract_feat_visitor->region_mapping);
+  gt_str_array_delete(extract_feat_visitor->sequences);
 }
 
 static void construct_description(GtStr *description, const char *type,
@@ -58,24 +63,28 @@ static void construct_description(GtStr *description, const char *type,
     gt_str_append_cstr(description, " (translated)");
 }
 
-static void show_entry(GtStr *description, GtStr *sequence, bool translate,
-                       GtFile *outfp)
+static void translate_sequence(GtStr *sequence)
 {
-  if (translate) {
-    GtStr *protein = gt_str_new();
-    GtTranslator* tr = gt_translator_new();
-    gt_translator_translate_string(tr, protein,
-                                   gt_str_get(sequence),
-                                   gt_str_length(sequence), 0, NULL);
-    gt_fasta_show_entry_generic(gt_str_get(description), gt_str_get(protein),
-                                gt_str_length(protein), 0, outfp);
-    gt_str_delete(protein);
-    gt_translator_delete(tr);
-  }
-  else {
-    gt_fasta_show_entry_generic(gt_str_get(description), gt_str_get(sequence),
-                                gt_str_length(sequence), 0, outfp);
-  }
+  GtStr *protein = gt_str_new();
+  GtTranslator* tr = gt_translator_new();
+  gt_translator_translate_string(tr, protein,
+                                 gt_str_get(sequence),
+                                 gt_str_length(sequence), 0, NULL);
+  gt_str_reset(sequence);
+  gt_str_append_str(sequence, protein);
+  gt_str_delete(protein);
+  gt_translator_delete(tr);
+}
+
+static void show_entry(GtExtractFeatVisitor *efv, GtStr *description,
+                       const char *sequence, unsigned long sequence_length)
+{
+  efv->fastaseq_counter++;
+  construct_description(description, efv->type, efv->fastaseq_counter,
+                        efv->join, efv->translate);
+  gt_fasta_show_entry_generic(gt_str_get(description), sequence,
+                              sequence_length, 0, efv->outfp);
+  gt_str_reset(description);
 }
 
 static int extract_feat_visitor_genome_feature(GtNodeVisitor *nv,
@@ -101,11 +110,14 @@ static int extract_feat_visitor_genome_feature(GtNodeVisitor *nv,
     }
 
     if (!had_err && gt_str_length(sequence)) {
-      efv->fastaseq_counter++;
-      construct_description(description, efv->type, efv->fastaseq_counter,
-                            efv->join, efv->translate);
-      show_entry(description, sequence, efv->translate, efv->outfp);
-      gt_str_reset(description);
+      if (efv->translate)
+        translate_sequence(sequence);
+      if (efv->sequences)
+        gt_str_array_add(efv->sequences, sequence);
+      else {
+        show_entry(efv, description, gt_str_get(sequence),
+                   gt_str_length(sequence));
+      }
       gt_str_reset(sequence);
     }
   }
@@ -146,3 +158,49 @@ GtNodeVisitor* gt_extract_feat_visitor_new(GtRegionMapping *rm,
   efv->outfp = outfp;
   return gv;
 }
+
+GtNodeVisitor* gt_extract_feat_visitor_new_worker(void *efv, GtError *err)
+{
+  GtExtractFeatVisitor *v = gt_extract_feat_visitor_cast(efv), *worker;
+  GtRegionMapping *rm;
+  GtNodeVisitor *gv;
+  gt_error_check(err);
+  if (!(rm = gt_region_mapping_clone(v->region_mapping, err)))
+    return NULL;
+  gv = gt_extract_feat_visitor_new(rm, v->type, v->join, v->translate, NULL);
+  worker = gt_extract_feat_visitor_cast(gv);
+  worker->sequences = gt_str_array_new();
+  return gv;
+}
+
+void* gt_extract_feat_visitor_collect(GtNodeVisitor *gv)
+{
+  GtExtractFeatVisitor *efv = gt_extract_feat_visitor_cast(gv);
+  GtStrArray *sequences;
+  gt_assert(efv->sequences);
+  if (!gt_str_array_size(efv->sequences))
+    return NULL;
+  sequences = efv->sequences;
+  efv->sequences = gt_str_array_new();
+  return sequences;
+}
+
+int gt_extract_feat_visitor_emit(GtNodeVisitor *gv, void *sequences,
+                                 GT_UNUSED GtError *err)
+{
+  GtExtractFeatVisitor *efv = gt_extract_feat_visitor_cast(gv);
+  GtStr *description,
+        *sequence;
+  unsigned long i;
+  gt_error_check(err);
+  if (!sequences)
+    return 0;
+  description = gt_str_new();
+  for (i = 0; i < gt_str_array_size(sequences); i++) {
+    sequence = gt_str_array_get_str(sequences, i);
+    show_entry(efv, description, gt_str_get(sequence),
+               gt_str_length(sequence));
+  }
+  gt_str_delete(description);
+  return 0;
+}
@@ -31,5 +31,17 @@ GtNodeVisitor*            gt_extract_feat_visitor_new(GtRegionMapping *rm,
                                                    const char*, bool join,
                                                    bool translate,
                                                    GtFile *outfp);
+/* Return a new visitor with the same settings and a copy of the region mapping
+   of <efv> which collects the extracted sequences instead of showing them (for
+   the worker threads of a parallel visitor stream). */
+GtNodeVisitor*            gt_extract_feat_visitor_new_worker(void *efv,
+                                                             GtError*);
+/* Return the sequences collected by the worker visitor <gv> for the last
+   feature tree (a <GtStrArray*> or NULL, if there are none). */
+void*                     gt_extract_feat_visitor_collect(GtNodeVisitor *gv);
+/* Show the <sequences> collected by a worker visitor with <gv>. */
+int                       gt_extract_feat_visitor_emit(GtNodeVisitor *gv,
+                                                       void *sequences,
+                                                       GtError*);
 
 #endif
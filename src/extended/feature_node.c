@@ -15,13 +15,16 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include "core/arena.h"
 #include "core/assert_api.h"
 #include "core/cstr.h"
 #include "core/ensure.h"
 #include "core/hashtable.h"
 #include "core/ma.h"
+#include "core/mathsupport.h"
 #include "core/queue.h"
 #include "core/strcmp.h"
 #include "core/symbol.h"
@@ -49,6 +52,11 @@
 #define MULTI_FEATURE_MASK              0x1
 #define PSEUDO_FEATURE_OFFSET           15
 #define PSEUDO_FEATURE_MASK             0x1
+#define CHILDREN_STATUS_OFFSET          16
+#define CHILDREN_STATUS_MASK            0x3
+
+/* the initial capacity of the children array of a feature node */
+#define CHILDREN_INITIAL_SIZE           2
 
 typedef enum {
   NO_PARENT,
@@ -56,6 +64,12 @@ typedef enum {
   MULTIPLE_PARENTS
 } ParentStatus;
 
+typedef enum {
+  NO_CHILDREN,
+  ONE_CHILD,       /* stored in the node itself */
+  SPILLED_CHILDREN /* stored in a separate array */
+} ChildrenStatus;
+
 typedef enum {
   TREE_STATUS_UNDETERMINED,
   IS_TREE,
@@ -72,21 +86,60 @@ typedef struct {
   unsigned long number;
 } GtTypeTraverseInfo;
 
+static ChildrenStatus get_children_status(unsigned int bit_field)
+{
+  return (bit_field >> CHILDREN_STATUS_OFFSET) & CHILDREN_STATUS_MASK;
+}
+
+static void set_children_status(unsigned int *bit_field,
+                                ChildrenStatus children_status)
+{
+  *bit_field &= ~(CHILDREN_STATUS_MASK << CHILDREN_STATUS_OFFSET);
+  *bit_field |= children_status << CHILDREN_STATUS_OFFSET;
+}
+
+GtFeatureNode* const* gt_feature_node_get_children(const GtFeatureNode *fn,
+                                                   unsigned long *nof_children)
+{
+  gt_assert(fn && nof_children);
+  switch (get_children_status(fn->bit_field)) {
+    case NO_CHILDREN:
+      *nof_children = 0;
+      return NULL;
+    case ONE_CHILD:
+      *nof_children = 1;
+      return &fn->children.child;
+    default:
+      *nof_children = fn->children.spilled->size;
+      return fn->children.spilled->nodes + fn->children.spilled->first;
+  }
+}
+
+/* Returns true if the children array of <fn> has been allocated from the arena
+   of <fn>. This is only the case for the initial (small) array, larger arrays
+   are kept on the heap to avoid wasting arena space when they grow. */
+static bool children_in_arena(const GtFeatureNode *fn)
+{
+  gt_assert(fn && get_children_status(fn->bit_field) == SPILLED_CHILDREN);
+  return fn->parent_instance.arena &&
+         fn->children.spilled->allocated <= CHILDREN_INITIAL_SIZE;
+}
+
 static void feature_node_free(GtGenomeNode *gn)
 {
   GtFeatureNode *fn = gt_feature_node_cast(gn);
+  GtFeatureNode * const *children;
+  unsigned long i, nof_children;
   gt_str_delete(fn->seqid);
   gt_str_delete(fn->source);
   gt_tag_value_map_delete(fn->attributes);
-  if (fn->children) {
-    GtDlistelem *dlistelem;
-    for (dlistelem = gt_dlist_first(fn->children);
-         dlistelem != NULL;
-         dlistelem = gt_dlistelem_next(dlistelem)) {
-      gt_genome_node_delete(gt_dlistelem_get_data(dlistelem));
-    }
+  children = gt_feature_node_get_children(fn, &nof_children);
+  for (i = 0; i < nof_children; i++)
+    gt_genome_node_delete((GtGenomeNode*) children[i]);
+  if (get_children_status(fn->bit_field) == SPILLED_CHILDREN &&
+      !children_in_arena(fn)) {
+    gt_free(fn->children.spilled);
   }
-  gt_dlist_delete(fn->children);
 }
 
 const char* gt_feature_node_get_attribute(const GtFeatureNode *fn,
@@ -192,12 +245,20 @@ static void set_tree_status(unsigned int *bit_field, TreeStatus tree_status)
 GtGenomeNode* gt_feature_node_new(GtStr *seqid, const char *type,
                                   unsigned long start, unsigned long end,
                                   GtStrand strand)
+{
+  return gt_feature_node_new_with_arena(seqid, type, start, end, strand, NULL);
+}
+
+GtGenomeNode* gt_feature_node_new_with_arena(GtStr *seqid, const char *type,
+                                             unsigned long start,
+                                             unsigned long end,
+                                             GtStrand strand, GtArena *arena)
 {
   GtGenomeNode *gn;
   GtFeatureNode *fn;
   gt_assert(seqid && type);
   gt_assert(start <= end);
-  gn = gt_genome_node_create(gt_feature_node_class());
+  gn = gt_genome_node_create_with_arena(gt_feature_node_class(), arena);
   fn = gt_feature_node_cast(gn);
   fn->seqid       = gt_str_ref(seqid);
   fn->source      = NULL;
@@ -208,7 +269,7 @@ GtGenomeNode* gt_feature_node_new(GtStr *seqid, const char *type,
   fn->attributes  = NULL;
   fn->bit_field   = 0;
   fn->bit_field |= strand << STRAND_OFFSET;
-  fn->children    = NULL; /* the children list is create on demand */
+  fn->children.spilled = NULL; /* the children are stored on demand */
   gt_feature_node_set_phase(fn, GT_PHASE_UNDEFINED);
   set_transcriptfeaturetype(fn, TRANSCRIPT_FEATURE_TYPE_UNDETERMINED);
   set_tree_status(&fn->bit_field, IS_TREE);
@@ -216,20 +277,30 @@ GtGenomeNode* gt_feature_node_new(GtStr *seqid, const char *type,
   return gn;
 }
 
-GtGenomeNode* gt_feature_node_new_pseudo(GtStr *seqid, unsigned long start,
-                                         unsigned long end, GtStrand strand)
+GtGenomeNode* gt_feature_node_new_pseudo_with_arena(GtStr *seqid,
+                                                    unsigned long start,
+                                                    unsigned long end,
+                                                    GtStrand strand,
+                                                    GtArena *arena)
 {
   GtFeatureNode *pf;
   GtGenomeNode *pn;
   gt_assert(seqid);
   gt_assert(start <= end);
-  pn = gt_feature_node_new(seqid, "pseudo", start, end, strand);
+  pn = gt_feature_node_new_with_arena(seqid, "pseudo", start, end, strand,
+                                      arena);
   pf = gt_feature_node_cast(pn);
   pf->type = NULL; /* pseudo features do not have a type */
   pf->bit_field |= 1 << PSEUDO_FEATURE_OFFSET;
   return pn;
 }
 
+GtGenomeNode* gt_feature_node_new_pseudo(GtStr *seqid, unsigned long start,
+                                         unsigned long end, GtStrand strand)
+{
+  return gt_feature_node_new_pseudo_with_arena(seqid, start, end, strand, NULL);
+}
+
 GtGenomeNode* gt_feature_node_new_pseudo_template(GtFeatureNode *fn)
 {
   GtFeatureNode *pf;
@@ -237,9 +308,12 @@ GtGenomeNode* gt_feature_node_new_pseudo_template(GtFeatureNode *fn)
   GtRange range;
   gt_assert(fn);
   range = feature_node_get_range((GtGenomeNode*) fn),
-  pn = gt_feature_node_new_pseudo(feature_node_get_seqid((GtGenomeNode*) fn),
-                                  range.start, range.end,
-                                  gt_feature_node_get_strand(fn));
+  /* the pseudo-feature lives in the same arena as its template (if any) */
+  pn = gt_feature_node_new_pseudo_with_arena(feature_node_get_seqid(
+                                               (GtGenomeNode*) fn),
+                                             range.start, range.end,
+                                             gt_feature_node_get_strand(fn),
+                                             fn->parent_instance.arena);
   pf = gt_feature_node_cast(pn);
   gt_feature_node_set_source(pf, fn->source);
   return pn;
@@ -659,6 +733,35 @@ bool gt_genome_features_are_similar(GtFeatureNode *fn_a,
   return false;
 }
 
+size_t gt_feature_node_get_memory_footprint(const GtFeatureNode *fn)
+{
+  size_t footprint;
+  gt_assert(fn);
+  footprint = sizeof (GtFeatureNode);
+  if (fn->attributes)
+    footprint += gt_tag_value_map_size(fn->attributes);
+  if (get_children_status(fn->bit_field) == SPILLED_CHILDREN) {
+    footprint += sizeof (GtFeatureNodeChildren) +
+                 fn->children.spilled->allocated * sizeof (GtFeatureNode*);
+  }
+  return footprint;
+}
+
+typedef struct {
+  GtGenomeNode *parent;
+  unsigned long nof_visited;
+} RemoveChildInfo;
+
+static int remove_child_at_300(GtGenomeNode *gn, void *data,
+                               GT_UNUSED GtError *err)
+{
+  RemoveChildInfo *info = data;
+  info->nof_visited++;
+  if (gt_genome_node_get_start(gn) == 300)
+    gt_genome_node_remove_leaf(info->parent, gn);
+  return 0;
+}
+
 int gt_feature_node_unit_test(GtError *err)
 {
   GtGenomeNode *fn;
@@ -673,6 +776,130 @@ int gt_feature_node_unit_test(GtError *err)
   ensure(had_err, !gt_feature_node_score_is_defined((GtFeatureNode*) fn));
 
   gt_genome_node_delete(fn);
+
+  /* test the sorted children array (on the heap and in an arena) */
+  if (!had_err) {
+    static const unsigned long starts[] = { 500, 100, 900, 300, 300, 700, 100,
+                                            800, 200, 600 };
+    GtGenomeNode *children[sizeof starts / sizeof starts[0]];
+    GtFeatureNodeIterator *fni;
+    GtFeatureNode *child, *prev;
+    GtArena *arena;
+    unsigned long i, j, nof_children = sizeof starts / sizeof starts[0];
+    for (j = 0; !had_err && j < 2; j++) {
+      arena = j ? gt_arena_new(0) : NULL;
+      fn = gt_feature_node_new_with_arena(seqid, gt_ft_gene, 1, 1000,
+                                          GT_STRAND_FORWARD, arena);
+      for (i = 0; i < nof_children; i++) {
+        children[i] = gt_feature_node_new_with_arena(seqid, gt_ft_exon,
+                                                     starts[i], starts[i] + 50,
+                                                     GT_STRAND_FORWARD, arena);
+        gt_feature_node_add_child((GtFeatureNode*) fn,
+                                  (GtFeatureNode*) children[i]);
+      }
+      ensure(had_err,
+             gt_genome_node_number_of_children(fn) == nof_children);
+      /* remove a child from the middle */
+      gt_genome_node_remove_leaf(fn, children[3]);
+      ensure(had_err,
+             gt_genome_node_number_of_children(fn) == nof_children - 1);
+      /* the children are sorted and equal children keep their order */
+      prev = NULL;
+      fni = gt_feature_node_iterator_new_direct((GtFeatureNode*) fn);
+      while (!had_err && (child = gt_feature_node_iterator_next(fni))) {
+        ensure(had_err, child != (GtFeatureNode*) children[3]);
+        if (prev) {
+          ensure(had_err, gt_genome_node_cmp((GtGenomeNode*) prev,
+                                             (GtGenomeNode*) child) <= 0);
+          if (gt_genome_node_get_start((GtGenomeNode*) child) == 100) {
+            ensure(had_err, prev == (GtFeatureNode*) children[1]);
+            ensure(had_err, child == (GtFeatureNode*) children[6]);
+          }
+        }
+        prev = child;
+      }
+      gt_feature_node_iterator_delete(fni);
+      gt_genome_node_delete(children[3]);
+      gt_genome_node_delete(fn);
+      gt_arena_delete(arena);
+    }
+  }
+
+  /* many children added in ascending, descending, and random order are
+     sorted, a single child is stored in the node itself */
+  if (!had_err) {
+    GtFeatureNode * const *children;
+    GtFeatureNodeChildren *spilled;
+    GtGenomeNode *child;
+    unsigned long i, j, k, nof_children = 1000;
+    for (j = 0; !had_err && j < 3; j++) {
+      fn = gt_feature_node_new(seqid, gt_ft_gene, 1, 10 * nof_children,
+                               GT_STRAND_FORWARD);
+      for (i = 0; i < nof_children; i++) {
+        k = j == 0 ? i : j == 1 ? nof_children - i - 1
+                                : gt_rand_max(nof_children - 1);
+        child = gt_feature_node_new(seqid, gt_ft_exon, 10 * k + 1, 10 * k + 5,
+                                    GT_STRAND_FORWARD);
+        gt_feature_node_add_child((GtFeatureNode*) fn, (GtFeatureNode*) child);
+        if (!i) {
+          ensure(had_err, get_children_status(((GtFeatureNode*) fn)->bit_field)
+                          == ONE_CHILD);
+        }
+      }
+      children = gt_feature_node_get_children((GtFeatureNode*) fn,
+                                              &nof_children);
+      ensure(had_err, nof_children == 1000UL);
+      for (i = 1; !had_err && i < nof_children; i++) {
+        ensure(had_err, gt_genome_node_cmp((GtGenomeNode*) children[i-1],
+                                           (GtGenomeNode*) children[i]) <= 0);
+      }
+      /* sorted input leaves the free space where the children are added */
+      spilled = ((GtFeatureNode*) fn)->children.spilled;
+      if (j < 2)
+        ensure(had_err, spilled->allocated < 2 * nof_children);
+      /* remove the children from both ends */
+      while (!had_err &&
+             (nof_children = gt_genome_node_number_of_children(fn))) {
+        child = (GtGenomeNode*) spilled->nodes[spilled->first +
+                                               (nof_children % 2
+                                                ? nof_children - 1 : 0)];
+        gt_genome_node_remove_leaf(fn, child);
+        ensure(had_err, gt_genome_node_number_of_children(fn)
+                        == nof_children - 1);
+        gt_genome_node_delete(child);
+      }
+      nof_children = 1000;
+      gt_genome_node_delete(fn);
+    }
+  }
+
+  /* remove children while the direct children are traversed */
+  if (!had_err) {
+    static const unsigned long starts[] = { 100, 300, 300, 500, 300 };
+    GtGenomeNode *children[sizeof starts / sizeof starts[0]];
+    RemoveChildInfo info;
+    unsigned long i, nof_children = sizeof starts / sizeof starts[0];
+    fn = gt_feature_node_new(seqid, gt_ft_gene, 1, 1000, GT_STRAND_FORWARD);
+    for (i = 0; i < nof_children; i++) {
+      children[i] = gt_feature_node_new(seqid, gt_ft_exon, starts[i],
+                                        starts[i] + 50, GT_STRAND_FORWARD);
+      gt_feature_node_add_child((GtFeatureNode*) fn,
+                                (GtFeatureNode*) children[i]);
+    }
+    info.parent = fn;
+    info.nof_visited = 0;
+    had_err = gt_genome_node_traverse_direct_children(fn, &info,
+                                                      remove_child_at_300,
+                                                      err);
+    ensure(had_err, info.nof_visited == nof_children);
+    ensure(had_err, gt_genome_node_number_of_children(fn) == 2);
+    for (i = 0; i < nof_children; i++) {
+      if (starts[i] == 300)
+        gt_genome_node_delete(children[i]);
+    }
+    gt_genome_node_delete(fn);
+  }
+
   gt_str_delete(seqid);
 
   return had_err;
@@ -728,8 +955,8 @@ static int feature_node_traverse_children_generic(GtGenomeNode *genome_node,
   GtQueue *node_queue = NULL;
   GtGenomeNode *gn, *child_feature;
   GtFeatureNode *feature_node, *fn, *fn_ref;
-  GtDlistelem *dlistelem;
-  unsigned long i;
+  GtFeatureNode * const *children;
+  unsigned long i, nof_children;
   GtHashtable *traversed_nodes = NULL;
   bool has_node_with_multiple_parents = false;
   int had_err = 0;
@@ -749,10 +976,9 @@ static int feature_node_traverse_children_generic(GtGenomeNode *genome_node,
     if (gt_feature_node_try_cast(genome_node) &&
         gt_feature_node_is_pseudo((GtFeatureNode*) genome_node)) {
       /* add the children backwards to traverse in order */
-      for (dlistelem = gt_dlist_last(feature_node->children);
-           dlistelem != NULL;
-           dlistelem = gt_dlistelem_previous(dlistelem)) {
-        child_feature = (GtGenomeNode*) gt_dlistelem_get_data(dlistelem);
+      children = gt_feature_node_get_children(feature_node, &nof_children);
+      for (i = nof_children; i > 0; i--) {
+        child_feature = (GtGenomeNode*) children[i-1];
         gt_array_add(node_stack, child_feature);
       }
     }
@@ -763,10 +989,9 @@ static int feature_node_traverse_children_generic(GtGenomeNode *genome_node,
   else {
     node_queue = gt_queue_new();
     if (gt_feature_node_is_pseudo(feature_node)) {
-      for (dlistelem = gt_dlist_first(feature_node->children);
-           dlistelem != NULL;
-           dlistelem = gt_dlistelem_next(dlistelem)) {
-        child_feature = (GtGenomeNode*) gt_dlistelem_get_data(dlistelem);
+      children = gt_feature_node_get_children(feature_node, &nof_children);
+      for (i = 0; i < nof_children; i++) {
+        child_feature = (GtGenomeNode*) children[i];
         gt_queue_add(node_queue, child_feature);
       }
     }
@@ -792,14 +1017,12 @@ static int feature_node_traverse_children_generic(GtGenomeNode *genome_node,
     gt_array_reset(list_of_children);
     /* XXX */
     fn = gt_feature_node_cast(gn);
-    if (fn->children) {
-      /* a backup of the children array is necessary if traverse() frees the
-         node */
-      for (dlistelem = gt_dlist_first(fn->children); dlistelem != NULL;
-           dlistelem = gt_dlistelem_next(dlistelem)) {
-        child_feature = (GtGenomeNode*) gt_dlistelem_get_data(dlistelem);
-        gt_array_add(list_of_children, child_feature);
-      }
+    /* a backup of the children array is necessary if traverse() frees the
+       node */
+    children = gt_feature_node_get_children(fn, &nof_children);
+    for (i = 0; i < nof_children; i++) {
+      child_feature = (GtGenomeNode*) children[i];
+      gt_array_add(list_of_children, child_feature);
     }
     /* store the implications of <gn> to the tree status of <feature_node> */
     if (multiple_parents(fn->bit_field))
@@ -897,22 +1120,27 @@ int gt_genome_node_traverse_direct_children(GtGenomeNode *gn,
                                             GtGenomeNodeTraverseFunc traverse,
                                             GtError *err)
 {
-  GtFeatureNode *fn;
-  GtDlistelem *dlistelem;
+  GtFeatureNode *fn, *child;
+  GtFeatureNode * const *children;
+  unsigned long i = 0, j, nof_children;
   int had_err = 0;
   gt_error_check(err);
   if (!gn || !traverse)
     return 0;
   /* XXX */
   fn = gt_feature_node_cast(gn);
-  if (fn->children) {
-    for (dlistelem = gt_dlist_first(fn->children); dlistelem != NULL;
-         dlistelem = gt_dlistelem_next(dlistelem)) {
-      had_err = traverse((GtGenomeNode*) gt_dlistelem_get_data(dlistelem),
-                          traverse_func_data, err);
-      if (had_err)
-        break;
-    }
+  children = gt_feature_node_get_children(fn, &nof_children);
+  while (i < nof_children) {
+    child = children[i];
+    had_err = traverse((GtGenomeNode*) child, traverse_func_data, err);
+    if (had_err)
+      break;
+    /* skip the children <traverse> might have added in front of <child>,
+       if it removed <child> the next child has taken its place */
+    children = gt_feature_node_get_children(fn, &nof_children);
+    for (j = i; j < nof_children && children[j] != child; j++);
+    if (j < nof_children)
+      i = j + 1;
   }
   return had_err;
 }
@@ -938,9 +1166,119 @@ unsigned long gt_genome_node_number_of_children_of_type(const GtGenomeNode
 unsigned long gt_genome_node_number_of_children(const GtGenomeNode *gn)
 {
   GtFeatureNode *fn;
+  unsigned long nof_children;
   gt_assert(gn);
   fn = gt_feature_node_cast((GtGenomeNode*) gn); /* XXX */
-  return gt_dlist_size(fn->children);
+  (void) gt_feature_node_get_children(fn, &nof_children);
+  return nof_children;
+}
+
+/* Move the children of <parent> to an array twice as large as the current one
+   (or to the initial array, if the only child is stored in <parent>). The free
+   space is left in front of the children if <at_front> is true and behind
+   them otherwise. If <parent> lives in an arena, the initial array is
+   allocated from it as well (most nodes have only a few children). */
+static void children_grow(GtFeatureNode *parent, bool at_front)
+{
+  GtFeatureNodeChildren *old = NULL, *children;
+  unsigned long allocated, first;
+  size_t size;
+  gt_assert(parent);
+  if (get_children_status(parent->bit_field) == SPILLED_CHILDREN)
+    old = parent->children.spilled;
+  allocated = old ? 2 * old->allocated : CHILDREN_INITIAL_SIZE;
+  gt_assert(allocated <= UINT_MAX);
+  size = sizeof (GtFeatureNodeChildren) + allocated * sizeof (GtFeatureNode*);
+  if (old && !children_in_arena(parent))
+    children = gt_realloc(old, size);
+  else {
+    if (!old && parent->parent_instance.arena)
+      children = gt_arena_malloc(parent->parent_instance.arena, size);
+    else
+      children = gt_malloc(size);
+    if (old) {
+      /* spill the array from the arena to the heap */
+      memcpy(children, old, sizeof (GtFeatureNodeChildren) +
+             (old->first + old->size) * sizeof (GtFeatureNode*));
+    }
+    else if (get_children_status(parent->bit_field) == ONE_CHILD) {
+      children->first = 0;
+      children->size = 1;
+      children->nodes[0] = parent->children.child;
+    }
+    else {
+      children->first = 0;
+      children->size = 0;
+    }
+  }
+  first = at_front ? allocated - children->size : 0;
+  memmove(children->nodes + first, children->nodes + children->first,
+          children->size * sizeof (GtFeatureNode*));
+  children->first = first;
+  children->allocated = allocated;
+  parent->children.spilled = children;
+  set_children_status(&parent->bit_field, SPILLED_CHILDREN);
+}
+
+/* Insert <child> into the sorted children of <parent>, behind all children
+   which are smaller or equal (equal children keep their insertion order). The
+   position is found by binary search, afterwards the children in front of it
+   or behind it are moved, depending on which are fewer and where the array has
+   room. Hence, children added in ascending or descending order take amortized
+   constant time, otherwise O(log n) comparisons and at most n moves. */
+static void children_add(GtFeatureNode *parent, GtFeatureNode *child)
+{
+  GtFeatureNodeChildren *children;
+  GtFeatureNode * const *nodes;
+  unsigned long left = 0, right, mid, size;
+  bool front;
+  gt_assert(parent && child);
+  if (get_children_status(parent->bit_field) == NO_CHILDREN) {
+    parent->children.child = child;
+    set_children_status(&parent->bit_field, ONE_CHILD);
+    return;
+  }
+  nodes = gt_feature_node_get_children(parent, &size);
+  if (!size || gt_genome_node_cmp((GtGenomeNode*) nodes[size-1],
+                                  (GtGenomeNode*) child) <= 0) {
+    /* the new child is larger or equal than the last child (the common
+       case) */
+    left = size;
+  }
+  else {
+    right = size - 1;
+    while (left < right) {
+      mid = left + (right - left) / 2;
+      if (gt_genome_node_cmp((GtGenomeNode*) nodes[mid],
+                             (GtGenomeNode*) child) <= 0) {
+        left = mid + 1;
+      }
+      else
+        right = mid;
+    }
+  }
+  front = left < size - left;
+  if (get_children_status(parent->bit_field) == ONE_CHILD)
+    children_grow(parent, front);
+  children = parent->children.spilled;
+  if (!children->first && children->size == children->allocated) {
+    children_grow(parent, front);
+    children = parent->children.spilled;
+  }
+  if (children->first &&
+      (front || children->first + children->size == children->allocated)) {
+    /* move the children in front of the position one slot to the front */
+    memmove(children->nodes + children->first - 1,
+            children->nodes + children->first, left * sizeof (GtFeatureNode*));
+    children->first--;
+  }
+  else {
+    memmove(children->nodes + children->first + left + 1,
+            children->nodes + children->first + left,
+            (children->size - left) * sizeof (GtFeatureNode*));
+  }
+  children->nodes[children->first + left] = child;
+  children->size++;
 }
 
 void gt_feature_node_add_child(GtFeatureNode *parent, GtFeatureNode *child)
@@ -951,10 +1289,8 @@ void gt_feature_node_add_child(GtFeatureNode *parent, GtFeatureNode *child)
                         gt_genome_node_get_seqid((GtGenomeNode*) child)));
   /* pseudo-features have to be top-level */
   gt_assert(!gt_feature_node_is_pseudo((GtFeatureNode*) child));
-  /* create children list on demand */
-  if (!parent->children)
-    parent->children = gt_dlist_new((GtCompare) gt_genome_node_cmp);
-  gt_dlist_add(parent->children, child); /* XXX: check for circles */
+  /* the children array is created on demand */
+  children_add(parent, child); /* XXX: check for circles */
   /* update tree status of <parent> */
   set_tree_status(&parent->bit_field, TREE_STATUS_UNDETERMINED);
   /* update parent info of <child> */
@@ -964,19 +1300,42 @@ void gt_feature_node_add_child(GtFeatureNode *parent, GtFeatureNode *child)
 static int remove_leaf(GtGenomeNode *node, void *data, GT_UNUSED GtError *err)
 {
   GtFeatureNode *node_feature;
-  GtDlistelem *dlistelem;
-  GtGenomeNode *child, *leaf = (GtGenomeNode*) data;
+  GtFeatureNodeChildren *children;
+  GtGenomeNode *leaf = (GtGenomeNode*) data;
+  unsigned long i;
   gt_error_check(err);
   node_feature = gt_feature_node_cast(node); /* XXX */
-  if (node != leaf && node_feature->children) {
-    for (dlistelem = gt_dlist_first(node_feature->children); dlistelem != NULL;
-         dlistelem = gt_dlistelem_next(dlistelem)) {
-      child = (GtGenomeNode*) gt_dlistelem_get_data(dlistelem);
-      if (child == leaf) {
-        gt_dlist_remove(node_feature->children, dlistelem);
-        break;
+  if (node == leaf)
+    return 0;
+  switch (get_children_status(node_feature->bit_field)) {
+    case ONE_CHILD:
+      if ((GtGenomeNode*) node_feature->children.child == leaf) {
+        node_feature->children.child = NULL;
+        set_children_status(&node_feature->bit_field, NO_CHILDREN);
       }
-    }
+      break;
+    case SPILLED_CHILDREN:
+      children = node_feature->children.spilled;
+      for (i = 0; i < children->size; i++) {
+        if ((GtGenomeNode*) children->nodes[children->first + i] == leaf) {
+          /* close the gap from the side with fewer children */
+          if (i < children->size - i - 1) {
+            memmove(children->nodes + children->first + 1,
+                    children->nodes + children->first,
+                    i * sizeof (GtFeatureNode*));
+            children->first++;
+          }
+          else {
+            memmove(children->nodes + children->first + i,
+                    children->nodes + children->first + i + 1,
+                    (children->size - i - 1) * sizeof (GtFeatureNode*));
+          }
+          children->size--;
+          break;
+        }
+      }
+      break;
+    default: ;
   }
   return 0;
 }
@@ -1032,9 +1391,7 @@ bool gt_genome_node_has_children(GtGenomeNode *gn)
   GtFeatureNode *fn;
   gt_assert(gn);
   fn = gt_feature_node_cast((GtGenomeNode*) gn); /* XXX */
-  if (!fn->children || gt_dlist_size(fn->children) == 0)
-    return false;
-  return true;
+  return gt_genome_node_number_of_children((GtGenomeNode*) fn) ? true : false;
 }
 
 bool gt_genome_node_direct_children_do_not_overlap_generic(GtGenomeNode
@@ -1044,9 +1401,10 @@ bool gt_genome_node_direct_children_do_not_overlap_generic(GtGenomeNode
 {
   GtFeatureNode *parent_node;
   GtArray *children_ranges;
-  GtDlistelem *dlistelem;
   GtFeatureNode *fn = NULL, *child_fn;
+  GtFeatureNode * const *children;
   GtRange range;
+  unsigned long i, nof_children;
   bool rval;
 
   gt_assert(parent);
@@ -1056,21 +1414,17 @@ bool gt_genome_node_direct_children_do_not_overlap_generic(GtGenomeNode
 
   parent_node = gt_feature_node_cast(parent); /* XXX */
 
-  if (!parent_node->children)
+  children = gt_feature_node_get_children(parent_node, &nof_children);
+  if (!nof_children)
     return true;
 
   /* get children ranges */
   children_ranges = gt_array_new(sizeof (GtRange));
-  gt_assert(parent_node->children);
-  for (dlistelem = gt_dlist_first(parent_node->children); dlistelem != NULL;
-       dlistelem = gt_dlistelem_next(dlistelem)) {
-    if (!fn ||
-        ((child_fn =
-            gt_feature_node_try_cast(gt_dlistelem_get_data(dlistelem))) &&
-         gt_feature_node_get_type(fn) ==
-         gt_feature_node_get_type(child_fn))) {
-      range = gt_genome_node_get_range((GtGenomeNode*)
-                                    gt_dlistelem_get_data(dlistelem));
+  for (i = 0; i < nof_children; i++) {
+    child_fn = children[i];
+    if (!fn || gt_feature_node_get_type(fn) ==
+               gt_feature_node_get_type(child_fn)) {
+      range = gt_genome_node_get_range((GtGenomeNode*) child_fn);
       gt_array_add(children_ranges, range);
     }
   }
@@ -18,6 +18,7 @@
 #ifndef FEATURE_NODE_H
 #define FEATURE_NODE_H
 
+#include "core/arena.h"
 #include "core/bittab.h"
 #include "core/range.h"
 #include "core/strand_api.h"
@@ -63,6 +64,15 @@ typedef int (*GtGenomeNodeTraverseFunc)(GtGenomeNode*, void*, GtError*);
 
 const GtGenomeNodeClass* gt_feature_node_class(void);
 
+/* Like <gt_feature_node_new()>, but the new <GtFeatureNode*> is allocated from
+   <arena> (if it is not <NULL>). The same holds for the array of children which
+   is later added to it. The memory is released when the last node allocated
+   from <arena> has been deleted. */
+GtGenomeNode*  gt_feature_node_new_with_arena(GtStr *seqid, const char *type,
+                                              unsigned long start,
+                                              unsigned long end,
+                                              GtStrand strand, GtArena *arena);
+
 /* Create a new pseudo-<GtFeatureNode*> on sequence with ID <seqid> which lies
    from <start> to <end> on strand <strand>. Pseudo-features do not have a type.
    The <GtFeatureNode*> stores a new reference to <seqid>, so make sure you do
@@ -71,6 +81,13 @@ const GtGenomeNodeClass* gt_feature_node_class(void);
    to be smaller or equal than <end>. */
 GtGenomeNode*  gt_feature_node_new_pseudo(GtStr *seqid, unsigned long start,
                                           unsigned long end, GtStrand strand);
+/* Like <gt_feature_node_new_pseudo()>, but the new <GtFeatureNode*> is
+   allocated from <arena> (if it is not <NULL>). */
+GtGenomeNode*  gt_feature_node_new_pseudo_with_arena(GtStr *seqid,
+                                                     unsigned long start,
+                                                     unsigned long end,
+                                                     GtStrand strand,
+                                                     GtArena *arena);
 /* Create a new pseudo-<GtFeatureNode*> node which uses <feature_node> as
    template.  That is, the sequence ID, range, strand, and source are taken from
    <feature_node>. */
@@ -106,6 +123,11 @@ double         gt_feature_node_average_splice_site_prob(const GtFeatureNode*);
 /* Returns true, if the given features have the same seqid, feature type, range,
    strand, and phase. */
 bool           gt_genome_features_are_similar(GtFeatureNode*, GtFeatureNode*);
+/* Return the number of bytes occupied by <feature_node> itself, including its
+   attributes and the array of its direct children (but not the children
+   themselves). Shared objects like the sequence ID are not counted. */
+size_t         gt_feature_node_get_memory_footprint(const GtFeatureNode
+                                                    *feature_node);
 int            gt_feature_node_unit_test(GtError*);
 
 /* perform depth first traversal of the given genome node */
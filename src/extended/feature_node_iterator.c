@@ -41,16 +41,16 @@ static GtFeatureNodeIterator* feature_node_iterator_new_base(const GtFeatureNode
 GtFeatureNodeIterator* gt_feature_node_iterator_new(const GtFeatureNode *fn)
 {
   GtFeatureNodeIterator *fni;
-  GtFeatureNode *child_feature;
-  GtDlistelem *dlistelem;
+  GtFeatureNode * const *children, *child;
+  unsigned long i, nof_children;
   gt_assert(fn);
   fni = feature_node_iterator_new_base(fn);
   if (gt_feature_node_is_pseudo((GtFeatureNode*) fn)) {
     /* add the children backwards to traverse in order */
-    for (dlistelem = gt_dlist_last(fn->children); dlistelem != NULL;
-         dlistelem = gt_dlistelem_previous(dlistelem)) {
-      child_feature = (GtFeatureNode*) gt_dlistelem_get_data(dlistelem);
-      gt_array_add(fni->feature_stack, child_feature);
+    children = gt_feature_node_get_children(fn, &nof_children);
+    for (i = nof_children; i > 0; i--) {
+      child = children[i-1];
+      gt_array_add(fni->feature_stack, child);
     }
   }
   else
@@ -63,13 +63,13 @@ GtFeatureNodeIterator* gt_feature_node_iterator_new(const GtFeatureNode *fn)
 static void add_children_to_stack(GtArray *feature_stack,
                                   const GtFeatureNode *fn)
 {
-  GtFeatureNode *child;
-  GtDlistelem *dlistelem;
-  gt_assert(feature_stack && fn && fn->children);
+  GtFeatureNode * const *children, *child;
+  unsigned long i, nof_children;
+  gt_assert(feature_stack && fn);
   /* add the children backwards to traverse in order */
-  for (dlistelem = gt_dlist_last(fn->children); dlistelem != NULL;
-       dlistelem = gt_dlistelem_previous(dlistelem)) {
-    child = gt_dlistelem_get_data(dlistelem);
+  children = gt_feature_node_get_children(fn, &nof_children);
+  for (i = nof_children; i > 0; i--) {
+    child = children[i-1];
     gt_array_add(feature_stack, child);
   }
 }
@@ -80,8 +80,7 @@ GtFeatureNodeIterator* gt_feature_node_iterator_new_direct(const GtFeatureNode
   GtFeatureNodeIterator *fni;
   gt_assert(fn);
   fni = feature_node_iterator_new_base(fn);
-  if (fn->children)
-    add_children_to_stack(fni->feature_stack, fn);
+  add_children_to_stack(fni->feature_stack, fn);
   fni->direct = true;
   return fni;
 }
@@ -95,7 +94,7 @@ GtFeatureNode* gt_feature_node_iterator_next(GtFeatureNodeIterator *fni)
   /* pop */
   fn = *(GtFeatureNode**) gt_array_pop(fni->feature_stack);
   /* push children on stack */
-  if (!fni->direct && fn->children)
+  if (!fni->direct)
     add_children_to_stack(fni->feature_stack, fn);
   return fn;
 }
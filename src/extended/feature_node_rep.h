@@ -21,17 +21,39 @@
 #include "extended/genome_node_rep.h"
 #include "extended/tag_value_map.h"
 
+/* The children of a feature node are kept sorted. A single child is stored in
+   the node itself, more children are spilled to an array which is allocated
+   together with its header. The array has room at both ends, children added
+   in ascending or in descending order are inserted in amortized constant
+   time. */
+typedef struct {
+  unsigned int first, /* index of the first child in <nodes> */
+               size,
+               allocated;
+  GtFeatureNode *nodes[];
+} GtFeatureNodeChildren;
+
 struct GtFeatureNode {
   GtGenomeNode parent_instance;
-  GtStr *seqid,
+  GtStr *seqid, /* seqid and source are shared between nodes */
         *source;
   const char *type;
   GtRange range;
   float score;
-  GtTagValueMap attributes; /* stores the attributes; created on demand */
   unsigned int bit_field;
-  GtDlist *children;
+  GtTagValueMap attributes; /* stores the attributes; created on demand */
+  union {
+    GtFeatureNode *child; /* the only child */
+    GtFeatureNodeChildren *spilled; /* created on demand */
+  } children; /* the member in use is stored in <bit_field> */
   GtFeatureNode *representative;
 };
 
+/* Returns the children of <fn> in sorted order and stores their number in
+   <nof_children>. The returned array is only valid until the children of <fn>
+   are changed. */
+GtFeatureNode* const* gt_feature_node_get_children(const GtFeatureNode *fn,
+                                                   unsigned long
+                                                   *nof_children);
+
 #endif
@@ -34,24 +34,38 @@ typedef struct {
 GtGenomeNode* gt_genome_node_ref(GtGenomeNode *gn)
 {
   gt_assert(gn);
+#ifdef GT_THREADS_ENABLED
+  /* feature trees kept in a feature index are shared between threads drawing
+     different parts of it */
+  __sync_fetch_and_add(&gn->reference_count, 1);
+#else
   gn->reference_count++;
+#endif
   return gn;
 }
 
 void gt_genome_node_delete(GtGenomeNode *gn)
 {
   if (!gn) return;
+#ifdef GT_THREADS_ENABLED
+  if (__sync_fetch_and_sub(&gn->reference_count, 1))
+    return;
+#else
   if (gn->reference_count) {
     gn->reference_count--;
     return;
   }
+#endif
   gt_assert(gn->c_class);
   if (gn->c_class->free)
     gn->c_class->free(gn);
   gt_str_delete(gn->filename);
   if (gn->userdata)
     gt_hashmap_delete(gn->userdata);
-  gt_free(gn);
+  if (gn->arena)
+    gt_arena_delete(gn->arena); /* memory is released together with arena */
+  else
+    gt_free(gn);
 }
 
 static void userdata_delete(void *data)
@@ -131,16 +145,28 @@ static int compare_genome_nodes_with_delta(GtGenomeNode *gn_a,
 }
 
 GtGenomeNode* gt_genome_node_create(const GtGenomeNodeClass *gnc)
+{
+  return gt_genome_node_create_with_arena(gnc, NULL);
+}
+
+GtGenomeNode* gt_genome_node_create_with_arena(const GtGenomeNodeClass *gnc,
+                                               GtArena *arena)
 {
   GtGenomeNode *gn;
   gt_assert(gnc && gnc->size);
-  gn                     = gt_malloc(gnc->size);
+  if (arena) {
+    gn                   = gt_arena_malloc(arena, gnc->size);
+    gn->arena            = gt_arena_ref(arena);
+  }
+  else {
+    gn                   = gt_malloc(gnc->size);
+    gn->arena            = NULL;
+  }
   gn->c_class            = gnc;
   gn->filename           = NULL; /* means the node is generated */
   gn->line_number        = 0;
   gn->reference_count    = 0;
   gn->userdata           = NULL;
-  gn->userdata_nof_items = 0;
   return gn;
 }
 
@@ -299,12 +325,35 @@ void gt_genome_node_add_user_data(GtGenomeNode *gn, const char *key, void *data,
   ud = gt_malloc(sizeof (GtGenomeNodeUserData));
   ud->ptr = data;
   ud->free_func = free_func;
-  if (!gn->userdata) {
+  /* free old data if overwriting */
+  gt_genome_node_release_user_data(gn, key);
+  if (!gn->userdata)
     gn->userdata = gt_hashmap_new(HASH_STRING, NULL, userdata_delete);
-  } else /* free old data if overwriting */
-    gt_genome_node_release_user_data(gn, key);
   gt_hashmap_add(gn->userdata, (char*) key, ud);
-  gn->userdata_nof_items++;
+}
+
+static int count_user_data(GT_UNUSED void *key, void *value, void *data,
+                           GT_UNUSED GtError *err)
+{
+  unsigned long *nof_items = data;
+  gt_error_check(err);
+  if (value)
+    (*nof_items)++;
+  return 0;
+}
+
+/* the number of user data items is not stored to keep the nodes small */
+static unsigned long userdata_nof_items(const GtGenomeNode *gn)
+{
+  unsigned long nof_items = 0;
+  int had_err;
+  gt_assert(gn);
+  if (!gn->userdata)
+    return 0;
+  had_err = gt_hashmap_foreach(gn->userdata, count_user_data, &nof_items,
+                               NULL);
+  gt_assert(!had_err); /* count_user_data() is sane */
+  return nof_items;
 }
 
 void* gt_genome_node_get_user_data(const GtGenomeNode *gn, const char *key)
@@ -326,7 +375,7 @@ void gt_genome_node_release_user_data(GtGenomeNode *gn, const char *key)
   if ((ud = (GtGenomeNodeUserData*) gt_hashmap_get(gn->userdata, key))) {
     gt_hashmap_add(gn->userdata, (char*) key, NULL);
     userdata_delete(ud);
-    if (--gn->userdata_nof_items == 0) {
+    if (!userdata_nof_items(gn)) {
       gt_hashmap_delete(gn->userdata);
       gn->userdata = NULL;
     }
@@ -353,27 +402,27 @@ int gt_genome_node_unit_test(GtError *err)
   gn = gt_genome_node_create(gnc);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey1) == NULL);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey2) == NULL);
-  ensure(had_err, gn->userdata_nof_items == 0);
+  ensure(had_err, userdata_nof_items(gn) == 0);
   ensure(had_err, gn->userdata == NULL);
 
   gt_genome_node_add_user_data(gn, testkey1, testptr1, NULL);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey1) != NULL);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey1) == testptr1);
-  ensure(had_err, gn->userdata_nof_items == 1);
+  ensure(had_err, userdata_nof_items(gn) == 1);
   ensure(had_err, gn->userdata != NULL);
 
   gt_genome_node_add_user_data(gn, testkey2, testptr2, gt_free_func);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey2) != NULL);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey2) == testptr2);
-  ensure(had_err, gn->userdata_nof_items == 2);
+  ensure(had_err, userdata_nof_items(gn) == 2);
 
   gt_genome_node_release_user_data(gn, testkey1);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey1) == NULL);
-  ensure(had_err, gn->userdata_nof_items == 1);
+  ensure(had_err, userdata_nof_items(gn) == 1);
 
   gt_genome_node_release_user_data(gn, testkey2);
   ensure(had_err, gt_genome_node_get_user_data(gn, testkey2) == NULL);
-  ensure(had_err, gn->userdata_nof_items == 0);
+  ensure(had_err, userdata_nof_items(gn) == 0);
   ensure(had_err, gn->userdata == NULL);
 
   testptr2 = gt_malloc(sizeof (char)*4);
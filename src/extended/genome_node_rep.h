@@ -19,6 +19,7 @@
 #define GENOME_NODE_REP_H
 
 #include <stdio.h>
+#include "core/arena.h"
 #include "core/dlist.h"
 #include "core/hashmap.h"
 #include "extended/genome_node.h"
@@ -40,12 +41,17 @@ struct GtGenomeNode
 {
   const GtGenomeNodeClass *c_class;
   GtStr *filename;
-  GtHashmap *userdata;
+  GtHashmap *userdata; /* created on demand */
+  GtArena *arena; /* the node memory has been allocated from here, if
+                     defined */
   unsigned int line_number,
-               reference_count,
-               userdata_nof_items;
+               reference_count;
 };
 
 GtGenomeNode* gt_genome_node_create(const GtGenomeNodeClass*);
+/* Like <gt_genome_node_create()>, but the node is allocated from <arena> (if
+   defined), which is referenced until the node is deleted. */
+GtGenomeNode* gt_genome_node_create_with_arena(const GtGenomeNodeClass*,
+                                               GtArena *arena);
 
 #endif
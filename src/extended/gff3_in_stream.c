@@ -21,6 +21,7 @@
 #include "core/fileutils_api.h"
 #include "core/progressbar.h"
 #include "core/str_array.h"
+#include "extended/binary_in_stream.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_in_stream.h"
 #include "extended/gff3_parser.h"
@@ -35,8 +36,13 @@ struct GtGFF3InStream {
        stdin_argument,
        file_is_open,
        progress_bar,
-       checkids;
+       checkids,
+       arena_allocation,
+       gff3_only_options; /* type checker, offset or tidy mode set, which
+                             cannot be applied to binary annotation files */
   GtFile *fpin;
+  GtNodeStream *binary_in_stream; /* used instead of <fpin> for files in the
+                                     binary annotation format */
   unsigned long long line_number;
   GtQueue *genome_node_buffer;
   GtGFF3Parser *gff3_parser;
@@ -69,6 +75,30 @@ static int buffer_is_sorted(void **elem, void *info, GtError *err)
   return 0;
 }
 
+/* Read the next genome nodes from the current file into the buffer. Sets
+   <status_code> to EOF if the end of the current file has been reached. */
+static int read_genome_nodes(GtGFF3InStream *is, int *status_code,
+                             GtStr *filenamestr, GtError *err)
+{
+  GtGenomeNode *gn;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(is && status_code);
+  if (is->binary_in_stream) {
+    /* the nodes have been checked and linked already */
+    had_err = gt_node_stream_next(is->binary_in_stream, &gn, err);
+    if (!had_err && gn)
+      gt_queue_add(is->genome_node_buffer, gn);
+    /* same semantic as in the GFF3 parser */
+    *status_code = gt_queue_size(is->genome_node_buffer) ? 0 : EOF;
+    return had_err;
+  }
+  return gt_gff3_parser_parse_genome_nodes(is->gff3_parser, status_code,
+                                           is->genome_node_buffer,
+                                           is->used_types, filenamestr,
+                                           &is->line_number, is->fpin, err);
+}
+
 static int gff3_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
                                GtError *err)
 {
@@ -105,6 +135,22 @@ static int gff3_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
           is->file_is_open = true;
           is->stdin_argument = true;
         }
+        else if (gt_binary_in_stream_file_is_binary(
+                            gt_str_array_get(is->files, is->next_file))) {
+          if (is->gff3_only_options) {
+            gt_error_set(err, "type checking, offsets and tidy mode cannot be "
+                         "applied to binary annotation file \"%s\"",
+                         gt_str_array_get(is->files, is->next_file));
+            had_err = -1;
+            break;
+          }
+          is->binary_in_stream =
+            gt_binary_in_stream_new(gt_str_array_get(is->files, is->next_file),
+                                    is->used_types);
+          if (is->arena_allocation)
+            gt_binary_in_stream_enable_arena_allocation(is->binary_in_stream);
+          is->file_is_open = true;
+        }
         else {
           is->fpin = gt_file_xopen(gt_str_array_get(is->files,
                                                        is->next_file), "r");
@@ -135,28 +181,22 @@ static int gff3_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
                   ? gt_str_array_get_str(is->files, is->next_file-1)
                   : is->stdinstr;
     /* read two nodes */
-    had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser, &status_code,
-                                                is->genome_node_buffer,
-                                                is->used_types, filenamestr,
-                                                &is->line_number, is->fpin,
-                                                err);
+    had_err = read_genome_nodes(is, &status_code, filenamestr, err);
     if (had_err)
       break;
     if (status_code != EOF) {
-      had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser, &status_code,
-                                                  is->genome_node_buffer,
-                                                  is->used_types, filenamestr,
-                                                  &is->line_number, is->fpin,
-                                                  err);
+      had_err = read_genome_nodes(is, &status_code, filenamestr, err);
       if (had_err)
         break;
     }
 
     if (status_code == EOF) {
       /* end of current file */
-      if (is->progress_bar) gt_progressbar_stop();
+      if (is->progress_bar && !is->binary_in_stream) gt_progressbar_stop();
       gt_file_delete(is->fpin);
       is->fpin = NULL;
+      gt_node_stream_delete(is->binary_in_stream);
+      is->binary_in_stream = NULL;
       is->file_is_open = false;
       gt_gff3_parser_reset(is->gff3_parser);
       if (!gt_str_array_size(is->files))
@@ -196,6 +236,7 @@ static void gff3_in_stream_free(GtNodeStream *ns)
   gt_gff3_parser_delete(gff3_in_stream->gff3_parser);
   gt_cstr_table_delete(gff3_in_stream->used_types);
   gt_file_delete(gff3_in_stream->fpin);
+  gt_node_stream_delete(gff3_in_stream->binary_in_stream);
 }
 
 const GtNodeStreamClass* gt_gff3_in_stream_class(void)
@@ -223,12 +264,15 @@ static GtNodeStream* gff3_in_stream_new(GtStrArray *files,
   gff3_in_stream->stdin_argument     = false;
   gff3_in_stream->file_is_open       = false;
   gff3_in_stream->fpin               = NULL;
+  gff3_in_stream->binary_in_stream   = NULL;
+  gff3_in_stream->gff3_only_options  = false;
   gff3_in_stream->line_number        = 0;
   gff3_in_stream->genome_node_buffer = gt_queue_new();
   gff3_in_stream->checkids           = false;
   gff3_in_stream->gff3_parser        = gt_gff3_parser_new(NULL);
   gff3_in_stream->used_types         = gt_cstr_table_new();
   gff3_in_stream->progress_bar       = false;
+  gff3_in_stream->arena_allocation   = false;
   return ns;
 }
 
@@ -250,10 +294,13 @@ void gt_gff3_in_stream_set_type_checker(GtNodeStream *ns,
 {
   GtGFF3InStream *is = gff3_in_stream_cast(ns);
   gt_assert(is);
+  is->gff3_only_options = true;
   gt_gff3_parser_delete(is->gff3_parser);
   is->gff3_parser = gt_gff3_parser_new(type_checker);
   if (is->checkids)
     gt_gff3_parser_check_id_attributes(is->gff3_parser);
+  if (is->arena_allocation)
+    gt_gff3_parser_enable_arena_allocation(is->gff3_parser);
 }
 
 GtStrArray* gt_gff3_in_stream_get_used_types(GtNodeStream *ns)
@@ -267,6 +314,7 @@ void gt_gff3_in_stream_set_offset(GtNodeStream *ns, long offset)
 {
   GtGFF3InStream *is = gff3_in_stream_cast(ns);
   gt_assert(is);
+  is->gff3_only_options = true;
   gt_gff3_parser_set_offset(is->gff3_parser, offset);
 }
 
@@ -275,6 +323,7 @@ int gt_gff3_in_stream_set_offsetfile(GtNodeStream *ns, GtStr *offsetfile,
 {
   GtGFF3InStream *is = gff3_in_stream_cast(ns);
   gt_assert(is);
+  is->gff3_only_options = true;
   return gt_gff3_parser_set_offsetfile(is->gff3_parser, offsetfile, err);
 }
 
@@ -282,9 +331,18 @@ void gt_gff3_in_stream_enable_tidy_mode(GtNodeStream *ns)
 {
   GtGFF3InStream *is = gff3_in_stream_cast(ns);
   gt_assert(is);
+  is->gff3_only_options = true;
   gt_gff3_parser_enable_tidy_mode(is->gff3_parser);
 }
 
+void gt_gff3_in_stream_enable_arena_allocation(GtNodeStream *ns)
+{
+  GtGFF3InStream *is = gff3_in_stream_cast(ns);
+  gt_assert(is);
+  is->arena_allocation = true;
+  gt_gff3_parser_enable_arena_allocation(is->gff3_parser);
+}
+
 GtNodeStream* gt_gff3_in_stream_new_unsorted(int num_of_files,
                                              const char **filenames)
 {
@@ -24,6 +24,8 @@
 #include "extended/type_checker.h"
 
 const GtNodeStreamClass* gt_gff3_in_stream_class(void);
+/* The type checker, the offsets and the tidy mode apply to GFF3 files only,
+   reading a binary annotation file with one of them set is an error. */
 void                     gt_gff3_in_stream_set_type_checker(GtNodeStream*,
                                                             GtTypeChecker
                                                             *type_checker);
@@ -36,5 +38,10 @@ void                     gt_gff3_in_stream_set_offset(GtNodeStream*, long);
 int                      gt_gff3_in_stream_set_offsetfile(GtNodeStream*, GtStr*,
                                                           GtError*);
 void                     gt_gff3_in_stream_enable_tidy_mode(GtNodeStream*);
+/* Allocate the parsed feature trees from arenas, which reduces the allocation
+   overhead considerably. Best suited for pipelines which do not keep single
+   nodes of a tree alive much longer than the rest of it. */
+void                     gt_gff3_in_stream_enable_arena_allocation(GtNodeStream
+                                                                   *);
 
 #endif
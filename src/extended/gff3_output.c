@@ -15,11 +15,19 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "core/assert_api.h"
+#include "core/ensure.h"
 #include "core/undef.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_output.h"
 
+static const unsigned long decimal_powers[] = { 1UL, 10UL, 100UL, 1000UL,
+                                                10000UL, 100000UL, 1000000UL };
+
 void gt_gff3_output_leading(GtFeatureNode *gf, GtFile *outfp)
 {
   GtGenomeNode *gn;
@@ -39,3 +47,115 @@ void gt_gff3_output_leading(GtFeatureNode *gf, GtFile *outfp)
                      GT_STRAND_CHARS[gt_feature_node_get_strand(gf)],
                      GT_PHASE_CHARS[gt_feature_node_get_phase(gf)]);
 }
+
+/* Append <score> to <outstr> formatted like "%.3g" would do it. The common
+   range of scores is formatted by hand and the remaining ones by snprintf(). */
+static void append_score(GtStr *outstr, float score)
+{
+  double value = score, scaled;
+  unsigned long digits, integral, fraction;
+  int exponent, decimals;
+  char buf[32];
+  if (signbit(value)) {
+    gt_str_append_char(outstr, '-');
+    value = -value;
+  }
+  if (value >= 0.0001 && value < 1000) {
+    /* determine the decimal exponent of <value>, the products below are exact
+       because a float has only 24 significant bits and 10^6 < 2^20 */
+    for (exponent = 2; value * 10000 < decimal_powers[exponent + 4];
+         exponent--);
+    /* scale <value> to three integral digits */
+    decimals = 2 - exponent;
+    scaled = value * decimal_powers[decimals];
+    digits = (unsigned long) scaled;
+    /* round half to even, like printf(3) */
+    if (scaled - digits > 0.5 || (scaled - digits == 0.5 && (digits & 1)))
+      digits++;
+    if (digits == 1000) {
+      /* rounding produced another digit */
+      digits = 100;
+      decimals--;
+    }
+    if (decimals >= 0) {
+      integral = digits / decimal_powers[decimals];
+      fraction = digits % decimal_powers[decimals];
+      gt_str_append_ulong(outstr, integral);
+      if (fraction) {
+        /* remove trailing zeros */
+        while (!(fraction % 10)) {
+          fraction /= 10;
+          decimals--;
+        }
+        gt_str_append_char(outstr, '.');
+        while (--decimals && fraction < decimal_powers[decimals])
+          gt_str_append_char(outstr, '0');
+        gt_str_append_ulong(outstr, fraction);
+      }
+      return;
+    }
+  }
+  (void) snprintf(buf, sizeof buf, "%.3g", value);
+  gt_str_append_cstr(outstr, buf);
+}
+
+void gt_gff3_output_leading_str(GtFeatureNode *gf, GtStr *outstr)
+{
+  GtGenomeNode *gn;
+  gt_assert(gf && outstr);
+  gn = (GtGenomeNode*) gf;
+  gt_str_append_str(outstr, gt_genome_node_get_seqid(gn));
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_cstr(outstr, gt_feature_node_get_source(gf));
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_cstr(outstr, gt_feature_node_get_type(gf));
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_ulong(outstr, gt_genome_node_get_start(gn));
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_ulong(outstr, gt_genome_node_get_end(gn));
+  gt_str_append_char(outstr, '\t');
+  if (gt_feature_node_score_is_defined(gf))
+    append_score(outstr, gt_feature_node_get_score(gf));
+  else
+    gt_str_append_char(outstr, '.');
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_char(outstr, GT_STRAND_CHARS[gt_feature_node_get_strand(gf)]);
+  gt_str_append_char(outstr, '\t');
+  gt_str_append_char(outstr, GT_PHASE_CHARS[gt_feature_node_get_phase(gf)]);
+  gt_str_append_char(outstr, '\t');
+}
+
+static int check_score(float score, GtStr *outstr, GtError *err)
+{
+  char buf[32];
+  int had_err = 0;
+  gt_error_check(err);
+  gt_str_reset(outstr);
+  append_score(outstr, score);
+  (void) snprintf(buf, sizeof buf, "%.3g", score);
+  ensure(had_err, !strcmp(gt_str_get(outstr), buf));
+  return had_err;
+}
+
+int gt_gff3_output_unit_test(GtError *err)
+{
+  static const float scores[] = { 0, 1, -1, 0.5, 0.25, 0.125, 0.0625, 1e-4,
+                                  1.5e-4, 9.995e-4, 0.001, 0.987, 0.9995,
+                                  0.99951, 9.995, 99.95, 99.96, 999.4, 999.5,
+                                  999.6, 1000, 123456, 1e-5, -0.75, 2.5,
+                                  3.5, 12.5, 0.0125 };
+  GtStr *outstr;
+  unsigned long i;
+  int had_err = 0;
+  gt_error_check(err);
+  outstr = gt_str_new();
+  for (i = 0; !had_err && i < sizeof scores / sizeof scores[0]; i++)
+    had_err = check_score(scores[i], outstr, err);
+  /* compare random scores of different magnitudes */
+  for (i = 0; !had_err && i < 100000; i++) {
+    had_err = check_score((float) rand() / RAND_MAX *
+                          decimal_powers[rand() % 7] / 1000, outstr, err);
+  }
+  gt_str_delete(outstr);
+  return had_err;
+}
@@ -23,5 +23,9 @@
 /* output the leading part of a genome feature in GFF3 format (i.e., the part
    up to the attributes) */
 void gt_gff3_output_leading(GtFeatureNode*, GtFile*);
+/* append the leading part of a genome feature in GFF3 format to <outstr>,
+   without going through a formatted output function for every field */
+void gt_gff3_output_leading_str(GtFeatureNode*, GtStr *outstr);
+int  gt_gff3_output_unit_test(GtError*);
 
 #endif
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "core/arena.h"
 #include "core/array.h"
 #include "core/assert_api.h"
 #include "core/cstr.h"
@@ -39,6 +40,9 @@
 #include "extended/mapping.h"
 #include "extended/region_node.h"
 
+/* the number of bytes after which a new arena is started */
+#define GFF3_PARSER_ARENA_CHUNK_SIZE  (1UL << 20)
+
 struct GtGFF3Parser {
   GtFeatureInfo *feature_info;
   GtHashmap *seqid_to_ssr_mapping, /* maps seqids to simple sequence regions */
@@ -53,6 +57,11 @@ struct GtGFF3Parser {
   GtMapping *offset_mapping;
   GtTypeChecker *type_checker;
   unsigned int last_terminator; /* line number of the last terminator */
+  GtSplitter *splitter, /* reused for every line to save allocations */
+             *attribute_splitter,
+             *tmp_splitter;
+  bool arena_allocation;
+  GtArena *arena; /* the arena feature nodes are currently allocated from */
 };
 
 typedef struct {
@@ -126,6 +135,11 @@ GtGFF3Parser* gt_gff3_parser_new(GtTypeChecker *type_checker)
   parser->type_checker = type_checker ? gt_type_checker_ref(type_checker)
                                       : NULL;
   parser->last_terminator = 0;
+  parser->splitter = gt_splitter_new();
+  parser->attribute_splitter = gt_splitter_new();
+  parser->tmp_splitter = gt_splitter_new();
+  parser->arena_allocation = false;
+  parser->arena = NULL;
   return parser;
 }
 
@@ -161,6 +175,30 @@ void gt_gff3_parser_enable_tidy_mode(GtGFF3Parser *parser)
   parser->tidy = true;
 }
 
+void gt_gff3_parser_enable_arena_allocation(GtGFF3Parser *parser)
+{
+  gt_assert(parser);
+  parser->arena_allocation = true;
+}
+
+/* Returns the arena new feature nodes should be allocated from (or <NULL>).
+   Every GFF3_PARSER_ARENA_CHUNK_SIZE bytes a new arena is started, the old one
+   is released as soon as all nodes allocated from it have been deleted. */
+static GtArena* get_arena(GtGFF3Parser *parser)
+{
+  gt_assert(parser);
+  if (!parser->arena_allocation)
+    return NULL;
+  if (parser->arena &&
+      gt_arena_size(parser->arena) >= GFF3_PARSER_ARENA_CHUNK_SIZE) {
+    gt_arena_delete(parser->arena);
+    parser->arena = NULL;
+  }
+  if (!parser->arena)
+    parser->arena = gt_arena_new(0);
+  return parser->arena;
+}
+
 static int add_offset_if_necessary(GtRange *range, GtGFF3Parser *parser,
                                    const char *seqid, GtError *err)
 {
@@ -884,16 +922,16 @@ static int parse_attributes(char *attributes, GtGenomeNode *feature_node,
                             const char *filename, unsigned int line_number,
                             GtError *err)
 {
-  GtSplitter *attribute_splitter, *tmp_splitter, *parent_splitter;
+  GtSplitter *attribute_splitter, *tmp_splitter;
   unsigned long i;
   int had_err = 0;
 
   gt_error_check(err);
   gt_assert(attributes);
 
-  attribute_splitter = gt_splitter_new();
-  tmp_splitter = gt_splitter_new();
-  parent_splitter = gt_splitter_new();
+  attribute_splitter = parser->attribute_splitter;
+  tmp_splitter = parser->tmp_splitter;
+  gt_splitter_reset(attribute_splitter);
   gt_splitter_split(attribute_splitter, attributes, strlen(attributes), ';');
 
   for (i = 0; !had_err && i < gt_splitter_size(attribute_splitter); i++) {
@@ -1023,10 +1061,6 @@ static int parse_attributes(char *attributes, GtGenomeNode *feature_node,
                                                 line_number, err);
   }
 
-  gt_splitter_delete(parent_splitter);
-  gt_splitter_delete(tmp_splitter);
-  gt_splitter_delete(attribute_splitter);
-
   return had_err;
 }
 
@@ -1069,8 +1103,9 @@ static int parse_regular_gff3_line(GtGFF3Parser *parser,
 
   filename = gt_str_get(filenamestr);
 
-  /* create splitter */
-  splitter = gt_splitter_new();
+  /* reset splitter */
+  splitter = parser->splitter;
+  gt_splitter_reset(splitter);
 
   /* parse */
   gt_splitter_split(splitter, line, line_length, '\t');
@@ -1145,8 +1180,9 @@ static int parse_regular_gff3_line(GtGFF3Parser *parser,
 
   /* create the feature */
   if (!had_err) {
-    feature_node = gt_feature_node_new(seqid_str, type, range.start, range.end,
-                                       gt_strand_value);
+    feature_node = gt_feature_node_new_with_arena(seqid_str, type, range.start,
+                                                  range.end, gt_strand_value,
+                                                  get_arena(parser));
     gt_genome_node_set_origin(feature_node, filenamestr, line_number);
   }
 
@@ -1181,7 +1217,6 @@ static int parse_regular_gff3_line(GtGFF3Parser *parser,
 
   /* free */
   gt_str_delete(seqid_str);
-  gt_splitter_delete(splitter);
 
   return had_err;
 }
@@ -1532,5 +1567,9 @@ void gt_gff3_parser_delete(GtGFF3Parser *parser)
   gt_hashmap_delete(parser->undefined_sequence_regions);
   gt_mapping_delete(parser->offset_mapping);
   gt_type_checker_delete(parser->type_checker);
+  gt_splitter_delete(parser->splitter);
+  gt_splitter_delete(parser->attribute_splitter);
+  gt_splitter_delete(parser->tmp_splitter);
+  gt_arena_delete(parser->arena);
   gt_free(parser);
 }
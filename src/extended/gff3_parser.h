@@ -41,6 +41,9 @@ void          gt_gff3_parser_check_id_attributes(GtGFF3Parser*);
 void          gt_gff3_parser_set_offset(GtGFF3Parser*, long);
 int           gt_gff3_parser_set_offsetfile(GtGFF3Parser*, GtStr*, GtError*);
 void          gt_gff3_parser_enable_tidy_mode(GtGFF3Parser*);
+/* Allocate the parsed feature nodes (and their lists of children) in chunks
+   from arenas instead of one by one from the heap. */
+void          gt_gff3_parser_enable_arena_allocation(GtGFF3Parser*);
 int           gt_gff3_parser_parse_target_attributes(const char *values,
                                                      unsigned long
                                                      *num_of_targets,
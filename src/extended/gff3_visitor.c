@@ -33,6 +33,9 @@
 #include "extended/gff3_visitor.h"
 #include "extended/node_visitor_rep.h"
 
+/* size of the blocks in which output to a file is written */
+#define GFF3_VISITOR_BLOCK_SIZE (1UL << 20)
+
 struct GtGFF3Visitor {
   const GtNodeVisitor parent_instance;
   bool version_string_shown,
@@ -41,19 +44,26 @@ struct GtGFF3Visitor {
   GtStringDistri *id_counter;
   GtHashmap *feature_node_to_id_array,
             *feature_node_to_unique_id_str;
-  unsigned long fasta_width;
+  /* the ID strings and parent arrays are reused for every tree, the first
+     <nof_used_*> entries are in use for the current one */
+  GtArray *id_strs,
+          *parent_arrays;
+  unsigned long nof_used_id_strs,
+                nof_used_parent_arrays,
+                fasta_width;
+  GtStr *outstr; /* the nodes are formatted into this buffer */
   GtFile *outfp;
   GtCstrTable *used_ids;
 };
 
 typedef struct {
-  GtHashmap *gt_feature_node_to_id_array;
+  GtGFF3Visitor *gff3_visitor;
   const char *id;
 } AddIDInfo;
 
 typedef struct {
   bool *attribute_shown;
-  GtFile *outfp;
+  GtStr *outstr;
 } ShowAttributeInfo;
 
 #define gff3_visitor_cast(GV)\
@@ -64,19 +74,81 @@ static void gff3_version_string(GtNodeVisitor *gv)
   GtGFF3Visitor *gff3_visitor = gff3_visitor_cast(gv);
   gt_assert(gff3_visitor);
   if (!gff3_visitor->version_string_shown) {
-    gt_file_xprintf(gff3_visitor->outfp, "%s   %u\n", GFF_VERSION_PREFIX,
-                       GFF_VERSION);
+    gt_str_append_cstr(gff3_visitor->outstr, GFF_VERSION_PREFIX);
+    gt_str_append_cstr(gff3_visitor->outstr, "   ");
+    gt_str_append_uint(gff3_visitor->outstr, GFF_VERSION);
+    gt_str_append_char(gff3_visitor->outstr, '\n');
     gff3_visitor->version_string_shown = true;
   }
 }
 
+/* Writes the formatted output. Output to a file is collected until a block of
+   GFF3_VISITOR_BLOCK_SIZE bytes is full (or <force> is set), output to stdout
+   is written per node, because other code may write to stdout as well. */
+static void flush_output(GtGFF3Visitor *gff3_visitor, bool force)
+{
+  gt_assert(gff3_visitor);
+  if (gt_str_length(gff3_visitor->outstr) &&
+      (force || !gff3_visitor->outfp ||
+       gt_str_length(gff3_visitor->outstr) >= GFF3_VISITOR_BLOCK_SIZE)) {
+    gt_file_xwrite(gff3_visitor->outfp, gt_str_get_mem(gff3_visitor->outstr),
+                   gt_str_length(gff3_visitor->outstr));
+    gt_str_reset(gff3_visitor->outstr);
+  }
+}
+
+static GtStr* get_id_str(GtGFF3Visitor *gff3_visitor)
+{
+  GtStr *id;
+  gt_assert(gff3_visitor);
+  if (gff3_visitor->nof_used_id_strs < gt_array_size(gff3_visitor->id_strs)) {
+    id = *(GtStr**) gt_array_get(gff3_visitor->id_strs,
+                                 gff3_visitor->nof_used_id_strs);
+    gt_str_reset(id);
+  }
+  else {
+    id = gt_str_new();
+    gt_array_add(gff3_visitor->id_strs, id);
+  }
+  gff3_visitor->nof_used_id_strs++;
+  return id;
+}
+
+static GtArray* get_parent_array(GtGFF3Visitor *gff3_visitor)
+{
+  GtArray *parent_features;
+  gt_assert(gff3_visitor);
+  if (gff3_visitor->nof_used_parent_arrays <
+      gt_array_size(gff3_visitor->parent_arrays)) {
+    parent_features = *(GtArray**)
+                      gt_array_get(gff3_visitor->parent_arrays,
+                                   gff3_visitor->nof_used_parent_arrays);
+    gt_array_reset(parent_features);
+  }
+  else {
+    parent_features = gt_array_new(sizeof (char*));
+    gt_array_add(gff3_visitor->parent_arrays, parent_features);
+  }
+  gff3_visitor->nof_used_parent_arrays++;
+  return parent_features;
+}
+
 static void gff3_visitor_free(GtNodeVisitor *gv)
 {
   GtGFF3Visitor *gff3_visitor = gff3_visitor_cast(gv);
+  unsigned long i;
   gt_assert(gff3_visitor);
+  flush_output(gff3_visitor, true);
   gt_string_distri_delete(gff3_visitor->id_counter);
   gt_hashmap_delete(gff3_visitor->feature_node_to_id_array);
   gt_hashmap_delete(gff3_visitor->feature_node_to_unique_id_str);
+  for (i = 0; i < gt_array_size(gff3_visitor->id_strs); i++)
+    gt_str_delete(*(GtStr**) gt_array_get(gff3_visitor->id_strs, i));
+  gt_array_delete(gff3_visitor->id_strs);
+  for (i = 0; i < gt_array_size(gff3_visitor->parent_arrays); i++)
+    gt_array_delete(*(GtArray**) gt_array_get(gff3_visitor->parent_arrays, i));
+  gt_array_delete(gff3_visitor->parent_arrays);
+  gt_str_delete(gff3_visitor->outstr);
   gt_cstr_table_delete(gff3_visitor->used_ids);
 }
 
@@ -88,8 +160,10 @@ static int gff3_visitor_comment_node(GtNodeVisitor *gv, GtCommentNode *cn,
   gff3_visitor = gff3_visitor_cast(gv);
   gt_assert(gv && cn);
   gff3_version_string(gv);
-  gt_file_xprintf(gff3_visitor->outfp, "#%s\n",
-                     gt_comment_node_get_comment(cn));
+  gt_str_append_char(gff3_visitor->outstr, '#');
+  gt_str_append_cstr(gff3_visitor->outstr, gt_comment_node_get_comment(cn));
+  gt_str_append_char(gff3_visitor->outstr, '\n');
+  flush_output(gff3_visitor, false);
   return 0;
 }
 
@@ -98,11 +172,13 @@ static int add_id(GtGenomeNode *gn, void *data, GT_UNUSED GtError *err)
   AddIDInfo *info = (AddIDInfo*) data;
   GtArray *parent_features = NULL;
   gt_error_check(err);
-  gt_assert(gn && info && info->gt_feature_node_to_id_array && info->id);
-  parent_features = gt_hashmap_get(info->gt_feature_node_to_id_array, gn);
+  gt_assert(gn && info && info->gff3_visitor && info->id);
+  parent_features =
+    gt_hashmap_get(info->gff3_visitor->feature_node_to_id_array, gn);
   if (!parent_features) {
-    parent_features = gt_array_new(sizeof (char*));
-    gt_hashmap_add(info->gt_feature_node_to_id_array, gn, parent_features);
+    parent_features = get_parent_array(info->gff3_visitor);
+    gt_hashmap_add(info->gff3_visitor->feature_node_to_id_array, gn,
+                   parent_features);
   }
   gt_array_add(parent_features, info->id);
   return 0;
@@ -115,10 +191,12 @@ static void show_attribute(const char *attr_name, const char *attr_value,
   gt_assert(attr_name && attr_value && info);
   if (strcmp(attr_name, ID_STRING) && strcmp(attr_name, PARENT_STRING)) {
     if (*info->attribute_shown)
-      gt_file_xfputc(';', info->outfp);
+      gt_str_append_char(info->outstr, ';');
     else
       *info->attribute_shown = true;
-    gt_file_xprintf(info->outfp, "%s=%s", attr_name, attr_value);
+    gt_str_append_cstr(info->outstr, attr_name);
+    gt_str_append_char(info->outstr, '=');
+    gt_str_append_cstr(info->outstr, attr_value);
   }
 }
 
@@ -130,18 +208,21 @@ static int gff3_show_feature_node(GtGenomeNode *gn, void *data,
   GtFeatureNode *fn = (GtFeatureNode*) gn;
   GtArray *parent_features = NULL;
   ShowAttributeInfo info;
+  GtStr *outstr;
   unsigned long i;
   GtStr *id;
 
   gt_error_check(err);
   gt_assert(gn && fn && gff3_visitor);
+  outstr = gff3_visitor->outstr;
 
   /* output leading part */
-  gt_gff3_output_leading(fn, gff3_visitor->outfp);
+  gt_gff3_output_leading_str(fn, outstr);
 
   /* show unique id part of attributes */
   if ((id = gt_hashmap_get(gff3_visitor->feature_node_to_unique_id_str, gn))) {
-    gt_file_xprintf(gff3_visitor->outfp, "%s=%s", ID_STRING, gt_str_get(id));
+    gt_str_append_cstr(outstr, ID_STRING "=");
+    gt_str_append_str(outstr, id);
     part_shown = true;
   }
 
@@ -149,28 +230,27 @@ static int gff3_show_feature_node(GtGenomeNode *gn, void *data,
   parent_features = gt_hashmap_get(gff3_visitor->feature_node_to_id_array, gn);
   if (gt_array_size(parent_features)) {
     if (part_shown)
-      gt_file_xfputc(';', gff3_visitor->outfp);
-    gt_file_xprintf(gff3_visitor->outfp, "%s=", PARENT_STRING);
+      gt_str_append_char(outstr, ';');
+    gt_str_append_cstr(outstr, PARENT_STRING "=");
     for (i = 0; i < gt_array_size(parent_features); i++) {
       if (i)
-        gt_file_xfputc(',', gff3_visitor->outfp);
-      gt_file_xprintf(gff3_visitor->outfp, "%s",
-                         *(char**) gt_array_get(parent_features, i));
+        gt_str_append_char(outstr, ',');
+      gt_str_append_cstr(outstr, *(char**) gt_array_get(parent_features, i));
     }
     part_shown = true;
   }
 
   /* show missing part of attributes */
   info.attribute_shown = &part_shown;
-  info.outfp = gff3_visitor->outfp;
+  info.outstr = outstr;
   gt_feature_node_foreach_attribute(fn, show_attribute, &info);
 
   /* show dot if no attributes have been shown */
   if (!part_shown)
-    gt_file_xfputc('.', gff3_visitor->outfp);
+    gt_str_append_char(outstr, '.');
 
   /* show terminal newline */
-  gt_file_xfputc('\n', gff3_visitor->outfp);
+  gt_str_append_char(outstr, '\n');
 
   return 0;
 }
@@ -186,7 +266,8 @@ static GtStr* create_unique_id(GtGFF3Visitor *gff3_visitor, GtFeatureNode *fn)
   gt_string_distri_add(gff3_visitor->id_counter, type);
 
   /* build id string */
-  id = gt_str_new_cstr(type);
+  id = get_id_str(gff3_visitor);
+  gt_str_append_cstr(id, type);
   gt_str_append_ulong(id, gt_string_distri_get(gff3_visitor->id_counter, type));
 
   /* store (unique) id */
@@ -213,7 +294,8 @@ static bool id_string_is_unique(GtStr *id, GtStr *buf, GtCstrTable *tab,
 static GtStr* make_id_unique(GtGFF3Visitor *gff3_visitor, GtFeatureNode *fn)
 {
   unsigned long i = 1;
-  GtStr *id = gt_str_new_cstr(gt_feature_node_get_attribute(fn, "ID"));
+  GtStr *id = get_id_str(gff3_visitor);
+  gt_str_append_cstr(id, gt_feature_node_get_attribute(fn, "ID"));
 
   if (gt_cstr_table_get(gff3_visitor->used_ids, gt_str_get(id))) {
     GtStr *buf = gt_str_new();
@@ -256,8 +338,7 @@ static int store_ids(GtGenomeNode *gn, void *data, GtError *err)
         }
       }
       if (gt_feature_node_get_multi_representative(fn) != fn) {
-        gt_hashmap_add(gff3_visitor->feature_node_to_unique_id_str, fn,
-                       gt_str_ref(id));
+        gt_hashmap_add(gff3_visitor->feature_node_to_unique_id_str, fn, id);
       }
     }
     else {
@@ -267,8 +348,7 @@ static int store_ids(GtGenomeNode *gn, void *data, GtError *err)
         id = create_unique_id(gff3_visitor, fn);
     }
     /* for each child -> store the parent feature in the hash map */
-    add_id_info.gt_feature_node_to_id_array =
-      gff3_visitor->feature_node_to_id_array,
+    add_id_info.gff3_visitor = gff3_visitor;
     add_id_info.id = gt_str_get(id);
     had_err = gt_genome_node_traverse_direct_children(gn, &add_id_info, add_id,
                                                       err);
@@ -305,16 +385,19 @@ static int gff3_visitor_feature_node(GtNodeVisitor *gv, GtFeatureNode *fn,
     }
   }
 
-  /* reset hashmaps */
+  /* reset hashmaps, the strings and arrays are kept for the next tree */
   gt_hashmap_reset(gff3_visitor->feature_node_to_id_array);
   gt_hashmap_reset(gff3_visitor->feature_node_to_unique_id_str);
+  gff3_visitor->nof_used_id_strs = 0;
+  gff3_visitor->nof_used_parent_arrays = 0;
 
   /* show terminator, if the feature has children (otherwise it is clear that
      the feature is complete, because no ID attribute has been shown) */
   if (gt_genome_node_has_children((GtGenomeNode*) fn) ||
       (gff3_visitor->retain_ids && gt_feature_node_get_attribute(fn, "ID"))) {
-    gt_file_xprintf(gff3_visitor->outfp, "%s\n", GFF_TERMINATOR);
+    gt_str_append_cstr(gff3_visitor->outstr, GFF_TERMINATOR "\n");
   }
+  flush_output(gff3_visitor, false);
 
   return had_err;
 }
@@ -327,11 +410,17 @@ static int gff3_visitor_region_node(GtNodeVisitor *gv, GtRegionNode *rn,
   gff3_visitor = gff3_visitor_cast(gv);
   gt_assert(gv && rn);
   gff3_version_string(gv);
-  gt_file_xprintf(gff3_visitor->outfp, "%s   %s %lu %lu\n",
-                     GFF_SEQUENCE_REGION,
-                     gt_str_get(gt_genome_node_get_seqid((GtGenomeNode*) rn)),
-                     gt_genome_node_get_start((GtGenomeNode*) rn),
-                     gt_genome_node_get_end((GtGenomeNode*) rn));
+  gt_str_append_cstr(gff3_visitor->outstr, GFF_SEQUENCE_REGION "   ");
+  gt_str_append_str(gff3_visitor->outstr,
+                    gt_genome_node_get_seqid((GtGenomeNode*) rn));
+  gt_str_append_char(gff3_visitor->outstr, ' ');
+  gt_str_append_ulong(gff3_visitor->outstr,
+                      gt_genome_node_get_start((GtGenomeNode*) rn));
+  gt_str_append_char(gff3_visitor->outstr, ' ');
+  gt_str_append_ulong(gff3_visitor->outstr,
+                      gt_genome_node_get_end((GtGenomeNode*) rn));
+  gt_str_append_char(gff3_visitor->outstr, '\n');
+  flush_output(gff3_visitor, false);
   return 0;
 }
 
@@ -342,6 +431,8 @@ static int gff3_visitor_sequence_node(GtNodeVisitor *gv, GtSequenceNode *sn,
   gt_error_check(err);
   gff3_visitor = gff3_visitor_cast(gv);
   gt_assert(gv && sn);
+  /* the sequence is written directly */
+  flush_output(gff3_visitor, true);
   if (!gff3_visitor->fasta_directive_shown) {
     gt_file_xprintf(gff3_visitor->outfp, "%s\n", GFF_FASTA_DIRECTIVE);
     gff3_visitor->fasta_directive_shown = true;
@@ -375,9 +466,14 @@ GtNodeVisitor* gt_gff3_visitor_new(GtFile *outfp)
   gff3_visitor->fasta_directive_shown = false;
   gff3_visitor->id_counter = gt_string_distri_new();
   gff3_visitor->feature_node_to_id_array =
-    gt_hashmap_new(HASH_DIRECT, NULL, (GtFree) gt_array_delete);
+    gt_hashmap_new(HASH_DIRECT, NULL, NULL);
   gff3_visitor->feature_node_to_unique_id_str =
-    gt_hashmap_new(HASH_DIRECT, NULL, (GtFree) gt_str_delete);
+    gt_hashmap_new(HASH_DIRECT, NULL, NULL);
+  gff3_visitor->id_strs = gt_array_new(sizeof (GtStr*));
+  gff3_visitor->parent_arrays = gt_array_new(sizeof (GtArray*));
+  gff3_visitor->nof_used_id_strs = 0;
+  gff3_visitor->nof_used_parent_arrays = 0;
+  gff3_visitor->outstr = gt_str_new();
   gff3_visitor->fasta_width = 0;
   gff3_visitor->outfp = outfp;
   gff3_visitor->used_ids = gt_cstr_table_new();
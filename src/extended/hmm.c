@@ -27,6 +27,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "core/array2dim_api.h"
 #include "core/assert_api.h"
 #include "core/ensure.h"
@@ -293,127 +296,286 @@ void gt_hmm_init_random(GtHMM *hmm)
   gt_assert(gt_hmm_is_valid(hmm));
 }
 
-/* [DEKM98, p. 56] */
-void gt_hmm_decode(const GtHMM *hmm,
-                unsigned int *state_sequence,
-                const unsigned int *emissions,
-                unsigned int num_of_emissions)
+/* number of doubles processed at once by the Viterbi kernel */
+#ifdef __SSE2__
+#define GT_HMM_LANES 2
+#else
+#define GT_HMM_LANES 1
+#endif
+
+struct GtHMMCompiled {
+  unsigned int num_of_states,
+               num_of_symbols,
+               stride;              /* num_of_states rounded up to lanes */
+  double *initial_state_prob,       /* log values */
+         *transition_prob,          /* [from * stride + to], log values */
+         *emission_prob;            /* [symbol * stride + state], log values */
+};
+
+GtHMMCompiled* gt_hmm_compiled_new(const GtHMM *hmm)
 {
-  double **max_probabilities, tmp_prob;
-  unsigned int **backtrace, colidx, precolidx;
-  int row, column, num_of_rows, num_of_columns, previous_row;
+  GtHMMCompiled *chmm;
+  unsigned int i, j, stride;
 
   gt_assert(hmm);
   gt_assert(gt_hmm_is_valid(hmm));
-  gt_assert(num_of_emissions);
 
-  /* alloc tables */
-  num_of_rows = hmm->num_of_states;
-  num_of_columns = num_of_emissions;
-  gt_array2dim_malloc(max_probabilities, num_of_rows, 2);
-  gt_array2dim_malloc(backtrace, num_of_rows, num_of_columns);
-
-  /* fill DP table */
-  for (row = 0; row < num_of_rows; row++) { /* first column */
-    gt_assert(emissions[0] < hmm->num_of_symbols);
-    max_probabilities[row][0] = hmm->initial_state_prob[row] +
-                                hmm->emission_prob[row][emissions[0]];
-    backtrace[row][0] = row;
+  chmm = gt_malloc(sizeof *chmm);
+  chmm->num_of_states = hmm->num_of_states;
+  chmm->num_of_symbols = hmm->num_of_symbols;
+  stride = (hmm->num_of_states + GT_HMM_LANES - 1) / GT_HMM_LANES
+           * GT_HMM_LANES;
+  chmm->stride = stride;
+  chmm->initial_state_prob = gt_malloc(sizeof (double) * stride);
+  chmm->transition_prob = gt_malloc(sizeof (double) * stride * stride);
+  chmm->emission_prob = gt_malloc(sizeof (double) * hmm->num_of_symbols
+                                  * stride);
+
+  /* the padding states cannot be reached and are never a predecessor */
+  for (i = 0; i < stride; i++) {
+    chmm->initial_state_prob[i] = i < hmm->num_of_states
+                                  ? hmm->initial_state_prob[i]
+                                  : MINUSINFINITY;
+    for (j = 0; j < stride; j++) {
+      chmm->transition_prob[i * stride + j] = i < hmm->num_of_states &&
+                                              j < hmm->num_of_states
+                                              ? hmm->transition_prob[i][j]
+                                              : MINUSINFINITY;
+    }
+  }
+  for (i = 0; i < hmm->num_of_symbols; i++) {
+    for (j = 0; j < stride; j++) {
+      chmm->emission_prob[i * stride + j] = j < hmm->num_of_states
+                                            ? hmm->emission_prob[j][i]
+                                            : MINUSINFINITY;
+    }
   }
+  return chmm;
+}
 
-  for (column = 1; column < num_of_columns; column++) { /* other columns */
-    gt_assert(emissions[column] < hmm->num_of_symbols);
-    colidx = column & 1;
-    precolidx = (column - 1) & 1;
-    for (row = 0; row < num_of_rows; row++) {
-      max_probabilities[row][colidx] = max_probabilities[0][precolidx] +
-                                     hmm->transition_prob[0][row] +
-                                     hmm->emission_prob[row][emissions[column]];
-      backtrace[row][column] = 0;
-      for (previous_row = 1; previous_row < num_of_rows; previous_row++) {
-        tmp_prob = max_probabilities[previous_row][precolidx] +
-                   hmm->transition_prob[previous_row][row] +
-                   hmm->emission_prob[row][emissions[column]];
-        if (tmp_prob > max_probabilities[row][colidx]) {
-          max_probabilities[row][colidx] = tmp_prob;
-          backtrace[row][column] = previous_row;
-        }
+/* Fills column <column> of the Viterbi table from the previous column
+   <previous>. For every state the predecessor with the maximal probability is
+   stored in <backtrace>, the first one on ties. The sums are computed in the
+   same order as in the scalar case, so the results do not depend on the
+   kernel. */
+static void viterbi_column(const GtHMMCompiled *chmm, double *column,
+                           unsigned int *backtrace, const double *previous,
+                           unsigned int symbol)
+{
+  const double *emission = chmm->emission_prob + symbol * chmm->stride,
+               *transition;
+  unsigned int row, previous_row;
+#ifdef __SSE2__
+  double argmax[GT_HMM_LANES];
+  for (row = 0; row < chmm->stride; row += GT_HMM_LANES) {
+    __m128d e, max, arg, tmp, mask;
+    e = _mm_loadu_pd(emission + row);
+    transition = chmm->transition_prob + row;
+    max = _mm_add_pd(_mm_add_pd(_mm_set1_pd(previous[0]),
+                                _mm_loadu_pd(transition)), e);
+    arg = _mm_setzero_pd();
+    for (previous_row = 1; previous_row < chmm->num_of_states;
+         previous_row++) {
+      transition += chmm->stride;
+      tmp = _mm_add_pd(_mm_add_pd(_mm_set1_pd(previous[previous_row]),
+                                  _mm_loadu_pd(transition)), e);
+      mask = _mm_cmpgt_pd(tmp, max);
+      max = _mm_or_pd(_mm_and_pd(mask, tmp), _mm_andnot_pd(mask, max));
+      arg = _mm_or_pd(_mm_and_pd(mask, _mm_set1_pd((double) previous_row)),
+                      _mm_andnot_pd(mask, arg));
+    }
+    _mm_storeu_pd(column + row, max);
+    _mm_storeu_pd(argmax, arg);
+    backtrace[row] = (unsigned int) argmax[0];
+    backtrace[row + 1] = (unsigned int) argmax[1];
+  }
+#else
+  double tmp_prob;
+  for (row = 0; row < chmm->stride; row++) {
+    transition = chmm->transition_prob + row;
+    column[row] = previous[0] + transition[0] + emission[row];
+    backtrace[row] = 0;
+    for (previous_row = 1; previous_row < chmm->num_of_states;
+         previous_row++) {
+      transition += chmm->stride;
+      tmp_prob = previous[previous_row] + transition[0] + emission[row];
+      if (tmp_prob > column[row]) {
+        column[row] = tmp_prob;
+        backtrace[row] = previous_row;
       }
     }
   }
+#endif
+}
 
-  /* backtracing, determine end state with maximum probability */
-  colidx = (num_of_columns - 1) & 1;
-  tmp_prob = max_probabilities[0][colidx];
-  state_sequence[num_of_columns - 1] = 0;
-  for (row = 1; row < num_of_rows; row++) {
-    if (max_probabilities[row][colidx] > tmp_prob)
-      state_sequence[num_of_columns - 1] = row;
+/* [DEKM98, p. 56], <columns> has space for two columns, <backtrace> for
+   <num_of_emissions> columns */
+static void viterbi_decode(const GtHMMCompiled *chmm, double *columns,
+                           unsigned int *backtrace,
+                           unsigned int *state_sequence,
+                           const unsigned int *emissions,
+                           unsigned int num_of_emissions)
+{
+  double *column = columns, *previous = columns + chmm->stride, *tmp,
+         tmp_prob;
+  unsigned int row, stride = chmm->stride;
+  int col;
+
+  gt_assert(num_of_emissions);
+
+  /* fill DP table */
+  gt_assert(emissions[0] < chmm->num_of_symbols);
+  for (row = 0; row < stride; row++) { /* first column */
+    column[row] = chmm->initial_state_prob[row] +
+                  chmm->emission_prob[emissions[0] * stride + row];
+    backtrace[row] = row;
+  }
+  for (col = 1; col < num_of_emissions; col++) { /* other columns */
+    gt_assert(emissions[col] < chmm->num_of_symbols);
+    tmp = previous;
+    previous = column;
+    column = tmp;
+    viterbi_column(chmm, column, backtrace + col * stride, previous,
+                   emissions[col]);
+  }
+
+  /* backtracing, determine end state. Like the original implementation this
+     takes the last state which is more probable than state 0, which is not
+     necessarily the most probable one. */
+  tmp_prob = column[0];
+  state_sequence[num_of_emissions - 1] = 0;
+  for (row = 1; row < chmm->num_of_states; row++) {
+    if (column[row] > tmp_prob)
+      state_sequence[num_of_emissions - 1] = row;
   }
 
   /* backtracing, follow the links */
-  for (column = num_of_columns - 2; column >= 0; column--)
-    state_sequence[column] = backtrace[state_sequence[column + 1]][column + 1];
+  for (col = num_of_emissions - 2; col >= 0; col--) {
+    state_sequence[col] = backtrace[(col + 1) * stride +
+                                    state_sequence[col + 1]];
+  }
+}
 
-  /* free tables */
-  gt_array2dim_delete(backtrace);
-  gt_array2dim_delete(max_probabilities);
+void gt_hmm_compiled_decode_batch(const GtHMMCompiled *chmm,
+                                  unsigned int **state_sequences,
+                                  const unsigned int **emissions,
+                                  const unsigned int *num_of_emissions,
+                                  unsigned long num_of_sequences)
+{
+  unsigned long i;
+  unsigned int max_num_of_emissions = 0, *backtrace;
+  double *columns;
+
+  gt_assert(chmm && state_sequences && emissions && num_of_emissions);
+
+  for (i = 0; i < num_of_sequences; i++) {
+    if (num_of_emissions[i] > max_num_of_emissions)
+      max_num_of_emissions = num_of_emissions[i];
+  }
+  columns = gt_malloc(sizeof (double) * 2 * chmm->stride);
+  backtrace = gt_malloc(sizeof (unsigned int) * chmm->stride *
+                        max_num_of_emissions);
+  for (i = 0; i < num_of_sequences; i++) {
+    viterbi_decode(chmm, columns, backtrace, state_sequences[i], emissions[i],
+                   num_of_emissions[i]);
+  }
+  gt_free(backtrace);
+  gt_free(columns);
 }
 
-/* [DEKM98, p. 58] */
-static void compute_forward_table(double **f, const GtHMM *hmm,
-                                  const unsigned int *emissions,
-                                  unsigned long num_of_emissions)
+void gt_hmm_compiled_decode(const GtHMMCompiled *chmm,
+                            unsigned int *state_sequence,
+                            const unsigned int *emissions,
+                            unsigned int num_of_emissions)
 {
-  int row, column, previous_row;
-  double tmp_prob;
+  gt_assert(chmm && state_sequence && emissions);
+  gt_hmm_compiled_decode_batch(chmm, &state_sequence, &emissions,
+                               &num_of_emissions, 1);
+}
 
-  gt_assert(f && hmm && emissions && num_of_emissions);
+/* [DEKM98, p. 56] */
+void gt_hmm_decode(const GtHMM *hmm,
+                unsigned int *state_sequence,
+                const unsigned int *emissions,
+                unsigned int num_of_emissions)
+{
+  GtHMMCompiled *chmm;
+  gt_assert(hmm);
+  chmm = gt_hmm_compiled_new(hmm);
+  gt_hmm_compiled_decode(chmm, state_sequence, emissions, num_of_emissions);
+  gt_hmm_compiled_delete(chmm);
+}
 
-  /* fill DP table 'f' (hmm->num_of_states * num_of_emissions) */
-  for (row = 0; row < hmm->num_of_states; row++) { /* first column */
-    gt_assert(emissions[0] < hmm->num_of_symbols);
-    f[row][0] = hmm->initial_state_prob[row] +
-                hmm->emission_prob[row][emissions[0]];
+/* [DEKM98, p. 58], only the last column of the forward table is kept */
+double gt_hmm_compiled_forward(const GtHMMCompiled *chmm,
+                               const unsigned int *emissions,
+                               unsigned int num_of_emissions)
+{
+  unsigned int row, previous_row, column, stride;
+  double *columns, *f, *previous, *tmp, tmp_prob, P;
+
+  gt_assert(chmm && emissions && num_of_emissions);
+  stride = chmm->stride;
+  columns = gt_malloc(sizeof (double) * 2 * stride);
+  f = columns;
+  previous = columns + stride;
+
+  gt_assert(emissions[0] < chmm->num_of_symbols);
+  for (row = 0; row < chmm->num_of_states; row++) { /* first column */
+    f[row] = chmm->initial_state_prob[row] +
+             chmm->emission_prob[emissions[0] * stride + row];
   }
 
   for (column = 1; column < num_of_emissions; column++) { /* other columns */
-    gt_assert(emissions[column] < hmm->num_of_symbols);
-    for (row = 0; row < hmm->num_of_states; row++) {
-      f[row][column] = hmm->emission_prob[row][emissions[column]];
-      tmp_prob = f[0][column-1] + hmm->transition_prob[0][row];
-      for (previous_row = 1; previous_row < hmm->num_of_states;
+    gt_assert(emissions[column] < chmm->num_of_symbols);
+    tmp = previous;
+    previous = f;
+    f = tmp;
+    for (row = 0; row < chmm->num_of_states; row++) {
+      tmp_prob = previous[0] + chmm->transition_prob[row];
+      for (previous_row = 1; previous_row < chmm->num_of_states;
            previous_row++) {
         /* XXX: replace the logsum() call with a tabulated version */
-        tmp_prob = gt_logsum(tmp_prob, f[previous_row][column-1] +
-                                       hmm->transition_prob[previous_row][row]);
+        tmp_prob = gt_logsum(tmp_prob, previous[previous_row] +
+                             chmm->transition_prob[previous_row * stride +
+                                                   row]);
       }
-      f[row][column] += tmp_prob;
+      f[row] = chmm->emission_prob[emissions[column] * stride + row] +
+               tmp_prob;
     }
   }
+
+  /* compute P(x) */
+  P = f[0];
+  for (row = 1; row < chmm->num_of_states; row++) {
+    /* XXX: replace the logsum() call with a tabulated version */
+    P = gt_logsum(P, f[row]);
+  }
+
+  gt_free(columns);
+  return P;
+}
+
+void gt_hmm_compiled_delete(GtHMMCompiled *chmm)
+{
+  if (!chmm) return;
+  gt_free(chmm->initial_state_prob);
+  gt_free(chmm->transition_prob);
+  gt_free(chmm->emission_prob);
+  gt_free(chmm);
 }
 
 /* [DEKM98, p. 58] */
 double gt_hmm_forward(const GtHMM* hmm, const unsigned int *emissions,
                    unsigned int num_of_emissions)
 {
-  unsigned int i;
-  double **f, P;
+  GtHMMCompiled *chmm;
+  double P;
 
   gt_assert(hmm && emissions && num_of_emissions);
-  gt_array2dim_malloc(f, hmm->num_of_states, num_of_emissions);
-
-  /* XXX: we do not need the full table here, the last column would suffice */
-  compute_forward_table(f, hmm, emissions, num_of_emissions);
-
-  /* compute P(x) */
-  P = f[0][num_of_emissions-1];
-  for (i = 1; i < hmm->num_of_states; i++) {
-    /* XXX: replace the logsum() call with a tabulated version */
-    P = gt_logsum(P, f[i][num_of_emissions-1]);
-  }
-
-  gt_array2dim_delete(f);
+  chmm = gt_hmm_compiled_new(hmm);
+  P = gt_hmm_compiled_forward(chmm, emissions, num_of_emissions);
+  gt_hmm_compiled_delete(chmm);
   return P;
 }
 
@@ -575,6 +737,63 @@ void gt_hmm_show(const GtHMM *hmm, FILE *fp)
   }
 }
 
+/* the scalar Viterbi of [DEKM98, p. 56] which the compiled kernel replaced,
+   kept to check the kernel against in the unit test */
+static void reference_decode(const GtHMM *hmm, unsigned int *state_sequence,
+                             const unsigned int *emissions,
+                             unsigned int num_of_emissions)
+{
+  double **max_probabilities, tmp_prob;
+  unsigned int **backtrace, colidx, precolidx;
+  int row, column, num_of_rows, num_of_columns, previous_row;
+
+  num_of_rows = hmm->num_of_states;
+  num_of_columns = num_of_emissions;
+  gt_array2dim_malloc(max_probabilities, num_of_rows, 2);
+  gt_array2dim_malloc(backtrace, num_of_rows, num_of_columns);
+
+  for (row = 0; row < num_of_rows; row++) { /* first column */
+    max_probabilities[row][0] = hmm->initial_state_prob[row] +
+                                hmm->emission_prob[row][emissions[0]];
+    backtrace[row][0] = row;
+  }
+
+  for (column = 1; column < num_of_columns; column++) { /* other columns */
+    colidx = column & 1;
+    precolidx = (column - 1) & 1;
+    for (row = 0; row < num_of_rows; row++) {
+      max_probabilities[row][colidx] = max_probabilities[0][precolidx] +
+                                     hmm->transition_prob[0][row] +
+                                     hmm->emission_prob[row][emissions[column]];
+      backtrace[row][column] = 0;
+      for (previous_row = 1; previous_row < num_of_rows; previous_row++) {
+        tmp_prob = max_probabilities[previous_row][precolidx] +
+                   hmm->transition_prob[previous_row][row] +
+                   hmm->emission_prob[row][emissions[column]];
+        if (tmp_prob > max_probabilities[row][colidx]) {
+          max_probabilities[row][colidx] = tmp_prob;
+          backtrace[row][column] = previous_row;
+        }
+      }
+    }
+  }
+
+  /* the end state is chosen exactly as the compiled kernel does it */
+  colidx = (num_of_columns - 1) & 1;
+  tmp_prob = max_probabilities[0][colidx];
+  state_sequence[num_of_columns - 1] = 0;
+  for (row = 1; row < num_of_rows; row++) {
+    if (max_probabilities[row][colidx] > tmp_prob)
+      state_sequence[num_of_columns - 1] = row;
+  }
+
+  for (column = num_of_columns - 2; column >= 0; column--)
+    state_sequence[column] = backtrace[state_sequence[column + 1]][column + 1];
+
+  gt_array2dim_delete(backtrace);
+  gt_array2dim_delete(max_probabilities);
+}
+
 int gt_hmm_unit_test(GtError *err)
 {
   /* the last coin string must be the longest */
@@ -596,8 +815,10 @@ int gt_hmm_unit_test(GtError *err)
                                 "6366646623252441366166116325256246225526525226"
                                 "6435353336233121625364414432335163243633665562"
                                 "466662632666612355245242" };
-  unsigned int *encoded_seq;
+  unsigned int *encoded_seq, **encoded_seqs, **decoded_seqs, *lengths,
+               *decoded;
   GtAlphabet *alpha;
+  GtHMMCompiled *chmm;
   size_t i, j, len, size;
   GtHMM *fair_hmm, *loaded_hmm;
   int had_err = 0;
@@ -662,6 +883,72 @@ int gt_hmm_unit_test(GtError *err)
   }
 
   gt_free(encoded_seq);
+
+  /* batch decoding must give the paths of the scalar Viterbi, and the
+     compiled forward algorithm the probabilities of the backward algorithm */
+  encoded_seqs = gt_malloc(sizeof (unsigned int*) * size);
+  decoded_seqs = gt_malloc(sizeof (unsigned int*) * size);
+  lengths = gt_malloc(sizeof (unsigned int) * size);
+  for (i = 0; i < size; i++) {
+    lengths[i] = strlen(dice_rolls[i]);
+    encoded_seqs[i] = gt_malloc(sizeof (unsigned int) * lengths[i]);
+    decoded_seqs[i] = gt_malloc(sizeof (unsigned int) * lengths[i]);
+    for (j = 0; j < lengths[i]; j++)
+      encoded_seqs[i][j] = gt_alphabet_encode(alpha, dice_rolls[i][j]);
+  }
+  chmm = gt_hmm_compiled_new(loaded_hmm);
+  gt_hmm_compiled_decode_batch(chmm, decoded_seqs,
+                               (const unsigned int**) encoded_seqs, lengths,
+                               size);
+  decoded = gt_malloc(sizeof (unsigned int) * lengths[size-1]);
+  for (i = 0; i < size && !had_err; i++) {
+    reference_decode(loaded_hmm, decoded, encoded_seqs[i], lengths[i]);
+    ensure(had_err, !memcmp(decoded, decoded_seqs[i],
+                            sizeof (unsigned int) * lengths[i]));
+    ensure(had_err,
+           gt_double_equals_double(exp(gt_hmm_compiled_forward(chmm,
+                                                              encoded_seqs[i],
+                                                              lengths[i])),
+                                   exp(gt_hmm_backward(loaded_hmm,
+                                                       encoded_seqs[i],
+                                                       lengths[i]))));
+  }
+  /* a long run of sixes comes from the loaded die */
+  for (i = 0; i < size && !had_err; i++) {
+    if (strspn(dice_rolls[i], "6") == lengths[i] && lengths[i] > 10) {
+      for (j = 0; j < lengths[i]; j++)
+        ensure(had_err, decoded_seqs[i][j] == DICE_LOADED);
+    }
+  }
+  gt_hmm_compiled_delete(chmm);
+
+  /* random HMMs, also with state numbers which are not a multiple of the
+     vector width */
+  for (i = 1; i <= 5 && !had_err; i++) {
+    GtHMM *random_hmm = gt_hmm_new(i, DICE_NUM_OF_SYMBOLS);
+    gt_hmm_init_random(random_hmm);
+    chmm = gt_hmm_compiled_new(random_hmm);
+    for (j = 0; j < lengths[size-1]; j++)
+      encoded_seqs[size-1][j] = gt_rand_max(DICE_NUM_OF_SYMBOLS - 1);
+    gt_hmm_compiled_decode(chmm, decoded_seqs[size-1], encoded_seqs[size-1],
+                           lengths[size-1]);
+    reference_decode(random_hmm, decoded, encoded_seqs[size-1],
+                     lengths[size-1]);
+    ensure(had_err, !memcmp(decoded, decoded_seqs[size-1],
+                            sizeof (unsigned int) * lengths[size-1]));
+    gt_hmm_compiled_delete(chmm);
+    gt_hmm_delete(random_hmm);
+  }
+
+  gt_free(decoded);
+  for (i = 0; i < size; i++) {
+    gt_free(encoded_seqs[i]);
+    gt_free(decoded_seqs[i]);
+  }
+  gt_free(lengths);
+  gt_free(decoded_seqs);
+  gt_free(encoded_seqs);
+
   gt_alphabet_delete(alpha);
   ensure(had_err, gt_double_equals_double(gt_hmm_rmsd(fair_hmm, fair_hmm),
                                           0.0));
@@ -51,6 +51,31 @@ double gt_hmm_forward(const GtHMM*, const unsigned int *emissions,
 /* Backward algorithm, returns log(P(emissions)) */
 double gt_hmm_backward(const GtHMM*, const unsigned int *emissions,
                     unsigned int num_of_emissions);
+
+/* A read-only copy of a <GtHMM> with its log probabilities in contiguous
+   arrays, for decoding many sequences with the same model. Later changes to
+   the <GtHMM> do not affect the copy. */
+typedef struct GtHMMCompiled GtHMMCompiled;
+
+GtHMMCompiled* gt_hmm_compiled_new(const GtHMM*);
+/* Viterbi algorithm, same result as <gt_hmm_decode()> */
+void           gt_hmm_compiled_decode(const GtHMMCompiled*,
+                                      unsigned int *state_sequence,
+                                      const unsigned int *emissions,
+                                      unsigned int num_of_emissions);
+/* decodes <num_of_sequences> sequences one after another with the same DP
+   tables, <state_sequences>[i] receives the path of <emissions>[i] */
+void           gt_hmm_compiled_decode_batch(const GtHMMCompiled*,
+                                            unsigned int **state_sequences,
+                                            const unsigned int **emissions,
+                                            const unsigned int
+                                              *num_of_emissions,
+                                            unsigned long num_of_sequences);
+/* Forward algorithm, same result as <gt_hmm_forward()> */
+double         gt_hmm_compiled_forward(const GtHMMCompiled*,
+                                       const unsigned int *emissions,
+                                       unsigned int num_of_emissions);
+void           gt_hmm_compiled_delete(GtHMMCompiled*);
 void   gt_hmm_emit(GtHMM*, unsigned long num_of_emissions,
                 void (*proc_emission)(unsigned int symbol, void *data),
                 void *data);
@@ -0,0 +1,317 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "core/assert_api.h"
+#include "core/ma.h"
+#include "core/thread.h"
+#include "extended/genome_node.h"
+#include "extended/node_stream_api.h"
+#include "extended/parallel_visitor_stream.h"
+
+/* the number of jobs which can be processed or waiting per thread, allows to
+   balance feature trees of different size */
+#define JOBS_PER_THREAD  4
+/* the nodes are handed over in batches to keep the synchronization overhead
+   small compared to the processing of a (small) feature tree */
+#define NODES_PER_JOB    64
+
+typedef struct {
+  GtGenomeNode *nodes[NODES_PER_JOB];
+  void *results[NODES_PER_JOB];
+  unsigned long nof_nodes,
+                next_node, /* next node to be returned */
+                err_node;  /* the node which caused the error (if any) */
+  GtError *err;
+  int had_err;
+  bool done;
+} ParallelVisitorJob;
+
+typedef struct {
+  GtParallelVisitorStream *pvs;
+  GtNodeVisitor *visitor;
+  GtThread *thread;
+} ParallelVisitorWorker;
+
+struct GtParallelVisitorStream {
+  const GtNodeStream parent_instance;
+  GtNodeStream *in_stream;
+  ParallelVisitorWorker *workers;
+  unsigned int nof_workers;
+  ParallelVisitorJob *jobs; /* ring buffer, job <i> is stored at i % nof_jobs */
+  unsigned long nof_jobs,
+                submitted, /* number of jobs handed over to the workers */
+                next_job,  /* next job to be processed by a worker */
+                returned;  /* number of jobs whose nodes have been returned */
+  GtMutex *mutex;
+  GtCondition *job_available,
+              *job_finished;
+  bool eof,
+       finish,
+       merged;
+  GtNodeVisitor *merge_dest,
+                *emit_dest;
+  GtParallelVisitorMergeFunc merge;
+  GtParallelVisitorCollectFunc collect;
+  GtParallelVisitorEmitFunc emit;
+  GtFree free_results;
+};
+
+#define parallel_visitor_stream_cast(GS)\
+        gt_node_stream_cast(gt_parallel_visitor_stream_class(), GS)
+
+static void* visit_nodes(void *data)
+{
+  ParallelVisitorWorker *worker = data;
+  GtParallelVisitorStream *pvs = worker->pvs;
+  ParallelVisitorJob *job;
+  unsigned long i;
+  gt_mutex_lock(pvs->mutex);
+  for (;;) {
+    while (pvs->next_job == pvs->submitted && !pvs->finish)
+      gt_condition_wait(pvs->job_available, pvs->mutex);
+    if (pvs->finish)
+      break; /* the remaining nodes are not needed anymore */
+    job = pvs->jobs + pvs->next_job++ % pvs->nof_jobs;
+    gt_mutex_unlock(pvs->mutex);
+    for (i = 0; !job->had_err && i < job->nof_nodes; i++) {
+      job->had_err = gt_genome_node_accept(job->nodes[i], worker->visitor,
+                                           job->err);
+      if (job->had_err)
+        job->err_node = i;
+      if (pvs->collect)
+        job->results[i] = pvs->collect(worker->visitor);
+    }
+    gt_mutex_lock(pvs->mutex);
+    job->done = true;
+    gt_condition_signal(pvs->job_finished);
+  }
+  gt_mutex_unlock(pvs->mutex);
+  return NULL;
+}
+
+static void merge_visitors(GtParallelVisitorStream *pvs)
+{
+  unsigned int i;
+  if (pvs->merged)
+    return;
+  if (pvs->merge) {
+    for (i = 0; i < pvs->nof_workers; i++)
+      pvs->merge(pvs->merge_dest, pvs->workers[i].visitor);
+  }
+  pvs->merged = true;
+}
+
+static void free_results(GtParallelVisitorStream *pvs, ParallelVisitorJob *job,
+                         unsigned long i)
+{
+  if (pvs->free_results)
+    pvs->free_results(job->results[i]);
+  job->results[i] = NULL;
+}
+
+static int parallel_visitor_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
+                                        GtError *err)
+{
+  GtParallelVisitorStream *pvs;
+  ParallelVisitorJob *job;
+  GtGenomeNode *node;
+  unsigned long i;
+  int had_err = 0;
+  gt_error_check(err);
+  pvs = parallel_visitor_stream_cast(ns);
+
+  /* keep all workers busy */
+  while (!pvs->eof && pvs->submitted - pvs->returned < pvs->nof_jobs) {
+    job = pvs->jobs + pvs->submitted % pvs->nof_jobs;
+    job->nof_nodes = 0;
+    while (job->nof_nodes < NODES_PER_JOB) {
+      if (gt_node_stream_next(pvs->in_stream, &node, err)) {
+        for (i = 0; i < job->nof_nodes; i++)
+          gt_genome_node_delete(job->nodes[i]);
+        return -1;
+      }
+      if (!node) {
+        pvs->eof = true;
+        break;
+      }
+      job->nodes[job->nof_nodes++] = node;
+    }
+    if (!job->nof_nodes)
+      break;
+    job->next_node = 0;
+    job->had_err = 0;
+    job->done = false;
+    gt_mutex_lock(pvs->mutex);
+    pvs->submitted++;
+    gt_condition_signal(pvs->job_available);
+    gt_mutex_unlock(pvs->mutex);
+  }
+
+  if (pvs->returned == pvs->submitted) {
+    /* input stream is exhausted and all nodes have been returned */
+    gt_assert(pvs->eof);
+    merge_visitors(pvs);
+    *gn = NULL;
+    return 0;
+  }
+
+  /* return the nodes in input order */
+  job = pvs->jobs + pvs->returned % pvs->nof_jobs;
+  gt_mutex_lock(pvs->mutex);
+  while (!job->done)
+    gt_condition_wait(pvs->job_finished, pvs->mutex);
+  gt_mutex_unlock(pvs->mutex);
+
+  i = job->next_node++;
+  if (job->had_err && i == job->err_node) {
+    gt_error_set(err, "%s", gt_error_get(job->err));
+    gt_error_unset(job->err);
+    had_err = -1;
+  }
+  if (!had_err && pvs->emit)
+    had_err = pvs->emit(pvs->emit_dest, job->results[i], err);
+  free_results(pvs, job, i);
+  if (had_err) {
+    /* we own the node -> delete it */
+    gt_genome_node_delete(job->nodes[i]);
+    *gn = NULL;
+  }
+  else
+    *gn = job->nodes[i];
+  job->nodes[i] = NULL;
+  if (job->next_node == job->nof_nodes ||
+      (job->had_err && job->next_node > job->err_node)) {
+    /* the job is not needed anymore */
+    for (i = job->next_node; i < job->nof_nodes; i++) {
+      gt_genome_node_delete(job->nodes[i]);
+      free_results(pvs, job, i);
+    }
+    pvs->returned++;
+  }
+  return had_err;
+}
+
+static void parallel_visitor_stream_free(GtNodeStream *ns)
+{
+  GtParallelVisitorStream *pvs = parallel_visitor_stream_cast(ns);
+  ParallelVisitorJob *job;
+  unsigned long i;
+  gt_mutex_lock(pvs->mutex);
+  pvs->finish = true;
+  gt_condition_broadcast(pvs->job_available);
+  gt_mutex_unlock(pvs->mutex);
+  for (i = 0; i < pvs->nof_workers; i++) {
+    if (pvs->workers[i].thread)
+      gt_thread_join(pvs->workers[i].thread);
+    gt_node_visitor_delete(pvs->workers[i].visitor);
+  }
+  /* delete the nodes which have not been returned (after an error) */
+  for (; pvs->returned < pvs->submitted; pvs->returned++) {
+    job = pvs->jobs + pvs->returned % pvs->nof_jobs;
+    for (i = job->next_node; i < job->nof_nodes; i++) {
+      gt_genome_node_delete(job->nodes[i]);
+      free_results(pvs, job, i);
+    }
+  }
+  for (i = 0; i < pvs->nof_jobs; i++)
+    gt_error_delete(pvs->jobs[i].err);
+  gt_free(pvs->jobs);
+  gt_free(pvs->workers);
+  gt_condition_delete(pvs->job_finished);
+  gt_condition_delete(pvs->job_available);
+  gt_mutex_delete(pvs->mutex);
+  gt_node_stream_delete(pvs->in_stream);
+}
+
+const GtNodeStreamClass* gt_parallel_visitor_stream_class(void)
+{
+  static const GtNodeStreamClass *nsc = NULL;
+  if (!nsc) {
+    nsc = gt_node_stream_class_new(sizeof (GtParallelVisitorStream),
+                                   parallel_visitor_stream_free,
+                                   parallel_visitor_stream_next);
+  }
+  return nsc;
+}
+
+GtNodeStream* gt_parallel_visitor_stream_new(GtNodeStream *in_stream,
+                                             unsigned int nof_threads,
+                                             GtParallelVisitorNewFunc
+                                             new_visitor, void *data,
+                                             GtError *err)
+{
+  GtParallelVisitorStream *pvs;
+  GtNodeStream *ns;
+  unsigned long i;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(in_stream && nof_threads && new_visitor);
+  ns = gt_node_stream_create(gt_parallel_visitor_stream_class(),
+                             gt_node_stream_is_sorted(in_stream));
+  pvs = parallel_visitor_stream_cast(ns);
+  pvs->in_stream = gt_node_stream_ref(in_stream);
+  pvs->mutex = gt_mutex_new();
+  pvs->job_available = gt_condition_new();
+  pvs->job_finished = gt_condition_new();
+  pvs->nof_jobs = JOBS_PER_THREAD * nof_threads;
+  pvs->jobs = gt_calloc(pvs->nof_jobs, sizeof (ParallelVisitorJob));
+  for (i = 0; i < pvs->nof_jobs; i++)
+    pvs->jobs[i].err = gt_error_new();
+  pvs->nof_workers = nof_threads;
+  pvs->workers = gt_calloc(nof_threads, sizeof (ParallelVisitorWorker));
+  for (i = 0; !had_err && i < nof_threads; i++) {
+    pvs->workers[i].pvs = pvs;
+    if (!(pvs->workers[i].visitor = new_visitor(data, err)))
+      had_err = -1;
+  }
+  for (i = 0; !had_err && i < nof_threads; i++) {
+    pvs->workers[i].thread = gt_thread_new(visit_nodes, pvs->workers + i, err);
+    if (!pvs->workers[i].thread)
+      had_err = -1;
+  }
+  if (had_err) {
+    gt_node_stream_delete(ns);
+    return NULL;
+  }
+  return ns;
+}
+
+void gt_parallel_visitor_stream_set_merge_func(GtNodeStream *ns,
+                                               GtNodeVisitor *dest,
+                                               GtParallelVisitorMergeFunc merge)
+{
+  GtParallelVisitorStream *pvs = parallel_visitor_stream_cast(ns);
+  gt_assert(dest && merge);
+  pvs->merge_dest = dest;
+  pvs->merge = merge;
+}
+
+void gt_parallel_visitor_stream_set_collect_func(GtNodeStream *ns,
+                                                 GtNodeVisitor *dest,
+                                                 GtParallelVisitorCollectFunc
+                                                 collect,
+                                                 GtParallelVisitorEmitFunc emit,
+                                                 GtFree free_results)
+{
+  GtParallelVisitorStream *pvs = parallel_visitor_stream_cast(ns);
+  gt_assert(dest && collect && emit && free_results);
+  gt_assert(!pvs->submitted); /* has to be called before the stream is used */
+  pvs->emit_dest = dest;
+  pvs->collect = collect;
+  pvs->emit = emit;
+  pvs->free_results = free_results;
+}
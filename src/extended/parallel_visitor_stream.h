@@ -0,0 +1,71 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#ifndef PARALLEL_VISITOR_STREAM_H
+#define PARALLEL_VISITOR_STREAM_H
+
+#include "core/fptr_api.h"
+#include "extended/node_stream_api.h"
+#include "extended/node_visitor.h"
+
+/* Implements the ``genome_stream'' interface. Every feature tree (and every
+   other node) retrieved from the input stream is handed to one of several
+   worker threads, each of which owns its own visitor instance, and accepted
+   there. The nodes are returned in their original order. */
+typedef struct GtParallelVisitorStream GtParallelVisitorStream;
+
+/* Return a new visitor for a worker thread. Called in the thread which
+   creates the stream. */
+typedef GtNodeVisitor* (*GtParallelVisitorNewFunc)(void *data, GtError*);
+/* Add the aggregate state of the worker visitor <src> to <dest>. */
+typedef void           (*GtParallelVisitorMergeFunc)(GtNodeVisitor *dest,
+                                                     GtNodeVisitor *src);
+/* Detach the results the worker visitor <src> produced for the last node and
+   return them. Called in the worker thread. */
+typedef void*          (*GtParallelVisitorCollectFunc)(GtNodeVisitor *src);
+/* Process the <results> collected for a node. Called in input order in the
+   thread which pulls the stream. */
+typedef int            (*GtParallelVisitorEmitFunc)(GtNodeVisitor *dest,
+                                                    void *results, GtError*);
+
+const GtNodeStreamClass* gt_parallel_visitor_stream_class(void);
+
+/* Create a parallel visitor stream which reads from <in_stream> and starts
+   <nof_threads> worker threads with visitors created by <new_visitor>.
+   Returns NULL and sets <err> if a visitor or a thread could not be created
+   (e.g., if GenomeTools has been compiled without thread support). */
+GtNodeStream* gt_parallel_visitor_stream_new(GtNodeStream *in_stream,
+                                             unsigned int nof_threads,
+                                             GtParallelVisitorNewFunc
+                                             new_visitor, void *data,
+                                             GtError *err);
+/* After the stream has been exhausted, <merge> is called for every worker
+   visitor to reduce its state into <dest>. */
+void          gt_parallel_visitor_stream_set_merge_func(GtNodeStream*,
+                                                        GtNodeVisitor *dest,
+                                                    GtParallelVisitorMergeFunc);
+/* After a worker visitor accepted a node, <collect> is called to detach its
+   results. Before the node is returned by the stream, <emit> is called with
+   <dest> and these results. Afterwards (or if the results are never emitted
+   because of an error) they are freed with <free_results>. */
+void          gt_parallel_visitor_stream_set_collect_func(GtNodeStream*,
+                                                          GtNodeVisitor *dest,
+                                                   GtParallelVisitorCollectFunc,
+                                                      GtParallelVisitorEmitFunc,
+                                                          GtFree free_results);
+
+#endif
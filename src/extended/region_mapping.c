@@ -15,6 +15,9 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#ifdef GT_THREADS_ENABLED
+#include <pthread.h>
+#endif
 #include "lua.h"
 #include "lauxlib.h"
 #include "lualib.h"
@@ -25,7 +28,8 @@
 #include "extended/region_mapping.h"
 
 struct GtRegionMapping {
-  GtStr *sequence_filename,
+  GtStr *mapping_filename,
+        *sequence_filename,
       *sequence_file, /* the (current) sequence file */
       *sequence_name; /* the (current) sequence name */
   GtMapping *mapping;
@@ -33,6 +37,16 @@ struct GtRegionMapping {
   unsigned int reference_count;
 };
 
+#ifdef GT_THREADS_ENABLED
+/* region mappings of different threads might create the same index files */
+static pthread_mutex_t bioseq_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define bioseq_lock()   pthread_mutex_lock(&bioseq_mutex)
+#define bioseq_unlock() pthread_mutex_unlock(&bioseq_mutex)
+#else
+#define bioseq_lock()
+#define bioseq_unlock()
+#endif
+
 GtRegionMapping* gt_region_mapping_new_mapping(GtStr *mapping_filename,
                                                GtError *err)
 {
@@ -40,6 +54,7 @@ GtRegionMapping* gt_region_mapping_new_mapping(GtStr *mapping_filename,
   gt_error_check(err);
   gt_assert(mapping_filename);
   rm = gt_calloc(1, sizeof (GtRegionMapping));
+  rm->mapping_filename = gt_str_clone(mapping_filename);
   rm->mapping = gt_mapping_new(mapping_filename, "mapping", MAPPINGTYPE_STRING,
                                err);
   if (!rm->mapping) {
@@ -58,6 +73,22 @@ GtRegionMapping* gt_region_mapping_new_seqfile(GtStr *sequence_filename)
   return rm;
 }
 
+GtRegionMapping* gt_region_mapping_clone(const GtRegionMapping *rm,
+                                         GtError *err)
+{
+  GtRegionMapping *clone;
+  GtStr *sequence_filename;
+  gt_error_check(err);
+  gt_assert(rm);
+  if (rm->sequence_filename) {
+    sequence_filename = gt_str_clone(rm->sequence_filename);
+    clone = gt_region_mapping_new_seqfile(sequence_filename);
+    gt_str_delete(sequence_filename);
+    return clone;
+  }
+  return gt_region_mapping_new_mapping(rm->mapping_filename, err);
+}
+
 GtRegionMapping* gt_region_mapping_ref(GtRegionMapping *rm)
 {
   gt_assert(rm);
@@ -94,7 +125,9 @@ static int update_bioseq_if_necessary(GtRegionMapping *rm, GtStr *seqid,
         gt_str_reset(rm->sequence_name);
       gt_str_append_str(rm->sequence_name, seqid);
       gt_bioseq_delete(rm->bioseq);
+      bioseq_lock();
       rm->bioseq = gt_bioseq_new_str(rm->sequence_file, err);
+      bioseq_unlock();
       if (!rm->bioseq)
         had_err = -1;
     }
@@ -134,6 +167,7 @@ void gt_region_mapping_delete(GtRegionMapping *rm)
     rm->reference_count--;
     return;
   }
+  gt_str_delete(rm->mapping_filename);
   gt_str_delete(rm->sequence_filename);
   gt_str_delete(rm->sequence_file);
   gt_str_delete(rm->sequence_name);
@@ -26,6 +26,10 @@ typedef struct GtRegionMapping GtRegionMapping;
 GtRegionMapping* gt_region_mapping_new_mapping(GtStr *mapping_filename,
                                                GtError*);
 GtRegionMapping* gt_region_mapping_new_seqfile(GtStr *sequence_filename);
+/* Return a new region mapping with the same mapping as <region_mapping> which
+   does not share any state with it (e.g., for use in another thread). */
+GtRegionMapping* gt_region_mapping_clone(const GtRegionMapping
+                                         *region_mapping, GtError*);
 GtRegionMapping* gt_region_mapping_ref(GtRegionMapping*);
 int              gt_region_mapping_get_raw_sequence(GtRegionMapping*,
                                                     const char **raw,
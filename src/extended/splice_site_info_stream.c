@@ -17,13 +17,15 @@
 
 #include "core/assert_api.h"
 #include "extended/node_stream_api.h"
+#include "extended/parallel_visitor_stream.h"
 #include "extended/splice_site_info_stream.h"
 #include "extended/splice_site_info_visitor.h"
 
 struct GtSpliceSiteInfoStream
 {
   const GtNodeStream parent_instance;
-  GtNodeStream *in_stream;
+  GtNodeStream *in_stream,
+               *parallel_stream; /* visits the nodes in worker threads */
   GtNodeVisitor *splice_site_info_visitor;
 };
 
@@ -37,6 +39,8 @@ static int gt_splice_site_info_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
   int had_err;
   gt_error_check(err);
   ssis = gt_splice_site_info_stream_cast(gs);
+  if (ssis->parallel_stream)
+    return gt_node_stream_next(ssis->parallel_stream, gn, err);
   had_err = gt_node_stream_next(ssis->in_stream, gn, err);
   if (!had_err) {
     gt_assert(ssis->splice_site_info_visitor);
@@ -55,6 +59,7 @@ static int gt_splice_site_info_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
 static void gt_splice_site_info_stream_free(GtNodeStream *gs)
 {
   GtSpliceSiteInfoStream *ssis = gt_splice_site_info_stream_cast(gs);
+  gt_node_stream_delete(ssis->parallel_stream);
   gt_node_visitor_delete(ssis->splice_site_info_visitor);
   gt_node_stream_delete(ssis->in_stream);
 }
@@ -81,6 +86,25 @@ GtNodeStream* gt_splice_site_info_stream_new(GtNodeStream *in_stream,
   return gs;
 }
 
+int gt_splice_site_info_stream_enable_threads(GtNodeStream *gs,
+                                              unsigned int nof_threads,
+                                              GtError *err)
+{
+  GtSpliceSiteInfoStream *ssis = gt_splice_site_info_stream_cast(gs);
+  gt_error_check(err);
+  gt_assert(!ssis->parallel_stream);
+  ssis->parallel_stream =
+    gt_parallel_visitor_stream_new(ssis->in_stream, nof_threads,
+                                   gt_splice_site_info_visitor_new_worker,
+                                   ssis->splice_site_info_visitor, err);
+  if (!ssis->parallel_stream)
+    return -1;
+  gt_parallel_visitor_stream_set_merge_func(ssis->parallel_stream,
+                                            ssis->splice_site_info_visitor,
+                                            gt_splice_site_info_visitor_merge);
+  return 0;
+}
+
 bool gt_splice_site_info_stream_show(GtNodeStream *gs)
 {
   GtSpliceSiteInfoStream *ssis;
@@ -30,6 +30,12 @@ const GtNodeStreamClass* gt_splice_site_info_stream_class(void);
 /* create a GtSpliceSiteInfoStream, takes ownership of GtRegionMapping  */
 GtNodeStream*            gt_splice_site_info_stream_new(GtNodeStream*,
                                                      GtRegionMapping*);
+/* process the feature trees in <nof_threads> worker threads, has to be called
+   before the first node is pulled from the stream */
+int                      gt_splice_site_info_stream_enable_threads(
+                                                       GtNodeStream*,
+                                                       unsigned int nof_threads,
+                                                       GtError*);
 /* returns if an intron has been processed, false otherwise */
 bool                     gt_splice_site_info_stream_show(GtNodeStream*);
 
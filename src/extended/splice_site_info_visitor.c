@@ -154,6 +154,38 @@ GtNodeVisitor* gt_splice_site_info_visitor_new(GtRegionMapping *rm)
   return gv;
 }
 
+GtNodeVisitor* gt_splice_site_info_visitor_new_worker(void *ssiv,
+                                                      GtError *err)
+{
+  GtSpliceSiteInfoVisitor *v = splice_site_info_visitor_cast(ssiv);
+  GtRegionMapping *rm;
+  gt_error_check(err);
+  if (!(rm = gt_region_mapping_clone(v->region_mapping, err)))
+    return NULL;
+  return gt_splice_site_info_visitor_new(rm);
+}
+
+static void add_to_string_distri(const char *string, unsigned long occurrences,
+                                 GT_UNUSED double probability, void *data)
+{
+  gt_string_distri_add_multi(data, string, occurrences);
+}
+
+void gt_splice_site_info_visitor_merge(GtNodeVisitor *dest,
+                                       GtNodeVisitor *src)
+{
+  GtSpliceSiteInfoVisitor *d = splice_site_info_visitor_cast(dest),
+                          *s = splice_site_info_visitor_cast(src);
+  gt_string_distri_foreach(s->splicesites, add_to_string_distri,
+                           d->splicesites);
+  gt_string_distri_foreach(s->donorsites, add_to_string_distri,
+                           d->donorsites);
+  gt_string_distri_foreach(s->acceptorsites, add_to_string_distri,
+                           d->acceptorsites);
+  d->show = d->show || s->show;
+  d->intron_processed = d->intron_processed || s->intron_processed;
+}
+
 static void showsplicesite(const char *string, unsigned long occurrences,
                            double probability, GT_UNUSED void *unused)
 {
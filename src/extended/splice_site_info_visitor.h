@@ -28,6 +28,15 @@ typedef struct GtSpliceSiteInfoVisitor GtSpliceSiteInfoVisitor;
 const GtNodeVisitorClass* gt_splice_site_info_visitor_class(void);
 /* takes ownership of <rm> */
 GtNodeVisitor*            gt_splice_site_info_visitor_new(GtRegionMapping *rm);
+/* Return a new visitor with a copy of the region mapping of <ssiv> (for the
+   worker threads of a parallel visitor stream). */
+GtNodeVisitor*            gt_splice_site_info_visitor_new_worker(void *ssiv,
+                                                                 GtError*);
+/* Add the splice sites gathered by <src> to <dest>. */
+void                      gt_splice_site_info_visitor_merge(GtNodeVisitor
+                                                            *dest,
+                                                            GtNodeVisitor
+                                                            *src);
 bool                      gt_splice_site_info_visitor_show(GtNodeVisitor*);
 
 #endif
@@ -19,11 +19,13 @@
 #include "extended/stat_stream.h"
 #include "extended/stat_visitor.h"
 #include "extended/node_stream_api.h"
+#include "extended/parallel_visitor_stream.h"
 
 struct GtStatStream
 {
   const GtNodeStream parent_instance;
-  GtNodeStream *in_stream;
+  GtNodeStream *in_stream,
+               *parallel_stream; /* visits the nodes in worker threads */
   GtNodeVisitor *stat_visitor;
   unsigned long number_of_DAGs;
 };
@@ -37,6 +39,12 @@ static int stat_stream_next(GtNodeStream *gs, GtGenomeNode **gn, GtError *err)
   int had_err;
   gt_error_check(err);
   stat_stream = stat_stream_cast(gs);
+  if (stat_stream->parallel_stream) {
+    had_err = gt_node_stream_next(stat_stream->parallel_stream, gn, err);
+    if (!had_err && *gn)
+      stat_stream->number_of_DAGs++;
+    return had_err;
+  }
   had_err = gt_node_stream_next(stat_stream->in_stream, gn, err);
   if (!had_err) {
     gt_assert(stat_stream->stat_visitor);
@@ -52,6 +60,7 @@ static int stat_stream_next(GtNodeStream *gs, GtGenomeNode **gn, GtError *err)
 static void stat_stream_free(GtNodeStream *gs)
 {
   GtStatStream *stat_stream = stat_stream_cast(gs);
+  gt_node_stream_delete(stat_stream->parallel_stream);
   gt_node_visitor_delete(stat_stream->stat_visitor);
   gt_node_stream_delete(stat_stream->in_stream);
 }
@@ -72,17 +81,37 @@ GtNodeStream* gt_stat_stream_new(GtNodeStream *in_stream,
                                  bool gene_score_distri,
                                  bool exon_length_distri,
                                  bool exon_number_distri,
-                                 bool intron_length_distri)
+                                 bool intron_length_distri,
+                                 bool memory_footprint)
 {
   GtNodeStream *gs = gt_node_stream_create(gt_stat_stream_class(), false);
   GtStatStream *ss = stat_stream_cast(gs);
   ss->in_stream = gt_node_stream_ref(in_stream);
   ss->stat_visitor = gt_stat_visitor_new(gene_length_distri, gene_score_distri,
                                          exon_length_distri, exon_number_distri,
-                                         intron_length_distri);
+                                         intron_length_distri,
+                                         memory_footprint);
   return gs;
 }
 
+int gt_stat_stream_enable_threads(GtNodeStream *gs, unsigned int nof_threads,
+                                  GtError *err)
+{
+  GtStatStream *ss = stat_stream_cast(gs);
+  gt_error_check(err);
+  gt_assert(!ss->parallel_stream);
+  ss->parallel_stream = gt_parallel_visitor_stream_new(ss->in_stream,
+                                                       nof_threads,
+                                                    gt_stat_visitor_new_worker,
+                                                       ss->stat_visitor, err);
+  if (!ss->parallel_stream)
+    return -1;
+  gt_parallel_visitor_stream_set_merge_func(ss->parallel_stream,
+                                            ss->stat_visitor,
+                                            gt_stat_visitor_merge);
+  return 0;
+}
+
 void gt_stat_stream_show_stats(GtNodeStream *gs)
 {
   GtStatStream *ss = stat_stream_cast(gs);
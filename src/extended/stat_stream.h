@@ -31,7 +31,13 @@ GtNodeStream*            gt_stat_stream_new(GtNodeStream*,
                                             bool gene_score_distri,
                                             bool exon_length_distri,
                                             bool exon_number_distri,
-                                            bool intron_length_distri);
+                                            bool intron_length_distri,
+                                            bool memory_footprint);
+/* Compute the statistics in <nof_threads> worker threads. Has to be called
+   before the first node is pulled from the stream. */
+int                      gt_stat_stream_enable_threads(GtNodeStream*,
+                                                       unsigned int nof_threads,
+                                                       GtError*);
 void                     gt_stat_stream_show_stats(GtNodeStream*);
 
 #endif
@@ -18,6 +18,7 @@
 #include "core/assert_api.h"
 #include "core/disc_distri.h"
 #include "core/unused_api.h"
+#include "extended/feature_node.h"
 #include "extended/node_visitor_rep.h"
 #include "extended/stat_visitor.h"
 
@@ -30,8 +31,11 @@ struct GtStatVisitor {
                 number_of_exons,
                 number_of_CDSs,
                 number_of_LTR_retrotransposons,
-                exon_number_for_distri;
-  unsigned long long total_length_of_sequence_regions;
+                exon_number_for_distri,
+                number_of_feature_nodes;
+  unsigned long long total_length_of_sequence_regions,
+                     total_size_of_feature_nodes;
+  bool memory_footprint;
   GtDiscDistri *gene_length_distribution,
              *gene_score_distribution,
              *exon_length_distribution,
@@ -74,6 +78,11 @@ static int compute_statistics(GtGenomeNode *gn, void *data, GtError *err)
   gt_assert(data);
   stat_visitor = (GtStatVisitor*) data;
   gf = (GtFeatureNode*) gn;
+  if (stat_visitor->memory_footprint) {
+    stat_visitor->number_of_feature_nodes++;
+    stat_visitor->total_size_of_feature_nodes +=
+      gt_feature_node_get_memory_footprint(gf);
+  }
   if (gt_feature_node_has_type(gf, gt_ft_gene)) {
     stat_visitor->number_of_genes++;
     if (gt_feature_node_has_CDS(gf))
@@ -166,7 +175,8 @@ GtNodeVisitor* gt_stat_visitor_new(bool gene_length_distri,
                                    bool gene_score_distri,
                                    bool exon_length_distri,
                                    bool exon_number_distri,
-                                   bool intron_length_distri)
+                                   bool intron_length_distri,
+                                   bool memory_footprint)
 {
   GtNodeVisitor *gv = gt_node_visitor_create(gt_stat_visitor_class());
   GtStatVisitor *stat_visitor = stat_visitor_cast(gv);
@@ -180,9 +190,56 @@ GtNodeVisitor* gt_stat_visitor_new(bool gene_length_distri,
     stat_visitor->exon_number_distribution = gt_disc_distri_new();
   if (intron_length_distri)
     stat_visitor->intron_length_distribution = gt_disc_distri_new();
+  stat_visitor->memory_footprint = memory_footprint;
   return gv;
 }
 
+GtNodeVisitor* gt_stat_visitor_new_worker(void *stat_visitor,
+                                          GT_UNUSED GtError *err)
+{
+  GtStatVisitor *sv = stat_visitor_cast(stat_visitor);
+  gt_error_check(err);
+  return gt_stat_visitor_new(sv->gene_length_distribution != NULL,
+                             sv->gene_score_distribution != NULL,
+                             sv->exon_length_distribution != NULL,
+                             sv->exon_number_distribution != NULL,
+                             sv->intron_length_distribution != NULL,
+                             sv->memory_footprint);
+}
+
+static void add_to_distri(unsigned long key, unsigned long long value,
+                          void *data)
+{
+  gt_disc_distri_add_multi(data, key, value);
+}
+
+static void merge_distri(GtDiscDistri *dest, const GtDiscDistri *src)
+{
+  if (src)
+    gt_disc_distri_foreach(src, add_to_distri, dest);
+}
+
+void gt_stat_visitor_merge(GtNodeVisitor *dest, GtNodeVisitor *src)
+{
+  GtStatVisitor *d = stat_visitor_cast(dest),
+                *s = stat_visitor_cast(src);
+  d->number_of_sequence_regions += s->number_of_sequence_regions;
+  d->number_of_genes += s->number_of_genes;
+  d->number_of_protein_coding_genes += s->number_of_protein_coding_genes;
+  d->number_of_mRNAs += s->number_of_mRNAs;
+  d->number_of_exons += s->number_of_exons;
+  d->number_of_CDSs += s->number_of_CDSs;
+  d->number_of_LTR_retrotransposons += s->number_of_LTR_retrotransposons;
+  d->number_of_feature_nodes += s->number_of_feature_nodes;
+  d->total_length_of_sequence_regions += s->total_length_of_sequence_regions;
+  d->total_size_of_feature_nodes += s->total_size_of_feature_nodes;
+  merge_distri(d->gene_length_distribution, s->gene_length_distribution);
+  merge_distri(d->gene_score_distribution, s->gene_score_distribution);
+  merge_distri(d->exon_length_distribution, s->exon_length_distribution);
+  merge_distri(d->exon_number_distribution, s->exon_number_distribution);
+  merge_distri(d->intron_length_distribution, s->intron_length_distribution);
+}
+
 void gt_stat_visitor_show_stats(GtNodeVisitor *gv)
 {
   GtStatVisitor *stat_visitor = stat_visitor_cast(gv);
@@ -207,6 +264,13 @@ void gt_stat_visitor_show_stats(GtNodeVisitor *gv)
     printf("LTR_retrotransposons: %lu\n",
            stat_visitor->number_of_LTR_retrotransposons);
   }
+  if (stat_visitor->number_of_feature_nodes) {
+    printf("feature nodes: %lu (%llu bytes, %.2f bytes per feature)\n",
+           stat_visitor->number_of_feature_nodes,
+           stat_visitor->total_size_of_feature_nodes,
+           (double) stat_visitor->total_size_of_feature_nodes /
+           stat_visitor->number_of_feature_nodes);
+  }
   if (stat_visitor->gene_length_distribution) {
     printf("gene length distribution:\n");
     gt_disc_distri_show(stat_visitor->gene_length_distribution);
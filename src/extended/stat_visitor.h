@@ -28,7 +28,15 @@ GtNodeVisitor*            gt_stat_visitor_new(bool gene_length_distri,
                                               bool gene_score_distri,
                                               bool exon_length_distri,
                                               bool exon_number_distri,
-                                              bool intron_length_distri);
+                                              bool intron_length_distri,
+                                              bool memory_footprint);
+/* Return a new stat visitor with the same settings as <stat_visitor> (for the
+   worker threads of a parallel visitor stream). */
+GtNodeVisitor*            gt_stat_visitor_new_worker(void *stat_visitor,
+                                                     GtError*);
+/* Add the statistics gathered by <src> to <dest>. */
+void                      gt_stat_visitor_merge(GtNodeVisitor *dest,
+                                                GtNodeVisitor *src);
 void                      gt_stat_visitor_show_stats(GtNodeVisitor*);
 
 #endif
@@ -16,131 +16,478 @@
 */
 
 #include <limits.h>
-#include "core/array2dim_api.h"
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "core/alphabet.h"
 #include "core/assert_api.h"
+#include "core/chardef.h"
+#include "core/ensure.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
 #include "core/minmax.h"
 #include "core/undef.h"
 #include "extended/swalign.h"
 
+#ifdef __SSE2__
+/* number of 16-bit lanes in a vector */
+#define SWALIGN_LANES  8
+#define LOAD(P)        _mm_loadu_si128((const __m128i*) (P))
+#define STORE(P, V)    _mm_storeu_si128((__m128i*) (P), V)
+#endif
+
+/* traceback flags of a DP matrix cell */
+#define MAX_REPLACEMENT  1
+#define MAX_DELETION     2
+#define MAX_INSERTION    4
+#define ZERO_SCORE       8
+
 typedef struct {
   unsigned long x,
                 y;
 } Coordinate;
 
-typedef struct {
-  long score;
-  bool max_replacement,
-       max_deletion,
-       max_insertion;
-} DPentry;
-
-static void swalign_fill_table(DPentry **dptable,
-                               const GtUchar *u, unsigned long ulen,
-                               const GtUchar *v, unsigned long vlen,
-                               const int **scores,
-                               int deletion_score, int insertion_score,
-                               Coordinate *max_coordinate)
+struct GtSWAlignProfile {
+  const char *u_orig;
+  GtUchar *u_enc,
+          *v_enc,
+          wildcard; /* the index of wildcards in the score matrix */
+  unsigned long ulen,
+                v_allocated;
+  const int **scores;
+  int deletion_score,
+      insertion_score;
+  long *column; /* one column of the DP matrix */
+#ifdef __SSE2__
+  /* the scores of <u> against each character, in the striped layout: lane
+     <l> of vector <k> belongs to position <l> * <seglen> + <k> of <u> */
+  bool striped;
+  unsigned long seglen;
+  short *profile,
+        *hload,
+        *hstore;
+#endif
+};
+
+/* Copies the encoding of <s> to <dest> with wildcards mapped to the last row
+   of the score matrix. */
+static void swalign_encode(GtUchar *dest, GtSeq *s, GtUchar wildcard)
+{
+  const GtUchar *encoded = gt_seq_get_encoded(s);
+  unsigned long i;
+  for (i = 0; i < gt_seq_length(s); i++)
+    dest[i] = encoded[i] == (GtUchar) WILDCARD ? wildcard : encoded[i];
+}
+
+static const GtUchar* swalign_encode_v(GtSWAlignProfile *p, GtSeq *v)
+{
+  if (gt_seq_length(v) > p->v_allocated) {
+    p->v_allocated = gt_seq_length(v);
+    p->v_enc = gt_realloc(p->v_enc, p->v_allocated * sizeof *p->v_enc);
+  }
+  swalign_encode(p->v_enc, v, p->wildcard);
+  return p->v_enc;
+}
+
+GtSWAlignProfile* gt_swalign_profile_new(GtSeq *u, const GtScoreFunction *sf)
+{
+  GtSWAlignProfile *p;
+  gt_assert(u && gt_seq_length(u) && sf);
+  p = gt_calloc(1, sizeof *p);
+  p->u_orig = gt_seq_get_orig(u);
+  p->ulen = gt_seq_length(u);
+  p->wildcard = gt_alphabet_num_of_chars(gt_seq_get_alphabet(u));
+  p->u_enc = gt_malloc(p->ulen * sizeof *p->u_enc);
+  swalign_encode(p->u_enc, u, p->wildcard);
+  p->scores = gt_score_function_get_scores(sf);
+  p->deletion_score = gt_score_function_get_deletion_score(sf);
+  p->insertion_score = gt_score_function_get_insertion_score(sf);
+  p->column = gt_malloc((p->ulen + 1) * sizeof *p->column);
+#ifdef __SSE2__
+  {
+    unsigned long i, k, l, dimension;
+    unsigned int c, d;
+    int max_score = 0;
+    dimension = gt_alphabet_size(gt_seq_get_alphabet(u));
+    /* the 16-bit lanes can be used if no score can overflow and gaps do not
+       increase the score (otherwise the lazy F loop would not terminate) */
+    p->striped = p->deletion_score <= 0 && p->insertion_score <= 0 &&
+                 p->deletion_score >= SHRT_MIN &&
+                 p->insertion_score >= SHRT_MIN;
+    for (c = 0; p->striped && c < dimension; c++) {
+      for (d = 0; d < dimension; d++) {
+        if (p->scores[c][d] < SHRT_MIN || p->scores[c][d] > SHRT_MAX)
+          p->striped = false;
+        max_score = MAX(max_score, p->scores[c][d]);
+      }
+    }
+    if (p->striped && (double) max_score * p->ulen > SHRT_MAX)
+      p->striped = false;
+    if (p->striped) {
+      p->seglen = (p->ulen + SWALIGN_LANES - 1) / SWALIGN_LANES;
+      p->profile = gt_malloc(dimension * p->seglen * SWALIGN_LANES
+                             * sizeof *p->profile);
+      for (c = 0; c < dimension; c++) {
+        for (k = 0; k < p->seglen; k++) {
+          for (l = 0; l < SWALIGN_LANES; l++) {
+            i = l * p->seglen + k;
+            p->profile[(c * p->seglen + k) * SWALIGN_LANES + l] =
+              i < p->ulen ? p->scores[p->u_enc[i]][c] : SHRT_MIN;
+          }
+        }
+      }
+      p->hload = gt_malloc(p->seglen * SWALIGN_LANES * sizeof *p->hload);
+      p->hstore = gt_malloc(p->seglen * SWALIGN_LANES * sizeof *p->hstore);
+    }
+  }
+#endif
+  return p;
+}
+
+/* Computes the score of an optimal local alignment without traceback, in
+   linear space. The end of the alignment is the first cell with the maximal
+   score in column-major order. */
+static long swalign_score_scalar(GtSWAlignProfile *p, const GtUchar *v,
+                                 unsigned long vlen, Coordinate *end)
 {
   unsigned long i, j;
-  long maxscore, repscore, delscore, insscore, overall_maxscore = LONG_MIN;
-  gt_assert(dptable && u && ulen && v && vlen && max_coordinate);
+  long maxscore, repscore, delscore, insscore, diagscore,
+       overall_maxscore = LONG_MIN;
+  gt_assert(p && v && vlen && end);
+  memset(p->column, 0, (p->ulen + 1) * sizeof *p->column);
   for (j = 1; j <= vlen; j++) {
-    for (i = 1; i <= ulen; i++) {
-      repscore = dptable[i-1][j-1].score + scores[(int) u[i-1]][(int) v[j-1]];
-      delscore = dptable[i-1][j].score + deletion_score;
-      insscore = dptable[i][j-1].score + insertion_score;
+    diagscore = 0;
+    for (i = 1; i <= p->ulen; i++) {
+      repscore = diagscore + p->scores[(int) p->u_enc[i-1]][(int) v[j-1]];
+      delscore = p->column[i-1] + p->deletion_score;
+      insscore = p->column[i] + p->insertion_score;
       maxscore = MAX(MAX(MAX(repscore, delscore), insscore), 0);
-      dptable[i][j].score = maxscore;
-      dptable[i][j].max_replacement = (maxscore == repscore) ? true : false;
-      dptable[i][j].max_deletion    = (maxscore == delscore) ? true : false;
-      dptable[i][j].max_insertion   = (maxscore == insscore) ? true : false;
+      diagscore = p->column[i];
+      p->column[i] = maxscore;
       if (maxscore > overall_maxscore) {
         overall_maxscore = maxscore;
-        max_coordinate->x = i;
-        max_coordinate->y = j;
+        end->x = i;
+        end->y = j;
+      }
+    }
+  }
+  return overall_maxscore;
+}
+
+#ifdef __SSE2__
+static short horizontal_max(__m128i v)
+{
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+  return (short) _mm_extract_epi16(v, 0);
+}
+
+/* Like swalign_score_scalar(), but processes eight cells of a column at once
+   (Farrar's striped Smith-Waterman). */
+static long swalign_score_striped(GtSWAlignProfile *p, const GtUchar *v,
+                                  unsigned long vlen, Coordinate *end)
+{
+  __m128i vzero = _mm_setzero_si128(),
+          vdel = _mm_set1_epi16(p->deletion_score),
+          vins = _mm_set1_epi16(p->insertion_score),
+          vh, vf, vmax;
+  short *hload = p->hload, *hstore = p->hstore, *hswap, colmax;
+  const short *profile;
+  unsigned long i, j, k, seglen = p->seglen;
+  long overall_maxscore = LONG_MIN;
+  gt_assert(p && p->striped && v && vlen && end);
+  memset(hload, 0, seglen * SWALIGN_LANES * sizeof *hload);
+  for (j = 0; j < vlen; j++) {
+    profile = p->profile + v[j] * seglen * SWALIGN_LANES;
+    vf = vzero;
+    vmax = vzero;
+    /* the diagonal predecessor of the first row in each lane is the last row
+       of the previous lane */
+    vh = _mm_slli_si128(LOAD(hload + (seglen - 1) * SWALIGN_LANES), 2);
+    for (k = 0; k < seglen; k++) {
+      vh = _mm_adds_epi16(vh, LOAD(profile + k * SWALIGN_LANES));
+      vh = _mm_max_epi16(vh, _mm_adds_epi16(LOAD(hload + k * SWALIGN_LANES),
+                                            vins));
+      vh = _mm_max_epi16(vh, vf);
+      vh = _mm_max_epi16(vh, vzero);
+      vmax = _mm_max_epi16(vmax, vh);
+      STORE(hstore + k * SWALIGN_LANES, vh);
+      vf = _mm_adds_epi16(vh, vdel);
+      vh = LOAD(hload + k * SWALIGN_LANES);
+    }
+    /* propagate deletions across the lanes until they do not change any cell
+       anymore */
+    vf = _mm_slli_si128(vf, 2);
+    k = 0;
+    while (_mm_movemask_epi8(_mm_cmpgt_epi16(vf, vh = LOAD(hstore + k *
+                                                         SWALIGN_LANES)))) {
+      vh = _mm_max_epi16(vh, vf);
+      vmax = _mm_max_epi16(vmax, vh);
+      STORE(hstore + k * SWALIGN_LANES, vh);
+      vf = _mm_adds_epi16(vf, vdel);
+      if (++k == seglen) {
+        k = 0;
+        vf = _mm_slli_si128(vf, 2);
+      }
+    }
+    /* look for the first row with a new maximum only if there is one */
+    colmax = horizontal_max(vmax);
+    if (colmax > overall_maxscore) {
+      overall_maxscore = colmax;
+      for (i = 0; i < p->ulen; i++) {
+        if (hstore[(i % seglen) * SWALIGN_LANES + i / seglen] == colmax) {
+          end->x = i + 1;
+          end->y = j + 1;
+          break;
+        }
       }
+      gt_assert(i < p->ulen);
     }
+    hswap = hload;
+    hload = hstore;
+    hstore = hswap;
   }
+  return overall_maxscore;
 }
+#endif
 
-static Coordinate traceback(GtAlignment *a, DPentry **dptable,
-                            unsigned long i, unsigned long j)
+static long swalign_score(GtSWAlignProfile *p, const GtUchar *v,
+                          unsigned long vlen, Coordinate *end)
+{
+#ifdef __SSE2__
+  if (p->striped)
+    return swalign_score_striped(p, v, vlen, end);
+#endif
+  return swalign_score_scalar(p, v, vlen, end);
+}
+
+long gt_swalign_profile_score(GtSWAlignProfile *p, GtSeq *v)
+{
+  Coordinate end;
+  gt_assert(p && v && gt_seq_length(v));
+  return swalign_score(p, swalign_encode_v(p, v), gt_seq_length(v), &end);
+}
+
+/* Recomputes the DP matrix up to the alignment end <end> with one byte of
+   traceback flags per cell and adds the operations of the optimal alignment
+   to <a>. Returns the start of the alignment. */
+static Coordinate traceback(GtAlignment *a, GtSWAlignProfile *p,
+                            const GtUchar *v, Coordinate end)
 {
   Coordinate start_coordinate = { GT_UNDEF_ULONG, GT_UNDEF_ULONG };
-  gt_assert(a && dptable);
-  while (dptable[i][j].score) {
-    gt_assert(dptable[i][j].score > 0);
+  unsigned long i, j, rows = end.x, cols = end.y;
+  long maxscore, repscore, delscore, insscore, diagscore;
+  unsigned char *flags, *cell;
+  gt_assert(a && p && v && rows && cols);
+  flags = gt_malloc(rows * cols * sizeof *flags);
+  memset(p->column, 0, (rows + 1) * sizeof *p->column);
+  for (j = 1; j <= cols; j++) {
+    diagscore = 0;
+    for (i = 1; i <= rows; i++) {
+      repscore = diagscore + p->scores[(int) p->u_enc[i-1]][(int) v[j-1]];
+      delscore = p->column[i-1] + p->deletion_score;
+      insscore = p->column[i] + p->insertion_score;
+      maxscore = MAX(MAX(MAX(repscore, delscore), insscore), 0);
+      diagscore = p->column[i];
+      p->column[i] = maxscore;
+      cell = flags + (j-1) * rows + (i-1);
+      *cell = 0;
+      if (maxscore == repscore)
+        *cell |= MAX_REPLACEMENT;
+      if (maxscore == delscore)
+        *cell |= MAX_DELETION;
+      if (maxscore == insscore)
+        *cell |= MAX_INSERTION;
+      if (!maxscore)
+        *cell |= ZERO_SCORE;
+    }
+  }
+  i = rows;
+  j = cols;
+  while (i && j && !((cell = flags + (j-1) * rows + (i-1))[0] & ZERO_SCORE)) {
     start_coordinate.x = i;
     start_coordinate.y = j;
-    if (dptable[i][j].max_replacement) {
+    if (*cell & MAX_REPLACEMENT) {
       gt_alignment_add_replacement(a);
       i--;
       j--;
     }
-    else if (dptable[i][j].max_deletion) {
+    else if (*cell & MAX_DELETION) {
       gt_alignment_add_deletion(a);
-      i--;;
+      i--;
     }
-    else if (dptable[i][j].max_insertion) {
+    else if (*cell & MAX_INSERTION) {
       gt_alignment_add_insertion(a);
       j--;
     }
   }
+  gt_free(flags);
   gt_assert(start_coordinate.x != GT_UNDEF_ULONG);
   gt_assert(start_coordinate.y != GT_UNDEF_ULONG);
   return start_coordinate;
 }
 
-static GtAlignment* smith_waterman_align(const char *u_orig,
-                                         const char *v_orig,
-                                         const GtUchar *u_enc,
-                                         const GtUchar *v_enc,
-                                         unsigned long u_len,
-                                         unsigned long v_len,
-                                         const int **scores,
-                                         int deletion_score,
-                                         int insertion_score)
+GtAlignment* gt_swalign_profile_align(GtSWAlignProfile *p, GtSeq *v,
+                                      long min_score)
 {
-  gt_assert(u_orig && v_orig && u_enc && v_enc && u_len && v_len && scores);
   Coordinate alignment_start,
              alignment_end = { GT_UNDEF_ULONG, GT_UNDEF_ULONG };
+  const GtUchar *v_enc;
+  const char *v_orig;
   GtRange urange, vrange;
-  DPentry **dptable;
-  GtAlignment *a = NULL;
-  gt_array2dim_calloc(dptable, u_len+1, v_len+1);
-  swalign_fill_table(dptable, u_enc, u_len, v_enc, v_len, scores,
-                     deletion_score, insertion_score, &alignment_end);
+  GtAlignment *a;
+  long score;
+  gt_assert(p && v && gt_seq_length(v));
+  v_enc = swalign_encode_v(p, v);
+  v_orig = gt_seq_get_orig(v);
+  score = swalign_score(p, v_enc, gt_seq_length(v), &alignment_end);
   gt_assert(alignment_end.x != GT_UNDEF_ULONG);
   gt_assert(alignment_end.y != GT_UNDEF_ULONG);
-  if (dptable[alignment_end.x][alignment_end.y].score) {
-    /* construct only an alignment if a (positive) score was computed */
-    a = gt_alignment_new();
-    alignment_start = traceback(a, dptable, alignment_end.x, alignment_end.y);
-    /* transform the positions in the DP matrix to sequence positions */
-    urange.start = --alignment_start.x;
-    vrange.start = --alignment_start.y;
-    urange.end = --alignment_end.x;
-    vrange.end = --alignment_end.y;
-    /* employ sequence positions to set alignment sequences */
-    gt_alignment_set_seqs(a,
-                          (const GtUchar *) (u_orig + alignment_start.x),
-                          alignment_end.x - alignment_start.x + 1,
-                          (const GtUchar *) (v_orig + alignment_start.y),
-                          alignment_end.y - alignment_start.y + 1);
-    gt_alignment_set_urange(a, urange);
-    gt_alignment_set_vrange(a, vrange);
-  }
-  gt_array2dim_delete(dptable);
+  /* construct only an alignment if a (positive) score was computed which is
+     good enough */
+  if (!score || score < min_score)
+    return NULL;
+  a = gt_alignment_new();
+  alignment_start = traceback(a, p, v_enc, alignment_end);
+  /* transform the positions in the DP matrix to sequence positions */
+  urange.start = --alignment_start.x;
+  vrange.start = --alignment_start.y;
+  urange.end = --alignment_end.x;
+  vrange.end = --alignment_end.y;
+  /* employ sequence positions to set alignment sequences */
+  gt_alignment_set_seqs(a,
+                        (const GtUchar *) (p->u_orig + alignment_start.x),
+                        alignment_end.x - alignment_start.x + 1,
+                        (const GtUchar *) (v_orig + alignment_start.y),
+                        alignment_end.y - alignment_start.y + 1);
+  gt_alignment_set_urange(a, urange);
+  gt_alignment_set_vrange(a, vrange);
   return a;
 }
 
+void gt_swalign_profile_delete(GtSWAlignProfile *p)
+{
+  if (!p) return;
+#ifdef __SSE2__
+  gt_free(p->hstore);
+  gt_free(p->hload);
+  gt_free(p->profile);
+#endif
+  gt_free(p->column);
+  gt_free(p->v_enc);
+  gt_free(p->u_enc);
+  gt_free(p);
+}
+
 GtAlignment* gt_swalign(GtSeq *u, GtSeq *v, const GtScoreFunction *sf)
 {
+  GtSWAlignProfile *p;
+  GtAlignment *a;
   gt_assert(u && v && sf);
-  return smith_waterman_align(gt_seq_get_orig(u), gt_seq_get_orig(v),
-                              gt_seq_get_encoded(u), gt_seq_get_encoded(v),
-                              gt_seq_length(u), gt_seq_length(v),
-                              gt_score_function_get_scores(sf),
-                              gt_score_function_get_deletion_score(sf),
-                              gt_score_function_get_insertion_score(sf));
+  p = gt_swalign_profile_new(u, sf);
+  a = gt_swalign_profile_align(p, v, 1);
+  gt_swalign_profile_delete(p);
+  return a;
+}
+
+static GtScoreFunction* unit_test_score_function(GtAlphabet *alpha, int match,
+                                                 int mismatch, int indel)
+{
+  GtScoreMatrix *sm = gt_score_matrix_new(alpha);
+  unsigned int c, d;
+  for (c = 0; c < gt_alphabet_size(alpha); c++) {
+    for (d = 0; d < gt_alphabet_size(alpha); d++)
+      gt_score_matrix_set_score(sm, c, d, c == d ? match : mismatch);
+  }
+  return gt_score_function_new(sm, indel, indel);
+}
+
+int gt_swalign_unit_test(GtError *err)
+{
+  static const int parameters[][3] = { { 2, -1, -1 },
+                                       { 5, -10, -20 },
+                                       { 1, -3, 0 },
+                                       { 3, -2, -4 } };
+  static const char *dna = "acgt";
+  char useq[130], vseq[90];
+  GtAlphabet *alpha;
+  GtScoreFunction *sf;
+  GtSWAlignProfile *p;
+  GtSeq *u, *v;
+  GtAlignment *a;
+  Coordinate end, scalar_end;
+  GtRange urange;
+  unsigned long i, t, ulen, vlen, pi;
+  long score;
+  int had_err = 0;
+  gt_error_check(err);
+
+  alpha = gt_alphabet_new_dna();
+
+  /* a known alignment */
+  sf = unit_test_score_function(alpha, 5, -10, -20);
+  u = gt_seq_new("aaaacgtacgtaaaa", 15, alpha);
+  v = gt_seq_new("ggggcgtacgtgggg", 15, alpha);
+  p = gt_swalign_profile_new(u, sf);
+  ensure(had_err, gt_swalign_profile_score(p, v) == 35);
+  ensure(had_err, !gt_swalign_profile_align(p, v, 36));
+  a = gt_swalign_profile_align(p, v, 35);
+  ensure(had_err, a != NULL);
+  if (!had_err) {
+    urange = gt_alignment_get_urange(a);
+    ensure(had_err, urange.start == 4 && urange.end == 10);
+    urange = gt_alignment_get_vrange(a);
+    ensure(had_err, urange.start == 4 && urange.end == 10);
+    ensure(had_err, gt_alignment_eval(a) == 0);
+  }
+  gt_alignment_delete(a);
+  gt_swalign_profile_delete(p);
+  gt_seq_delete(v);
+  gt_seq_delete(u);
+  gt_score_function_delete(sf);
+
+  /* the striped computation has to find the same scores and alignment ends as
+     the scalar one */
+  for (pi = 0; !had_err && pi < sizeof parameters / sizeof parameters[0];
+       pi++) {
+    sf = unit_test_score_function(alpha, parameters[pi][0], parameters[pi][1],
+                                  parameters[pi][2]);
+    for (t = 0; !had_err && t < 100; t++) {
+      ulen = 1 + gt_rand_max(sizeof useq - 1);
+      vlen = 1 + gt_rand_max(sizeof vseq - 1);
+      /* with some wildcards, which have their own row in the score matrix */
+      for (i = 0; i < ulen; i++)
+        useq[i] = gt_rand_max(50) ? dna[gt_rand_max(3)] : 'n';
+      /* take parts of <u> to get good alignments */
+      for (i = 0; i < vlen; i++) {
+        vseq[i] = gt_rand_max(3) ? useq[(i + t) % ulen]
+                                 : dna[gt_rand_max(3)];
+      }
+      u = gt_seq_new(useq, ulen, alpha);
+      v = gt_seq_new(vseq, vlen, alpha);
+      p = gt_swalign_profile_new(u, sf);
+      score = swalign_score(p, swalign_encode_v(p, v), vlen, &end);
+      ensure(had_err, score == swalign_score_scalar(p, p->v_enc, vlen,
+                                                    &scalar_end));
+      ensure(had_err, end.x == scalar_end.x && end.y == scalar_end.y);
+      if (!had_err && score) {
+        a = gt_swalign_profile_align(p, v, score);
+        ensure(had_err, a != NULL);
+        if (!had_err) {
+          urange = gt_alignment_get_urange(a);
+          ensure(had_err, urange.end == end.x - 1);
+        }
+        gt_alignment_delete(a);
+      }
+      gt_swalign_profile_delete(p);
+      gt_seq_delete(v);
+      gt_seq_delete(u);
+    }
+    gt_score_function_delete(sf);
+  }
+
+  gt_alphabet_delete(alpha);
+  return had_err;
 }
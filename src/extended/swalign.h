@@ -18,6 +18,7 @@
 #ifndef SWALIGN_H
 #define SWALIGN_H
 
+#include "core/error.h"
 #include "core/score_function.h"
 #include "core/seq.h"
 #include "extended/alignment.h"
@@ -25,6 +26,28 @@
 /* (locally) align <u> and <v> (Smith-Waterman algorithm ) with the given score
    function and return one optimal Alignment.
    If no such alignment was found, NULL is returned. */
-GtAlignment* gt_swalign(GtSeq *u, GtSeq *v, const GtScoreFunction*);
+GtAlignment*      gt_swalign(GtSeq *u, GtSeq *v, const GtScoreFunction*);
+
+/* A <GtSWAlignProfile> holds the scores of a sequence <u> against every
+   character of the alphabet, to align <u> locally with many other sequences.
+   The score-only pass processes eight cells at once if SSE2 is available and
+   no score can overflow 16 bits. The traceback is done only for alignments
+   which are good enough. A profile must not be used by several threads at
+   once. <u> and the score function must stay valid while it is used. */
+typedef struct GtSWAlignProfile GtSWAlignProfile;
+
+GtSWAlignProfile* gt_swalign_profile_new(GtSeq *u, const GtScoreFunction*);
+/* Return the score of an optimal local alignment of the sequence of
+   <profile> and <v>, without constructing it. */
+long              gt_swalign_profile_score(GtSWAlignProfile *profile,
+                                           GtSeq *v);
+/* Like <gt_swalign()> for the sequence of <profile> and <v>, but NULL is also
+   returned (without any traceback) if the optimal score is below
+   <min_score>. */
+GtAlignment*      gt_swalign_profile_align(GtSWAlignProfile *profile,
+                                           GtSeq *v, long min_score);
+void              gt_swalign_profile_delete(GtSWAlignProfile*);
+
+int               gt_swalign_unit_test(GtError*);
 
 #endif
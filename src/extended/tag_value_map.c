@@ -87,6 +87,12 @@ static size_t get_map_len(const GtTagValueMap map)
   return map_ptr - map - 1;
 }
 
+size_t gt_tag_value_map_size(const GtTagValueMap map)
+{
+  gt_assert(map);
+  return get_map_len(map) + 1;
+}
+
 void gt_tag_value_map_add(GtTagValueMap *map, const char *tag,
                           const char *value)
 {
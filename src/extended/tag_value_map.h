@@ -47,6 +47,8 @@ void          gt_tag_value_map_foreach(const GtTagValueMap,
                                        GtTagValueMapIteratorFunc,
                                        void *data);
 void          gt_tag_value_map_show(const GtTagValueMap);
+/* Return the number of bytes occupied by the given map. */
+size_t        gt_tag_value_map_size(const GtTagValueMap);
 int           gt_tag_value_map_example(GtError*);
 int           gt_tag_value_map_unit_test(GtError*);
 
@@ -127,6 +127,31 @@ static int diagram_lua_new_from_array(lua_State *L)
   return 1;
 }
 
+static int diagram_lua_update(lua_State *L)
+{
+  GtDiagram **diagram;
+  GtFeatureIndex **feature_index;
+  GtRange *range;
+  GtError *err;
+  const char *seqid;
+  int had_err;
+  diagram = check_diagram(L, 1);
+  /* get feature index */
+  feature_index = check_feature_index(L, 2);
+  /* get seqid */
+  seqid = luaL_checkstring(L, 3);
+  luaL_argcheck(L, gt_feature_index_has_seqid(*feature_index, seqid),
+                3, "feature index does not contain the given sequence id");
+  /* get range */
+  range = check_range(L, 4);
+  err = gt_error_new();
+  had_err = gt_diagram_update(*diagram, *feature_index, seqid, range, err);
+  if (had_err)
+    return gt_lua_error(L, err);
+  gt_error_delete(err);
+  return 0;
+}
+
 static int diagram_lua_delete(lua_State *L)
 {
   GtDiagram **diagram;
@@ -142,6 +167,7 @@ static const struct luaL_Reg diagram_lib_f [] = {
 };
 
 static const struct luaL_Reg diagram_lib_m [] = {
+  { "update", diagram_lua_update },
   { NULL, NULL }
 };
 
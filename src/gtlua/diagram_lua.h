@@ -31,6 +31,12 @@
    -- <array>. The range from <startpos> to <endpos> determines the visible
    -- region and should include the nodes in <array>.
    function diagram_new_from_array(array, startpos, endpos)
+
+   -- Change the <diagram> to contain the genome nodes given in
+   -- <feature_index> in the given <range> of the sequence region with sequence
+   -- ID <seqid>. When panning (i.e., <range> has the same length as before),
+   -- the parts of the diagram which are still completely visible are reused.
+   function diagram:update(feature_index, seqid, range)
 */
 int gt_lua_open_diagram(lua_State*);
 
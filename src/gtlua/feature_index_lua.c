@@ -18,6 +18,7 @@
 #ifndef WITHOUT_CAIRO
 
 #include "lauxlib.h"
+#include "annotationsketch/feature_index_file_api.h"
 #include "annotationsketch/feature_index_memory_api.h"
 #include "extended/luahelper.h"
 #include "gtlua/feature_index_lua.h"
@@ -35,6 +36,30 @@ static int feature_index_memory_lua_new(lua_State *L)
   return 1;
 }
 
+static int feature_index_file_lua_new(lua_State *L)
+{
+  GtFeatureIndex **feature_index;
+  const char *filename;
+  lua_Integer cache_size = 0;
+  GtError *err;
+  filename = luaL_checkstring(L, 1);
+  if (!lua_isnoneornil(L, 2)) {
+    cache_size = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, cache_size >= 0, 2, "cache size must be >= 0");
+  }
+  feature_index = lua_newuserdata(L, sizeof (GtFeatureIndex*));
+  gt_assert(feature_index);
+  err = gt_error_new();
+  if (!(*feature_index = gt_feature_index_file_new(filename, err)))
+    return gt_lua_error(L, err);
+  gt_error_delete(err);
+  if (!lua_isnoneornil(L, 2))
+    gt_feature_index_file_set_cache_size(*feature_index, cache_size);
+  luaL_getmetatable(L, FEATURE_INDEX_METATABLE);
+  lua_setmetatable(L, -2);
+  return 1;
+}
+
 static int feature_index_lua_add_region_node(lua_State *L)
 {
   GtFeatureIndex **fi;
@@ -91,8 +116,8 @@ static void push_features_as_table(lua_State *L, GtArray *features)
     lua_newtable(L);
     for (i = 0; i < gt_array_size(features); i++) {
       lua_pushinteger(L, i+1); /* in Lua we index from 1 on */
-      gt_lua_genome_node_push(L, gt_genome_node_ref(*(GtGenomeNode**)
-                                                  gt_array_get(features, i)));
+      /* the references of the results are handed over to Lua */
+      gt_lua_genome_node_push(L, *(GtGenomeNode**) gt_array_get(features, i));
       lua_rawset(L, -3);
     }
   }
@@ -119,6 +144,7 @@ static int feature_index_lua_get_features_for_range(lua_State *L)
   const char *seqid;
   GtRange *range;
   GtArray *features;
+  GtError *err;
   int had_err;
   feature_index = check_feature_index(L, 1);
   seqid = luaL_checkstring(L, 2);
@@ -126,10 +152,16 @@ static int feature_index_lua_get_features_for_range(lua_State *L)
                 "feature_index does not contain seqid");
   range = check_range(L, 3);
   features = gt_array_new(sizeof (GtGenomeNode*));
+  err = gt_error_new();
   had_err = gt_feature_index_get_features_for_range(*feature_index, features,
-                                                    seqid, range, NULL);
-  gt_assert(!had_err); /* it was checked before that the feature_index contains
-                          the given sequence id*/
+                                                    seqid, range, err);
+  if (had_err) {
+    /* it was checked before that the feature_index contains the given sequence
+       id, but file based indices can be corrupt */
+    gt_array_delete(features);
+    return gt_lua_error(L, err);
+  }
+  gt_error_delete(err);
   push_features_as_table(L, features);
   gt_array_delete(features);
   return 1;
@@ -183,6 +215,7 @@ static int feature_index_lua_delete(lua_State *L)
 
 static const struct luaL_Reg feature_index_lib_f [] = {
   { "feature_index_memory_new", feature_index_memory_lua_new },
+  { "feature_index_file_new", feature_index_file_lua_new },
   { NULL, NULL }
 };
 
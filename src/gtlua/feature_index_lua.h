@@ -25,6 +25,11 @@
    -- Returns a new FeatureIndex object storing the index in memory.
    function feature_index_memory_new()
 
+   -- Returns a new FeatureIndex object reading the features from the binary
+   -- annotation file <filename> on demand. At most <cache_size> of the feature
+   -- trees read are cached for later queries (default: 1024).
+   function feature_index_file_new(filename, cache_size)
+
    -- Add all features from all sequence regions contained in <gff3file> to
    -- <feature_index>.
    function feature_index:add_gff3file(gff3file)
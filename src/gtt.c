@@ -16,10 +16,12 @@
 */
 
 #include "gtt.h"
+#include "core/arena.h"
 #include "core/array.h"
 #include "core/array2dim_api.h"
 #include "core/array3dim.h"
 #include "core/basename_api.h"
+#include "core/bioseq.h"
 #include "core/bitpackarray.h"
 #include "core/bitpackstring.h"
 #include "core/bittab.h"
@@ -30,13 +32,16 @@
 #include "core/dlist.h"
 #include "core/dynbittab.h"
 #include "core/grep_api.h"
+#include "core/gzip_block_writer.h"
 #include "core/hashmap.h"
 #include "core/hashtable.h"
+#include "core/implicit_interval_tree.h"
 #include "core/interval_tree.h"
 #include "core/quality.h"
 #include "core/queue.h"
 #include "core/sequence_buffer.h"
 #include "core/splitter.h"
+#include "core/thread.h"
 #include "core/tokenizer.h"
 #include "core/translator.h"
 #include "extended/alignment.h"
@@ -45,10 +50,12 @@
 #include "extended/feature_node.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_escaping.h"
+#include "extended/gff3_output.h"
 #include "extended/hmm.h"
 #include "extended/luaserialize.h"
 #include "extended/splicedseq.h"
 #include "extended/string_matching.h"
+#include "extended/swalign.h"
 #include "extended/tag_value_map.h"
 #include "extended/redblack.h"
 #include "ltr/gt_ltrdigest.h"
@@ -101,6 +108,7 @@
 #include "annotationsketch/block.h"
 #include "annotationsketch/diagram.h"
 #include "annotationsketch/feature_index.h"
+#include "annotationsketch/feature_index_file.h"
 #include "annotationsketch/feature_index_memory.h"
 #include "annotationsketch/gt_sketch.h"
 #include "annotationsketch/gt_sketch_page.h"
@@ -108,6 +116,7 @@
 #include "annotationsketch/track.h"
 #include "annotationsketch/rec_map.h"
 #include "annotationsketch/style.h"
+#include "annotationsketch/text_width_cache.h"
 #endif
 
 GtToolbox* gtt_tools(void)
@@ -171,6 +180,7 @@ GtHashmap* gtt_unit_tests(void)
 
   /* add unit tests */
   gt_hashmap_add(unit_tests, "alignment class", gt_alignment_unit_test);
+  gt_hashmap_add(unit_tests, "arena class", gt_arena_unit_test);
   gt_hashmap_add(unit_tests, "array class", gt_array_unit_test);
   gt_hashmap_add(unit_tests, "array example", gt_array_example);
   gt_hashmap_add(unit_tests, "array2dim example", gt_array2dim_example);
@@ -179,6 +189,7 @@ GtHashmap* gtt_unit_tests(void)
   gt_hashmap_add(unit_tests, "bit pack array class", gt_bitpackarray_unit_test);
   gt_hashmap_add(unit_tests, "bit pack string module",
                  gt_bitPackString_unit_test);
+  gt_hashmap_add(unit_tests, "bioseq class", gt_bioseq_unit_test);
   gt_hashmap_add(unit_tests, "bittab class", gt_bittab_unit_test);
   gt_hashmap_add(unit_tests, "bittab example", gt_bittab_example);
   gt_hashmap_add(unit_tests, "bsearch module", gt_bsearch_unit_test);
@@ -193,12 +204,17 @@ GtHashmap* gtt_unit_tests(void)
                  gt_feature_node_iterator_example);
   gt_hashmap_add(unit_tests, "feature node class", gt_feature_node_unit_test);
   gt_hashmap_add(unit_tests, "genome node class", gt_genome_node_unit_test);
+  gt_hashmap_add(unit_tests, "gff3 output module", gt_gff3_output_unit_test);
   gt_hashmap_add(unit_tests, "gff3 escaping module",
                  gt_gff3_escaping_unit_test);
   gt_hashmap_add(unit_tests, "grep module", gt_grep_unit_test);
+  gt_hashmap_add(unit_tests, "gzip block writer class",
+                 gt_gzip_block_writer_unit_test);
   gt_hashmap_add(unit_tests, "hashmap class", gt_hashmap_unit_test);
   gt_hashmap_add(unit_tests, "hashtable class", gt_hashtable_unit_test);
   gt_hashmap_add(unit_tests, "hmm class", gt_hmm_unit_test);
+  gt_hashmap_add(unit_tests, "implicit interval tree class",
+                 gt_implicit_interval_tree_unit_test);
   gt_hashmap_add(unit_tests, "interval tree class", gt_interval_tree_unit_test);
   gt_hashmap_add(unit_tests, "Lua serializer module",
                  gt_lua_serializer_unit_test);
@@ -215,21 +231,28 @@ GtHashmap* gtt_unit_tests(void)
                  gt_sequence_buffer_unit_test);
   gt_hashmap_add(unit_tests, "splicedseq class", gt_splicedseq_unit_test);
   gt_hashmap_add(unit_tests, "splitter class", gt_splitter_unit_test);
+  gt_hashmap_add(unit_tests, "Smith-Waterman alignment module",
+                 gt_swalign_unit_test);
   gt_hashmap_add(unit_tests, "string class", gt_str_unit_test);
   gt_hashmap_add(unit_tests, "string matching module",
                  gt_string_matching_unit_test);
   gt_hashmap_add(unit_tests, "tag value map class", gt_tag_value_map_unit_test);
   gt_hashmap_add(unit_tests, "tag value map example", gt_tag_value_map_example);
+  gt_hashmap_add(unit_tests, "thread module", gt_thread_unit_test);
   gt_hashmap_add(unit_tests, "tokenizer class", gt_tokenizer_unit_test);
   gt_hashmap_add(unit_tests, "translator class", gt_translator_unit_test);
 #ifndef WITHOUT_CAIRO
   gt_hashmap_add(unit_tests, "block class", gt_block_unit_test);
   gt_hashmap_add(unit_tests, "style class", gt_style_unit_test);
   gt_hashmap_add(unit_tests, "element class", gt_element_unit_test);
+  gt_hashmap_add(unit_tests, "file feature index class",
+                 gt_feature_index_file_unit_test);
   gt_hashmap_add(unit_tests, "memory feature index class",
                  gt_feature_index_memory_unit_test);
   gt_hashmap_add(unit_tests, "imageinfo class", gt_image_info_unit_test);
   gt_hashmap_add(unit_tests, "line class", gt_line_unit_test);
+  gt_hashmap_add(unit_tests, "text width cache class",
+                 gt_text_width_cache_unit_test);
   gt_hashmap_add(unit_tests, "track class", gt_track_unit_test);
 #endif
 
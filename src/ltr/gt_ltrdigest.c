@@ -44,7 +44,8 @@ typedef struct GtLTRdigestOptions {
   bool verbose;
   GtOutputFileInfo *ofi;
   GtFile *outfp;
-  unsigned int seqnamelen;
+  unsigned int seqnamelen,
+               nof_threads;
 } GtLTRdigestOptions;
 
 static void* gt_ltrdigest_arguments_new(void)
@@ -317,6 +318,15 @@ static GtOptionParser* gt_ltrdigest_option_parser_new(void *tool_arguments)
   gt_option_is_extended_option(o);
   gt_option_imply(o, ot);
 
+  /* -elemthreads */
+
+  o = gt_option_new_uint_min("elemthreads",
+                             "number of worker threads which process the LTR "
+                             "elements",
+                             &arguments->nof_threads,
+                             1, 1);
+  gt_option_parser_add_option(op, o);
+
   /* verbosity */
 
   o = gt_option_new_verbose(&arguments->verbose);
@@ -439,6 +449,13 @@ static int gt_ltrdigest_runner(GT_UNUSED int argc, const char **argv,
       had_err = -1;
   }
 
+  if (!had_err && arguments->nof_threads > 1)
+  {
+    had_err = gt_ltrdigest_stream_enable_threads(ltrdigest_stream,
+                                                 arguments->nof_threads,
+                                                 err);
+  }
+
   if (!had_err)
   {
     /* attach tabular output stream, if requested */
@@ -25,6 +25,8 @@
 #include "extended/node_stream_api.h"
 #include "extended/feature_node.h"
 #include "extended/feature_node_iterator_api.h"
+#include "extended/node_visitor_rep.h"
+#include "extended/parallel_visitor_stream.h"
 #include "extended/reverse.h"
 #include "ltr/ltrdigest_def.h"
 #include "ltr/ltrdigest_stream.h"
@@ -32,39 +34,55 @@
 
 struct GtLTRdigestStream {
   const GtNodeStream parent_instance;
-  GtNodeStream *in_stream;
+  GtNodeStream *in_stream,
+               *parallel_stream; /* processes the elements in worker threads */
+  GtNodeVisitor *visitor;
   Encodedsequence *encseq;
   GtPBSOptions *pbs_opts;
+  GtPBSFinder *pbf;
   GtPPTOptions *ppt_opts;
+  GtPPTFinder *ppf;
 #ifdef HAVE_HMMER
   GtPdomFinder *pdf;
   GtPdomOptions *pdom_opts;
 #endif
-  GtLTRVisitor *lv;
   GtStr *ltrdigest_tag;
   int tests_to_run;
-  GtLTRElement element;
 };
 
+/* Annotates one LTR element. The finders and options of the stream are only
+   read, so that every worker thread can use a visitor of its own. */
+typedef struct {
+  const GtNodeVisitor parent_instance;
+  GtLTRdigestStream *ls;
+  GtLTRVisitor *lv;
+  GtLTRElement element;
+} LTRdigestVisitor;
+
 #define GT_ALIWIDTH 60
 
 #define gt_ltrdigest_stream_cast(GS)\
         gt_node_stream_cast(gt_ltrdigest_stream_class(), GS)
 
+#define ltrdigest_visitor_cast(GV)\
+        gt_node_visitor_cast(ltrdigest_visitor_class(), GV)
+
+static const GtNodeVisitorClass* ltrdigest_visitor_class(void);
+
 #ifdef HAVE_HMMER
 static int pdom_hit_attach_gff3(GtPdomModel *model, GtPdomModelHit *hit,
                                 void *data, GT_UNUSED GtError *err)
 {
   unsigned long i;
   GtRange rng;
-  GtLTRdigestStream *ls = (GtLTRdigestStream *) data;
+  LTRdigestVisitor *v = (LTRdigestVisitor*) data;
   GtStrand strand;
   gt_assert(model && hit);
 
   strand = gt_pdom_model_hit_get_best_strand(hit);
   /* do not use the hits on the non-predicted strand
       -- maybe identify nested elements ? */
-  if (strand != gt_feature_node_get_strand(ls->element.mainnode))
+  if (strand != gt_feature_node_get_strand(v->element.mainnode))
     return 0;
 
   for (i=0;i<gt_pdom_model_hit_best_chain_length(hit);i++)
@@ -87,7 +105,7 @@ static int pdom_hit_attach_gff3(GtPdomModel *model, GtPdomModelHit *hit,
 
     rng.start++; rng.end++;  /* GFF3 is 1-based */
     gf = gt_feature_node_new(gt_genome_node_get_seqid((GtGenomeNode*)
-                                                      ls->element.mainnode),
+                                                      v->element.mainnode),
                              GT_PDOM_TYPE,
                              rng.start,
                              rng.end,
@@ -96,7 +114,7 @@ static int pdom_hit_attach_gff3(GtPdomModel *model, GtPdomModelHit *hit,
                                  alignmentstring, (GtFree) gt_str_delete);
     gt_genome_node_add_user_data((GtGenomeNode*) gf, "pdom_aaseq",
                                  aastring, (GtFree) gt_str_delete);
-    gt_feature_node_set_source((GtFeatureNode*) gf, ls->ltrdigest_tag);
+    gt_feature_node_set_source((GtFeatureNode*) gf, v->ls->ltrdigest_tag);
     gt_feature_node_set_score((GtFeatureNode*) gf,
                               gt_pdom_single_hit_get_evalue(singlehit));
     gt_feature_node_set_phase((GtFeatureNode*) gf, frame);
@@ -104,7 +122,7 @@ static int pdom_hit_attach_gff3(GtPdomModel *model, GtPdomModelHit *hit,
                                   gt_pdom_model_get_name(model));
     gt_feature_node_add_attribute((GtFeatureNode*) gf,"pfamid",
                                   gt_pdom_model_get_acc(model));
-    gt_feature_node_add_child(ls->element.mainnode, (GtFeatureNode*) gf);
+    gt_feature_node_add_child(v->element.mainnode, (GtFeatureNode*) gf);
   }
   return 0;
 }
@@ -198,7 +216,7 @@ static void ppt_attach_results_to_gff3(GtPPTResults *results,
 }
 
 static int run_ltrdigest(GtLTRElement *element, char *seq,
-                         GtLTRdigestStream *ls,
+                         LTRdigestVisitor *v,
 #ifdef HAVE_HMMER
                          GtError *err)
 #else
@@ -209,6 +227,7 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
   char *rev_seq;
   unsigned long seqlen = gt_ltrelement_length(element);
   GtStrand canonical_strand = GT_STRAND_UNKNOWN;
+  GtLTRdigestStream *ls = v->ls;
 
   /* create reverse strand sequence */
   rev_seq = gt_calloc(seqlen+1, sizeof (char));
@@ -230,6 +249,8 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
         had_err = -1;
       } else
       {
+        /* the pdom finder can be used by several element threads at once,
+           their searches are scheduled on its worker pool */
         pdom_results = gt_pdom_finder_find(ls->pdf, (const char*) seq,
                                            (const char*) rev_seq, element, err);
         if (!pdom_results)
@@ -245,11 +266,11 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
               canonical_strand = GT_STRAND_FORWARD;
             else
               canonical_strand = GT_STRAND_REVERSE;
-            gt_feature_node_set_strand(ls->element.mainnode, canonical_strand);
+            gt_feature_node_set_strand(element->mainnode, canonical_strand);
             /* create nodes for protein match annotations */
             (void) gt_pdom_results_foreach_domain_hit(pdom_results,
                                                       pdom_hit_attach_gff3,
-                                                      ls,
+                                                      v,
                                                       err);
           }
           gt_pdom_results_delete(pdom_results);
@@ -263,8 +284,8 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
     if (ls->tests_to_run & GT_LTRDIGEST_RUN_PPT)
     {
       GtPPTResults *ppt_results = NULL;
-      ppt_results = gt_ppt_find((const char*) seq, (const char*) rev_seq,
-                              element, ls->ppt_opts);
+      ppt_results = gt_ppt_finder_find(ls->ppf, (const char*) seq,
+                                       (const char*) rev_seq, element);
       if (gt_ppt_results_get_number_of_hits(ppt_results) > 0)
       {
         ppt_attach_results_to_gff3(ppt_results, element, &canonical_strand,
@@ -278,8 +299,8 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
     if (ls->tests_to_run & GT_LTRDIGEST_RUN_PBS)
     {
       GtPBSResults *pbs_results = NULL;
-      pbs_results = gt_pbs_find((const char*) seq, (const char*) rev_seq,
-                                element, ls->pbs_opts, err);
+      pbs_results = gt_pbs_finder_find(ls->pbf, (const char*) seq,
+                                       (const char*) rev_seq, element, err);
        if (gt_pbs_results_get_number_of_hits(pbs_results) > 0)
        {
         pbs_attach_results_to_gff3(pbs_results, element, &canonical_strand,
@@ -292,47 +313,38 @@ static int run_ltrdigest(GtLTRElement *element, char *seq,
   return had_err;
 }
 
-static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
-                                    GtError *e)
+static int ltrdigest_visitor_feature_node(GtNodeVisitor *gv,
+                                          GtFeatureNode *fn, GtError *e)
 {
+  LTRdigestVisitor *v;
   GtLTRdigestStream *ls;
-  GtFeatureNode *fn;
-  int had_err;
+  GtFeatureNodeIterator *gni;
+  GtFeatureNode *mygn;
+  int had_err = 0;
 
   gt_error_check(e);
-  ls = gt_ltrdigest_stream_cast(gs);
+  v = ltrdigest_visitor_cast(gv);
+  ls = v->ls;
 
   /* initialize this element */
-  memset(&ls->element, 0, sizeof (GtLTRElement));
+  memset(&v->element, 0, sizeof (GtLTRElement));
 
-  /* get annotations from parser */
-  had_err = gt_node_stream_next(ls->in_stream, gn, e);
-  if (!had_err && *gn)
-  {
-    GtFeatureNodeIterator *gni;
-    GtFeatureNode *mygn;
-
-   /* only process feature nodes */
-   if (!(fn = gt_feature_node_try_cast(*gn)))
-     return 0;
-
-    /* fill LTRElement structure from GFF3 subgraph */
-    gni = gt_feature_node_iterator_new(fn);
-    for (mygn = fn; mygn; mygn = gt_feature_node_iterator_next(gni))
-      (void) gt_genome_node_accept((GtGenomeNode*) mygn,
-                                   (GtNodeVisitor*) ls->lv,
-                                   e);
-    gt_feature_node_iterator_delete(gni);
-  }
+  /* fill LTRElement structure from GFF3 subgraph */
+  gni = gt_feature_node_iterator_new(fn);
+  for (mygn = fn; mygn; mygn = gt_feature_node_iterator_next(gni))
+    (void) gt_genome_node_accept((GtGenomeNode*) mygn,
+                                 (GtNodeVisitor*) v->lv,
+                                 e);
+  gt_feature_node_iterator_delete(gni);
 
-  if (ls->element.mainnode)
+  if (v->element.mainnode)
   {
     unsigned long seqid;
     const char *sreg;
     char *seq;
 
     sreg = gt_str_get(gt_genome_node_get_seqid((GtGenomeNode*)
-                                               ls->element.mainnode));
+                                               v->element.mainnode));
 
     /* we assume that this is the correct numbering! */
     if (!sscanf(sreg,"seq%lu", &seqid))
@@ -340,11 +352,11 @@ static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
       gt_error_set(e, "Feature '%s' on line %u has invalid region identifier,"
                       "must be 'seqX' with X being a sequence number, but was "
                       "'%s'!",
-                      gt_feature_node_get_attribute(ls->element.mainnode, "ID"),
+                      gt_feature_node_get_attribute(v->element.mainnode, "ID"),
                       gt_genome_node_get_line_number((GtGenomeNode*)
-                                                      ls->element.mainnode),
+                                                      v->element.mainnode),
                       gt_str_get(gt_genome_node_get_seqid((GtGenomeNode*)
-                                                      ls->element.mainnode)));
+                                                      v->element.mainnode)));
 
       had_err = -1;
     }
@@ -365,22 +377,22 @@ static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
 
       getencseqSeqinfo(&seqinfo, ls->encseq, seqid);
 
-      if (ls->element.rightLTR_3 <= seqinfo.seqlength)
+      if (v->element.rightLTR_3 <= seqinfo.seqlength)
       {
         alpha        = getencseqAlphabet(ls->encseq);
-        length       = gt_ltrelement_length(&ls->element);
+        length       = gt_ltrelement_length(&v->element);
         seq          = gt_malloc((length+1) * sizeof (char));
         symbolstring = gt_malloc((length+1) * sizeof (GtUchar));
         encseqextract(symbolstring,
                       ls->encseq,
-                      seqinfo.seqstartpos + (ls->element.leftLTR_5),
-                      seqinfo.seqstartpos + (ls->element.leftLTR_5)
+                      seqinfo.seqstartpos + (v->element.leftLTR_5),
+                      seqinfo.seqstartpos + (v->element.leftLTR_5)
                         + length - 1);
         gt_alphabet_sprintf_symbolstring(alpha, seq, symbolstring, length);
         gt_free(symbolstring);
 
         /* run LTRdigest core routine */
-        had_err = run_ltrdigest(&ls->element, seq, ls, e);
+        had_err = run_ltrdigest(&v->element, seq, v, e);
 
         gt_free(seq);
       }
@@ -389,12 +401,62 @@ static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
         /* do not process elements whose positions exceed sequence boundaries
          (obviously annotation and sequence do not match!) */
         gt_error_set(e, "Element '%s' exceeds sequence boundaries! (%lu > %lu)",
-          gt_feature_node_get_attribute(ls->element.mainnode, "ID"),
-          ls->element.rightLTR_3, (unsigned long) seqinfo.seqlength);
+          gt_feature_node_get_attribute(v->element.mainnode, "ID"),
+          v->element.rightLTR_3, (unsigned long) seqinfo.seqlength);
         had_err = -1;
       }
     }
   }
+  return had_err;
+}
+
+static void ltrdigest_visitor_free(GtNodeVisitor *gv)
+{
+  LTRdigestVisitor *v = ltrdigest_visitor_cast(gv);
+  gt_node_visitor_delete((GtNodeVisitor*) v->lv);
+}
+
+static const GtNodeVisitorClass* ltrdigest_visitor_class(void)
+{
+  static const GtNodeVisitorClass *gvc = NULL;
+  if (!gvc) {
+    gvc = gt_node_visitor_class_new(sizeof (LTRdigestVisitor),
+                                    ltrdigest_visitor_free,
+                                    NULL,
+                                    ltrdigest_visitor_feature_node,
+                                    NULL,
+                                    NULL);
+  }
+  return gvc;
+}
+
+static GtNodeVisitor* ltrdigest_visitor_new(void *ls, GT_UNUSED GtError *err)
+{
+  GtNodeVisitor *gv;
+  LTRdigestVisitor *v;
+  gv = gt_node_visitor_create(ltrdigest_visitor_class());
+  v = ltrdigest_visitor_cast(gv);
+  v->ls = ls;
+  v->lv = (GtLTRVisitor*) gt_ltr_visitor_new(&v->element);
+  return gv;
+}
+
+static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
+                                    GtError *e)
+{
+  GtLTRdigestStream *ls;
+  int had_err;
+
+  gt_error_check(e);
+  ls = gt_ltrdigest_stream_cast(gs);
+
+  if (ls->parallel_stream)
+    return gt_node_stream_next(ls->parallel_stream, gn, e);
+
+  /* get annotations from parser */
+  had_err = gt_node_stream_next(ls->in_stream, gn, e);
+  if (!had_err && *gn)
+    had_err = gt_genome_node_accept(*gn, ls->visitor, e);
   if (had_err) {
     gt_genome_node_delete(*gn);
     *gn = NULL;
@@ -405,9 +467,12 @@ static int gt_ltrdigest_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
 static void gt_ltrdigest_stream_free(GtNodeStream *gs)
 {
   GtLTRdigestStream *ls = gt_ltrdigest_stream_cast(gs);
-  gt_node_visitor_delete((GtNodeVisitor*) ls->lv);
+  gt_node_stream_delete(ls->parallel_stream);
+  gt_node_visitor_delete(ls->visitor);
   gt_str_delete(ls->ltrdigest_tag);
   gt_node_stream_delete(ls->in_stream);
+  gt_pbs_finder_delete(ls->pbf);
+  gt_ppt_finder_delete(ls->ppf);
 #ifdef HAVE_HMMER
   gt_pdom_finder_delete(ls->pdf);
 #endif
@@ -430,10 +495,8 @@ GtNodeStream* gt_ltrdigest_stream_new(GtNodeStream *in_stream,
                                       GtPPTOptions *ppt_opts,
 #ifdef HAVE_HMMER
                                       GtPdomOptions *pdom_opts,
-                                      GtError *err)
-#else
-                                      GT_UNUSED GtError *err)
 #endif
+                                      GtError *err)
 {
   GtNodeStream *gs;
   GtLTRdigestStream *ls;
@@ -453,7 +516,7 @@ GtNodeStream* gt_ltrdigest_stream_new(GtNodeStream *in_stream,
   ls->tests_to_run = tests_to_run;
   ls->encseq = encseq;
   ls->ltrdigest_tag = gt_str_new_cstr(GT_LTRDIGEST_TAG);
-  ls->lv = (GtLTRVisitor*) gt_ltr_visitor_new(&ls->element);
+  ls->visitor = ltrdigest_visitor_new(ls, err);
 #ifdef HAVE_HMMER
   if (!ls->pdf)
   {
@@ -461,7 +524,32 @@ GtNodeStream* gt_ltrdigest_stream_new(GtNodeStream *in_stream,
        We assume that the error message has been set. */
     gt_node_stream_delete(gs);
     return NULL;
-  } else
+  }
 #endif
+  /* the PPT HMM is compiled once for all elements */
+  if (tests_to_run & GT_LTRDIGEST_RUN_PPT)
+    ls->ppf = gt_ppt_finder_new(ls->ppt_opts);
+  if (tests_to_run & GT_LTRDIGEST_RUN_PBS)
+  {
+    /* the tRNA library is prepared once for all elements */
+    if (!(ls->pbf = gt_pbs_finder_new(ls->pbs_opts, err)))
+    {
+      gt_node_stream_delete(gs);
+      return NULL;
+    }
+  }
   return gs;
 }
+
+int gt_ltrdigest_stream_enable_threads(GtNodeStream *gs,
+                                       unsigned int nof_threads, GtError *err)
+{
+  GtLTRdigestStream *ls = gt_ltrdigest_stream_cast(gs);
+  gt_error_check(err);
+  gt_assert(!ls->parallel_stream);
+  ls->parallel_stream = gt_parallel_visitor_stream_new(ls->in_stream,
+                                                       nof_threads,
+                                                       ltrdigest_visitor_new,
+                                                       ls, err);
+  return ls->parallel_stream ? 0 : -1;
+}
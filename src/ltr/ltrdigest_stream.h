@@ -41,5 +41,11 @@ GtNodeStream* gt_ltrdigest_stream_new(GtNodeStream *in_stream,
                                       GtPdomOptions *pdom_opts,
 #endif
                                       GtError *err);
+/* Annotate the LTR elements in <nof_threads> worker threads. The elements are
+   returned in their input order. Has to be called before the stream is
+   used. */
+int           gt_ltrdigest_stream_enable_threads(GtNodeStream*,
+                                                 unsigned int nof_threads,
+                                                 GtError *err);
 
 #endif
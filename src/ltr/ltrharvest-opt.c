@@ -211,6 +211,7 @@ static OPrval parse_options(int *parsed_args,
          *optiondel,
          *optionv,
          *optionoffset,
+         *optionthreads,
          *optionlongoutput,
          *optionout,
          *optionoutinner,
@@ -455,6 +456,15 @@ static OPrval parse_options(int *parsed_args,
   gt_option_parser_add_option(op, optionoffset);
   gt_option_is_extended_option(optionoffset);
 
+  /* -threads */
+  optionthreads = gt_option_new_uint_min("threads",
+                                     "number of threads used to enumerate "
+                                     "the maximal repeats",
+                                     &lo->numofthreads,
+                                     1U,
+                                     1U);
+  gt_option_parser_add_option(op, optionthreads);
+
   /* implications */
   gt_option_imply(optionmaxtsd, optionmintsd);
   gt_option_imply(optionmotifmis, optionmotif);
@@ -52,6 +52,7 @@ typedef struct
   bool fastaoutputinnerregion;
   bool gff3output;       /* by default no gff3 output */
   unsigned long offset;
+  unsigned int numofthreads;   /* threads for the seed enumeration */
 
   unsigned int minlengthTSD,   /* minlength of TSD, default */
                maxlengthTSD;   /* maxlength of TSD, default */
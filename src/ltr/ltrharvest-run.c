@@ -25,7 +25,6 @@
 
 #include "ltrharvest-opt.h"
 #include "ltrharvest-run.h"
-#include "repeats.h"
 #include "searchforLTRs.h"
 #include "duplicates.h"
 #include "outputstd.h"
@@ -130,35 +129,32 @@ static int runltrharvest(LTRharvestoptions *lo, GtError *err)
     showuserdefinedoptionsandvalues(lo);
   }
 
-  /* init array for maximal repeats */
-  GT_INITARRAY (&lo->repeatinfo.repeats, Repeat);
   lo->repeatinfo.encseq = encseq;
 
-  /* search for maximal repeats */
-  if (!had_err && enumeratemaxpairs(ssar,
-                                    encseq,
-                                    readmodeSequentialsuffixarrayreader(ssar),
-                                    (unsigned int) lo->minseedlength,
-                                    simpleexactselfmatchstore,
-                                    &lo->repeatinfo,
-                                    NULL,
-                                    err) != 0)
-  {
-    had_err = true;
-  }
-
   /* init array for candidate pairs */
   GT_INITARRAY(&arrayLTRboundaries, LTRboundaries);
 
-  /* apply the filter algorithms */
-  if (!had_err && searchforLTRs (lo, &arrayLTRboundaries, encseq, err) != 0)
+  /* search for maximal repeats and apply the filter algorithms to each
+     seed as soon as it is found */
+  if (!had_err)
   {
-    had_err = true;
+    LTRsearch *ltrsearch = newLTRsearch(lo, &arrayLTRboundaries, encseq);
+
+    if (enumeratemaxpairs(ssar,
+                          encseq,
+                          readmodeSequentialsuffixarrayreader(ssar),
+                          (unsigned int) lo->minseedlength,
+                          lo->numofthreads,
+                          searchforLTRs,
+                          ltrsearch,
+                          NULL,
+                          err) != 0)
+    {
+      had_err = true;
+    }
+    freeLTRsearch(ltrsearch);
   }
 
-  /* free array for maximal repeats */
-  GT_FREEARRAY(&lo->repeatinfo.repeats, Repeat);
-
   /* remove exact duplicates */
   if (!had_err)
   {
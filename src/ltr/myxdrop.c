@@ -226,6 +226,54 @@ void calculateallowedMININFINITYINTgenerations(
           break;\
         }
 
+/*
+ Most extensions on a diagonal stop after a few characters, for which the
+ word wise comparison does not pay off. Hence we switch to it only after
+ MINSLIDELENGTH matching characters.
+ */
+#define MINSLIDELENGTH 8
+
+/*
+ The following function returns the length of the longest common prefix
+ of the sequences starting at <pos1> and <pos2> (reading to the left if
+ <fwd> is false), which does not contain a special character and is not
+ longer than <maxlen>. The characters are compared word by word on the two
+ bit encoding. The character following the common prefix is again compared
+ by COMPARESYMBOLSSEP, so that separators are handled as before.
+ */
+static int xdropslide(bool fwd,
+                      const Encodedsequence *encseq,
+                      Encodedsequencescanstate *esr1,
+                      Encodedsequencescanstate *esr2,
+                      Seqpos pos1,
+                      Seqpos pos2,
+                      int maxlen)
+{
+  GtCommonunits commonunits;
+
+  if (maxlen <= 0 || pos1 == pos2)
+  {
+    return 0;
+  }
+  if (!fwd)
+  {
+    /* compareEncseqsequencesmaxdepth expects positions in reverse mode */
+    pos1 = REVERSEPOS(getencseqtotallength(encseq),pos1);
+    pos2 = REVERSEPOS(getencseqtotallength(encseq),pos2);
+  }
+  (void) compareEncseqsequencesmaxdepth(&commonunits,
+                                        encseq,
+                                        fwd,
+                                        false,
+                                        esr1,
+                                        esr2,
+                                        pos1,
+                                        pos2,
+                                        0,
+                                        (Seqpos) maxlen);
+  return (int) commonunits.finaldepth;
+}
+
 #ifdef XDROPDEF_H
   #undef MATCHSCORE
   #undef HALFMATCHSCORE
@@ -249,12 +297,17 @@ void calculateallowedMININFINITYINTgenerations(
 #define VSEQ(A,J) A = getencodedchar(str_vseq,/* Random access */\
                                      vseq+(Seqpos)(J),\
                                      Forwardmode)
+#define SLIDE(I,J,MAXLEN) xdropslide(true,str_useq,esr1,esr2,\
+                                     useq+(Seqpos)(I),\
+                                     vseq+(Seqpos)(J),\
+                                     MAXLEN)
 
 #include "myxdrop.gen"
 
 #undef EVALXDROPARBITSCORES
 #undef USEQ
 #undef VSEQ
+#undef SLIDE
 
 /*
   Now we redefine the macros to compute the left to right
@@ -270,5 +323,9 @@ void calculateallowedMININFINITYINTgenerations(
 #define VSEQ(A,J) A = getencodedchar(str_vseq,/* Random access */\
                                      vseq-(Seqpos)1-(J),\
                                      Forwardmode)
+#define SLIDE(I,J,MAXLEN) xdropslide(false,str_useq,esr1,esr2,\
+                                     useq-(Seqpos)1-(I),\
+                                     vseq-(Seqpos)1-(J),\
+                                     MAXLEN)
 
 #include "myxdrop.gen"
@@ -15,6 +15,7 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <limits.h>
 #include <math.h>
 #include "core/ma.h"
 #include "core/mathsupport.h"
@@ -22,6 +23,8 @@
 #include "core/xansi.h"
 #include "core/array.h"
 #include "core/bioseq.h"
+#include "core/bittab.h"
+#include "core/chardef.h"
 #include "core/ensure.h"
 #include "core/fa.h"
 #include "core/fileutils_api.h"
@@ -48,6 +51,26 @@ struct GtPBSResults {
   GtPBSOptions *opts;
 };
 
+/* seeds longer than this would make the seed tables too large */
+#define GT_PBS_MAX_SEEDLEN 6
+/* shorter seeds occur almost everywhere, so no filtering is done */
+#define GT_PBS_MIN_SEEDLEN 4
+
+typedef struct {
+  GtSeq *from3;
+  const char *desc;
+  GtBittab *seeds;
+} GtPBSTRNA;
+
+struct GtPBSFinder {
+  GtPBSOptions *opts;
+  GtAlphabet *alpha;
+  GtScoreFunction *sf;
+  GtPBSTRNA *trnas;
+  unsigned long nof_trnas;
+  unsigned int seedlen;
+};
+
 static GtPBSHit* gt_pbs_hit_new(unsigned long alilen, GtStrand strand,
                                 const char *tRNA, unsigned long tstart,
                                 unsigned long start, unsigned long end,
@@ -176,6 +199,41 @@ static GtScoreFunction* gt_dna_scorefunc_new(GtAlphabet *a, int match,
   return sf;
 }
 
+/* Returns a lower bound for the alignment score of any hit in <seq>: a hit
+   aligns at least <o->alilen.start> positions of <seq> with at most
+   <o->max_edist> edit operations, and identical characters cannot score less
+   than the worst score of a character of <seq> against itself. If such
+   characters can score negatively, no useful bound exists and 1 is
+   returned. */
+static long gt_pbs_min_score(const GtPBSOptions *o, GtSeq *seq,
+                             const GtScoreFunction *sf)
+{
+  const int **scores = gt_score_function_get_scores(sf);
+  const GtUchar *encoded = gt_seq_get_encoded(seq);
+  unsigned long i, nof_chars = gt_alphabet_size(gt_seq_get_alphabet(seq));
+  long min_identity = LONG_MAX, min_edit, bound;
+  unsigned int c, d;
+  for (i = 0; i < gt_seq_length(seq); i++)
+  {
+    /* wildcards are scored in the last row of the score matrix */
+    unsigned long e = encoded[i] == (GtUchar) WILDCARD ? nof_chars - 1
+                                                       : encoded[i];
+    min_identity = MIN(min_identity, scores[e][e]);
+  }
+  if (min_identity < 0)
+    return 1;
+  min_edit = MIN(MIN(gt_score_function_get_deletion_score(sf),
+                     gt_score_function_get_insertion_score(sf)), 0);
+  for (c = 0; c < nof_chars; c++) {
+    for (d = 0; d < nof_chars; d++)
+      min_edit = MIN(min_edit, scores[c][d]);
+  }
+  bound = (o->alilen.start > o->max_edist
+           ? (long) (o->alilen.start - o->max_edist) * min_identity : 0)
+          + (long) o->max_edist * min_edit;
+  return MAX(bound, 1);
+}
+
 static double gt_pbs_score_func(unsigned long edist, unsigned long offset,
                                 unsigned long alilen, unsigned long trnalen,
                                 unsigned long trna_offset)
@@ -242,74 +300,261 @@ static int gt_pbs_hit_compare(const void *h1, const void *h2)
   return (gt_double_compare(hp2->score, hp1->score));
 }
 
-GtPBSResults* gt_pbs_find(const char *seq,
-                          const char *rev_seq,
-                          GtLTRElement *element,
-                          GtPBSOptions *o,
-                          GtError *err)
+/* Every hit aligns at least <o->alilen.start> characters of the element with
+   at most <o->max_edist> edit operations, so its matching characters form at
+   most <o->max_edist> + 1 runs, one of which has the length returned here.
+   Returns 0 if seeds of this length are too short to filter anything. */
+static unsigned int gt_pbs_seedlen(const GtPBSOptions *o)
+{
+  unsigned long seedlen;
+  if (o->alilen.start <= o->max_edist)
+    return 0;
+  /* ceil((alilen.start - max_edist) / (max_edist + 1)) */
+  seedlen = o->alilen.start / (o->max_edist + 1);
+  if (seedlen < GT_PBS_MIN_SEEDLEN)
+    return 0;
+  return MIN(seedlen, GT_PBS_MAX_SEEDLEN);
+}
+
+/* Calls <func> for the code of every seed of length <seedlen> starting in
+   positions <from> to <to> of <encoded>. Returns false if a wildcard occurs
+   in this region, because two equal wildcards are counted as a match. */
+static bool gt_pbs_collect_seeds(const GtUchar *encoded, unsigned long from,
+                                 unsigned long to, unsigned int seedlen,
+                                 unsigned int nof_chars,
+                                 unsigned long *codes, unsigned long *nof_codes)
+{
+  unsigned long i, code = 0, mask = (1UL << (2 * seedlen)) - 1;
+  *nof_codes = 0;
+  for (i = from; i < to; i++) {
+    if (encoded[i] >= nof_chars)
+      return false;
+    code = ((code << 2) | encoded[i]) & mask;
+    if (i + 1 >= from + seedlen)
+      codes[(*nof_codes)++] = code;
+  }
+  return true;
+}
+
+GtPBSFinder* gt_pbs_finder_new(GtPBSOptions *o, GtError *err)
+{
+  GtPBSFinder *pf;
+  unsigned long j, *codes, nof_codes, seedreg;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(o && o->trna_lib);
+
+  pf = gt_calloc(1, sizeof (GtPBSFinder));
+  pf->opts = o;
+  pf->alpha = gt_alphabet_new_dna();
+  pf->sf = gt_dna_scorefunc_new(pf->alpha,
+                                o->ali_score_match,
+                                o->ali_score_mismatch,
+                                o->ali_score_insertion,
+                                o->ali_score_deletion);
+  pf->seedlen = gt_pbs_seedlen(o);
+  pf->nof_trnas = gt_bioseq_number_of_sequences(o->trna_lib);
+  pf->trnas = gt_calloc(pf->nof_trnas, sizeof (GtPBSTRNA));
+
+  /* a hit starts at most <o->trnaoffsetlen.end> positions into the reverse
+     complemented tRNA and is not longer than this */
+  seedreg = o->trnaoffsetlen.end + o->alilen.end + o->max_edist;
+  codes = gt_malloc(seedreg * sizeof (unsigned long));
+
+  for (j = 0; !had_err && j < pf->nof_trnas; j++)
+  {
+    GtSeq *trna_seq;
+    GtPBSTRNA *trna = pf->trnas + j;
+    char *trna_from3_full;
+    unsigned long i, trna_seqlen;
+
+    trna_seq = gt_bioseq_get_seq(o->trna_lib, j);
+    trna_seqlen = gt_seq_length(trna_seq);
+    trna->desc = gt_seq_get_description(trna_seq);
+
+    trna_from3_full = gt_calloc(trna_seqlen, sizeof (char));
+    memcpy(trna_from3_full, gt_seq_get_orig(trna_seq),
+           sizeof (char)*trna_seqlen);
+    had_err = gt_reverse_complement(trna_from3_full, trna_seqlen, err);
+    trna->from3 = gt_seq_new_own(trna_from3_full, trna_seqlen, pf->alpha);
+    /* a GtSeq is encoded on first use, this is done here before the finder
+       is shared between threads which only read it */
+    (void) gt_seq_get_encoded(trna->from3);
+
+    if (!had_err && pf->seedlen > 0
+          && gt_pbs_collect_seeds(gt_seq_get_encoded(trna->from3), 0,
+                                  MIN(seedreg, trna_seqlen), pf->seedlen,
+                                  gt_alphabet_num_of_chars(pf->alpha),
+                                  codes, &nof_codes))
+    {
+      trna->seeds = gt_bittab_new(1UL << (2 * pf->seedlen));
+      for (i = 0; i < nof_codes; i++)
+        gt_bittab_set_bit(trna->seeds, codes[i]);
+    }
+  }
+  gt_free(codes);
+
+  if (had_err)
+  {
+    gt_pbs_finder_delete(pf);
+    return NULL;
+  }
+  return pf;
+}
+
+static bool gt_pbs_trna_has_seed(const GtPBSTRNA *trna,
+                                 const unsigned long *codes,
+                                 unsigned long nof_codes)
+{
+  unsigned long i;
+  for (i = 0; i < nof_codes; i++)
+  {
+    if (gt_bittab_bit_is_set(trna->seeds, codes[i]))
+      return true;
+  }
+  return false;
+}
+
+/* Returns in <codes> the seeds of the part of <seq> a hit may cover. If
+   <seq> cannot be filtered, <nof_codes> is set to ULONG_MAX. */
+static void gt_pbs_element_seeds(const GtPBSFinder *pf, GtSeq *seq,
+                                 unsigned long *codes,
+                                 unsigned long *nof_codes)
+{
+  const GtPBSOptions *o = pf->opts;
+  unsigned long from, to;
+  from = o->radius > o->offsetlen.end ? o->radius - o->offsetlen.end : 0;
+  to = MIN(o->radius + o->offsetlen.end + o->alilen.end, gt_seq_length(seq));
+  if (pf->seedlen == 0
+        || !gt_pbs_collect_seeds(gt_seq_get_encoded(seq), from, to,
+                                 pf->seedlen,
+                                 gt_alphabet_num_of_chars(pf->alpha),
+                                 codes, nof_codes))
+  {
+    *nof_codes = ULONG_MAX;
+  }
+}
+
+static GtPBSResults* gt_pbs_finder_search(GtPBSFinder *pf, const char *seq,
+                                          const char *rev_seq,
+                                          GtLTRElement *element,
+                                          bool use_seeds)
 {
   GtSeq *seq_forward, *seq_rev;
+  GtSWAlignProfile *profile_forward, *profile_rev;
   GtPBSResults *results;
-  unsigned long j;
+  GtPBSOptions *o;
+  unsigned long j, *codes_forward, *codes_rev, nof_forward, nof_rev;
+  long min_score_forward, min_score_rev;
   GtAlignment *ali;
-  GtAlphabet *a = gt_alphabet_new_dna();
-  GtScoreFunction *sf = gt_dna_scorefunc_new(a,
-                                             o->ali_score_match,
-                                             o->ali_score_mismatch,
-                                             o->ali_score_insertion,
-                                             o->ali_score_deletion);
 
-  gt_assert(seq && rev_seq && sf && a && element);
+  gt_assert(pf && seq && rev_seq && element);
+  o = pf->opts;
 
   results = gt_pbs_results_new(element, o);
 
   seq_forward = gt_seq_new(seq + (gt_ltrelement_leftltrlen(element))
                                - (o->radius),
                            2*o->radius + 1,
-                           a);
+                           pf->alpha);
 
   seq_rev     = gt_seq_new(rev_seq + (gt_ltrelement_rightltrlen(element))
                                    - (o->radius),
                            2*o->radius + 1,
-                           a);
+                           pf->alpha);
+
+  /* the profiles of the element sequences are used for all tRNAs, only
+     alignments which can become hits are traced back */
+  profile_forward = gt_swalign_profile_new(seq_forward, pf->sf);
+  profile_rev = gt_swalign_profile_new(seq_rev, pf->sf);
+  min_score_forward = gt_pbs_min_score(o, seq_forward, pf->sf);
+  min_score_rev = gt_pbs_min_score(o, seq_rev, pf->sf);
+
+  codes_forward = gt_malloc(2 * (2*o->radius + 1) * sizeof (unsigned long));
+  codes_rev = codes_forward + 2*o->radius + 1;
+  nof_forward = nof_rev = ULONG_MAX;
+  if (use_seeds)
+  {
+    gt_pbs_element_seeds(pf, seq_forward, codes_forward, &nof_forward);
+    gt_pbs_element_seeds(pf, seq_rev, codes_rev, &nof_rev);
+  }
 
-    for (j=0;j<gt_bioseq_number_of_sequences(o->trna_lib);j++)
+  /* the seeds only decide which tRNAs are aligned, a tRNA which is aligned
+     is aligned as a whole, so that the alignments are exactly those of an
+     exhaustive search */
+  for (j = 0; j < pf->nof_trnas; j++)
   {
-    GtSeq *trna_seq, *trna_from3;
-    char *trna_from3_full;
-    unsigned long trna_seqlen;
+    const GtPBSTRNA *trna = pf->trnas + j;
+    unsigned long trna_seqlen = gt_seq_length(trna->from3);
 
-    trna_seq = gt_bioseq_get_seq(o->trna_lib, j);
-    trna_seqlen = gt_seq_length(trna_seq);
+    if (!trna->seeds || nof_forward == ULONG_MAX
+          || gt_pbs_trna_has_seed(trna, codes_forward, nof_forward))
+    {
+      ali = gt_swalign_profile_align(profile_forward, trna->from3,
+                                     min_score_forward);
+      gt_pbs_add_hit(results->hits, ali, o, trna_seqlen, trna->desc,
+                     GT_STRAND_FORWARD, results);
+      gt_alignment_delete(ali);
+    }
 
-    trna_from3_full = gt_calloc(trna_seqlen, sizeof (char));
-    memcpy(trna_from3_full, gt_seq_get_orig(trna_seq),
-           sizeof (char)*trna_seqlen);
-    (void) gt_reverse_complement(trna_from3_full, trna_seqlen, err);
-    trna_from3 = gt_seq_new_own(trna_from3_full, trna_seqlen, a);
-
-    ali = gt_swalign(seq_forward, trna_from3, sf);
-    gt_pbs_add_hit(results->hits, ali, o, trna_seqlen,
-                   gt_seq_get_description(trna_seq), GT_STRAND_FORWARD,
-                   results);
-    gt_alignment_delete(ali);
-
-    ali = gt_swalign(seq_rev, trna_from3, sf);
-    gt_pbs_add_hit(results->hits, ali, o, trna_seqlen,
-                   gt_seq_get_description(trna_seq), GT_STRAND_REVERSE,
-                   results);
-    gt_alignment_delete(ali);
-
-    gt_seq_delete(trna_from3);
+    if (!trna->seeds || nof_rev == ULONG_MAX
+          || gt_pbs_trna_has_seed(trna, codes_rev, nof_rev))
+    {
+      ali = gt_swalign_profile_align(profile_rev, trna->from3, min_score_rev);
+      gt_pbs_add_hit(results->hits, ali, o, trna_seqlen, trna->desc,
+                     GT_STRAND_REVERSE, results);
+      gt_alignment_delete(ali);
+    }
   }
+  gt_free(codes_forward);
+  gt_swalign_profile_delete(profile_forward);
+  gt_swalign_profile_delete(profile_rev);
   gt_seq_delete(seq_forward);
   gt_seq_delete(seq_rev);
-  gt_score_function_delete(sf);
-  gt_alphabet_delete(a);
   gt_array_sort(results->hits, gt_pbs_hit_compare);
   return results;
 }
 
+GtPBSResults* gt_pbs_finder_find(GtPBSFinder *pf, const char *seq,
+                                 const char *rev_seq, GtLTRElement *element,
+                                 GtError *err)
+{
+  gt_error_check(err);
+  return gt_pbs_finder_search(pf, seq, rev_seq, element, true);
+}
+
+void gt_pbs_finder_delete(GtPBSFinder *pf)
+{
+  unsigned long j;
+  if (!pf) return;
+  for (j = 0; j < pf->nof_trnas; j++)
+  {
+    gt_seq_delete(pf->trnas[j].from3);
+    gt_bittab_delete(pf->trnas[j].seeds);
+  }
+  gt_free(pf->trnas);
+  gt_score_function_delete(pf->sf);
+  gt_alphabet_delete(pf->alpha);
+  gt_free(pf);
+}
+
+GtPBSResults* gt_pbs_find(const char *seq,
+                          const char *rev_seq,
+                          GtLTRElement *element,
+                          GtPBSOptions *o,
+                          GtError *err)
+{
+  GtPBSFinder *pf;
+  GtPBSResults *results = NULL;
+  gt_error_check(err);
+  if ((pf = gt_pbs_finder_new(o, err)))
+  {
+    results = gt_pbs_finder_find(pf, seq, rev_seq, element, err);
+    gt_pbs_finder_delete(pf);
+  }
+  return results;
+}
+
 void gt_pbs_results_delete(GtPBSResults *results)
 {
     unsigned long i;
@@ -335,6 +580,7 @@ int gt_pbs_unit_test(GtError *err)
   FILE *tmpfp;
   GtPBSResults *res;
   GtPBSHit *hit;
+  unsigned long i;
   double score1, score2;
   GtRange rng;
   char *rev_seq,
@@ -437,6 +683,69 @@ int gt_pbs_unit_test(GtError *err)
          (rng.end - rng.start + 1) * sizeof (char));
   ensure(had_err, strcmp(tmp, "gatcctaaggctac" ) == 0);
 
+  /* the seed filter must not change the hits */
+  gt_bioseq_delete(o.trna_lib);
+  gt_xremove(gt_str_get(tmpfilename));
+  gt_str_reset(tmpfilename);
+  tmpfp = gt_xtmpfp(tmpfilename);
+  for (i = 0; i < 12; i++)
+  {
+    unsigned long j;
+    fprintf(tmpfp, ">random%lu\n", i);
+    for (j = 30 + gt_rand_max(40); j > 0; j--)
+      gt_xfputc("acgt"[gt_rand_max(3)], tmpfp);
+    gt_xfputc('\n', tmpfp);
+  }
+  gt_fa_xfclose(tmpfp);
+  o.trna_lib = gt_bioseq_new(gt_str_get(tmpfilename), err);
+  ensure(had_err, o.trna_lib != NULL);
+  for (i = 0; !had_err && i < 50; i++)
+  {
+    GtPBSFinder *pf;
+    GtPBSResults *res_seeds, *res_all;
+    GtSeq *trna;
+    unsigned long j, k, l, toffset;
+    o.max_edist = gt_rand_max(3);
+    o.alilen.start = 8 + gt_rand_max(8);
+    o.trnaoffsetlen.end = gt_rand_max(10);
+    pf = gt_pbs_finder_new(&o, err);
+    ensure(had_err, pf != NULL);
+    if (had_err)
+      break;
+    for (j = 0; j < 600; j++)
+    {
+      seq[j] = "acgt"[gt_rand_max(3)];
+      rev_seq[j] = gt_rand_max(200) ? "acgt"[gt_rand_max(3)] : 'n';
+    }
+    /* plant slightly mutated tRNA 3' ends behind the LTRs */
+    for (k = 0; k < 2; k++)
+    {
+      trna = pf->trnas[gt_rand_max(pf->nof_trnas - 1)].from3;
+      toffset = gt_rand_max(3);
+      for (j = 0, l = 11 + gt_rand_max(9); j < l; j++)
+      {
+        char c = gt_seq_get_orig(trna)[toffset + j];
+        (k ? rev_seq : seq)[100 + j] = gt_rand_max(19) ? c : 'g';
+      }
+    }
+    res_seeds = gt_pbs_finder_search(pf, seq, rev_seq, &element, true);
+    res_all = gt_pbs_finder_search(pf, seq, rev_seq, &element, false);
+    ensure(had_err, gt_pbs_results_get_number_of_hits(res_seeds)
+                      == gt_pbs_results_get_number_of_hits(res_all));
+    for (j = 0; !had_err && j < gt_pbs_results_get_number_of_hits(res_all);
+         j++)
+    {
+      GtPBSHit *h1 = gt_pbs_results_get_ranked_hit(res_seeds, j),
+               *h2 = gt_pbs_results_get_ranked_hit(res_all, j);
+      ensure(had_err, h1->start == h2->start && h1->end == h2->end);
+      ensure(had_err, h1->tstart == h2->tstart && h1->edist == h2->edist);
+      ensure(had_err, h1->strand == h2->strand && h1->trna == h2->trna);
+    }
+    gt_pbs_results_delete(res_seeds);
+    gt_pbs_results_delete(res_all);
+    gt_pbs_finder_delete(pf);
+  }
+
   /* clean up */
   gt_xremove(gt_str_get(tmpfilename));
   ensure(had_err, !gt_file_exists(gt_str_get(tmpfilename)));
@@ -40,9 +40,22 @@ typedef struct GtPBSOptions {
   GtBioseq *trna_lib;
 } GtPBSOptions;
 
+typedef struct GtPBSFinder GtPBSFinder;
 typedef struct GtPBSHit GtPBSHit;
 typedef struct GtPBSResults GtPBSResults;
 
+/* Prepares the tRNAs of <o->trna_lib> once for the search in many LTR
+   elements: they are reverse complemented and encoded, and the seeds of their
+   3' ends are tabulated. tRNAs without a seed near the end of the 5' LTR of an
+   element are not aligned, this does not change the hits found. <o> must stay
+   valid while the finder is used. */
+GtPBSFinder*   gt_pbs_finder_new(GtPBSOptions *o, GtError *err);
+GtPBSResults*  gt_pbs_finder_find(GtPBSFinder*, const char *seq,
+                                  const char *rev_seq, GtLTRElement *element,
+                                  GtError *err);
+void           gt_pbs_finder_delete(GtPBSFinder*);
+
+/* Like <gt_pbs_finder_find()> with a finder used for this element only. */
 GtPBSResults*  gt_pbs_find(const char *seq,
                            const char *rev_seq,
                            GtLTRElement *element,
@@ -20,11 +20,11 @@
 #include <string.h>
 #include <ctype.h>
 #include <float.h>
-#include <pthread.h>
 #include "core/codon.h"
 #include "core/log.h"
 #include "core/ma.h"
 #include "core/mathsupport.h"
+#include "core/thread.h"
 #include "core/translator.h"
 #include "core/undef.h"
 #include "core/unused_api.h"
@@ -41,17 +41,67 @@
 /* number of tophit_s structs to preallocate in HMMER back-end */
 #define MAX_TOPHITS 50
 
+/* number of translated frames searched per element (three per strand) */
+#define GT_PDOM_NOF_FRAMES 6
+
+/* per-thread HMMER buffers, reused for all work items of a thread */
+typedef struct GtPdomScratch {
+  struct dpmatrix_s *mx;
+  struct tophit_s *ghit;
+} GtPdomScratch;
+
+/* result of the Viterbi search of one model in one frame */
+typedef struct GtPdomFrameHit {
+  struct p7trace_s *tr;
+  float sc;
+} GtPdomFrameHit;
+
+/* All work items of one element. A work item is a (model, frame) pair, items
+   are numbered model by model. The model whose last frame has been searched
+   is finished by the thread which searched that frame. */
+typedef struct GtPdomJob {
+  GtLTRElement *elem;
+  GtPdomResults *results;
+  unsigned char *dsq[GT_PDOM_NOF_FRAMES];
+  int seqlen[GT_PDOM_NOF_FRAMES];
+  GtPdomFrameHit *frame_hits;
+  unsigned int *frames_left;
+  unsigned long next_item,
+                nof_items,
+                models_left;
+  bool done;
+  struct GtPdomJob *next;
+} GtPdomJob;
+
+typedef struct GtPdomWorker {
+  GtThread *thread;
+  GtPdomFinder *gpf;
+  GtPdomScratch scratch;
+} GtPdomWorker;
+
 struct GtPdomFinder {
   GtStrArray *hmm_files;
   GtArray *models;
-  GtLTRElement *elem;
   struct threshold_s thresh;
   unsigned int nof_threads,
                chain_max_gap_length;
+  /* worker pool, lives as long as the finder */
+  GtPdomWorker *workers;
+  unsigned int nof_workers;
+  GtPdomJob *first_job, *last_job; /* jobs with unclaimed work items */
+  GtMutex *mutex,
+          *hmmer_lock;
+  GtCondition *work_available,
+              *job_finished;
+  bool shutdown;
+  GtPdomScratch scratch;           /* used if there are no worker threads */
 };
 
 struct GtPdomModel {
   struct plan7_s *model;
+  /* a matrix of the size a search starts with, only used to choose between
+     the full and the small space Viterbi as if the search matrix was new */
+  struct dpmatrix_s *space_mx;
   unsigned long reference_count;
 };
 
@@ -86,17 +136,6 @@ typedef struct GtPdomDomainTraverseInfo {
   void *data;
 } GtPdomDomainTraverseInfo;
 
-typedef struct GtPdomSharedMem {
-  pthread_t *thread;
-  int nof_threads;
-  GtPdomFinder *gpf;
-  unsigned long next_hmm;
-  GtArray *hmms;
-  GtStr **fwd, **rev;
-  GtPdomResults *results;
-  pthread_mutex_t in_lock, out_lock;
-} GtPdomSharedMem;
-
 /* --------------- GtPdomSingleHit ---------------------------------- */
 
 void gt_pdom_single_hit_format_alignment(const GtPdomSingleHit *sh,
@@ -346,6 +385,7 @@ static GtPdomModel* gt_pdom_model_new(struct plan7_s *model)
   gt_assert(model);
   newmodel = gt_calloc(1, sizeof (GtPdomModel));
   newmodel->model = model;
+  newmodel->space_mx = CreatePlan7Matrix(1, model->M, 25, 0);
   return newmodel;
 }
 
@@ -378,6 +418,7 @@ void gt_pdom_model_delete(void *value)
     return;
   }
   FreePlan7(model->model);
+  FreePlan7Matrix(model->space_mx);
   gt_free(model);
 }
 
@@ -387,8 +428,8 @@ static GtPdomResults* gt_pdom_results_new(void)
 {
   GtPdomResults *res;
   res = gt_calloc(1, sizeof (GtPdomResults));
-  res->domains = gt_hashmap_new(HASH_DIRECT, gt_pdom_model_delete,
-                                gt_pdom_model_hit_delete);
+  /* the models belong to the finder, which outlives its results */
+  res->domains = gt_hashmap_new(HASH_DIRECT, NULL, gt_pdom_model_hit_delete);
   res->empty = TRUE;
   res->combined_e_value_fwd = res->combined_e_value_rev = 0.0;
   return res;
@@ -445,56 +486,33 @@ int gt_pdom_results_foreach_domain_hit(GtPdomResults *results,
                             err);
 }
 
-void gt_hmmer_search(struct plan7_s *hmm,
-                     char *seq,
-                     unsigned long seqlen,
-                     char *seqdesc,
-                     struct threshold_s *thresh,
-                     struct tophit_s *ghit,
-                     struct tophit_s *dhit,
-                     pthread_mutex_t *lock)
+static void gt_pdom_scratch_init(GtPdomScratch *scratch)
 {
-  struct dpmatrix_s *mx;
-  struct p7trace_s *tr;
-  unsigned char *dsq;
-  float sc;
-  int retval;
-  double pvalue, evalue;
-
-  mx = CreatePlan7Matrix(1, hmm->M, 25, 0);
+  gt_assert(scratch);
+  scratch->mx = CreatePlan7Matrix(1, 1, 25, 0);
+  scratch->ghit = AllocTophits(MAX_TOPHITS);
+}
 
-  dsq = DigitizeSequence(seq, seqlen);
+static void gt_pdom_scratch_free(GtPdomScratch *scratch)
+{
+  if (!scratch || !scratch->mx) return;
+  FreePlan7Matrix(scratch->mx);
+  FreeTophits(scratch->ghit);
+}
 
-  if (P7ViterbiSpaceOK(seqlen, hmm->M, mx))
-    sc = P7Viterbi(dsq, seqlen, hmm, mx, &tr);
+/* Viterbi search of <model> in <dsq>, the matrix <mx> grows as needed and is
+   kept for the next search */
+static float gt_hmmer_viterbi(GtPdomModel *model, unsigned char *dsq,
+                              int seqlen, struct dpmatrix_s *mx,
+                              struct p7trace_s **tr)
+{
+  struct plan7_s *hmm = model->model;
+  float sc;
+  if (P7ViterbiSpaceOK(seqlen, hmm->M, model->space_mx))
+    sc = P7Viterbi(dsq, seqlen, hmm, mx, tr);
   else
-    sc = P7SmallViterbi(dsq, seqlen, hmm, mx, &tr);
-
-  sc -= TraceScoreCorrection(hmm, tr, dsq);
-
-  if ((retval = pthread_mutex_lock(lock)) != 0)
-  {
-    fprintf(stderr, "pthread_mutex_lock failure: %s\n", strerror(retval));
-    exit(EXIT_FAILURE);
-  }
-  pvalue = PValue(hmm, sc);
-  evalue = thresh->Z ? (double) thresh->Z * pvalue : (double) pvalue;
-
-  if (sc >= thresh->globT && evalue <= thresh->globE)
-  {
-    sc = PostprocessSignificantHit(ghit, dhit,
-                                   tr, hmm, dsq, seqlen,
-                                   seqdesc, NULL, NULL,
-                                   false, sc, true, thresh, FALSE);
-  }
-  if ((retval = pthread_mutex_unlock(lock)) != 0)
-  {
-    fprintf(stderr, "pthread_mutex_unlock failure: %s\n", strerror(retval));
-    exit(EXIT_FAILURE);
-  }
-  P7FreeTrace(tr);
-  free(dsq);
-  FreePlan7Matrix(mx);
+    sc = P7SmallViterbi(dsq, seqlen, hmm, mx, tr);
+  return sc - TraceScoreCorrection(hmm, *tr, dsq);
 }
 
 static void chainproc(GtChain *c, GtFragment *f,
@@ -531,289 +549,271 @@ static int gt_fragcmp(const void *frag1, const void *frag2)
   else return (f1->startpos2 < f2->startpos2 ? -1 : 1);
 }
 
-void* gt_pdom_per_domain_worker_thread(void *data)
+/* empties <hits> like FreeTophits() does, but keeps the allocated hit space
+   so that the list can be filled again */
+static void gt_pdom_clear_tophits(struct tophit_s *hits)
 {
-  GtPdomSharedMem *shared;
-  GtPdomModel *hmm;
-  int retval;
-  struct tophit_s *ghit = NULL, *hits = NULL;
+  int i;
+  gt_assert(hits);
+  for (i = 0; i < hits->num; i++)
+  {
+    if (hits->unsrt[i].ali != NULL)
+      FreeFancyAli(hits->unsrt[i].ali);
+    free(hits->unsrt[i].name);
+    free(hits->unsrt[i].acc);
+    free(hits->unsrt[i].desc);
+  }
+  free(hits->hit);
+  hits->hit = NULL;
+  hits->num = 0;
+}
+
+static char *gt_pdom_frame_desc[GT_PDOM_NOF_FRAMES] =
+  { "0+", "1+", "2+", "0-", "1-", "2-" };
+
+/* collects the significant frame hits of <hmm> in <job> in frame order,
+   chains the hits on the best strand and registers them in the results */
+static void gt_pdom_finish_model(GtPdomFinder *gpf, GtPdomJob *job,
+                                 GtPdomModel *hmm, GtPdomFrameHit *frame_hits,
+                                 GtPdomScratch *scratch)
+{
+  struct tophit_s *hits = NULL;
   bool best_fwd = TRUE;
   unsigned long i;
+  unsigned int frame;
   GtFragment *frags;
   GtPdomModelHit *hit;
 
-  shared = (GtPdomSharedMem*) data;
-
-  for (;;)
+  hit = gt_pdom_model_hit_new(job->elem);
+  for (frame = 0; frame < GT_PDOM_NOF_FRAMES; frame++)
   {
-    /* Lock input */
-    if ((retval = pthread_mutex_lock(&shared->in_lock)) != 0)
-    {
-      fprintf(stderr, "Failed to lock: %s\n", strerror(retval));
-      exit(EXIT_FAILURE);
-    }
-    /* Have all HMMs been distributed? If so, we are done here. */
-    if (shared->next_hmm == gt_array_size(shared->gpf->models))
-    {
-      if ((retval = pthread_mutex_unlock(&shared->in_lock)) != 0)
-      {
-        fprintf(stderr, "Failed to unlock: %s\n", strerror(retval));
-        exit(EXIT_FAILURE);
-      }
-      pthread_exit(NULL);
-    }
+    double pvalue, evalue;
+    float sc = frame_hits[frame].sc;
 
-    /* Get work from HMM list */
-    hmm = *(GtPdomModel**) gt_array_get(shared->gpf->models,
-                                        shared->next_hmm);
-    shared->next_hmm++;
-
-    /* work claimed, release input */
-    if ((retval = pthread_mutex_unlock(&shared->in_lock)) != 0)
+    pvalue = PValue(hmm->model, sc);
+    evalue = gpf->thresh.Z ? (double) gpf->thresh.Z * pvalue : (double) pvalue;
+    if (sc >= gpf->thresh.globT && evalue <= gpf->thresh.globE)
     {
-      fprintf(stderr, "pthread_mutex_unlock failure: %s\n", strerror(retval));
-      exit(EXIT_FAILURE);
+      gt_mutex_lock(gpf->hmmer_lock);
+      (void) PostprocessSignificantHit(scratch->ghit,
+                                       frame < GT_PDOM_NOF_FRAMES/2
+                                         ? hit->hits_fwd : hit->hits_rev,
+                                       frame_hits[frame].tr, hmm->model,
+                                       job->dsq[frame], job->seqlen[frame],
+                                       gt_pdom_frame_desc[frame],
+                                       NULL, NULL, false, sc, true,
+                                       &gpf->thresh, FALSE);
+      gt_mutex_unlock(gpf->hmmer_lock);
     }
+    P7FreeTrace(frame_hits[frame].tr);
+    frame_hits[frame].tr = NULL;
+  }
+  /* the global hit list is not used, it is emptied for the next model */
+  gt_pdom_clear_tophits(scratch->ghit);
 
-    hit = gt_pdom_model_hit_new(shared->gpf->elem);
-    ghit = AllocTophits(MAX_TOPHITS);
-
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->fwd[0]),
-                    gt_str_length(shared->fwd[0]),
-                    "0+",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_fwd,
-                    &shared->out_lock);
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->fwd[1]),
-                    gt_str_length(shared->fwd[1]),
-                    "1+",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_fwd,
-                    &shared->out_lock);
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->fwd[2]),
-                    gt_str_length(shared->fwd[2]),
-                    "2+",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_fwd,
-                    &shared->out_lock);
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->rev[0]),
-                    gt_str_length(shared->rev[0]),
-                    "0-",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_rev,
-                    &shared->out_lock);
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->rev[1]),
-                    gt_str_length(shared->rev[1]),
-                    "1-",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_rev,
-                    &shared->out_lock);
-    gt_hmmer_search(hmm->model,
-                    gt_str_get(shared->rev[2]),
-                    gt_str_length(shared->rev[2]),
-                    "2-",
-                    &shared->gpf->thresh,
-                    ghit,
-                    hit->hits_rev,
-                    &shared->out_lock);
-
-    FullSortTophits(hit->hits_fwd);
-    FullSortTophits(hit->hits_rev);
-
-    /* check if there were any hits */
-    if (hit->hits_fwd->num > 0 || hit->hits_rev->num > 0)
-    {
-      shared->results->empty = FALSE;
-      if (hit->hits_fwd->num > 0)
-      {
-        if (hit->hits_rev->num > 0)
-        {
-          if (gt_double_compare(hit->hits_fwd->hit[0]->score,
-                                hit->hits_rev->hit[0]->score) < 0)
-            best_fwd = FALSE;
-        }
-        else best_fwd = TRUE;
-      }
-      else best_fwd = FALSE;
-
-      /* determine best-scoring strand */
-      hits = (best_fwd ? hit->hits_fwd : hit->hits_rev);
-      gt_assert(hits);
+  FullSortTophits(hit->hits_fwd);
+  FullSortTophits(hit->hits_rev);
 
-      /* no need to chain if there is only one hit */
-      if (hits->num > 1)
-      {
-        /* create GtFragment set for chaining */
-        frags = (GtFragment*) gt_calloc(hits->num, sizeof (GtFragment));
-        for (i=0;i<hits->num;i++)
-        {
-          frags[i].startpos1 = hits->hit[i]->hmmfrom;
-          frags[i].endpos1   = hits->hit[i]->hmmto;
-          frags[i].startpos2 = hits->hit[i]->sqfrom;
-          frags[i].endpos2   = hits->hit[i]->sqto;
-          /* let weight(f) be targetlength(f) multiplied by hmmerscore(f) */
-          frags[i].weight    = (hits->hit[i]->sqto - hits->hit[i]->sqfrom + 1)
-                                 * hits->hit[i]->score;
-          frags[i].data      = hits->hit[i];
-        }
-
-        /* sort GtFragments by position */
-        qsort(frags, hits->num, sizeof (GtFragment), gt_fragcmp);
-        for (i=0;i<hits->num;i++)
-        {
-          gt_log_log("(%lu %lu) (%lu %lu) %p", frags[i].startpos1,
-                                               frags[i].endpos1,
-                                               frags[i].startpos2,
-                                               frags[i].endpos2,
-                                               frags[i].data);
-        }
-        gt_log_log("chaining %d frags", hits->num);
-        /* do chaining */
-        gt_globalchaining_max(frags, hits->num,
-                              shared->gpf->chain_max_gap_length,
-                              chainproc, hit);
-        gt_free(frags);
-      }
-      else
+  /* check if there were any hits */
+  if (hit->hits_fwd->num > 0 || hit->hits_rev->num > 0)
+  {
+    if (hit->hits_fwd->num > 0)
+    {
+      if (hit->hits_rev->num > 0)
       {
-        GtPdomSingleHit *sh = gt_pdom_single_hit_new(hits->hit[0],
-                                                     hit);
-        gt_pdom_model_hit_add_single_hit(hit, sh);
+        if (gt_double_compare(hit->hits_fwd->hit[0]->score,
+                              hit->hits_rev->hit[0]->score) < 0)
+          best_fwd = FALSE;
       }
+      else best_fwd = TRUE;
+    }
+    else best_fwd = FALSE;
 
-      /* Lock results, we want to write to the result hashtable */
-      if ((retval = pthread_mutex_lock(&(shared->out_lock))) != 0)
-      {
-        fprintf(stderr, "Failed to lock: %s\n", strerror(retval));
-        exit(EXIT_FAILURE);
-      }
+    /* determine best-scoring strand */
+    hits = (best_fwd ? hit->hits_fwd : hit->hits_rev);
+    gt_assert(hits);
 
-      /* register results */
-      gt_hashmap_add(shared->results->domains,
-                     gt_pdom_model_ref(hmm),
-                     hit);
-      if (best_fwd)
+    /* no need to chain if there is only one hit */
+    if (hits->num > 1)
+    {
+      /* create GtFragment set for chaining */
+      frags = (GtFragment*) gt_calloc(hits->num, sizeof (GtFragment));
+      for (i=0;i<hits->num;i++)
       {
-        shared->results->combined_e_value_fwd
-          += log(hit->hits_fwd->hit[0]->pvalue);
-        hit->strand = GT_STRAND_FORWARD;
+        frags[i].startpos1 = hits->hit[i]->hmmfrom;
+        frags[i].endpos1   = hits->hit[i]->hmmto;
+        frags[i].startpos2 = hits->hit[i]->sqfrom;
+        frags[i].endpos2   = hits->hit[i]->sqto;
+        /* let weight(f) be targetlength(f) multiplied by hmmerscore(f) */
+        frags[i].weight    = (hits->hit[i]->sqto - hits->hit[i]->sqfrom + 1)
+                               * hits->hit[i]->score;
+        frags[i].data      = hits->hit[i];
       }
-      else
-      {
-        shared->results->combined_e_value_rev
-          += log(hit->hits_rev->hit[0]->pvalue);
-        hit->strand = GT_STRAND_REVERSE;
-       }
 
-      /* unlock results */
-      if ((retval = pthread_mutex_unlock(&(shared->out_lock))) != 0)
+      /* sort GtFragments by position */
+      qsort(frags, hits->num, sizeof (GtFragment), gt_fragcmp);
+      for (i=0;i<hits->num;i++)
       {
-        fprintf(stderr, "Failed to unlock: %s\n", strerror(retval));
-        exit(EXIT_FAILURE);
+        gt_log_log("(%lu %lu) (%lu %lu) %p", frags[i].startpos1,
+                                             frags[i].endpos1,
+                                             frags[i].startpos2,
+                                             frags[i].endpos2,
+                                             frags[i].data);
       }
+      gt_log_log("chaining %d frags", hits->num);
+      /* do chaining */
+      gt_globalchaining_max(frags, hits->num,
+                            gpf->chain_max_gap_length,
+                            chainproc, hit);
+      gt_free(frags);
     }
     else
-      gt_pdom_model_hit_delete(hit);
+    {
+      GtPdomSingleHit *sh = gt_pdom_single_hit_new(hits->hit[0],
+                                                   hit);
+      gt_pdom_model_hit_add_single_hit(hit, sh);
+    }
 
-    FreeTophits(ghit);
+    /* register results, other models of this element may finish now */
+    gt_mutex_lock(gpf->mutex);
+    job->results->empty = FALSE;
+    gt_hashmap_add(job->results->domains, hmm, hit);
+    if (best_fwd)
+    {
+      job->results->combined_e_value_fwd
+        += log(hit->hits_fwd->hit[0]->pvalue);
+      hit->strand = GT_STRAND_FORWARD;
+    }
+    else
+    {
+      job->results->combined_e_value_rev
+        += log(hit->hits_rev->hit[0]->pvalue);
+      hit->strand = GT_STRAND_REVERSE;
+    }
+    gt_mutex_unlock(gpf->mutex);
   }
+  else
+    gt_pdom_model_hit_delete(hit);
 }
 
-static GtPdomSharedMem* gt_pdom_run_threads(GtArray *hmms, int nof_threads,
-                                            GtStr **fwd, GtStr **rev,
-                                            GtPdomResults *results,
-                                            GtPdomFinder *gpf)
+/* searches one model in one frame of <job> */
+static void gt_pdom_process_item(GtPdomFinder *gpf, GtPdomJob *job,
+                                 unsigned long item, GtPdomScratch *scratch)
 {
-  int retval, i;
-  GtPdomSharedMem *shared;
-  pthread_attr_t attr;
-
-  gt_assert(hmms && nof_threads > 0 && fwd && rev && results && gpf);
-
-  shared = gt_calloc(1, sizeof (GtPdomSharedMem));
-
-  shared->nof_threads = nof_threads;
-  shared->thread = gt_calloc(nof_threads, sizeof (pthread_t));
-  shared->hmms = hmms;
-  shared->fwd = fwd;
-  shared->rev = rev;
-  shared->next_hmm = 0;
-  shared->results = results;
-  shared->gpf = gpf;
+  unsigned long modelnum = item / GT_PDOM_NOF_FRAMES;
+  unsigned int frame = (unsigned int) (item % GT_PDOM_NOF_FRAMES),
+               frames_left;
+  GtPdomModel *hmm;
+  GtPdomFrameHit *frame_hits = job->frame_hits
+                                 + modelnum * GT_PDOM_NOF_FRAMES;
+
+  hmm = *(GtPdomModel**) gt_array_get(gpf->models, modelnum);
+  frame_hits[frame].sc = gt_hmmer_viterbi(hmm, job->dsq[frame],
+                                          job->seqlen[frame], scratch->mx,
+                                          &frame_hits[frame].tr);
+  gt_mutex_lock(gpf->mutex);
+  frames_left = --job->frames_left[modelnum];
+  gt_mutex_unlock(gpf->mutex);
+  if (frames_left > 0)
+    return;
 
-  if ((retval = pthread_mutex_init(&shared->in_lock, NULL)) != 0)
-  {
-    fprintf(stderr, "Could not initialize lock! %s\n", strerror(retval));
-    exit(EXIT_FAILURE);
-  }
-  if ((retval = pthread_mutex_init(&shared->out_lock, NULL)) != 0)
+  gt_pdom_finish_model(gpf, job, hmm, frame_hits, scratch);
+  gt_mutex_lock(gpf->mutex);
+  if (--job->models_left == 0)
   {
-    fprintf(stderr, "Could not initialize lock! %s\n", strerror(retval));
-    exit(EXIT_FAILURE);
+    job->done = true;
+    gt_condition_broadcast(gpf->job_finished);
   }
+  gt_mutex_unlock(gpf->mutex);
+}
 
-  pthread_attr_init(&attr);
+static void* gt_pdom_worker_thread(void *data)
+{
+  GtPdomWorker *worker = (GtPdomWorker*) data;
+  GtPdomFinder *gpf = worker->gpf;
+  GtPdomJob *job;
+  unsigned long item;
 
-  for (i = 0; i < nof_threads; i++)
+  for (;;)
   {
-    if ((retval = pthread_create(&(shared->thread[i]), &attr,
-           gt_pdom_per_domain_worker_thread, (void *) shared)) != 0)
+    gt_mutex_lock(gpf->mutex);
+    while (!gpf->first_job && !gpf->shutdown)
+      gt_condition_wait(gpf->work_available, gpf->mutex);
+    if (!gpf->first_job)
+    {
+      gt_mutex_unlock(gpf->mutex);
+      break;
+    }
+    /* claim the next item of the oldest job */
+    job = gpf->first_job;
+    item = job->next_item++;
+    if (job->next_item == job->nof_items)
     {
-      fprintf(stderr,"Failed to create thread %d, return code %d\n", i, retval);
-      exit(EXIT_FAILURE);
+      gpf->first_job = job->next;
+      if (!gpf->first_job)
+        gpf->last_job = NULL;
     }
+    gt_mutex_unlock(gpf->mutex);
+
+    gt_pdom_process_item(gpf, job, item, &worker->scratch);
   }
-  pthread_attr_destroy(&attr);
-  return shared;
+  return NULL;
 }
 
-static void gt_pdom_free_shared(GtPdomSharedMem *shared)
+/* hands the work items of <job> to the worker pool and waits until all of
+   them are processed, without workers the items are processed here */
+static void gt_pdom_run_job(GtPdomFinder *gpf, GtPdomJob *job)
 {
-  gt_free(shared->thread);
-  gt_free(shared);
+  unsigned long item;
+  gt_assert(gpf && job && job->nof_items > 0);
+
+  if (gpf->nof_workers == 0)
+  {
+    for (item = 0; item < job->nof_items; item++)
+      gt_pdom_process_item(gpf, job, item, &gpf->scratch);
+    gt_assert(job->done);
+    return;
+  }
+
+  gt_mutex_lock(gpf->mutex);
+  if (gpf->last_job)
+    gpf->last_job->next = job;
+  else
+    gpf->first_job = job;
+  gpf->last_job = job;
+  gt_condition_broadcast(gpf->work_available);
+  while (!job->done)
+    gt_condition_wait(gpf->job_finished, gpf->mutex);
+  gt_mutex_unlock(gpf->mutex);
 }
 
 GtPdomResults* gt_pdom_finder_find(GtPdomFinder *gpf, const char *seq,
                                    const char *rev_seq, GtLTRElement *element,
                                    GtError *err)
 {
-  GtStr *fwd[3], *rev[3];
+  GtStr *frames[GT_PDOM_NOF_FRAMES];
   char translated;
-  unsigned long seqlen = gt_ltrelement_length(element);
-  GtPdomSharedMem *shared = NULL;
+  unsigned long i, nof_models,
+                seqlen = gt_ltrelement_length(element);
   GtPdomResults *results = NULL;
+  GtPdomJob job;
   GtTranslator *tr;
-  int i,
-      had_err = 0;
+  int had_err = 0;
   unsigned int frame;
   gt_assert(seq && rev_seq && strlen(seq) == strlen(rev_seq) && element);
 
-  gpf->elem = element;
   results = gt_pdom_results_new();
   tr = gt_translator_new();
 
-  for (i=0;i<3;i++)
-  {
-    fwd[i] = gt_str_new();
-    rev[i] = gt_str_new();
-  }
+  for (i=0;i<GT_PDOM_NOF_FRAMES;i++)
+    frames[i] = gt_str_new();
 
-  /* create translations */
+  /* create translations, frames 0-2 are on the forward strand */
   had_err = gt_translator_start(tr, seq, seqlen, &translated,
                                 &frame, err);
   while (!had_err && translated)
   {
-    gt_str_append_char(fwd[frame], translated);
+    gt_str_append_char(frames[frame], translated);
     had_err = gt_translator_next(tr, &translated, &frame, NULL);
   }
   if (!had_err)
@@ -822,43 +822,43 @@ GtPdomResults* gt_pdom_finder_find(GtPdomFinder *gpf, const char *seq,
                                   &frame, err);
     while (!had_err && translated)
     {
-      gt_str_append_char(rev[frame], translated);
+      gt_str_append_char(frames[GT_PDOM_NOF_FRAMES/2 + frame], translated);
       had_err = gt_translator_next(tr, &translated, &frame, NULL);
     }
   }
 
-  if (!had_err)
+  nof_models = gt_array_size(gpf->models);
+  if (!had_err && nof_models > 0)
   {
-    for (i=0;i<3;i++)
-    {
-      gt_assert(gt_str_length(fwd[i]) == (seqlen - i) / 3);
-      gt_assert(gt_str_length(rev[i]) == (seqlen - i) / 3);
-    }
-
-    /* start worker threads */
-    shared = gt_pdom_run_threads(gpf->models, gpf->nof_threads,
-                                 fwd, rev, results, gpf);
-
-    /* continue when all threads are done */
-    for (i = 0; i < shared->nof_threads; i++)
+    memset(&job, 0, sizeof (job));
+    job.elem = element;
+    job.results = results;
+    /* the digitized translations are shared by the searches of all models */
+    for (i=0;i<GT_PDOM_NOF_FRAMES;i++)
     {
-      if (pthread_join(shared->thread[i], NULL) != 0)
-      {
-        fprintf(stderr, "Could not join threads!");
-        exit(EXIT_FAILURE);
-      }
+      gt_assert(gt_str_length(frames[i])
+                  == (seqlen - (i % (GT_PDOM_NOF_FRAMES/2))) / 3);
+      job.seqlen[i] = (int) gt_str_length(frames[i]);
+      job.dsq[i] = DigitizeSequence(gt_str_get(frames[i]), job.seqlen[i]);
     }
-
-    /* cleanup */
-    gt_pdom_free_shared(shared);
+    job.frame_hits = gt_calloc(nof_models * GT_PDOM_NOF_FRAMES,
+                               sizeof (GtPdomFrameHit));
+    job.frames_left = gt_malloc(nof_models * sizeof (unsigned int));
+    for (i=0;i<nof_models;i++)
+      job.frames_left[i] = GT_PDOM_NOF_FRAMES;
+    job.nof_items = nof_models * GT_PDOM_NOF_FRAMES;
+    job.models_left = nof_models;
+
+    gt_pdom_run_job(gpf, &job);
+
+    for (i=0;i<GT_PDOM_NOF_FRAMES;i++)
+      free(job.dsq[i]);
+    gt_free(job.frame_hits);
+    gt_free(job.frames_left);
   }
 
-  SqdClean();
-  for (i=0;i<3;i++)
-  {
-    gt_str_delete(fwd[i]);
-    gt_str_delete(rev[i]);
-  }
+  for (i=0;i<GT_PDOM_NOF_FRAMES;i++)
+    gt_str_delete(frames[i]);
 
   gt_translator_delete(tr);
   return results;
@@ -932,6 +932,51 @@ static void gt_pdom_clear_hmms(GtArray *hmms)
   gt_array_delete(hmms);
 }
 
+static void gt_pdom_finder_stop_workers(GtPdomFinder *gpf)
+{
+  unsigned int i;
+  gt_assert(gpf);
+  gt_mutex_lock(gpf->mutex);
+  gpf->shutdown = true;
+  gt_condition_broadcast(gpf->work_available);
+  gt_mutex_unlock(gpf->mutex);
+  for (i = 0; i < gpf->nof_workers; i++)
+  {
+    gt_thread_join(gpf->workers[i].thread);
+    gt_pdom_scratch_free(&gpf->workers[i].scratch);
+  }
+  gt_free(gpf->workers);
+  gpf->workers = NULL;
+  gpf->nof_workers = 0;
+}
+
+/* starts the worker pool which searches the models for all elements, without
+   thread support the elements are searched by the calling thread */
+static int gt_pdom_finder_start_workers(GtPdomFinder *gpf, GtError *err)
+{
+  int had_err = 0;
+  unsigned int i;
+  gt_assert(gpf);
+  if (!gt_thread_support())
+    return 0;
+  gpf->workers = gt_calloc(gpf->nof_threads, sizeof (GtPdomWorker));
+  for (i = 0; !had_err && i < gpf->nof_threads; i++)
+  {
+    GtPdomWorker *worker = gpf->workers + i;
+    worker->gpf = gpf;
+    gt_pdom_scratch_init(&worker->scratch);
+    worker->thread = gt_thread_new(gt_pdom_worker_thread, worker, err);
+    if (!worker->thread)
+    {
+      gt_pdom_scratch_free(&worker->scratch);
+      had_err = -1;
+    }
+    else
+      gpf->nof_workers++;
+  }
+  return had_err;
+}
+
 GtPdomFinder* gt_pdom_finder_new(GtStrArray *hmmfiles, double eval_cutoff,
                                  unsigned int nof_threads,
                                  unsigned int chain_max_gap_length,
@@ -952,12 +997,18 @@ GtPdomFinder* gt_pdom_finder_new(GtStrArray *hmmfiles, double eval_cutoff,
   gpf->thresh.globE   = eval_cutoff;
   gpf->models = gt_array_new(sizeof (struct GtPdomModel*));
 
+  gpf->mutex = gt_mutex_new();
+  gpf->hmmer_lock = gt_mutex_new();
+  gpf->work_available = gt_condition_new();
+  gpf->job_finished = gt_condition_new();
+  gt_pdom_scratch_init(&gpf->scratch);
+
   had_err = gt_pdom_finder_load_files(gpf, hmmfiles, e);
+  if (!had_err)
+    had_err = gt_pdom_finder_start_workers(gpf, e);
   if (had_err)
   {
-    gt_pdom_clear_hmms(gpf->models);
-    gt_str_array_delete(gpf->hmm_files);
-    gt_free(gpf);
+    gt_pdom_finder_delete(gpf);
     return NULL;
   } else return gpf;
 }
@@ -965,8 +1016,15 @@ GtPdomFinder* gt_pdom_finder_new(GtStrArray *hmmfiles, double eval_cutoff,
 void gt_pdom_finder_delete(GtPdomFinder *gpf)
 {
   if (!gpf) return;
+  gt_pdom_finder_stop_workers(gpf);
+  gt_pdom_scratch_free(&gpf->scratch);
+  gt_condition_delete(gpf->job_finished);
+  gt_condition_delete(gpf->work_available);
+  gt_mutex_delete(gpf->hmmer_lock);
+  gt_mutex_delete(gpf->mutex);
   gt_pdom_clear_hmms(gpf->models);
   gt_str_array_delete(gpf->hmm_files);
+  SqdClean();
   gt_free(gpf);
 }
 
@@ -297,73 +297,104 @@ static void gt_group_hits(unsigned int *decoded, GtPPTResults *results,
   gt_free(tmp);
 }
 
-GtPPTResults* gt_ppt_find(const char *seq,
-                          const char *rev_seq,
-                          GtLTRElement *element,
-                          GtPPTOptions *o)
-{
-  unsigned int *encoded_seq=NULL,
-               *decoded=NULL;
+struct GtPPTFinder {
+  GtPPTOptions *opts;
   GtAlphabet *alpha;
   GtHMM *hmm;
+  GtHMMCompiled *chmm;
+};
+
+GtPPTFinder* gt_ppt_finder_new(GtPPTOptions *o)
+{
+  GtPPTFinder *pf;
+  gt_assert(o);
+
+  pf = gt_calloc(1, sizeof (GtPPTFinder));
+  pf->opts = o;
+  pf->alpha = gt_alphabet_new_dna();
+  pf->hmm = gt_ppt_hmm_new(pf->alpha, o);
+  gt_assert(pf->hmm);
+  pf->chmm = gt_hmm_compiled_new(pf->hmm);
+  return pf;
+}
+
+GtPPTResults* gt_ppt_finder_find(const GtPPTFinder *pf, const char *seq,
+                                 const char *rev_seq, GtLTRElement *element)
+{
+  unsigned int *encoded_seq[2],
+               *decoded[2],
+               window_len[2];
+  const char *strand_seq[2];
+  GtPPTOptions *o;
   GtPPTResults *results = NULL;
-  unsigned long i = 0,
-                radius = 0,
+  unsigned long i = 0, j,
+                radius[2],
                 seqlen = gt_ltrelement_length(element),
-                ltrlen = 0;
+                ltrlen[2];
 
-  gt_assert(seq && rev_seq && element && o);
+  gt_assert(pf && seq && rev_seq && element);
+  o = pf->opts;
 
   results = gt_ppt_results_new(element, o);
 
-  alpha = gt_alphabet_new_dna();
-  hmm = gt_ppt_hmm_new(alpha, o);
-
-  /* do PPT finding on forward strand
-   * -------------------------------- */
-  ltrlen = gt_ltrelement_rightltrlen(element);
-  /* make sure that we do not cross the LTR boundary */
-  radius = MIN(o->radius, ltrlen-1);
-  /* encode sequence */
-  encoded_seq = gt_malloc(sizeof (unsigned int) * seqlen);
-  for (i=0;i<seqlen;i++)
-  {
-    encoded_seq[i] = gt_alphabet_encode(alpha, seq[i]);
-  }
-  /* use Viterbi algorithm to decode emissions within radius */
-  decoded = gt_malloc(sizeof (unsigned int) * (2*radius+1));
-  gt_hmm_decode(hmm, decoded,
-                encoded_seq + (seqlen-1) - (ltrlen-1) - radius - 1,
-                2*radius+1);
-  gt_group_hits(decoded, results, radius, GT_STRAND_FORWARD);
-  /* radius length may change in the next strand, so reallocate */
-  gt_free(decoded);
-
-  /* do PPT finding on reverse strand
-   * -------------------------------- */
-  ltrlen = gt_ltrelement_leftltrlen(element);
-  /* make sure that we do not cross the LTR boundary */
-  radius = MIN(o->radius, ltrlen-1);
-  /* encode sequence */
-  for (i=0;i<seqlen;i++)
+  /* the PPT is searched on the forward strand near the right LTR and on the
+     reverse strand near the left LTR */
+  strand_seq[0] = seq;
+  ltrlen[0] = gt_ltrelement_rightltrlen(element);
+  strand_seq[1] = rev_seq;
+  ltrlen[1] = gt_ltrelement_leftltrlen(element);
+  for (i=0;i<2;i++)
   {
-    encoded_seq[i] = gt_alphabet_encode(alpha, rev_seq[i]);
+    const char *window;
+    /* make sure that we do not cross the LTR boundary */
+    radius[i] = MIN(o->radius, ltrlen[i]-1);
+    window_len[i] = (unsigned int) (2*radius[i]+1);
+    window = strand_seq[i] + (seqlen-1) - (ltrlen[i]-1) - radius[i] - 1;
+    /* encode the sequence within radius */
+    encoded_seq[i] = gt_malloc(sizeof (unsigned int) * window_len[i]);
+    for (j=0;j<window_len[i];j++)
+      encoded_seq[i][j] = gt_alphabet_encode(pf->alpha, window[j]);
+    decoded[i] = gt_malloc(sizeof (unsigned int) * window_len[i]);
   }
-  /* use Viterbi algorithm to decode emissions within radius */
-  decoded = gt_malloc(sizeof (unsigned int) * (2*radius+1));
-  gt_hmm_decode(hmm, decoded,
-                encoded_seq + (seqlen-1) - (ltrlen-1) - radius - 1,
-                2*radius+1);
-  gt_group_hits(decoded, results, radius, GT_STRAND_REVERSE);
+
+  /* use Viterbi algorithm to decode emissions of both strands */
+  gt_hmm_compiled_decode_batch(pf->chmm, decoded,
+                               (const unsigned int**) encoded_seq,
+                               window_len, 2);
+  gt_group_hits(decoded[0], results, radius[0], GT_STRAND_FORWARD);
+  gt_group_hits(decoded[1], results, radius[1], GT_STRAND_REVERSE);
 
   /* rank hits by descending score */
   gt_array_sort(results->hits, gt_ppt_hit_cmp);
 
-  gt_free(encoded_seq);
-  gt_free(decoded);
-  gt_alphabet_delete(alpha);
-  gt_hmm_delete(hmm);
+  for (i=0;i<2;i++)
+  {
+    gt_free(encoded_seq[i]);
+    gt_free(decoded[i]);
+  }
+
+  return results;
+}
+
+void gt_ppt_finder_delete(GtPPTFinder *pf)
+{
+  if (!pf) return;
+  gt_hmm_compiled_delete(pf->chmm);
+  gt_hmm_delete(pf->hmm);
+  gt_alphabet_delete(pf->alpha);
+  gt_free(pf);
+}
 
+GtPPTResults* gt_ppt_find(const char *seq,
+                          const char *rev_seq,
+                          GtLTRElement *element,
+                          GtPPTOptions *o)
+{
+  GtPPTFinder *pf;
+  GtPPTResults *results;
+  pf = gt_ppt_finder_new(o);
+  results = gt_ppt_finder_find(pf, seq, rev_seq, element);
+  gt_ppt_finder_delete(pf);
   return results;
 }
 
@@ -45,11 +45,22 @@ typedef struct {
   unsigned int radius;
 } GtPPTOptions;
 
+typedef struct GtPPTFinder GtPPTFinder;
 typedef struct GtPPTHit GtPPTHit;
 typedef struct GtPPTResults GtPPTResults;
 
 GtHMM* gt_ppt_hmm_new(const GtAlphabet *alphabet, GtPPTOptions *opts);
 
+/* Builds and compiles the PPT HMM for <o> once for the search in many LTR
+   elements. The finder is not changed by a search, so it can be used by
+   several threads at once. <o> must be valid and stay valid while the finder
+   is used. */
+GtPPTFinder*    gt_ppt_finder_new(GtPPTOptions *o);
+GtPPTResults*   gt_ppt_finder_find(const GtPPTFinder*, const char *seq,
+                                   const char *rev_seq, GtLTRElement *element);
+void            gt_ppt_finder_delete(GtPPTFinder*);
+
+/* Like <gt_ppt_finder_find()> with a finder used for this element only. */
 GtPPTResults*   gt_ppt_find(const char *seq,
                             const char *rev_seq,
                             GtLTRElement *element,
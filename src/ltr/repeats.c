@@ -15,7 +15,6 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
-#include <stdio.h>
 #include "core/arraydef.h"
 #include "core/error.h"
 #include "core/log.h"
@@ -26,48 +25,18 @@
 #include "ltrharvest-opt.h"
 #include "repeats.h"
 
-void showrepeats (RepeatInfo *repeatinfo,unsigned long seedminlength)
-{
-  GtArrayRepeat *repeats = &repeatinfo->repeats;
-  Repeat *reptab = repeats->spaceRepeat;
-  unsigned long i;
-
-  printf("# there are %lu seed-pairs as candidates for LTRs\n"
-         "# of user defined minimal seedlength %lu:",
-          repeats->nextfreeRepeat, seedminlength);
-  if (repeats->nextfreeRepeat == (unsigned long)0)
-  {
-    /* no repeats */
-    printf ("\nnone");
-  }
-  else
-  {
-    for (i = 0; i < repeats->nextfreeRepeat; i++)
-    {
-      printf ("\n#   len: " FormatSeqpos " ", PRINTSeqposcast(reptab[i].len));
-      printf ("pos1: " FormatSeqpos " ", PRINTSeqposcast(reptab[i].pos1));
-      printf ("pos2: " FormatSeqpos " ",
-              PRINTSeqposcast((reptab[i].pos1 + reptab[i].offset)));
-      printf ("offset: " FormatSeqpos " ", PRINTSeqposcast(reptab[i].offset));
-    }
-  }
-  printf ("\n");
-}
-
-int simpleexactselfmatchstore (void *info,
-                               Seqpos len,
-                               Seqpos pos1,
-                               Seqpos pos2,
-                               GT_UNUSED GtError *err)
+bool simpleexactselfmatchaccept(Repeat *repeat,
+                                const RepeatInfo *repeatinfo,
+                                Seqpos len,
+                                Seqpos pos1,
+                                Seqpos pos2)
 {
   Seqpos tmp;
   unsigned long contignumber = 0,
                 seqnum1,
                 seqnum2;
   bool samecontig = false;
-  RepeatInfo *repeatinfo = (RepeatInfo *) info;
 
-  gt_error_check(err);
   if (pos1 > pos2)
   {
     tmp = pos1;
@@ -80,7 +49,7 @@ int simpleexactselfmatchstore (void *info,
     if (pos1 < (Seqpos) repeatinfo->ltrsearchseqrange.start  ||
         pos2 + len - 1 > (Seqpos) repeatinfo->ltrsearchseqrange.end)
     {
-      return 0;
+      return false;
     }
   }
 
@@ -100,22 +69,19 @@ int simpleexactselfmatchstore (void *info,
   if (samecontig && len <= (Seqpos) repeatinfo->lmax &&
       (Seqpos) repeatinfo->dmin <= tmp && tmp <= (Seqpos) repeatinfo->dmax)
   {
-    Repeat *nextfreerepeatptr;
-
-    GT_GETNEXTFREEINARRAY(nextfreerepeatptr, &repeatinfo->repeats,
-                       Repeat, 10);
     gt_log_log("maximal repeat pos1: " FormatSeqpos "\n",
                PRINTSeqposcast(pos1));
     gt_log_log("maximal repeat pos2: " FormatSeqpos "\n",
                PRINTSeqposcast(pos2));
     gt_log_log("len: " FormatSeqpos "\n", PRINTSeqposcast(len));
     gt_log_log("seq number: %lu\n\n", contignumber);
-    nextfreerepeatptr->pos1 = pos1;
-    nextfreerepeatptr->offset = tmp;
-    nextfreerepeatptr->len = len;
-    nextfreerepeatptr->contignumber = contignumber;
+    repeat->pos1 = pos1;
+    repeat->offset = tmp;
+    repeat->len = len;
+    repeat->contignumber = contignumber;
+    return true;
   }
-  return 0;
+  return false;
 }
 
 int subsimpleexactselfmatchstore(void *info,
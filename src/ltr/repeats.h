@@ -22,11 +22,14 @@
 #include "repeattypes.h"
 #include "ltrharvest-opt.h"
 
-void showrepeats (RepeatInfo *repeatinfo,
-                  unsigned long seedminlength);
-
-int simpleexactselfmatchstore(void *info,Seqpos len,Seqpos pos1, Seqpos pos2,
-                              GtError *err);
+/* Returns true if the maximal repeat of length <len> at <pos1> and <pos2>
+   fulfills the length and distance constraints of <repeatinfo> and both
+   instances lie on the same sequence. In this case <repeat> is filled. */
+bool simpleexactselfmatchaccept(Repeat *repeat,
+                                const RepeatInfo *repeatinfo,
+                                Seqpos len,
+                                Seqpos pos1,
+                                Seqpos pos2);
 
 int subsimpleexactselfmatchstore(void *info,
                                  unsigned long len,
@@ -36,11 +36,10 @@ typedef struct
 
 GT_DECLAREARRAYSTRUCT(Repeat);
 
-/* The datatype RepeatInfo stores all maximal repeats (seeds) and */
-/* information about the length and distance constraints. */
+/* The datatype RepeatInfo stores information about the length and */
+/* distance constraints of the maximal repeats (seeds). */
 typedef struct
 {
-  GtArrayRepeat repeats; /* array of maximal repeats (seeds) */
   unsigned long lmin;        /* minimum allowed length of a LTR */
   unsigned long lmax;        /* maximum allowed length of a LTR */
   unsigned long dmin;        /* minimum distance between LTRs */
@@ -94,247 +94,279 @@ static void adjustboundariesfromXdropextension(Myxdropbest xdropbest_left,
  */
 }
 
+struct LTRsearch
+{
+  LTRharvestoptions *lo;
+  GtArrayLTRboundaries *arrayLTRboundaries;
+  const Encodedsequence *encseq;
+  GtUchar *useq, /* buffers for the LTR sequences of a candidate pair */
+          *vseq;
+  Seqpos maxulen,
+         maxvlen;
+};
+
+LTRsearch *newLTRsearch(LTRharvestoptions *lo,
+                        GtArrayLTRboundaries *arrayLTRboundaries,
+                        const Encodedsequence *encseq)
+{
+  LTRsearch *ltrsearch;
+
+  ALLOCASSIGNSPACE(ltrsearch,NULL,LTRsearch,1);
+  ltrsearch->lo = lo;
+  ltrsearch->arrayLTRboundaries = arrayLTRboundaries;
+  ltrsearch->encseq = encseq;
+  ltrsearch->useq = NULL;
+  ltrsearch->vseq = NULL;
+  ltrsearch->maxulen = 0;
+  ltrsearch->maxvlen = 0;
+  return ltrsearch;
+}
+
+void freeLTRsearch(LTRsearch *ltrsearch)
+{
+  if (ltrsearch == NULL)
+  {
+    return;
+  }
+  FREESPACE(ltrsearch->useq);
+  FREESPACE(ltrsearch->vseq);
+  FREESPACE(ltrsearch);
+}
+
 /*
  The following function applies the filter algorithms one after another
- to all candidate pairs.
+ to a candidate pair.
 */
-int searchforLTRs(LTRharvestoptions *lo,
-                  GtArrayLTRboundaries *arrayLTRboundaries,
-                  const Encodedsequence *encseq,
-                  GtError *err)
+static int searchforLTRsfromrepeat(LTRsearch *ltrsearch,
+                                   const Repeat *repeatptr,
+                                   GtError *err)
 {
-  unsigned long repeatcounter;
+  LTRharvestoptions *lo = ltrsearch->lo;
+  GtArrayLTRboundaries *arrayLTRboundaries = ltrsearch->arrayLTRboundaries;
+  const Encodedsequence *encseq = ltrsearch->encseq;
   GtArrayMyfrontvalue fronts;
   Myxdropbest xdropbest_left;
   Myxdropbest xdropbest_right;
   Seqpos alilen = 0,
          totallength,
          ulen,
-         vlen,
-         maxulen = 0,
-         maxvlen = 0;
-  GtUchar *useq = NULL,
-        *vseq = NULL;
+         vlen;
   unsigned long edist;
-  Repeat *repeatptr;
   LTRboundaries *boundaries;
-  bool haserr = false;
-
-  gt_error_check(err);
 
-  /*
-  printf("xdropbelowscore = %d\n", lo->xdropbelowscore);
-  printf("scores:\n");
-  printf("mat  = %d\n", lo->arbitscores.mat);
-  printf("mis  = %d\n", lo->arbitscores.mis);
-  printf("ins  = %d\n", lo->arbitscores.ins);
-  printf("del  = %d\n", lo->arbitscores.del);
-  */
+  alilen = ((Seqpos)lo->repeatinfo.lmax) - repeatptr->len;
 
-  for (repeatcounter = 0; repeatcounter < lo->repeatinfo.repeats.nextfreeRepeat;
-       repeatcounter++)
+  /**** left (reverse) xdrop alignment ****/
+  GT_INITARRAY (&fronts, Myfrontvalue);
+  if (alilen <= repeatptr->pos1)
   {
-    /* printf("\n\nAlignments of repeat nr. = %u :\n", repeatcounter+1); */
-
-    repeatptr = &(lo->repeatinfo.repeats.spaceRepeat[repeatcounter]);
-    alilen = ((Seqpos)lo->repeatinfo.lmax) - repeatptr->len;
+    evalxdroparbitscoresleft(&lo->arbitscores,
+                             &xdropbest_left,
+                             &fronts,
+                             encseq,
+                             encseq,
+                             repeatptr->pos1,
+                             repeatptr->pos1 + repeatptr->offset,
+                             (int) alilen,
+                             (int) alilen,
+                             (Xdropscore)lo->xdropbelowscore);
+  }
+  else /* do not align over left sequence boundary */
+  {
+    evalxdroparbitscoresleft(&lo->arbitscores,
+                             &xdropbest_left,
+                             &fronts,
+                             encseq,
+                             encseq,
+                             repeatptr->pos1,
+                             repeatptr->pos1 + repeatptr->offset,
+                             (int) repeatptr->pos1,
+                             (int) (repeatptr->pos1 + repeatptr->offset),
+                             (Xdropscore)lo->xdropbelowscore);
+  }
+  GT_FREEARRAY (&fronts, Myfrontvalue);
 
-    /**** left (reverse) xdrop alignment ****/
-    GT_INITARRAY (&fronts, Myfrontvalue);
-    if (alilen <= repeatptr->pos1)
-    {
-      evalxdroparbitscoresleft(&lo->arbitscores,
-                               &xdropbest_left,
+  /**** right xdrop alignment ****/
+  GT_INITARRAY (&fronts, Myfrontvalue);
+  totallength = getencseqtotallength(encseq);
+  if (alilen <= totallength - (repeatptr->pos1 + repeatptr->offset +
+                              repeatptr->len) )
+  {
+    evalxdroparbitscoresright (&lo->arbitscores,
+                               &xdropbest_right,
                                &fronts,
                                encseq,
                                encseq,
-                               repeatptr->pos1,
-                               repeatptr->pos1 + repeatptr->offset,
+                               repeatptr->pos1 + repeatptr->len,
+                               repeatptr->pos1 + repeatptr->offset +
+                               repeatptr->len,
                                (int) alilen,
                                (int) alilen,
-                               (Xdropscore)lo->xdropbelowscore);
-    }
-    else /* do not align over left sequence boundary */
-    {
-      evalxdroparbitscoresleft(&lo->arbitscores,
-                               &xdropbest_left,
-                               &fronts,
-                               encseq,
-                               encseq,
-                               repeatptr->pos1,
-                               repeatptr->pos1 + repeatptr->offset,
-                               (int) repeatptr->pos1,
-                               (int) (repeatptr->pos1 + repeatptr->offset),
-                               (Xdropscore)lo->xdropbelowscore);
-    }
-    GT_FREEARRAY (&fronts, Myfrontvalue);
+                               lo->xdropbelowscore);
+  }
+  else /* do not align over right sequence boundary */
+  {
+    evalxdroparbitscoresright(&lo->arbitscores,
+                              &xdropbest_right,
+                              &fronts,
+                              encseq,
+                              encseq,
+                              repeatptr->pos1 + repeatptr->len,
+                              repeatptr->pos1 + repeatptr->offset +
+                              repeatptr->len,
+                              (int) (totallength -
+                              (repeatptr->pos1 + repeatptr->len)),
+                              (int) (totallength -
+                              (repeatptr->pos1 + repeatptr->offset +
+                               repeatptr->len)),
+                              lo->xdropbelowscore);
+  }
+  GT_FREEARRAY (&fronts, Myfrontvalue);
+
+  GT_GETNEXTFREEINARRAY(boundaries,arrayLTRboundaries,LTRboundaries,5);
+
+  boundaries->contignumber = repeatptr->contignumber;
+  boundaries->leftLTR_5 = (Seqpos) 0;
+  boundaries->leftLTR_3 = (Seqpos) 0;
+  boundaries->rightLTR_5 = (Seqpos) 0;
+  boundaries->rightLTR_3 = (Seqpos) 0;
+  boundaries->lenleftTSD = (Seqpos) 0;
+  boundaries->lenrightTSD = (Seqpos) 0;
+  boundaries->tsd = false;
+  boundaries->motif_near_tsd = false;
+  boundaries->motif_far_tsd = false;
+  boundaries->skipped = false;
+  boundaries->similarity = 0.0;
+
+  /* test
+  printf("contig number: %lu\n",
+             boundaries->contignumber);
+  printf("offset to contig startpos: " FormatSeqpos "\n",
+             PRINTSeqposcast(offset));
+
+  printf("Boundaries from vmatmaxoutdynamic:\n");
+
+  printf("boundaries->leftLTR_5 abs. = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1));
+  printf("boundaries->rightLTR_5 abs. = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset));
 
-    /**** right xdrop alignment ****/
-    GT_INITARRAY (&fronts, Myfrontvalue);
-    totallength = getencseqtotallength(encseq);
-    if (alilen <= totallength - (repeatptr->pos1 + repeatptr->offset +
-                                repeatptr->len) )
+  printf("boundaries->leftLTR_5  = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1 - offset));
+  printf("boundaries->leftLTR_3  = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1 + repeatptr->len - 1
+                      - offset));
+  printf("boundaries->rightLTR_5 = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset
+                      - offset));
+  printf("boundaries->rightLTR_3 = " FormatSeqpos "\n",
+            PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset +
+                      repeatptr->len - 1 - offset));
+  */
+
+  /* store new boundaries-positions in boundaries */
+  adjustboundariesfromXdropextension(
+                 xdropbest_left,
+                 xdropbest_right,
+                 repeatptr->pos1,  /*seed1 startpos*/
+                 repeatptr->pos1 + repeatptr->offset, /*seed2 startpos*/
+                 repeatptr->pos1 + repeatptr->len - 1, /*seed1 endpos*/
+                 repeatptr->pos1 + repeatptr->offset + repeatptr->len - 1,
+                                                       /*seed2 endpos*/
+                 boundaries);
+
+  /* if search for motif and/or TSD */
+  if ( lo->motif.allowedmismatches < 4U || lo->minlengthTSD > 1U)
+  {
+    if ( findcorrectboundaries(lo, boundaries, encseq, err) != 0 )
     {
-      evalxdroparbitscoresright (&lo->arbitscores,
-                                 &xdropbest_right,
-                                 &fronts,
-                                 encseq,
-                                 encseq,
-                                 repeatptr->pos1 + repeatptr->len,
-                                 repeatptr->pos1 + repeatptr->offset +
-                                 repeatptr->len,
-                                 (int) alilen,
-                                 (int) alilen,
-                                 lo->xdropbelowscore);
+      return -1;
     }
-    else /* do not align over right sequence boundary */
+
+    /* if search for TSDs and (not) motif */
+    if ( boundaries->tsd &&
+        (lo->motif.allowedmismatches >= (unsigned int)4 ||
+        (boundaries->motif_near_tsd && boundaries->motif_far_tsd)) )
     {
-      evalxdroparbitscoresright(&lo->arbitscores,
-                                &xdropbest_right,
-                                &fronts,
-                                encseq,
-                                encseq,
-                                repeatptr->pos1 + repeatptr->len,
-                                repeatptr->pos1 + repeatptr->offset +
-                                repeatptr->len,
-                                (int) (totallength -
-                                (repeatptr->pos1 + repeatptr->len)),
-                                (int) (totallength -
-                                (repeatptr->pos1 + repeatptr->offset +
-                                 repeatptr->len)),
-                                lo->xdropbelowscore);
+      /* predicted as full LTR-pair, keep it */
     }
-    GT_FREEARRAY (&fronts, Myfrontvalue);
-
-    GT_GETNEXTFREEINARRAY(boundaries,arrayLTRboundaries,LTRboundaries,5);
-
-    boundaries->contignumber = repeatptr->contignumber;
-    boundaries->leftLTR_5 = (Seqpos) 0;
-    boundaries->leftLTR_3 = (Seqpos) 0;
-    boundaries->rightLTR_5 = (Seqpos) 0;
-    boundaries->rightLTR_3 = (Seqpos) 0;
-    boundaries->lenleftTSD = (Seqpos) 0;
-    boundaries->lenrightTSD = (Seqpos) 0;
-    boundaries->tsd = false;
-    boundaries->motif_near_tsd = false;
-    boundaries->motif_far_tsd = false;
-    boundaries->skipped = false;
-    boundaries->similarity = 0.0;
-
-    /* test
-    printf("contig number: %lu\n",
-               boundaries->contignumber);
-    printf("offset to contig startpos: " FormatSeqpos "\n",
-               PRINTSeqposcast(offset));
-
-    printf("Boundaries from vmatmaxoutdynamic:\n");
-
-    printf("boundaries->leftLTR_5 abs. = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1));
-    printf("boundaries->rightLTR_5 abs. = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset));
-
-    printf("boundaries->leftLTR_5  = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1 - offset));
-    printf("boundaries->leftLTR_3  = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1 + repeatptr->len - 1
-                        - offset));
-    printf("boundaries->rightLTR_5 = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset
-                        - offset));
-    printf("boundaries->rightLTR_3 = " FormatSeqpos "\n",
-              PRINTSeqposcast(repeatptr->pos1 + repeatptr->offset +
-                        repeatptr->len - 1 - offset));
-    */
-
-    /* store new boundaries-positions in boundaries */
-    adjustboundariesfromXdropextension(
-                   xdropbest_left,
-                   xdropbest_right,
-                   repeatptr->pos1,  /*seed1 startpos*/
-                   repeatptr->pos1 + repeatptr->offset, /*seed2 startpos*/
-                   repeatptr->pos1 + repeatptr->len - 1, /*seed1 endpos*/
-                   repeatptr->pos1 + repeatptr->offset + repeatptr->len - 1,
-                                                         /*seed2 endpos*/
-                   boundaries);
-
-    /* if search for motif and/or TSD */
-    if ( lo->motif.allowedmismatches < 4U || lo->minlengthTSD > 1U)
+    else
     {
-      if ( findcorrectboundaries(lo, boundaries, encseq, err) != 0 )
-      {
-        haserr = true;
-        break;
-      }
-
-      /* if search for TSDs and (not) motif */
-      if ( boundaries->tsd &&
-          (lo->motif.allowedmismatches >= (unsigned int)4 ||
-          (boundaries->motif_near_tsd && boundaries->motif_far_tsd)) )
+      /* if search for motif only (and not TSD) */
+      if ( lo->minlengthTSD <= 1U &&
+          boundaries->motif_near_tsd &&
+          boundaries->motif_far_tsd )
       {
         /* predicted as full LTR-pair, keep it */
       }
       else
       {
-        /* if search for motif only (and not TSD) */
-        if ( lo->minlengthTSD <= 1U &&
-            boundaries->motif_near_tsd &&
-            boundaries->motif_far_tsd )
-        {
-          /* predicted as full LTR-pair, keep it */
-        }
-        else
-        {
-          /* delete this LTR-pair candidate */
-          arrayLTRboundaries->nextfreeLTRboundaries--;
-          continue;
-        }
+        /* delete this LTR-pair candidate */
+        arrayLTRboundaries->nextfreeLTRboundaries--;
+        return 0;
       }
     }
+  }
 
-    /* check length and distance constraints again */
-    if (!checklengthanddistanceconstraints(boundaries, &lo->repeatinfo))
-    {
-      /* delete this LTR-pair candidate */
-      arrayLTRboundaries->nextfreeLTRboundaries--;
-      continue;
-    }
-
-    /* check similarity from candidate pair
-       copy LTR sequences for greedyunitedist function */
-    ulen = boundaries->leftLTR_3 - boundaries->leftLTR_5 + 1;
-    vlen = boundaries->rightLTR_3 - boundaries->rightLTR_5 + 1;
-    if (ulen > maxulen)
-    {
-      maxulen = ulen;
-      ALLOCASSIGNSPACE(useq, useq, GtUchar, maxulen);
-    }
-    if (vlen > maxvlen)
-    {
-      maxvlen = vlen;
-      ALLOCASSIGNSPACE(vseq, vseq, GtUchar, maxvlen);
-    }
+  /* check length and distance constraints again */
+  if (!checklengthanddistanceconstraints(boundaries, &lo->repeatinfo))
+  {
+    /* delete this LTR-pair candidate */
+    arrayLTRboundaries->nextfreeLTRboundaries--;
+    return 0;
+  }
 
-    encseqextract(useq,encseq,boundaries->leftLTR_5,boundaries->leftLTR_3);
-    encseqextract(vseq,encseq,boundaries->rightLTR_5,boundaries->rightLTR_3);
-    edist = greedyunitedist(useq,(unsigned long) ulen, /*Implement for encseq */
-                            vseq,(unsigned long) vlen);
+  /* check similarity from candidate pair
+     copy LTR sequences for greedyunitedist function */
+  ulen = boundaries->leftLTR_3 - boundaries->leftLTR_5 + 1;
+  vlen = boundaries->rightLTR_3 - boundaries->rightLTR_5 + 1;
+  if (ulen > ltrsearch->maxulen)
+  {
+    ltrsearch->maxulen = ulen;
+    ALLOCASSIGNSPACE(ltrsearch->useq, ltrsearch->useq, GtUchar, ulen);
+  }
+  if (vlen > ltrsearch->maxvlen)
+  {
+    ltrsearch->maxvlen = vlen;
+    ALLOCASSIGNSPACE(ltrsearch->vseq, ltrsearch->vseq, GtUchar, vlen);
+  }
 
-    /* determine similarity */
-    boundaries->similarity = 100.0 *
-                             (1 - (((double) edist)/(MAX(ulen,vlen))));
+  encseqextract(ltrsearch->useq,encseq,boundaries->leftLTR_5,
+                boundaries->leftLTR_3);
+  encseqextract(ltrsearch->vseq,encseq,boundaries->rightLTR_5,
+                boundaries->rightLTR_3);
+  edist = greedyunitedist(ltrsearch->useq,(unsigned long) ulen,
+                          /*Implement for encseq */
+                          ltrsearch->vseq,(unsigned long) vlen);
+
+  /* determine similarity */
+  boundaries->similarity = 100.0 *
+                           (1 - (((double) edist)/(MAX(ulen,vlen))));
+
+  if (gt_double_smaller_double(boundaries->similarity,
+                               lo->similaritythreshold))
+  /* if ( boundaries->similarity < lo->similaritythreshold ) */
+  {
+    /* delete this LTR-pair candidate */
+    arrayLTRboundaries->nextfreeLTRboundaries--;
+  }
+  return 0;
+}
 
-    if (gt_double_smaller_double(boundaries->similarity,
-                                 lo->similaritythreshold))
-    /* if ( boundaries->similarity < lo->similaritythreshold ) */
-    {
-      /* delete this LTR-pair candidate */
-      arrayLTRboundaries->nextfreeLTRboundaries--;
-    }
+int searchforLTRs(void *info,
+                  Seqpos len,
+                  Seqpos pos1,
+                  Seqpos pos2,
+                  GtError *err)
+{
+  LTRsearch *ltrsearch = (LTRsearch *) info;
+  Repeat repeat;
 
+  gt_error_check(err);
+  if (!simpleexactselfmatchaccept(&repeat,&ltrsearch->lo->repeatinfo,
+                                  len,pos1,pos2))
+  {
+    return 0;
   }
-  FREESPACE(useq);
-  FREESPACE(vseq);
-
-  return haserr ? -1 : 0;
+  return searchforLTRsfromrepeat(ltrsearch,&repeat,err);
 }
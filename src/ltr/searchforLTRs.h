@@ -23,9 +23,25 @@
 #include "repeattypes.h"
 #include "ltrharvest-opt.h"
 
-int searchforLTRs(LTRharvestoptions *lo,
-                  GtArrayLTRboundaries *arrayLTRboundaries,
-                  const Encodedsequence *encseq,
+typedef struct LTRsearch LTRsearch;
+
+LTRsearch *newLTRsearch(LTRharvestoptions *lo,
+                        GtArrayLTRboundaries *arrayLTRboundaries,
+                        const Encodedsequence *encseq);
+
+void freeLTRsearch(LTRsearch *ltrsearch);
+
+/*
+ The following function is called by enumeratemaxpairs with an LTRsearch
+ as <info> for each maximal repeat. A repeat which is a seed of a candidate
+ pair is extended and filtered at once, and the candidate is appended to the
+ array of LTR boundaries if it passes all filters. Hence the seeds are not
+ stored and the memory only depends on the number of predictions.
+ */
+int searchforLTRs(void *info,
+                  Seqpos len,
+                  Seqpos pos1,
+                  Seqpos pos2,
                   GtError *err);
 
 #endif
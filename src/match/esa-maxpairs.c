@@ -16,6 +16,7 @@
 */
 
 #include "core/arraydef.h"
+#include "core/thread.h"
 #include "core/unused_api.h"
 #include "spacedef.h"
 #include "seqpos-def.h"
@@ -345,15 +346,15 @@ static int processbranchedge(bool firstsucc,
   return 0;
 }
 
-int enumeratemaxpairs(Sequentialsuffixarrayreader *ssar,
-                      const Encodedsequence *encseq,
-                      Readmode readmode,
-                      unsigned int searchlength,
-                      int(*processmaxpairs)(void *,Seqpos,Seqpos,
-                                            Seqpos,GtError *),
-                      void *processmaxpairsinfo,
-                      Verboseinfo *verboseinfo,
-                      GtError *err)
+static int dfsmaxpairs(Sequentialsuffixarrayreader *ssar,
+                       const Encodedsequence *encseq,
+                       Readmode readmode,
+                       unsigned int searchlength,
+                       int(*processmaxpairs)(void *,Seqpos,Seqpos,
+                                             Seqpos,GtError *),
+                       void *processmaxpairsinfo,
+                       Verboseinfo *verboseinfo,
+                       GtError *err)
 {
   unsigned int base;
   ArraySeqpos *ptr;
@@ -399,9 +400,267 @@ int enumeratemaxpairs(Sequentialsuffixarrayreader *ssar,
   return haserr ? -1 : 0;
 }
 
+#ifndef INLINEDSequentialsuffixarrayreader
+
+/* the suffix array is split into PARTSPERTHREAD parts per thread, so that
+   threads which finish a part early can continue with another one */
+#define PARTSPERTHREAD 8U
+
+typedef struct
+{
+  Sequentialsuffixarrayreader *ssar;
+  ArraySeqpos maxpairs; /* triples (len,pos1,pos2) in the order of the dfs */
+  GtError *err;
+  int had_err;
+  bool done;
+} Maxpairspart;
+
+typedef struct
+{
+  Maxpairspart *parts;
+  unsigned long numofparts,
+                nextpart,
+                nextconsumed, /* the part processmaxpairs continues with */
+                maxpending;   /* parts which can be ahead of nextconsumed */
+  const Encodedsequence *encseq;
+  Readmode readmode;
+  unsigned int searchlength;
+  bool stop;
+  GtMutex *mutex;
+  GtCondition *partdone,
+              *partconsumed;
+} Maxpairsthreadinfo;
+
+static int bufferonemaxpair(void *info,Seqpos len,Seqpos pos1,Seqpos pos2,
+                            GT_UNUSED GtError *err)
+{
+  ArraySeqpos *maxpairs = (ArraySeqpos *) info;
+
+  if (maxpairs->nextfreeSeqpos + 3 > maxpairs->allocatedSeqpos)
+  {
+    /* grow geometrically, a part may deliver many maximal pairs */
+    maxpairs->allocatedSeqpos += maxpairs->allocatedSeqpos/2 + 3 * 1024;
+    ALLOCASSIGNSPACE(maxpairs->spaceSeqpos,maxpairs->spaceSeqpos,Seqpos,
+                     maxpairs->allocatedSeqpos);
+  }
+  maxpairs->spaceSeqpos[maxpairs->nextfreeSeqpos++] = len;
+  maxpairs->spaceSeqpos[maxpairs->nextfreeSeqpos++] = pos1;
+  maxpairs->spaceSeqpos[maxpairs->nextfreeSeqpos++] = pos2;
+  return 0;
+}
+
+static void *enumeratemaxpairsthread(void *data)
+{
+  Maxpairsthreadinfo *threadinfo = (Maxpairsthreadinfo *) data;
+  Maxpairspart *part;
+
+  gt_mutex_lock(threadinfo->mutex);
+  for (;;)
+  {
+    /* do not run ahead of the consumer, as the maximal pairs of all parts
+       which have not been consumed are kept in memory */
+    while (!threadinfo->stop &&
+           threadinfo->nextpart < threadinfo->numofparts &&
+           threadinfo->nextpart >= threadinfo->nextconsumed +
+                                   threadinfo->maxpending)
+    {
+      gt_condition_wait(threadinfo->partconsumed,threadinfo->mutex);
+    }
+    if (threadinfo->stop || threadinfo->nextpart >= threadinfo->numofparts)
+    {
+      break;
+    }
+    part = threadinfo->parts + threadinfo->nextpart++;
+    gt_mutex_unlock(threadinfo->mutex);
+    part->had_err = dfsmaxpairs(part->ssar,
+                                threadinfo->encseq,
+                                threadinfo->readmode,
+                                threadinfo->searchlength,
+                                bufferonemaxpair,
+                                &part->maxpairs,
+                                NULL,
+                                part->err);
+    gt_mutex_lock(threadinfo->mutex);
+    part->done = true;
+    gt_condition_broadcast(threadinfo->partdone);
+  }
+  gt_mutex_unlock(threadinfo->mutex);
+  return NULL;
+}
+
+/* Enumerate the maximal pairs of the parts of the split suffix array in
+   <numofthreads> threads. The maximal pairs of each part are buffered and
+   handed over to <processmaxpairs> in the calling thread in the order of the
+   parts, which is the order in which the sequential dfs delivers them. At most
+   <numofthreads> + 1 parts are processed or buffered at any time, so that the
+   memory for the buffered maximal pairs stays bounded. */
+
+static int threadedmaxpairs(Sequentialsuffixarrayreader **splitssar,
+                            unsigned long numofparts,
+                            const Encodedsequence *encseq,
+                            Readmode readmode,
+                            unsigned int searchlength,
+                            unsigned int numofthreads,
+                            int(*processmaxpairs)(void *,Seqpos,Seqpos,
+                                                  Seqpos,GtError *),
+                            void *processmaxpairsinfo,
+                            GtError *err)
+{
+  Maxpairsthreadinfo threadinfo;
+  GtThread **threads;
+  Maxpairspart *part;
+  const Seqpos *spptr;
+  unsigned long idx, numofstartedthreads = 0;
+  bool haserr = false;
+
+  threadinfo.numofparts = numofparts;
+  threadinfo.nextpart = 0;
+  threadinfo.nextconsumed = 0;
+  threadinfo.maxpending = (unsigned long) numofthreads + 1;
+  threadinfo.encseq = encseq;
+  threadinfo.readmode = readmode;
+  threadinfo.searchlength = searchlength;
+  threadinfo.stop = false;
+  threadinfo.mutex = gt_mutex_new();
+  threadinfo.partdone = gt_condition_new();
+  threadinfo.partconsumed = gt_condition_new();
+  ALLOCASSIGNSPACE(threadinfo.parts,NULL,Maxpairspart,numofparts);
+  for (idx = 0; idx < numofparts; idx++)
+  {
+    part = threadinfo.parts + idx;
+    part->ssar = splitssar[idx];
+    GT_INITARRAY(&part->maxpairs,Seqpos);
+    part->err = gt_error_new();
+    part->had_err = 0;
+    part->done = false;
+  }
+  ALLOCASSIGNSPACE(threads,NULL,GtThread *,numofthreads);
+  for (idx = 0; idx < (unsigned long) numofthreads; idx++)
+  {
+    threads[idx] = gt_thread_new(enumeratemaxpairsthread,&threadinfo,err);
+    if (threads[idx] == NULL)
+    {
+      haserr = true;
+      break;
+    }
+    numofstartedthreads++;
+  }
+  for (idx = 0; !haserr && idx < numofparts; idx++)
+  {
+    part = threadinfo.parts + idx;
+    gt_mutex_lock(threadinfo.mutex);
+    while (!part->done)
+    {
+      gt_condition_wait(threadinfo.partdone,threadinfo.mutex);
+    }
+    gt_mutex_unlock(threadinfo.mutex);
+    if (part->had_err != 0)
+    {
+      gt_error_set(err,"%s",gt_error_get(part->err));
+      haserr = true;
+      break;
+    }
+    for (spptr = part->maxpairs.spaceSeqpos;
+         spptr < part->maxpairs.spaceSeqpos + part->maxpairs.nextfreeSeqpos;
+         spptr += 3)
+    {
+      if (processmaxpairs(processmaxpairsinfo,spptr[0],spptr[1],spptr[2],
+                          err) != 0)
+      {
+        haserr = true;
+        break;
+      }
+    }
+    GT_FREEARRAY(&part->maxpairs,Seqpos);
+    gt_mutex_lock(threadinfo.mutex);
+    threadinfo.nextconsumed = idx + 1;
+    gt_condition_broadcast(threadinfo.partconsumed);
+    gt_mutex_unlock(threadinfo.mutex);
+  }
+  gt_mutex_lock(threadinfo.mutex);
+  threadinfo.stop = true;
+  gt_condition_broadcast(threadinfo.partconsumed);
+  gt_mutex_unlock(threadinfo.mutex);
+  for (idx = 0; idx < numofstartedthreads; idx++)
+  {
+    gt_thread_join(threads[idx]);
+  }
+  for (idx = 0; idx < numofparts; idx++)
+  {
+    part = threadinfo.parts + idx;
+    GT_FREEARRAY(&part->maxpairs,Seqpos);
+    gt_error_delete(part->err);
+  }
+  FREESPACE(threads);
+  FREESPACE(threadinfo.parts);
+  gt_condition_delete(threadinfo.partdone);
+  gt_condition_delete(threadinfo.partconsumed);
+  gt_mutex_delete(threadinfo.mutex);
+  return haserr ? -1 : 0;
+}
+#endif /* ifndef INLINEDSequentialsuffixarrayreader */
+
+int enumeratemaxpairs(Sequentialsuffixarrayreader *ssar,
+                      const Encodedsequence *encseq,
+                      Readmode readmode,
+                      unsigned int searchlength,
+                      unsigned int numofthreads,
+                      int(*processmaxpairs)(void *,Seqpos,Seqpos,
+                                            Seqpos,GtError *),
+                      void *processmaxpairsinfo,
+                      Verboseinfo *verboseinfo,
+                      GtError *err)
+{
+#ifndef INLINEDSequentialsuffixarrayreader
+  gt_error_check(err);
+  if (numofthreads > 1U && gt_thread_support())
+  {
+    Sequentialsuffixarrayreader **splitssar;
+    unsigned long idx, numofparts;
+    int retval;
+
+    splitssar = splitSequentialsuffixarrayreader(&numofparts,
+                                                 ssar,
+                                                 (Seqpos) searchlength,
+                                                 (unsigned long)
+                                                 PARTSPERTHREAD *
+                                                 numofthreads);
+    if (splitssar != NULL)
+    {
+      showverbose(verboseinfo,"# enumerate maximal pairs in %lu parts "
+                              "with %u threads\n",numofparts,numofthreads);
+      retval = threadedmaxpairs(splitssar,
+                                numofparts,
+                                encseq,
+                                readmode,
+                                searchlength,
+                                numofthreads,
+                                processmaxpairs,
+                                processmaxpairsinfo,
+                                err);
+      for (idx = 0; idx < numofparts; idx++)
+      {
+        freeSequentialsuffixarrayreader(&splitssar[idx]);
+      }
+      FREESPACE(splitssar);
+      return retval;
+    }
+  }
+#endif
+  return dfsmaxpairs(ssar,
+                     encseq,
+                     readmode,
+                     searchlength,
+                     processmaxpairs,
+                     processmaxpairsinfo,
+                     verboseinfo,
+                     err);
+}
+
 int callenummaxpairs(const GtStr *indexname,
                      unsigned int userdefinedleastlength,
                      bool scanfile,
+                     unsigned int numofthreads,
                      int(*processmaxpairs)(void *,Seqpos,Seqpos,
                                            Seqpos,GtError *),
                      void *processmaxpairsinfo,
@@ -428,6 +687,7 @@ int callenummaxpairs(const GtStr *indexname,
                         encseqSequentialsuffixarrayreader(ssar),
                         readmodeSequentialsuffixarrayreader(ssar),
                         userdefinedleastlength,
+                        numofthreads,
                         processmaxpairs,
                         processmaxpairsinfo,
                         verboseinfo,
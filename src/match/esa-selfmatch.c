@@ -84,6 +84,7 @@ static int constructsarrandrunmaxpairs(
                             ssi->encseq,
                             readmode,
                             ssi->minlength,
+                            1U,
                             ssi->processmaxmatch,
                             ssi->processmaxmatchinfo,
                             verboseinfo,
@@ -99,6 +99,7 @@ Readmode readmodeSequentialsuffixarrayreader(
          nextlcptabindex, /* for SEQ_mappedboth */
          largelcpindex;   /* SEQ_mappedboth */
   Sequentialaccesstype seqactype;
+  bool ownsuffixarray; /* false for the parts of a split reader */
   Lcpvalueiterator *lvi;
   const Seqpos *suftab;
   const Encodedsequence *encseq;
@@ -131,6 +132,7 @@ Sequentialsuffixarrayreader *newSequentialsuffixarrayreaderfromfile(
   ssar->nextlcptabindex = (Seqpos) 1;
   ssar->largelcpindex = 0;
   ssar->seqactype = seqactype;
+  ssar->ownsuffixarray = true;
   ssar->suftab = NULL;
   ssar->encseq = ssar->suffixarray->encseq;
   ssar->readmode = ssar->suffixarray->readmode;
@@ -151,6 +153,7 @@ Sequentialsuffixarrayreader *newSequentialsuffixarrayreaderfromRAM(
   ssar->nextlcptabindex = (Seqpos) 1; /* not required here */
   ssar->largelcpindex = 0; /* not required here */
   ssar->seqactype = SEQ_suftabfrommemory;
+  ssar->ownsuffixarray = false;
   ssar->readmode = readmode;
   ssar->encseq = encseq;
   return ssar;
@@ -174,9 +177,84 @@ void updateSequentialsuffixarrayreaderfromRAM(
   }
 }
 
+static Sequentialsuffixarrayreader *newSequentialsuffixarrayreaderpart(
+                                  const Sequentialsuffixarrayreader *ssar,
+                                  Seqpos firstsuffix,
+                                  Seqpos numberofsuffixes,
+                                  Seqpos largelcpindex)
+{
+  Sequentialsuffixarrayreader *part;
+
+  ALLOCASSIGNSPACE(part,NULL,Sequentialsuffixarrayreader,1);
+  part->suffixarray = ssar->suffixarray;
+  part->ownsuffixarray = false;
+  part->nextsuftabindex = firstsuffix;
+  /* the lcp value at firstsuffix belongs to the root of the part */
+  part->nextlcptabindex = firstsuffix + 1;
+  part->largelcpindex = largelcpindex;
+  part->numberofsuffixes = firstsuffix + numberofsuffixes;
+  part->seqactype = SEQ_mappedboth;
+  part->suftab = NULL;
+  part->encseq = ssar->encseq;
+  part->readmode = ssar->readmode;
+  part->lvi = NULL;
+  return part;
+}
+
+Sequentialsuffixarrayreader **splitSequentialsuffixarrayreader(
+                                  unsigned long *numofparts,
+                                  const Sequentialsuffixarrayreader *ssar,
+                                  Seqpos minlcp,
+                                  unsigned long maxnumofparts)
+{
+  Sequentialsuffixarrayreader **parts;
+  const Suffixarray *suffixarray = ssar->suffixarray;
+  Seqpos idx, partstart = 0, partlargelcpindex = 0, largelcpindex = 0,
+         lcpvalue, minpartsize;
+
+  gt_assert(maxnumofparts > 0);
+  if (ssar->seqactype != SEQ_mappedboth)
+  {
+    *numofparts = 0;
+    return NULL;
+  }
+  minpartsize = ssar->numberofsuffixes/maxnumofparts;
+  ALLOCASSIGNSPACE(parts,NULL,Sequentialsuffixarrayreader *,maxnumofparts);
+  *numofparts = 0;
+  for (idx = (Seqpos) 1; idx < ssar->numberofsuffixes; idx++)
+  {
+    if (suffixarray->lcptab[idx] == LCPOVERFLOW)
+    {
+      gt_assert(suffixarray->llvtab[largelcpindex].position == idx);
+      lcpvalue = suffixarray->llvtab[largelcpindex++].value;
+    } else
+    {
+      lcpvalue = (Seqpos) suffixarray->lcptab[idx];
+    }
+    /* no lcp-interval of depth >= minlcp contains both idx-1 and idx */
+    if (lcpvalue < minlcp && idx - partstart >= minpartsize &&
+        *numofparts + 1 < maxnumofparts)
+    {
+      /* the part ends with suffix idx, so that the dfs reads the small lcp
+         value at idx which closes all intervals of depth >= minlcp */
+      parts[(*numofparts)++]
+        = newSequentialsuffixarrayreaderpart(ssar,partstart,
+                                             idx - partstart + 1,
+                                             partlargelcpindex);
+      partstart = idx;
+      partlargelcpindex = largelcpindex;
+    }
+  }
+  parts[(*numofparts)++]
+    = newSequentialsuffixarrayreaderpart(ssar,partstart,
+                                         ssar->numberofsuffixes - partstart,
+                                         partlargelcpindex);
+  return parts;
+}
+
 void freeSequentialsuffixarrayreader(Sequentialsuffixarrayreader **ssar)
 {
-  if ((*ssar)->suffixarray != NULL)
+  if ((*ssar)->suffixarray != NULL && (*ssar)->ownsuffixarray)
   {
     freesuffixarray((*ssar)->suffixarray);
     FREESPACE((*ssar)->suffixarray);
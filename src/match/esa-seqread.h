@@ -89,6 +89,22 @@ int nextSequentiallcpvalue(Seqpos *currentlcp,
 int nextSequentialsuftabvalue(Seqpos *currentsuffix,
                               Sequentialsuffixarrayreader *ssar);
 
+/* Split the suffix array read by <ssar> into at most <maxnumofparts>
+   consecutive parts of roughly equal size, each delivered by its own reader.
+   A part boundary is only placed at an index whose lcp value is smaller than
+   <minlcp>, so every lcp-interval of depth at least <minlcp> lies completely
+   inside one part. The suffix at a boundary is the last suffix of one part
+   and the first suffix of the next part; in the former it only belongs to
+   lcp-intervals of depth smaller than <minlcp>. The parts share the tables of
+   <ssar> and must be freed (with freeSequentialsuffixarrayreader) before
+   <ssar>. Returns NULL if <ssar> is not of type SEQ_mappedboth. */
+
+Sequentialsuffixarrayreader **splitSequentialsuffixarrayreader(
+                                  unsigned long *numofparts,
+                                  const Sequentialsuffixarrayreader *ssar,
+                                  Seqpos minlcp,
+                                  unsigned long maxnumofparts);
+
 #endif
 
 Sequentialsuffixarrayreader *newSequentialsuffixarrayreaderfromfile(
@@ -32,6 +32,7 @@ typedef struct {
   bool verbose;
   GtStr *seqfile,
       *regionmapping;
+  unsigned int nof_threads;
 } CDSArguments;
 
 static void *gt_cds_arguments_new(void)
@@ -65,6 +66,12 @@ static GtOptionParser* gt_cds_option_parser_new(void *tool_arguments)
   /* -seqfile and -regionmapping */
   gt_seqid2file_options(op, arguments->seqfile, arguments->regionmapping);
 
+  /* -threads */
+  option = gt_option_new_uint_min("threads", "number of worker threads which "
+                                  "process the feature trees",
+                                  &arguments->nof_threads, 1, 1);
+  gt_option_parser_add_option(op, option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -104,6 +111,10 @@ static int gt_cds_runner(GT_UNUSED int argc, const char **argv, int parsed_args,
     if (!cds_stream)
       had_err = -1;
   }
+  if (!had_err && arguments->nof_threads > 1) {
+    had_err = gt_cds_stream_enable_threads(cds_stream, arguments->nof_threads,
+                                           err);
+  }
 
   /* create gff3 output stream */
   /* XXX: replace NULL with proper outfile */
@@ -111,7 +122,8 @@ static int gt_cds_runner(GT_UNUSED int argc, const char **argv, int parsed_args,
     gff3_out_stream = gt_gff3_out_stream_new(cds_stream, NULL);
 
   /* pull the features through the stream and free them afterwards */
-  had_err = gt_node_stream_pull(gff3_out_stream, err);
+  if (!had_err)
+    had_err = gt_node_stream_pull(gff3_out_stream, err);
 
   /* free */
   gt_node_stream_delete(gff3_out_stream);
@@ -23,6 +23,7 @@
 #include "tools/gt_dev.h"
 #include "tools/gt_extracttarget.h"
 #include "tools/gt_guessprot.h"
+#include "tools/gt_intervalbench.h"
 #include "tools/gt_magicmatch.h"
 #include "tools/gt_maxpairs.h"
 #include "tools/gt_mergeesa.h"
@@ -36,6 +37,9 @@
 #include "tools/gt_readreads.h"
 #include "tools/gt_convertseq.h"
 #include "tools/gt_trieins.h"
+#ifndef WITHOUT_CAIRO
+#include "annotationsketch/gt_sketchbench.h"
+#endif
 
 static void* gt_dev_arguments_new(void)
 {
@@ -45,6 +49,7 @@ static void* gt_dev_arguments_new(void)
   gt_toolbox_add_tool(dev_toolbox, "consensus_sa", gt_consensus_sa_tool());
   gt_toolbox_add_tool(dev_toolbox, "extracttarget", gt_extracttarget());
   gt_toolbox_add(dev_toolbox, "guessprot", gt_guessprot);
+  gt_toolbox_add_tool(dev_toolbox, "intervalbench", gt_intervalbench());
   gt_toolbox_add_tool(dev_toolbox, "magicmatch", gt_magicmatch());
   gt_toolbox_add(dev_toolbox, "maxpairs", gt_maxpairs);
   gt_toolbox_add_tool(dev_toolbox, "idxlocali", gt_idxlocali());
@@ -58,6 +63,9 @@ static void* gt_dev_arguments_new(void)
   gt_toolbox_add_tool(dev_toolbox, "skproto", gt_skproto());
   gt_toolbox_add(dev_toolbox, "trieins", gt_trieins);
   gt_toolbox_add(dev_toolbox, "convertseq", gt_convertseq);
+#ifndef WITHOUT_CAIRO
+  gt_toolbox_add_tool(dev_toolbox, "sketchbench", gt_sketchbench());
+#endif
   return dev_toolbox;
 }
 
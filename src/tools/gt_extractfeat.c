@@ -33,6 +33,7 @@ typedef struct {
   GtStr *type,
         *seqfile,
         *regionmapping;
+  unsigned int nof_threads;
   GtOutputFileInfo *ofi;
   GtFile *outfp;
 } GtExtractFeatArguments;
@@ -91,6 +92,12 @@ static GtOptionParser* gt_extractfeat_option_parser_new(void *tool_arguments)
   /* -seqfile and -regionmapping */
   gt_seqid2file_options(op, arguments->seqfile, arguments->regionmapping);
 
+  /* -threads */
+  option = gt_option_new_uint_min("threads", "number of worker threads which "
+                                  "extract the features",
+                                  &arguments->nof_threads, 1, 1);
+  gt_option_parser_add_option(op, option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -137,7 +144,14 @@ static int gt_extractfeat_runner(GT_UNUSED int argc, const char **argv,
                                                      arguments->join,
                                                      arguments->translate,
                                                      arguments->outfp);
+    if (arguments->nof_threads > 1) {
+      had_err = gt_extract_feat_stream_enable_threads(extract_feat_stream,
+                                                      arguments->nof_threads,
+                                                      err);
+    }
+  }
 
+  if (!had_err) {
     /* pull the features through the stream and free them afterwards */
     had_err = gt_node_stream_pull(extract_feat_stream, err);
   }
@@ -21,7 +21,9 @@
 #include "core/outputfile.h"
 #include "core/undef.h"
 #include "core/versionfunc.h"
+#include "core/file.h"
 #include "extended/add_introns_stream.h"
+#include "extended/binary_out_stream.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_in_stream.h"
 #include "extended/gff3_out_stream_api.h"
@@ -40,7 +42,8 @@ typedef struct {
        addintrons,
        verbose,
        typecheck_built_in,
-       tidy;
+       tidy,
+       binary;
   long offset;
   GtStr *offsetfile,
         *typecheck;
@@ -74,7 +77,8 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
   GFF3Arguments *arguments = tool_arguments;
   GtOptionParser *op;
   GtOption *sort_option, *mergefeat_option, *addintrons_option, *offset_option,
-         *offsetfile_option, *typecheck_option, *built_in_option, *option;
+         *offsetfile_option, *typecheck_option, *built_in_option,
+         *retainids_option, *binary_option, *option;
   gt_assert(arguments);
 
   /* init */
@@ -93,12 +97,13 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
   gt_option_parser_add_option(op, option);
 
   /* -retainids */
-  option = gt_option_new_bool("retainids",
-                           "when available, use the original IDs provided "
-                           "in the source file\n"
-                           "(memory consumption is O(file_size))",
-                           &arguments->retainids, false);
-  gt_option_parser_add_option(op, option);
+  retainids_option = gt_option_new_bool("retainids",
+                                        "when available, use the original IDs "
+                                        "provided in the source file\n"
+                                        "(memory consumption is "
+                                        "O(file_size))",
+                                        &arguments->retainids, false);
+  gt_option_parser_add_option(op, retainids_option);
 
   /* -checkids */
   option = gt_option_new_bool("checkids",
@@ -153,6 +158,15 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
   gt_option_parser_add_option(op, built_in_option);
   gt_option_exclude(typecheck_option, built_in_option);
 
+  /* -binary */
+  binary_option = gt_option_new_bool("binary", "write the output in the binary "
+                                     "annotation format, which all tools "
+                                     "reading GFF3 files accept as input and "
+                                     "load much faster (cannot be compressed)",
+                                     &arguments->binary, false);
+  gt_option_parser_add_option(op, binary_option);
+  gt_option_exclude(binary_option, retainids_option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -165,7 +179,8 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
   gt_option_parser_add_option(op, option);
 
   /* output file options */
-  gt_outputfile_register_options(op, &arguments->outfp, arguments->ofi);
+  gt_outputfile_register_options_with_compthreads(op, &arguments->outfp,
+                                                  arguments->ofi);
 
   /* set comment function */
   gt_option_parser_set_comment_func(op, gt_gtdata_show_help, NULL);
@@ -196,6 +211,7 @@ static int gt_gff3_runner(int argc, const char **argv, int parsed_args,
     gt_gff3_in_stream_show_progress_bar((GtGFF3InStream*) gff3_in_stream);
   if (arguments->checkids)
     gt_gff3_in_stream_check_id_attributes((GtGFF3InStream*) gff3_in_stream);
+  gt_gff3_in_stream_enable_arena_allocation(gff3_in_stream);
 
   last_stream = gff3_in_stream;
 
@@ -247,8 +263,17 @@ static int gt_gff3_runner(int argc, const char **argv, int parsed_args,
     last_stream = add_introns_stream;
   }
 
-  /* create gff3 output stream */
-  if (!had_err) {
+  /* create gff3 (or binary) output stream */
+  if (!had_err && arguments->binary) {
+    if (arguments->outfp &&
+        gt_file_mode(arguments->outfp) != GFM_UNCOMPRESSED) {
+      gt_error_set(err, "binary output cannot be compressed");
+      had_err = -1;
+    }
+    else
+      gff3_out_stream = gt_binary_out_stream_new(last_stream, arguments->outfp);
+  }
+  else if (!had_err) {
     gff3_out_stream = gt_gff3_out_stream_new(last_stream, arguments->outfp);
     gt_gff3_out_stream_set_fasta_width(gff3_out_stream, arguments->width);
   }
@@ -0,0 +1,259 @@
+/*
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "core/cstr.h"
+#include "core/hashmap.h"
+#include "core/implicit_interval_tree.h"
+#include "core/interval_tree.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/timer.h"
+#include "core/unused_api.h"
+#include "extended/feature_node.h"
+#include "extended/gff3_in_stream.h"
+#include "tools/gt_intervalbench.h"
+
+typedef struct {
+  unsigned long nof_queries,
+                width;
+} IntervalbenchArguments;
+
+typedef struct {
+  GtArray *ranges;
+  GtRange extent;
+  GtIntervalTree *tree;
+  GtImplicitIntervalTree *implicit_tree;
+} BenchSeq;
+
+typedef struct {
+  unsigned long seqnum;
+  GtRange range;
+} BenchQuery;
+
+static void* gt_intervalbench_arguments_new(void)
+{
+  return gt_calloc(1, sizeof (IntervalbenchArguments));
+}
+
+static void gt_intervalbench_arguments_delete(void *tool_arguments)
+{
+  IntervalbenchArguments *arguments = tool_arguments;
+  if (!arguments) return;
+  gt_free(arguments);
+}
+
+static GtOptionParser* gt_intervalbench_option_parser_new(void *tool_arguments)
+{
+  IntervalbenchArguments *arguments = tool_arguments;
+  GtOptionParser *op;
+  GtOption *option;
+  gt_assert(arguments);
+
+  op = gt_option_parser_new("[option ...] [GFF3_file ...]",
+                            "Compare range queries on the top-level features "
+                            "of the given files\nin an interval tree and an "
+                            "implicit interval tree using random windows.");
+
+  option = gt_option_new_ulong_min("queries", "number of random windows",
+                                   &arguments->nof_queries, 100000, 1);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_ulong_min("width", "width of the random windows",
+                                   &arguments->width, 10000, 1);
+  gt_option_parser_add_option(op, option);
+
+  return op;
+}
+
+static int load_ranges(GtArray *seqs, int argc, const char **argv,
+                       GtError *err)
+{
+  GtNodeStream *in_stream;
+  GtHashmap *seqnums;
+  GtGenomeNode *gn;
+  BenchSeq seq, *seqp;
+  unsigned long seqnum;
+  GtRange range;
+  const char *seqid;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(seqs);
+  seqnums = gt_hashmap_new(HASH_STRING, gt_free_func, NULL);
+  in_stream = gt_gff3_in_stream_new_unsorted(argc, argv);
+  while (!(had_err = gt_node_stream_next(in_stream, &gn, err)) && gn) {
+    if (gt_feature_node_try_cast(gn)) {
+      seqid = gt_str_get(gt_genome_node_get_seqid(gn));
+      range = gt_genome_node_get_range(gn);
+      if (!(seqnum = (unsigned long) gt_hashmap_get(seqnums, seqid))) {
+        seq.ranges = gt_array_new(sizeof (GtRange));
+        seq.extent = range;
+        seq.tree = NULL;
+        seq.implicit_tree = NULL;
+        gt_array_add(seqs, seq);
+        seqnum = gt_array_size(seqs);
+        gt_hashmap_add(seqnums, gt_cstr_dup(seqid), (void*) seqnum);
+      }
+      seqp = gt_array_get(seqs, seqnum - 1);
+      gt_array_add(seqp->ranges, range);
+      seqp->extent = gt_range_join(&seqp->extent, &range);
+    }
+    gt_genome_node_delete(gn);
+  }
+  gt_node_stream_delete(in_stream);
+  gt_hashmap_delete(seqnums);
+  if (!had_err && !gt_array_size(seqs)) {
+    gt_error_set(err, "the input does not contain any features");
+    had_err = -1;
+  }
+  return had_err;
+}
+
+/* Returns a random number below <n>. */
+static unsigned long random_below(unsigned long n)
+{
+  gt_assert(n);
+  return n > 1 ? gt_rand_max(n - 1) : 0;
+}
+
+static int range_ptr_compare(const void *r1p, const void *r2p)
+{
+  return gt_range_compare(*(const GtRange**) r1p, *(const GtRange**) r2p);
+}
+
+static int gt_intervalbench_runner(int argc, const char **argv,
+                                   int parsed_args, void *tool_arguments,
+                                   GtError *err)
+{
+  IntervalbenchArguments *arguments = tool_arguments;
+  unsigned long i, j, nof_features = 0, tree_results = 0,
+                implicit_results = 0;
+  BenchQuery *queries = NULL;
+  GtArray *seqs, *results;
+  GtTimer *timer;
+  GtRange *range;
+  BenchSeq *seq;
+  int had_err;
+  gt_error_check(err);
+  gt_assert(arguments);
+
+  seqs = gt_array_new(sizeof (BenchSeq));
+  results = gt_array_new(sizeof (GtRange*));
+  timer = gt_timer_new();
+  had_err = load_ranges(seqs, argc - parsed_args, argv + parsed_args, err);
+
+  if (!had_err) {
+    for (i = 0; i < gt_array_size(seqs); i++) {
+      seq = gt_array_get(seqs, i);
+      nof_features += gt_array_size(seq->ranges);
+    }
+    printf("# %lu features on %lu sequences\n", nof_features,
+           gt_array_size(seqs));
+
+    /* build the indices, one insertion per feature for the interval tree and
+       one bulk build for the implicit tree */
+    printf("interval tree build: ");
+    gt_timer_start(timer);
+    for (i = 0; i < gt_array_size(seqs); i++) {
+      seq = gt_array_get(seqs, i);
+      seq->tree = gt_interval_tree_new(NULL);
+      for (j = 0; j < gt_array_size(seq->ranges); j++) {
+        range = gt_array_get(seq->ranges, j);
+        gt_interval_tree_insert(seq->tree,
+                                gt_interval_tree_node_new(range, range->start,
+                                                          range->end));
+      }
+    }
+    gt_timer_show(timer, stdout);
+    printf("implicit interval tree build: ");
+    gt_timer_start(timer);
+    for (i = 0; i < gt_array_size(seqs); i++) {
+      seq = gt_array_get(seqs, i);
+      seq->implicit_tree = gt_implicit_interval_tree_new(NULL);
+      for (j = 0; j < gt_array_size(seq->ranges); j++) {
+        range = gt_array_get(seq->ranges, j);
+        gt_implicit_interval_tree_add(seq->implicit_tree, range, range->start,
+                                      range->end);
+      }
+      gt_implicit_interval_tree_build(seq->implicit_tree);
+    }
+    gt_timer_show(timer, stdout);
+
+    /* draw the random windows (on a random sequence, within the range of its
+       features) */
+    queries = gt_malloc(arguments->nof_queries * sizeof *queries);
+    for (i = 0; i < arguments->nof_queries; i++) {
+      queries[i].seqnum = random_below(gt_array_size(seqs));
+      seq = gt_array_get(seqs, queries[i].seqnum);
+      queries[i].range.start = seq->extent.start +
+                               random_below(gt_range_length(&seq->extent));
+      queries[i].range.end = queries[i].range.start + arguments->width - 1;
+    }
+
+    /* the interval tree results have to be sorted afterwards */
+    printf("interval tree queries: ");
+    gt_timer_start(timer);
+    for (i = 0; i < arguments->nof_queries; i++) {
+      seq = gt_array_get(seqs, queries[i].seqnum);
+      gt_array_reset(results);
+      gt_interval_tree_find_all_overlapping(seq->tree, queries[i].range.start,
+                                            queries[i].range.end, results);
+      gt_array_sort(results, range_ptr_compare);
+      tree_results += gt_array_size(results);
+    }
+    gt_timer_show(timer, stdout);
+    printf("implicit interval tree queries: ");
+    gt_timer_start(timer);
+    for (i = 0; i < arguments->nof_queries; i++) {
+      seq = gt_array_get(seqs, queries[i].seqnum);
+      gt_array_reset(results);
+      gt_implicit_interval_tree_find_all_overlapping(seq->implicit_tree,
+                                                     queries[i].range.start,
+                                                     queries[i].range.end,
+                                                     results);
+      implicit_results += gt_array_size(results);
+    }
+    gt_timer_show(timer, stdout);
+    printf("# %lu queries of width %lu, %lu results\n", arguments->nof_queries,
+           arguments->width, implicit_results);
+    if (tree_results != implicit_results) {
+      gt_error_set(err, "interval tree reported %lu results, implicit interval "
+                   "tree %lu", tree_results, implicit_results);
+      had_err = -1;
+    }
+  }
+
+  for (i = 0; i < gt_array_size(seqs); i++) {
+    seq = gt_array_get(seqs, i);
+    gt_interval_tree_delete(seq->tree);
+    gt_implicit_interval_tree_delete(seq->implicit_tree);
+    gt_array_delete(seq->ranges);
+  }
+  gt_free(queries);
+  gt_timer_delete(timer);
+  gt_array_delete(results);
+  gt_array_delete(seqs);
+  return had_err;
+}
+
+GtTool* gt_intervalbench(void)
+{
+  return gt_tool_new(gt_intervalbench_arguments_new,
+                     gt_intervalbench_arguments_delete,
+                     gt_intervalbench_option_parser_new,
+                     NULL,
+                     gt_intervalbench_runner);
+}
@@ -33,7 +33,8 @@
 
 typedef struct
 {
-  unsigned int userdefinedleastlength;
+  unsigned int userdefinedleastlength,
+               numofthreads;
   unsigned long samples;
   bool scanfile;
   GtStr *indexname;
@@ -101,6 +102,14 @@ static OPrval parse_options(Maxpairsoptions *maxpairsoptions,
                                  (unsigned long) 1);
   gt_option_parser_add_option(op, sampleoption);
 
+  option = gt_option_new_uint_min("threads",
+                                  "Specify number of threads used to "
+                                  "enumerate the maximal pairs",
+                                  &maxpairsoptions->numofthreads,
+                                  1U,
+                                  1U);
+  gt_option_parser_add_option(op, option);
+
   scanoption = gt_option_new_bool("scan","scan index",
                                &maxpairsoptions->scanfile,
                                false);
@@ -161,6 +170,7 @@ int gt_maxpairs(int argc, const char **argv, GtError *err)
         if (callenummaxpairs(maxpairsoptions.indexname,
                              maxpairsoptions.userdefinedleastlength,
                              maxpairsoptions.scanfile,
+                             maxpairsoptions.numofthreads,
                              simpleexactselfmatchoutput,
                              NULL,
                              verboseinfo,
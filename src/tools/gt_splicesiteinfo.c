@@ -30,6 +30,7 @@ typedef struct {
   GtStr *seqfile,
       *regionmapping;
   bool addintrons;
+  unsigned int nof_threads;
 } SpliceSiteInfoArguments;
 
 static OPrval parse_options(int *parsed_args,
@@ -53,6 +54,12 @@ static OPrval parse_options(int *parsed_args,
                            "to be shown)", &arguments->addintrons, false);
   gt_option_parser_add_option(op, option);
 
+  /* -threads */
+  option = gt_option_new_uint_min("threads", "number of worker threads which "
+                                  "process the feature trees",
+                                  &arguments->nof_threads, 1, 1);
+  gt_option_parser_add_option(op, option);
+
   /* parse */
   gt_option_parser_set_comment_func(op, gt_gtdata_show_help, NULL);
   oprval = gt_option_parser_parse(op, parsed_args, argc, argv, gt_versionfunc,
@@ -109,7 +116,15 @@ int gt_splicesiteinfo(int argc, const char **argv, GtError *err)
                                                           ? add_introns_stream
                                                           : gff3_in_stream,
                                                           regionmapping);
+    if (arguments.nof_threads > 1) {
+      had_err = gt_splice_site_info_stream_enable_threads(
+                                                        splice_site_info_stream,
+                                                         arguments.nof_threads,
+                                                         err);
+    }
+  }
 
+  if (!had_err) {
     /* pull the features through the stream and free them afterwards */
     had_err = gt_node_stream_pull(splice_site_info_stream, err);
   }
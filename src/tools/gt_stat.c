@@ -29,6 +29,7 @@ typedef struct {
        exon_number_distribution,
        exon_length_distribution,
        intron_length_distribution;
+  unsigned int nof_threads;
 } StatArguments;
 
 static OPrval parse_options(int *parsed_args, StatArguments *arguments,
@@ -71,6 +72,12 @@ static OPrval parse_options(int *parsed_args, StatArguments *arguments,
                            &arguments->intron_length_distribution, false);
   gt_option_parser_add_option(op, option);
 
+  /* -threads */
+  option = gt_option_new_uint_min("threads", "number of worker threads which "
+                                  "process the feature trees",
+                                  &arguments->nof_threads, 1, 1);
+  gt_option_parser_add_option(op, option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -101,6 +108,8 @@ int gt_stat(int argc, const char **argv, GtError *err)
                                                   argv + parsed_args);
   if (arguments.verbose)
     gt_gff3_in_stream_show_progress_bar((GtGFF3InStream*) gff3_in_stream);
+  /* the feature trees are only read, allocate them in chunks */
+  gt_gff3_in_stream_enable_arena_allocation(gff3_in_stream);
 
   /* create s status stream */
   stat_stream = gt_stat_stream_new(gff3_in_stream,
@@ -108,11 +117,17 @@ int gt_stat(int argc, const char **argv, GtError *err)
                                    arguments.gene_score_distribution,
                                    arguments.exon_length_distribution,
                                    arguments.exon_number_distribution,
-                                   arguments.intron_length_distribution);
+                                   arguments.intron_length_distribution,
+                                   arguments.verbose);
+  had_err = 0;
+  if (arguments.nof_threads > 1)
+    had_err = gt_stat_stream_enable_threads(stat_stream, arguments.nof_threads,
+                                            err);
 
   /* pull the features through the stream , compute the statistics, and free
      them afterwards */
-  had_err = gt_node_stream_pull(stat_stream, err);
+  if (!had_err)
+    had_err = gt_node_stream_pull(stat_stream, err);
 
   /* show statistics */
   if (!had_err)
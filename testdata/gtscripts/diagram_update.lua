@@ -0,0 +1,96 @@
+--[[
+  Copyright (c) 2009 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+]]
+
+-- testing incremental diagram updates: a diagram which is updated to a new
+-- range must be laid out like a diagram created for this range
+
+function usage()
+  io.stderr:write(string.format("Usage: %s GFF3_file [cache_size]\n", arg[0]))
+  io.stderr:write("Pan over the first sequence region of GFF3_file.\n")
+  io.stderr:write("If a cache_size is given, GFF3_file must be a binary " ..
+                  "annotation file\nwhich is used as a file based feature " ..
+                  "index caching cache_size trees.\n")
+  os.exit(1)
+end
+
+if #arg == 1 or #arg == 2 then
+  gff3file = arg[1]
+else
+  usage()
+end
+
+if #arg == 2 then
+  feature_index = gt.feature_index_file_new(gff3file, tonumber(arg[2]))
+else
+  in_stream = gt.gff3_in_stream_new_sorted(gff3file)
+  feature_index = gt.feature_index_memory_new()
+  feature_stream = gt.feature_stream_new(in_stream, feature_index)
+  gn = feature_stream:next_tree()
+  -- fill feature index
+  while (gn) do
+    gn = feature_stream:next_tree()
+  end
+end
+
+function get_recmaps(diagram)
+  local ii = gt.imageinfo_new()
+  local layout = gt.layout_new(diagram, 800)
+  local canvas = gt.canvas_cairo_file_new_png(800, layout:get_height(), ii)
+  local recmaps = {}
+  layout:sketch(canvas)
+  for _,v in ipairs(ii:get_recmaps()) do
+    table.insert(recmaps, string.format("%.0f,%.0f,%.0f,%.0f, %s", v.nw_x,
+                                        v.nw_y, v.se_x, v.se_y,
+                                        v.feature_ref:get_type()))
+  end
+  table.sort(recmaps)
+  return table.concat(recmaps, "\n")
+end
+
+seqid = feature_index:get_first_seqid()
+seqrange = feature_index:get_range_for_seqid(seqid)
+width = math.floor((seqrange:get_end() - seqrange:get_start()) / 4)
+step = math.floor(width / 7)
+
+range = gt.range_new(seqrange:get_start(), seqrange:get_start() + width)
+diagram = gt.diagram_new(feature_index, seqid, range)
+nof_recmaps = 0
+-- pan to the right and back again, then zoom out
+starts = {}
+for start = seqrange:get_start(), seqrange:get_end() - width, step do
+  table.insert(starts, start)
+end
+for i = #starts - 1, 1, -1 do
+  table.insert(starts, starts[i])
+end
+for _,start in ipairs(starts) do
+  range = gt.range_new(start, start + width)
+  diagram:update(feature_index, seqid, range)
+  expected = get_recmaps(gt.diagram_new(feature_index, seqid, range))
+  if get_recmaps(diagram) ~= expected then
+    error(string.format("diagram updated to range %d-%d differs", start,
+                        start + width))
+  end
+  nof_recmaps = nof_recmaps + #expected
+end
+diagram:update(feature_index, seqid, seqrange)
+if get_recmaps(diagram) ~= get_recmaps(gt.diagram_new(feature_index, seqid,
+                                                      seqrange)) then
+  error("diagram updated to the whole sequence region differs")
+end
+if nof_recmaps == 0 then
+  error("no features drawn")
+end
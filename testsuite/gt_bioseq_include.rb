@@ -43,6 +43,22 @@ Test do
   end
 end
 
+Name "gt bioseq test truncated index"
+Keywords "gt_bioseq"
+Test do
+  run "cp #{$testdata}gt_bioseq_succ_3.fas test.fas"
+  run_test "#{$bin}gt bioseq -showfasta test.fas"
+  run "mv #{$last_stdout} expected"
+  bsi_size = File.size("test.fas.gt_bsi")
+  File.truncate("test.fas.gt_bsi", bsi_size / 2)
+  # the damaged index must be constructed again
+  run_test "#{$bin}gt bioseq -showfasta test.fas"
+  run "diff #{$last_stdout} expected"
+  if File.size("test.fas.gt_bsi") != bsi_size then
+    raise TestFailed, "index file has not been recreated"
+  end
+end
+
 Name "gt bioseq test 1 (stdin)"
 Keywords "gt_bioseq"
 Test do
@@ -7,6 +7,16 @@
   end
 end
 
+[1, 6, 14].each do |i|
+  Name "gt cds test #{i} (-threads)"
+  Keywords "gt_cds threads"
+  Test do
+    run_test "#{$bin}gt cds -threads 3 -seqfile " +
+             "#{$testdata}gt_cds_test_#{i}.fas #{$testdata}gt_cds_test_#{i}.in"
+    run "diff #{$last_stdout} #{$testdata}/gt_cds_test_#{i}.out"
+  end
+end
+
 if $gttestdata then
   Name "gt cds bug"
   Keywords "gt_cds"
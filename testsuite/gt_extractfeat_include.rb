@@ -40,6 +40,20 @@ Test do
   run "diff #{$last_stdout} #{$testdata}/gt_extractfeat_succ_2.out3"
 end
 
+Name "gt extractfeat -seqfile test 4 (-threads)"
+Keywords "gt_extractfeat threads"
+Test do
+  run_test "#{$bin}gt extractfeat -threads 3 -type exon -join -seqfile #{$testdata}/gt_extractfeat_succ_2.fas #{$testdata}/gt_extractfeat_succ_2.gff3"
+  run "diff #{$last_stdout} #{$testdata}/gt_extractfeat_succ_2.out3"
+end
+
+Name "gt extractfeat -regionmapping (-threads)"
+Keywords "gt_extractfeat threads"
+Test do
+  run_test("#{$bin}gt extractfeat -threads 2 -type exon -regionmapping #{$testdata}/regionmapping_1.lua #{$testdata}/gt_extractfeat_succ_1.gff3", :retval => 1 )
+  grep($last_stderr, "'mapping' must be either a table or a function ");
+end
+
 Name "gt extractfeat -seqfile test 5"
 Keywords "gt_extractfeat"
 Test do
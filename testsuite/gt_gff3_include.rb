@@ -35,6 +35,56 @@ Test do
   grep $last_stderr, "appending it"
 end
 
+Name "gt gff3 short test (compressed output, -compthreads)"
+Keywords "gt_gff3 compthreads"
+Test do
+  run_test "#{$bin}gt gff3 -o test.gz -gzip -compthreads 2 " +
+           "#{$testdata}gff3_file_1_short.txt"
+  run "gunzip -c test.gz"
+  run "env LC_ALL=C sort #{$last_stdout}"
+  run "diff #{$last_stdout} #{$testdata}gff3_file_1_short_sorted.txt"
+  run_test "#{$bin}gt gff3 test.gz"
+  run "env LC_ALL=C sort #{$last_stdout}"
+  run "diff #{$last_stdout} #{$testdata}gff3_file_1_short_sorted.txt"
+end
+
+Name "gt gff3 -compthreads without -gzip"
+Keywords "gt_gff3 compthreads"
+Test do
+  run_test("#{$bin}gt gff3 -o test -compthreads 2 " +
+           "#{$testdata}gff3_file_1_short.txt", :retval => 1)
+  grep $last_stderr, "requires option"
+end
+
+Name "gt gff3 -compthreads with -bzip2"
+Keywords "gt_gff3 compthreads"
+Test do
+  run_test("#{$bin}gt gff3 -o test -bzip2 -compthreads 2 " +
+           "#{$testdata}gff3_file_1_short.txt", :retval => 1)
+  grep $last_stderr, "requires option \"-gzip\""
+end
+
+Name "gt gff3 -compthreads (output larger than a block)"
+Keywords "gt_gff3 compthreads"
+Test do
+  run_test "#{$bin}gt gff3 #{$testdata}encode_known_genes_Mar07.gff3"
+  run "mv #{$last_stdout} stdout.gff3"
+  run_test "#{$bin}gt gff3 -o test.gff3 #{$testdata}encode_known_genes_Mar07.gff3"
+  run "diff test.gff3 stdout.gff3"
+  run_test "#{$bin}gt gff3 -o test.gff3.gz -gzip -compthreads 2 " +
+           "#{$testdata}encode_known_genes_Mar07.gff3"
+  run "gunzip -c test.gff3.gz"
+  run "diff #{$last_stdout} stdout.gff3"
+end
+
+Name "gt merge -compthreads"
+Keywords "gt_merge compthreads"
+Test do
+  run_test("#{$bin}gt merge -o test.gz -gzip -compthreads 2 " +
+           "#{$testdata}gff3_file_1_short.txt", :retval => 1)
+  grep $last_stderr, "unknown option"
+end
+
 Name "gt gff3 prob 1"
 Keywords "gt_gff3"
 Test do
@@ -759,6 +809,68 @@ Test do
   run "diff #{$last_stdout} #{$testdata}duplicate_attribute_fixed.gff3"
 end
 
+["standard_gene_simple.gff3", "standard_gene_with_introns_as_tree.gff3",
+ "eden.gff3", "multi_feature_simple.gff3", "multi_feature_simple_reverted.gff3",
+ "multiple_top_level_parents.gff3", "two_fasta_seqs.gff3",
+ "addintrons.gff3"].each do |file|
+  Name "gt gff3 binary roundtrip (#{file})"
+  Keywords "gt_gff3 binary"
+  Test do
+    run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}#{file}"
+    run_test "#{$bin}gt gff3 #{$testdata}#{file}"
+    run "mv #{$last_stdout} expected.gff3"
+    run_test "#{$bin}gt gff3 out.gtb"
+    run "diff #{$last_stdout} expected.gff3"
+  end
+end
+
+Name "gt gff3 binary input (-sort)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}gt_gff3_prob_5.in"
+  run_test "#{$bin}gt gff3 -sort out.gtb"
+  run "mv #{$last_stdout} binary.gff3"
+  run_test "#{$bin}gt gff3 -sort #{$testdata}gt_gff3_prob_5.in"
+  run "diff #{$last_stdout} binary.gff3"
+end
+
+Name "gt stat binary input"
+Keywords "gt_gff3 gt_stat binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}eden.gff3"
+  run_test "#{$bin}gt stat out.gtb"
+  run "mv #{$last_stdout} binary.txt"
+  run_test "#{$bin}gt stat #{$testdata}eden.gff3"
+  run "diff #{$last_stdout} binary.txt"
+end
+
+Name "gt gff3 binary output (compressed)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test("#{$bin}gt gff3 -binary -gzip -o out " +
+           "#{$testdata}standard_gene_simple.gff3", :retval => 1)
+  grep $last_stderr, "binary output cannot be compressed"
+end
+
+Name "gt gff3 binary input (truncated)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}eden.gff3"
+  run "head -c 200 out.gtb > truncated.gtb"
+  run_test("#{$bin}gt gff3 truncated.gtb", :retval => 1)
+  grep $last_stderr, "is corrupt"
+end
+
+["-tidy", "-offset 100", "-typecheck-built-in"].each do |option|
+  Name "gt gff3 binary input (#{option})"
+  Keywords "gt_gff3 binary"
+  Test do
+    run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}eden.gff3"
+    run_test("#{$bin}gt gff3 #{option} out.gtb", :retval => 1)
+    grep $last_stderr, "cannot be applied to binary annotation file"
+  end
+end
+
 Name "custom_stream (C)"
 Keywords "gt_gff3 examples"
 Test do
@@ -185,6 +185,20 @@ def check_amino_acid_output(gff3file, chr, pdoms)
   end
 end
 
+Name "gt ltrdigest -elemthreads (local data)"
+Keywords "gt_ltrdigest"
+Test do
+  run_test "#{$bin}gt suffixerator -dna -des -ssp -tis -suf -lcp -db #{$testdata}gt_ltrdigest_elements.fas -indexname elements"
+  run_test "#{$bin}gt ltrharvest -index elements -gff3 elements.gff3"
+  run_test "#{$bin}gt gff3 -sort elements.gff3 > elements.sorted.gff3"
+  run_test "#{$bin}gt ltrdigest elements.sorted.gff3 elements > sequential.gff3"
+  grep("sequential.gff3", "RR_tract")
+  run_test "#{$bin}gt ltrdigest -elemthreads 3 elements.sorted.gff3 elements > parallel.gff3"
+  run "diff sequential.gff3 parallel.gff3"
+  run_test "#{$bin}gt ltrdigest -elemthreads 0 elements.sorted.gff3 elements", :retval => 1
+  grep($last_stderr, "must be an integer >= 1")
+end
+
 if $gttestdata then
   Name "gt ltrdigest missing input GFF"
   Keywords "gt_ltrdigest"
@@ -246,6 +260,15 @@ if $gttestdata then
     #run "diff #{$last_stdout} #{$gttestdata}/ltrdigest/4_ref_noHMM.gff3"
   end
 
+  Name "gt ltrdigest -elemthreads"
+  Keywords "gt_ltrdigest"
+  Test do
+    run_test "#{$bin}gt suffixerator -dna -des -ssp -tis -v -db #{$gttestdata}ltrdigest/4_genomic_dmel_RELEASE3-1.FASTA.gz"
+    run_test "#{$bin}gt ltrdigest -trnas #{$gttestdata}/ltrdigest/Dm-tRNAs-uniq.fa #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz > sequential.gff3", :retval => 0
+    run_test "#{$bin}gt ltrdigest -elemthreads 3 -trnas #{$gttestdata}/ltrdigest/Dm-tRNAs-uniq.fa #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz > parallel.gff3", :retval => 0
+    run "diff sequential.gff3 parallel.gff3"
+  end
+
   if $arguments["hmmer"] then
     Name "gt ltrdigest corrupt pHMM"
     Keywords "gt_ltrdigest"
@@ -272,6 +295,17 @@ if $gttestdata then
       run_test "#{$bin}gt ltrdigest -pdomevalcutoff 2.2 #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz", :retval => 1
       grep($last_stderr, /argument to option "-pdomevalcutoff" must be a floating point value <= 1.000000/)
     end
+
+    Name "gt ltrdigest pHMM worker pool"
+    Keywords "gt_ltrdigest"
+    Test do
+      run_test "#{$bin}gt suffixerator -dna -des -ssp -tis -v -db #{$gttestdata}ltrdigest/4_genomic_dmel_RELEASE3-1.FASTA.gz"
+      run_test "#{$bin}gt ltrdigest -threads 1 -hmms #{$gttestdata}/ltrdigest/hmms/RVT_1_fs.hmm -- #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz > sequential.gff3", :retval => 0, :maxtime => 12000
+      run_test "#{$bin}gt ltrdigest -threads 4 -hmms #{$gttestdata}/ltrdigest/hmms/RVT_1_fs.hmm -- #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz > parallel.gff3", :retval => 0, :maxtime => 12000
+      run "diff sequential.gff3 parallel.gff3"
+      run_test "#{$bin}gt ltrdigest -threads 4 -elemthreads 3 -hmms #{$gttestdata}/ltrdigest/hmms/RVT_1_fs.hmm -- #{$gttestdata}/ltrdigest/dmel_test_Run9_4.gff3.sorted 4_genomic_dmel_RELEASE3-1.FASTA.gz > parallel.gff3", :retval => 0, :maxtime => 12000
+      run "diff sequential.gff3 parallel.gff3"
+    end
   end
 
   Name "gt ltrdigest PPT HMM parameters (background distribution)"
@@ -219,6 +219,19 @@ Test do
            " -longoutput -mintsd 5"
 end
 
+Name "gt ltrharvest threads"
+Keywords "gt_ltrharvest"
+Test do
+  run_test "#{$bin}gt suffixerator -db #{$testdata}Random.fna -dna -suf -lcp -tis -des -ssp"
+  run_test "#{$bin}gt ltrharvest -index Random.fna -seed 20" +
+           " -longoutput -mintsd 5"
+  run "grep -v '^# args' #{$last_stdout} > sequential.out"
+  run_test "#{$bin}gt ltrharvest -index Random.fna -seed 20" +
+           " -longoutput -mintsd 5 -threads 3"
+  run "grep -v '^# args' #{$last_stdout} > threads.out"
+  run "diff sequential.out threads.out"
+end
+
 Name "gt ltrharvest overlaps1"
 Keywords "gt_ltrharvest"
 Test do
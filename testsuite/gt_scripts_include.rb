@@ -161,6 +161,26 @@ if not $arguments["nocairo"] then
     run "diff #{$last_stdout} #{$testdata}standard_gene_as_tree.recmaps"
   end
 
+  Name "AnnotationSketch (incremental diagram update)"
+  Keywords "gt_scripts annotationsketch"
+  Test do
+    run_test "#{$bin}gt #{$testdata}/gtscripts/diagram_update.lua #{$testdata}encode_known_genes_Mar07.gff3"
+  end
+
+  Name "AnnotationSketch (incremental diagram update, file index)"
+  Keywords "gt_scripts annotationsketch binary"
+  Test do
+    run_test "#{$bin}gt gff3 -binary -o in.gtb " +
+             "#{$testdata}encode_known_genes_Mar07.gff3"
+    [0, 4, 1024].each do |cache_size|
+      run_test "#{$bin}gt #{$testdata}/gtscripts/diagram_update.lua in.gtb " +
+               "#{cache_size}"
+    end
+    run_test("#{$bin}gt #{$testdata}/gtscripts/diagram_update.lua in.gtb -1",
+             :retval => 1)
+    grep $last_stderr, "cache size must be >= 0"
+  end
+
   Name "AnnotationSketch (invalid ImageInfo object)"
   Keywords "gt_scripts"
   Test do
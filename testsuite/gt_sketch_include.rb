@@ -122,6 +122,149 @@ Test do
   run "diff #{$last_stdout} #{$testdata}gt_sketch_textwidth_2.recmaps"
 end
 
+Name "gt sketch -showrecmaps (binary input)"
+Keywords "gt_sketch showrecmaps binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o in.gtb " +
+           "#{$testdata}standard_gene_as_tree.gff3"
+  run_test "#{$bin}gt sketch -showrecmaps out.png in.gtb", :maxtime => 600
+  run "diff #{$last_stdout} #{$testdata}standard_gene_as_tree.recmaps"
+end
+
+Name "gt sketch -showrecmaps (binary input, range)"
+Keywords "gt_sketch showrecmaps binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o in.gtb " +
+           "#{$testdata}encode_known_genes_Mar07.gff3"
+  run_test "#{$bin}gt sketch -showrecmaps -seqid chr1 -start 148000000 " +
+           "-end 148200000 out.png in.gtb", :maxtime => 600
+  run "mv #{$last_stdout} binary.recmaps"
+  run_test "#{$bin}gt sketch -force -showrecmaps -seqid chr1 " +
+           "-start 148000000 -end 148200000 out.png " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+  run "diff #{$last_stdout} binary.recmaps"
+end
+
+Name "gt sketch (binary input, unknown seqid)"
+Keywords "gt_sketch binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o in.gtb " +
+           "#{$testdata}standard_gene_as_tree.gff3"
+  run_test("#{$bin}gt sketch -seqid foo out.png in.gtb", :retval => 1)
+  grep $last_stderr, "sequence region 'foo' does not exist"
+end
+
+Name "gt sketch (feature density instead of features)"
+Keywords "gt_sketch showrecmaps binary"
+Test do
+  run "cp #{$cur}/gtdata/sketch/default.style density.style"
+  File.open("density.style", "a") do |f|
+    f.puts "style.feature_density = { threshold = 0.001 }"
+  end
+  run_test "#{$bin}gt gff3 -binary -o in.gtb " +
+           "#{$testdata}encode_known_genes_Mar07.gff3"
+  run_test "#{$bin}gt sketch -style density.style -showrecmaps out.png in.gtb",
+           :maxtime => 600
+  run "test ! -s #{$last_stdout}"
+  run_test "#{$bin}gt sketch -force -style density.style -showrecmaps " +
+           "out.png #{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+  run "test ! -s #{$last_stdout}"
+  run_test "#{$bin}gt sketch -force -showrecmaps out.png in.gtb",
+           :maxtime => 600
+  run "test -s #{$last_stdout}"
+end
+
+Name "gt sketch -batch"
+Keywords "gt_sketch showrecmaps batch"
+Test do
+  File.open("tiles.txt", "w") do |f|
+    f.puts "# seqid start end image"
+    f.puts "chr1 148000000 148100000 tile1.png"
+    f.puts "chr1 148100000 148200000 tile2.png"
+    f.puts "chr1 148000000 148200000 tile3.png"
+  end
+  run_test "#{$bin}gt sketch -showrecmaps -batch tiles.txt -threads 2 " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+  grep $last_stdout, "3 images drawn with 2 threads"
+  run "grep -v '^#' #{$last_stdout} > batch.recmaps"
+  run "touch single.recmaps"
+  [[148000000, 148100000], [148100000, 148200000],
+   [148000000, 148200000]].each_with_index do |range, i|
+    run_test "#{$bin}gt sketch -force -showrecmaps -seqid chr1 " +
+             "-start #{range[0]} -end #{range[1]} out.png " +
+             "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+    run "cat #{$last_stdout} >> single.recmaps"
+    run "cmp out.png tile#{i + 1}.png"
+  end
+  run "diff batch.recmaps single.recmaps"
+end
+
+Name "gt sketch -batch (errors)"
+Keywords "gt_sketch batch"
+Test do
+  File.open("tiles.txt", "w") do |f|
+    f.puts "chr1 148000000 148100000 tile1.png"
+    f.puts "foo 1 1000 tile2.png"
+  end
+  run_test("#{$bin}gt sketch -batch tiles.txt " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :retval => 1,
+           :maxtime => 600)
+  grep $last_stderr, "sequence region 'foo' on line 2"
+  run_test("#{$bin}gt sketch -threads 2 out.png " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :retval => 1)
+  grep $last_stderr, "requires option \"-batch\""
+end
+
+Name "gt sketch -streaming"
+Keywords "gt_sketch streaming"
+Test do
+  ["", "-seqid chr1 -start 148000000 -end 148200000", "-addintrons"].each do |a|
+    run_test "#{$bin}gt sketch -showrecmaps #{a} index.png " +
+             "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+    run "mv #{$last_stdout} index.recmaps"
+    run_test "#{$bin}gt sketch -streaming -showrecmaps #{a} stream.png " +
+             "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+    run "diff #{$last_stdout} index.recmaps"
+    run "rm -f index.png stream.png"
+  end
+  run "#{$bin}gt gff3 -sort #{$testdata}gff3_file_1_short.txt > in.gff3"
+  run_test "#{$bin}gt sketch -streaming -pipe -start 1000 -end 2000 " +
+           "out.png < in.gff3 > out.gff3", :maxtime => 600
+  run "diff in.gff3 out.gff3"
+end
+
+Name "gt sketch -streaming (errors)"
+Keywords "gt_sketch streaming"
+Test do
+  run_test("#{$bin}gt sketch -streaming -seqid foo out.png " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :retval => 1)
+  grep $last_stderr, "sequence region 'foo' does not exist"
+  run_test("#{$bin}gt sketch -streaming out.png " +
+           "#{$testdata}encode_known_genes_Mar07.gff3 " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :retval => 1)
+  grep $last_stderr, "at most one GFF3 file"
+  run_test("#{$bin}gt sketch -streaming -input bed out.png " +
+           "#{$testdata}gff3_file_1_short.txt", :retval => 1)
+  grep $last_stderr, "requires GFF3 input"
+end
+
+Name "gt dev sketchbench"
+Keywords "gt_sketch sketchbench"
+Test do
+  ["genes", "pileup", "captions"].each do |workload|
+    run_test "#{$bin}gt dev sketchbench -workload #{workload} -features 200 " +
+             "-windows 3 -window 20000", :maxtime => 600
+    grep $last_stdout, "^layout  *3 "
+  end
+  run_test "#{$bin}gt dev sketchbench -windows 2 " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :maxtime => 600
+  grep $last_stdout, "^parse  *1 "
+  grep $last_stdout, "^sketch  *2 "
+  run_test("#{$bin}gt dev sketchbench -seqid foo " +
+           "#{$testdata}encode_known_genes_Mar07.gff3", :retval => 1)
+  grep $last_stderr, "sequence region 'foo' does not exist"
+end
+
 Name "sketch_constructed (C)"
 Keywords "gt_sketch annotationsketch"
 Test do
@@ -54,6 +54,13 @@ Test do
   run "diff #{$last_stdout} #{$testdata}gt_splicesiteinfo_test_5.out"
 end
 
+Name "gt splicesiteinfo test 5 (-addintrons, -threads)"
+Keywords "gt_splicesiteinfo threads"
+Test do
+  run_test "#{$bin}gt splicesiteinfo -threads 3 -addintrons -seqfile #{$testdata}gt_splicesiteinfo_test_5.fas #{$testdata}gt_splicesiteinfo_test_5.gff3"
+  run "diff #{$last_stdout} #{$testdata}gt_splicesiteinfo_test_5.out"
+end
+
 Name "gt splicesiteinfo test 6"
 Keywords "gt_splicesiteinfo"
 Test do
@@ -55,10 +55,17 @@ Name "gt stat (count LTR retrotransposons)"
 Keywords "gt_stat"
 Test do
   run_test "#{$bin}gt stat -v #{$testdata}gt_eval_ltr_test_1.in"
-  run "grep -v 'processing file' #{$last_stdout}"
+  run "grep -v -e 'processing file' -e '^feature nodes' #{$last_stdout}"
   run "diff #{$last_stdout} #{$testdata}gt_stat_test_6.out"
 end
 
+Name "gt stat (bytes per feature)"
+Keywords "gt_stat"
+Test do
+  run_test "#{$bin}gt stat -v #{$testdata}standard_gene_as_tree.gff3"
+  run "grep '^feature nodes: 16 (.* bytes per feature)$' #{$last_stdout}"
+end
+
 Name "gt stat (-exonnumberdistri standard gene)"
 Keywords "gt_stat"
 Test do
@@ -86,3 +93,19 @@ Keywords "gt_stat"
 Test do
   run_test "#{$bin}gt stat #{$testdata}minimal_fasta.gff3"
 end
+
+Name "gt stat (-exonnumberdistri encode, -threads)"
+Keywords "gt_stat threads"
+Test do
+  run_test "#{$bin}gt stat -threads 3 -exonnumberdistri " +
+           "#{$testdata}encode_known_genes_Mar07.gff3"
+  run "diff #{$last_stdout} #{$testdata}gt_stat_exonnumberdistri_encode.out"
+end
+
+Name "gt stat (-genelengthdistri, -threads)"
+Keywords "gt_stat threads"
+Test do
+  run_test "#{$bin}gt stat -threads 2 -genelengthdistri " +
+           "#{$testdata}standard_gene_as_tree.gff3"
+  run "diff #{$last_stdout} #{$testdata}gt_stat_test_2.out"
+end
@@ -109,6 +109,9 @@ Test do
   run_test "#{$bin}gt dev maxpairs -scan -l 8 -ii sfx"
   run "grep -v '^#' #{$last_stdout}"
   run "diff #{$last_stdout} #{$testdata}maxpairs-8-Atinsert.txt"
+  run_test "#{$bin}gt dev maxpairs -threads 3 -l 8 -ii sfx"
+  run "grep -v '^#' #{$last_stdout}"
+  run "diff #{$last_stdout} #{$testdata}maxpairs-8-Atinsert.txt"
   run_test "#{$bin}gt dev maxpairs -samples 40 -l 6 -ii sfx",:maxtime => 600
 end
 